@@ -683,9 +683,14 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
             int aes_key_ready = 0;
             int hmac_key_ready = 0;
 
+            // 작업 중에는 실행 버튼이 취소 버튼으로 동작
+            //  - 워커는 다음 버퍼 경계에서 멈추고 WM_WORKER_ERROR(-16)으로 알린다
             if (g_workerRunning) {
-                MessageBoxA(hwnd, "작업이 이미 실행 중입니다. 잠시 기다려주세요.",
-                    "알림", MB_OK | MB_ICONINFORMATION);
+                g_workerCancel = 1;
+                if (g_hRunBtn) {
+                    EnableWindow(g_hRunBtn, FALSE);
+                    SetWindowTextA(g_hRunBtn, "취소 중...");
+                }
                 goto RUN_CLEANUP;
             }
             if (g_selectedFile[0] == '\0') {
@@ -879,12 +884,12 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
             }
 
             if (g_hRunBtn) {
-                EnableWindow(g_hRunBtn, FALSE);
-                SetWindowTextA(g_hRunBtn, "처리 중...");
+                SetWindowTextA(g_hRunBtn, "취소");
             }
 
             g_hProgressDlg = CreateProgressDialog(hwnd);
 
+            g_workerCancel = 0;
             g_workerRunning = 1;
             g_hWorkerThread = CreateThread(NULL, 0,
                 WorkerThreadProc, data,
@@ -1078,6 +1083,17 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
         else if (errorCode == -117) {
             strcpy(err_msg, "임시 파일 경로가 입력/출력 파일과 충돌합니다.\n시스템 임시 디렉토리를 확인해주세요.");
         }
+        else if (errorCode == -118) {
+            strcpy(err_msg, "복호화 결과 쓰기 실패");
+        }
+        else if (errorCode == -119) {
+            strcpy(err_msg, "입력 파일 읽기 실패");
+        }
+        else if (errorCode == -16) {
+            MessageBoxA(hwnd, "사용자가 작업을 취소했습니다.",
+                "알림", MB_OK | MB_ICONINFORMATION);
+            break;
+        }
         else if (errorCode == -200) {
             strcpy(err_msg,
                 "SHA-512 해시 계산: 입력 파일을 열 수 없습니다.");
@@ -1108,6 +1124,7 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
     }
     case WM_DESTROY:
         if (g_workerRunning && g_hWorkerThread) {
+            g_workerCancel = 1;     // 진행 중인 작업은 다음 버퍼에서 멈춤
             WaitForSingleObject(g_hWorkerThread, INFINITE);
             CloseHandle(g_hWorkerThread);
             g_hWorkerThread = NULL;
@@ -4,6 +4,7 @@
 
 #include "crypto/stream/stream_api.h"
 #include "crypto/key/key_context.h"
+#include "crypto/key/pbkdf2.h"
 #include "crypto/cipher/aes_engine_ref.h"
 #include "crypto/cipher/aes_engine_ttable.h"
 #include "crypto/mode/mode_ctr.h"
@@ -92,6 +93,11 @@ typedef struct cli_cfg_t {
     int  key_random;   // 파일 모드에서 1=random, 0=seed
     char key_seed[256];
 
+    int  key_passphrase;        // 1 = 패스프레이즈(PBKDF2-HMAC-SHA512)
+    char key_salt[256];         // PBKDF2 salt
+    unsigned int key_iterations;// PBKDF2 반복 횟수
+    int  key_derive_ver;        // enc_key 파생 버전 (KC_DERIVE_V1 / KC_DERIVE_V2)
+
     char in_path[512];
     char out_path[512];
 } cli_cfg_t;
@@ -219,7 +225,8 @@ static int interactive_config(cli_cfg_t* cfg)
         printf("\n키 생성 방식:\n");
         printf("  1) 랜덤 키\n");
         printf("  2) seed 기반 결정적 키\n");
-        int k = ask_int("선택 (1/2): ");
+        printf("  3) 패스프레이즈 (PBKDF2-HMAC-SHA512)\n");
+        int k = ask_int("선택 (1/2/3): ");
         if (k == 1) {
             cfg->key_random = 1;
         }
@@ -231,10 +238,33 @@ static int interactive_config(cli_cfg_t* cfg)
                 return 0;
             }
         }
+        else if (k == 3) {
+            cfg->key_random = 0;
+            cfg->key_passphrase = 1;
+            ask_line("패스프레이즈 입력: ", cfg->key_seed, sizeof(cfg->key_seed));
+            ask_line("salt 문자열 입력: ", cfg->key_salt, sizeof(cfg->key_salt));
+            if (cfg->key_seed[0] == '\0' || cfg->key_salt[0] == '\0') {
+                printf("패스프레이즈/salt가 비었음.\n");
+                return 0;
+            }
+            int it = ask_int("반복 횟수 (0 = 기본값): ");
+            cfg->key_iterations = (it > 0) ? (unsigned int)it : PBKDF2_SHA512_DEFAULT_ITERATIONS;
+        }
         else {
             printf("잘못된 선택.\n");
             return 0;
         }
+
+        // 이전 빌드는 master_key 앞부분을 그대로 키로 썼으므로(V1) 그때 만든 파일은 V1로 복호화한다.
+        cfg->key_derive_ver = KC_DERIVE_VERSION;
+        if (!cfg->file_enc && !cfg->key_random) {
+            int v = ask_int("키 파생 버전 (1 = 이전 빌드 파일, 2 = HKDF 기본): ");
+            if (v == 1) cfg->key_derive_ver = KC_DERIVE_V1;
+            else if (v != 2) {
+                printf("잘못된 선택.\n");
+                return 0;
+            }
+        }
     }
 
     return 1;
@@ -295,12 +325,21 @@ static int run_file_mode(const cli_cfg_t* cfg)
     if (cfg->key_random) {
         key_context_init_random(&kc);
     }
+    else if (cfg->key_passphrase) {
+        if (key_context_init_passphrase(&kc,
+            (const unsigned char*)cfg->key_seed, strlen(cfg->key_seed),
+            (const unsigned char*)cfg->key_salt, strlen(cfg->key_salt),
+            cfg->key_iterations) != 0) {
+            printf("[ERR] PBKDF2 키 파생 실패\n");
+            return 1;
+        }
+    }
     else {
         key_context_init_seed(&kc,
             (const unsigned char*)cfg->key_seed,
             (unsigned int)strlen(cfg->key_seed));
     }
-    key_context_derive(&kc, (unsigned int)key_len);
+    key_context_derive_ex(&kc, (unsigned int)key_len, cfg->key_derive_ver);
 
     int rc;
     if (cfg->file_enc) {
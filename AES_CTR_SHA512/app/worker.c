@@ -21,10 +21,12 @@
 // worker 스레드:
 //  - GUI에서 선택한 암/복호화/해시 작업을 백그라운드에서 수행
 //  - 진행률/완료/에러를 메인 윈도우에 PostMessage로 알림
-//  - 모니터 스레드가 출력 파일 크기 또는 경과 시간 기반으로 진행률을 추적
+//  - 진행률은 스트림 API의 progress 콜백(처리한 입력 바이트)으로 계산하고,
+//    취소는 cancel 콜백이 g_workerCancel을 확인해 라이브러리 루프를 멈춘다
 
 // 이 파일이 g_workerRunning의 실제 정의를 가짐
 volatile int g_workerRunning = 0;
+volatile int g_workerCancel = 0;
 
 // 전체 파일 크기 (필요하면 진행률 계산에 활용 가능)
 static volatile long long g_totalFileSize = 0;
@@ -51,91 +53,53 @@ static void free_worker_data(worker_data_t* data)
     free(data);
 }
 
-// 진행률 모니터 스레드 데이터
+// 스트림 API 입출력 오류 코드 → GUI 오류 코드 (나머지는 그대로)
+//  - toTemp: 출력이 임시 파일 (HMAC 복호화)
+static int stream_io_error(int rc, int isEncrypt, int toTemp)
+{
+    if (rc == -3) return toTemp ? -110 : -105;      // 출력 파일 열기
+    if (rc == -6) return isEncrypt ? -112 : -118;   // 쓰기
+    if (rc == -7) return -119;                      // 입력 읽기
+    return rc;
+}
+
+// 진행률 콜백 상태
 typedef struct {
     HWND hwnd;
-    char outputFile[MAX_PATH + 20];  // 경로를 복사해서 저장
-    long long totalSize;
-    volatile int* running;
-    int isHashMode;  // SHA-512 해시 모드인지 여부
-} monitor_data_t;
+    int lastPercent;
+} progress_ctx_t;
 
 /* --------------------------------------------------------------------
- * 진행률 모니터 스레드
- *  - AES-CTR / AES-CTR+HMAC 모드에서 출력 파일 크기(or 추정 시간)을
- *    기반으로 진행률을 메인 윈도우에 WM_WORKER_PROGRESS로 전달
+ * 스트림 API 콜백 (작업 스레드에서 버퍼 하나를 마칠 때마다 호출)
+ *  - WorkerProgress: 처리한 입력 바이트로 진행률을 계산해 오를 때만 WM_WORKER_PROGRESS,
+ *    평균 메모리 계산용 샘플링(500ms 간격)도 여기서 수행
+ *  - WorkerCancelled: 메인 스레드가 취소 버튼으로 세운 g_workerCancel 확인
  * ------------------------------------------------------------------*/
-static DWORD WINAPI MonitorThreadProc(LPVOID lpParam) {
-    monitor_data_t* mdata = (monitor_data_t*)lpParam;
-    if (!mdata) return 1;
-
-    // 초기 진행률 0% 설정
-    PostMessageA(mdata->hwnd, WM_WORKER_PROGRESS, 0, 0);
-
-    DWORD startTime = GetTickCount();
-    int lastPercent = 0;
-    
-    // 메모리 샘플링 초기화
-    g_memSum = 0;
-    g_memSampleCount = 0;
-    g_lastMemCheck = GetTickCount();
-
-    while (*mdata->running) {
-        // 1) 주기적으로 메모리 사용량 샘플링 (평균값 산출용)
-        // 500ms마다 메모리 샘플링
-        DWORD now = GetTickCount();
-        if (now - g_lastMemCheck >= 500) {
-            SIZE_T mem = GetProcessMemoryUsageKB();
-            if (mem > 0) {
-                g_memSum += mem;
-                g_memSampleCount++;
-            }
-            g_lastMemCheck = now;
+static void WorkerProgress(void* user, uint64_t done, uint64_t total) {
+    progress_ctx_t* pc = (progress_ctx_t*)user;
+
+    DWORD now = GetTickCount();
+    if (now - g_lastMemCheck >= 500) {
+        SIZE_T mem = GetProcessMemoryUsageKB();
+        if (mem > 0) {
+            g_memSum += mem;
+            g_memSampleCount++;
         }
-        
-        if (mdata->isHashMode) {
-            // 2) 해시 모드: 파일 크기/시간으로만 대략 진행률 추정 (실제 사용은 거의 없음)
-            DWORD elapsed = GetTickCount() - startTime;
-            long long estimatedTimeMs =
-                (mdata->totalSize / (100 * 1024 * 1024)) * 1000;  // 100MB/s 가정
-
-            if (estimatedTimeMs < 1000)
-                estimatedTimeMs = 1000;  // 최소 1초
-
-            int percent = (int)((elapsed * 95) / estimatedTimeMs);  // 95%까지만
-            if (percent > 95) percent = 95;
+        g_lastMemCheck = now;
+    }
 
-            if (percent > lastPercent) {
-                PostMessageA(mdata->hwnd, WM_WORKER_PROGRESS, percent, 0);
-                lastPercent = percent;
-            }
-        }
-        else {
-            // 3) 암/복호화 모드: 현재까지 생성된 출력 파일 크기로 진행률 계산
-            // 파일이 존재하는지 먼저 확인 (삭제된 파일을 참조하지 않도록)
-            FILE* f_check = fopen(mdata->outputFile, "rb");
-            if (f_check) {
-                fclose(f_check);
-                long long currentSize = GetFileSizeBytes(mdata->outputFile);
-                if (mdata->totalSize > 0) {
-                    int percent = 0;
-                    if (currentSize > 0) {
-                        percent = (int)((currentSize * 100) / mdata->totalSize);
-                        if (percent > 100) percent = 100;
-                    }
-                    if (percent > lastPercent) {
-                        PostMessageA(mdata->hwnd, WM_WORKER_PROGRESS, percent, 0);
-                        lastPercent = percent;
-                    }
-                }
-            }
-            // 파일이 없으면 진행률을 업데이트하지 않음 (이미 삭제되었거나 아직 생성되지 않음)
-        }
-        Sleep(100);  // 100ms마다 확인
+    if (total == 0) return;
+    int percent = (int)(done * 100 / total);
+    if (percent > 100) percent = 100;
+    if (percent > pc->lastPercent) {
+        PostMessageA(pc->hwnd, WM_WORKER_PROGRESS, percent, 0);
+        pc->lastPercent = percent;
     }
+}
 
-    free(mdata);
-    return 0;
+static int WorkerCancelled(void* user) {
+    (void)user;
+    return g_workerCancel != 0;
 }
 
 /* --------------------------------------------------------------------
@@ -164,6 +128,21 @@ DWORD WINAPI WorkerThreadProc(LPVOID lpParam) {
         PostMessageA(data->hwnd, WM_WORKER_PROGRESS, 0, 0);  // 0% 시작
     }
 
+    // 메모리 샘플링 초기화 (샘플은 진행률 콜백에서 수집)
+    g_memSum = 0;
+    g_memSampleCount = 0;
+    g_lastMemCheck = GetTickCount();
+
+    // 스트림 옵션: 버퍼 크기는 측정값에 따라 조정하고,
+    // 진행률/취소는 라이브러리 루프가 버퍼마다 콜백으로 알린다.
+    progress_ctx_t progress = { data->hwnd, 0 };
+    stream_options_t streamOpt;
+    stream_options_init(&streamOpt);
+    streamOpt.adaptive = 1;
+    streamOpt.progress = WorkerProgress;
+    streamOpt.cancel = WorkerCancelled;
+    streamOpt.user = &progress;
+
     int rc = 0;
     const blockcipher_vtable_t* engine =
         (data->engineIndex == 1) ? &AES_REF_ENGINE : &AES_TTABLE_ENGINE;
@@ -186,180 +165,24 @@ DWORD WINAPI WorkerThreadProc(LPVOID lpParam) {
             // 1. 랜덤 IV 생성
             GenerateRandomBytes(iv, 16);
 
-            // 2. 임시 파일에 암호문 저장
-            char tempFile[MAX_PATH + 20];
-            strncpy(tempFile, data->outputFile, MAX_PATH - 1);
-            tempFile[MAX_PATH - 1] = '\0';
-            char* ext = strrchr(tempFile, '.');
-            if (ext) *ext = '\0';
-            size_t tlen = strlen(tempFile);
-            if (tlen + 10 < MAX_PATH) {
-                strcat(tempFile, ".tmp");
-            }
-
-            // 진행률 모니터 스레드 시작
-            if (totalSize > 0) {
-                monitor_data_t* monitorData =
-                    (monitor_data_t*)malloc(sizeof(monitor_data_t));
-                if (monitorData) {
-                    monitorData->hwnd = data->hwnd;
-                    strncpy(monitorData->outputFile, tempFile, MAX_PATH + 19);  // 경로 복사
-                    monitorData->outputFile[MAX_PATH + 19] = '\0';
-                    monitorData->totalSize = totalSize;
-                    monitorData->running = &g_workerRunning;
-                    monitorData->isHashMode = 0;
-
-                    HANDLE hMonitorThread =
-                        CreateThread(NULL, 0, MonitorThreadProc, monitorData, 0, NULL);
-                    if (hMonitorThread) {
-                        // 스레드는 detach 형태로 동작 (핸들만 닫고 기다리지 않음)
-                        CloseHandle(hMonitorThread);
-                    }
-                }
-            }
-
-            rc = stream_encrypt_ctr_file(engine,
+            // 2. IV || CT || HMAC 을 출력 파일에 한 번에 기록
+            //    (암호문을 쓰면서 바로 MAC하므로 임시 파일/재읽기 없음)
+            rc = stream_encrypt_ctr_hmac_file_ex(engine,
                 data->inputFile,
-                tempFile,
+                data->outputFile,
                 data->aes_key,
                 data->aesKeyLen,
-                iv);
+                iv,
+                data->hmac_key,
+                data->hmacKeyLen,
+                &streamOpt);
+            rc = stream_io_error(rc, 1, 0);
             if (rc != 0) {
-                remove(tempFile);
                 PostMessageA(data->hwnd, WM_WORKER_ERROR, rc, 0);
                 free_worker_data(data);
                 return 1;
             }
 
-            // 3. IV + 암호문에 대해 HMAC 계산
-            PostMessageA(data->hwnd, WM_WORKER_PROGRESS, 90, 0);
-
-            FILE* f_temp = fopen(tempFile, "rb");
-            if (!f_temp) {
-                remove(tempFile);
-                PostMessageA(data->hwnd, WM_WORKER_ERROR, -104, 0);
-                free_worker_data(data);
-                return 1;
-            }
-
-            hmac_ctx hmac_ctx_obj;
-            hmac_init(&hmac_ctx_obj, data->hmac_key, data->hmacKeyLen);
-
-            // IV 추가
-            hmac_update(&hmac_ctx_obj, iv, 16);
-
-            // 암호문 추가
-            size_t buf_size = 1024 * 1024;
-            unsigned char* buf = (unsigned char*)malloc(buf_size);
-            if (!buf) {
-                fclose(f_temp);
-                remove(tempFile);
-                PostMessageA(data->hwnd, WM_WORKER_ERROR, -202, 0);
-                free_worker_data(data);
-                return 1;
-            }
-
-            size_t n;
-            while ((n = fread(buf, 1, buf_size, f_temp)) > 0) {
-                hmac_update(&hmac_ctx_obj, buf, n);
-            }
-            fclose(f_temp);
-            free(buf);
-
-            unsigned char hmac_mac[64];
-            hmac_final(&hmac_ctx_obj, hmac_mac);
-
-            // HMAC 계산 완료, 최종 파일 작성 시작 (95%)
-            PostMessageA(data->hwnd, WM_WORKER_PROGRESS, 95, 0);
-
-            // 4. 최종 파일: IV(16) + 암호문 + HMAC(64)
-            FILE* f_out = fopen(data->outputFile, "wb");
-            if (!f_out) {
-                remove(tempFile);
-                PostMessageA(data->hwnd, WM_WORKER_ERROR, -105, 0);
-                free_worker_data(data);
-                return 1;
-            }
-
-            // IV 쓰기
-            if (fwrite(iv, 1, 16, f_out) != 16) {
-                fclose(f_out);
-                remove(data->outputFile);
-                remove(tempFile);
-                PostMessageA(data->hwnd, WM_WORKER_ERROR, -111, 0);
-                free_worker_data(data);
-                return 1;
-            }
-
-            // 암호문 복사
-            f_temp = fopen(tempFile, "rb");
-            if (!f_temp) {
-                fclose(f_out);
-                remove(data->outputFile);
-                remove(tempFile);
-                PostMessageA(data->hwnd, WM_WORKER_ERROR, -104, 0);
-                free_worker_data(data);
-                return 1;
-            }
-
-            buf = (unsigned char*)malloc(buf_size);
-            if (!buf) {
-                fclose(f_temp);
-                fclose(f_out);
-                remove(data->outputFile);
-                remove(tempFile);
-                PostMessageA(data->hwnd, WM_WORKER_ERROR, -202, 0);
-                free_worker_data(data);
-                return 1;
-            }
-
-            while ((n = fread(buf, 1, buf_size, f_temp)) > 0) {
-                if (fwrite(buf, 1, n, f_out) != n) {
-                    free(buf);
-                    fclose(f_temp);
-                    fclose(f_out);
-                    remove(data->outputFile);
-                    remove(tempFile);
-                    PostMessageA(data->hwnd, WM_WORKER_ERROR, -112, 0);
-                    free_worker_data(data);
-                    return 1;
-                }
-            }
-            free(buf);
-            fclose(f_temp);
-
-            // HMAC 쓰기
-            if (fwrite(hmac_mac, 1, 64, f_out) != 64) {
-                fclose(f_out);
-                remove(data->outputFile);
-                remove(tempFile);
-                PostMessageA(data->hwnd, WM_WORKER_ERROR, -113, 0);
-                free_worker_data(data);
-                return 1;
-            }
-
-            // 플러시 및 닫기
-            fflush(f_out);
-            if (fclose(f_out) != 0) {
-                remove(data->outputFile);
-                remove(tempFile);
-                PostMessageA(data->hwnd, WM_WORKER_ERROR, -114, 0);
-                free_worker_data(data);
-                return 1;
-            }
-
-            // 임시 파일 삭제
-            remove(tempFile);
-
-            // 최종 파일 존재 확인
-            FILE* f_check = fopen(data->outputFile, "rb");
-            if (!f_check) {
-                PostMessageA(data->hwnd, WM_WORKER_ERROR, -115, 0);
-                free_worker_data(data);
-                return 1;
-            }
-            fclose(f_check);
-
             strncpy(encryptedFile, data->outputFile, MAX_PATH);
 
             // 100% 완료 표시
@@ -367,90 +190,52 @@ DWORD WINAPI WorkerThreadProc(LPVOID lpParam) {
         }
         else {
             // 복호화: iv||ct||hmac 형태
-            FILE* f_in = fopen(data->inputFile, "rb");
-            if (!f_in) {
-                PostMessageA(data->hwnd, WM_WORKER_ERROR, -106, 0);
-                free_worker_data(data);
-                return 1;
-            }
-
-            // 1. IV 읽기 (16 bytes)
-            if (fread(iv, 1, 16, f_in) != 16) {
-                fclose(f_in);
-                PostMessageA(data->hwnd, WM_WORKER_ERROR, -107, 0);
-                free_worker_data(data);
-                return 1;
-            }
-
-            // 2. 파일 크기 확인 (최소 IV+HMAC 길이 체크)
-            _fseeki64(f_in, 0, SEEK_END);
-            long long fileSize = _ftelli64(f_in);
-            if (fileSize < 16 + 64) {
-                fclose(f_in);
-                PostMessageA(data->hwnd, WM_WORKER_ERROR, -108, 0);
-                free_worker_data(data);
-                return 1;
-            }
-
-            long long ctSize = fileSize - 16 - 64;  // 암호문 크기
-
-            // 3. HMAC 읽기 (마지막 64 bytes)
-            _fseeki64(f_in, fileSize - 64, SEEK_SET);
-            unsigned char hmac_expected[64];
-            if (fread(hmac_expected, 1, 64, f_in) != 64) {
-                fclose(f_in);
-                PostMessageA(data->hwnd, WM_WORKER_ERROR, -109, 0);
-                free_worker_data(data);
-                return 1;
+            //  - 입력을 앞에서부터 한 번만 읽으며 HMAC 검증과 복호화를 함께 수행
+            //    (태그를 읽으려고 끝으로 seek하거나 암호문을 임시 파일로 추출하지 않음)
+            //  - 평문은 검증에 성공해야 tempFile로 확정되고, 사용자가 승인하면 출력 파일로 이동
+            char tempFile[MAX_PATH + 20];
+            strncpy(tempFile, data->outputFile, MAX_PATH - 1);
+            tempFile[MAX_PATH - 1] = '\0';
+            char* ext = strrchr(tempFile, '.');
+            if (ext) *ext = '\0';
+            size_t tlen = strlen(tempFile);
+            if (tlen + 10 < MAX_PATH) {
+                strcat(tempFile, ".tmp");
             }
 
-            // 4. IV + 암호문에 대해 HMAC 검증
-            _fseeki64(f_in, 0, SEEK_SET);
-            hmac_ctx hmac_ctx_obj;
-            hmac_init(&hmac_ctx_obj, data->hmac_key, data->hmacKeyLen);
-
-            hmac_update(&hmac_ctx_obj, iv, 16);
-
-            size_t buf_size = 1024 * 1024;
-            unsigned char* buf = (unsigned char*)malloc(buf_size);
-            if (!buf) {
-                fclose(f_in);
-                PostMessageA(data->hwnd, WM_WORKER_ERROR, -202, 0);
+            // 안전 체크: 임시 파일 경로가 입력 파일이나 출력 파일과 같으면 안 됨
+            if (strcmp(tempFile, data->inputFile) == 0 ||
+                strcmp(tempFile, data->outputFile) == 0) {
+                PostMessageA(data->hwnd, WM_WORKER_ERROR, -117, 0);
                 free_worker_data(data);
                 return 1;
             }
 
-            _fseeki64(f_in, 16, SEEK_SET);  // IV 다음부터
-            long long remaining = ctSize;
-            while (remaining > 0) {
-                size_t to_read =
-                    (remaining > (long long)buf_size) ? buf_size : (size_t)remaining;
-                size_t n = fread(buf, 1, to_read, f_in);
-                if (n == 0) break;
-                hmac_update(&hmac_ctx_obj, buf, n);
-                remaining -= (long long)n;
-            }
-            free(buf);
-
-            unsigned char hmac_actual[64];
-            hmac_final(&hmac_ctx_obj, hmac_actual);
-
-            // HMAC 검증
-            if (memcmp(hmac_expected, hmac_actual, 64) != 0) {
-                fclose(f_in);
-                PostMessageA(data->hwnd, WM_WORKER_ERROR, -103, 0);
+            rc = stream_decrypt_ctr_hmac_file_ex(engine,
+                data->inputFile,
+                tempFile,
+                data->aes_key,
+                data->aesKeyLen,
+                data->hmac_key,
+                data->hmacKeyLen,
+                &streamOpt);
+            if (rc == -10) rc = -103;        // HMAC 검증 실패
+            else if (rc == -13) rc = -108;   // IV + HMAC보다 짧음
+            else rc = stream_io_error(rc, 0, 1);
+            if (rc != 0) {
+                PostMessageA(data->hwnd, WM_WORKER_ERROR, rc, 0);
                 free_worker_data(data);
                 return 1;
             }
 
-            // HMAC 검증 성공 후, 복호화 진행 여부를 메인 윈도우에 질의
+            // HMAC 검증 성공 후, 복호화 결과를 저장할지 메인 윈도우에 질의
             LRESULT userChoice = IDYES;
             if (IsWindow(data->hwnd)) {
                 userChoice = SendMessageA(data->hwnd, WM_HMAC_VERIFIED, 0, 0);
             }
 
             if (userChoice != IDYES) {
-                fclose(f_in);
+                remove(tempFile);
 
                 const char* doneMsg =
                     "인증에는 성공했지만, 사용자가 복호화를 취소했습니다.";
@@ -467,83 +252,9 @@ DWORD WINAPI WorkerThreadProc(LPVOID lpParam) {
                 return 0;
             }
 
-            // 5. 복호화 수행 (암호문을 임시 파일로 추출 후 복호화)
-            char tempFile[MAX_PATH + 20];
-            strncpy(tempFile, data->outputFile, MAX_PATH - 1);
-            tempFile[MAX_PATH - 1] = '\0';
-            char* ext = strrchr(tempFile, '.');
-            if (ext) *ext = '\0';
-            size_t tlen = strlen(tempFile);
-            if (tlen + 10 < MAX_PATH) {
-                strcat(tempFile, ".tmp");
-            }
-
-            FILE* f_temp = fopen(tempFile, "wb");
-            if (!f_temp) {
-                fclose(f_in);
-                PostMessageA(data->hwnd, WM_WORKER_ERROR, -110, 0);
-                free_worker_data(data);
-                return 1;
-            }
-
-            buf = (unsigned char*)malloc(buf_size);
-            if (!buf) {
-                fclose(f_in);
-                fclose(f_temp);
+            if (!MoveFileExA(tempFile, data->outputFile, MOVEFILE_REPLACE_EXISTING)) {
                 remove(tempFile);
-                PostMessageA(data->hwnd, WM_WORKER_ERROR, -202, 0);
-                free_worker_data(data);
-                return 1;
-            }
-
-            _fseeki64(f_in, 16, SEEK_SET);  // IV 다음부터
-            remaining = ctSize;
-            while (remaining > 0) {
-                size_t to_read =
-                    (remaining > (long long)buf_size) ? buf_size : (size_t)remaining;
-                size_t n = fread(buf, 1, to_read, f_in);
-                if (n == 0) break;
-                fwrite(buf, 1, n, f_temp);
-                remaining -= (long long)n;
-            }
-            free(buf);
-            fclose(f_in);
-            fclose(f_temp);
-
-            // 진행률 모니터 스레드 시작 (복호화 출력 파일 기준)
-            long long tempSize = GetFileSizeBytes(tempFile);
-            if (tempSize > 0) {
-                monitor_data_t* monitorData =
-                    (monitor_data_t*)malloc(sizeof(monitor_data_t));
-                if (monitorData) {
-                    monitorData->hwnd = data->hwnd;
-                    strncpy(monitorData->outputFile, data->outputFile, MAX_PATH + 19);  // 경로 복사
-                    monitorData->outputFile[MAX_PATH + 19] = '\0';
-                    monitorData->totalSize = tempSize;
-                    monitorData->running = &g_workerRunning;
-                    monitorData->isHashMode = 0;
-
-                    HANDLE hMonitorThread =
-                        CreateThread(NULL, 0, MonitorThreadProc, monitorData, 0, NULL);
-                    if (hMonitorThread) {
-                        CloseHandle(hMonitorThread); // detach
-                    }
-                    else {
-                        free(monitorData);
-                    }
-                }
-            }
-
-            rc = stream_decrypt_ctr_file(engine,
-                tempFile,
-                data->outputFile,
-                data->aes_key,
-                data->aesKeyLen,
-                iv);
-            remove(tempFile);
-
-            if (rc != 0) {
-                PostMessageA(data->hwnd, WM_WORKER_ERROR, rc, 0);
+                PostMessageA(data->hwnd, WM_WORKER_ERROR, -105, 0);
                 free_worker_data(data);
                 return 1;
             }
@@ -569,166 +280,23 @@ DWORD WINAPI WorkerThreadProc(LPVOID lpParam) {
             // IV 생성
             GenerateRandomBytes(iv, 16);
 
-            // 임시 파일에 암호문 저장
-            // 시스템 임시 디렉토리에 고유한 임시 파일 생성 (입력/출력 파일과 절대 겹치지 않도록)
-            char tempFile[MAX_PATH + 20];
-            char tmpDir[MAX_PATH];
-            if (GetTempPathA(MAX_PATH, tmpDir) > 0) {
-                // 고유한 파일명 생성 (프로세스 ID + 타임스탬프 사용)
-                DWORD pid = GetCurrentProcessId();
-                DWORD tick = GetTickCount();
-                char* fileName = strrchr(data->inputFile, '\\');
-                if (!fileName) fileName = strrchr(data->inputFile, '/');
-                if (!fileName) fileName = (char*)data->inputFile;
-                else fileName++;
-                // 파일명에서 확장자 제거
-                char baseName[MAX_PATH];
-                strncpy(baseName, fileName, MAX_PATH - 1);
-                baseName[MAX_PATH - 1] = '\0';
-                char* ext = strrchr(baseName, '.');
-                if (ext) *ext = '\0';
-                snprintf(tempFile, MAX_PATH, "%s%s_%lu_%lu.encrypt.tmp", tmpDir, baseName, (unsigned long)pid, (unsigned long)tick);
-            }
-            else {
-                // GetTempPathA 실패 시 입력 파일과 다른 경로 사용
-                strncpy(tempFile, data->inputFile, MAX_PATH - 1);
-                tempFile[MAX_PATH - 1] = '\0';
-                char* ext = strrchr(tempFile, '.');
-                if (ext) *ext = '\0';
-                size_t tlen = strlen(tempFile);
-                if (tlen + 15 < MAX_PATH) {
-                    strcat(tempFile, ".encrypt.tmp");
-                }
-                else {
-                    // 최후의 수단: 현재 디렉토리에 생성
-                    strncpy(tempFile, "encrypt.tmp", MAX_PATH - 1);
-                    tempFile[MAX_PATH - 1] = '\0';
-                }
-            }
-
-            // 안전 체크: 임시 파일 경로가 입력 파일이나 출력 파일과 같으면 안 됨
-            if (strcmp(tempFile, data->inputFile) == 0 || 
-                strcmp(tempFile, data->outputFile) == 0) {
-                PostMessageA(data->hwnd, WM_WORKER_ERROR, -117, 0);
-                free_worker_data(data);
-                return 1;
-            }
-
-            // 진행률 모니터 스레드 시작 (임시 파일 모니터링)
-            // 주의: 모니터 스레드는 임시 파일이 삭제되기 전까지만 실행됨
-            HANDLE hMonitorThread = NULL;
-            monitor_data_t* monitorData = NULL;
-            if (totalSize > 0) {
-                monitorData = (monitor_data_t*)malloc(sizeof(monitor_data_t));
-                if (monitorData) {
-                    monitorData->hwnd = data->hwnd;
-                    strncpy(monitorData->outputFile, tempFile, MAX_PATH + 19);  // 경로 복사
-                    monitorData->outputFile[MAX_PATH + 19] = '\0';
-                    monitorData->totalSize = totalSize;
-                    monitorData->running = &g_workerRunning;
-                    monitorData->isHashMode = 0;
-
-                    hMonitorThread = CreateThread(NULL, 0, MonitorThreadProc, monitorData, 0, NULL);
-                    if (hMonitorThread) {
-                        CloseHandle(hMonitorThread); // detach
-                    }
-                    else {
-                        free(monitorData);
-                        monitorData = NULL;
-                    }
-                }
-            }
-
-            rc = stream_encrypt_ctr_file(engine,
+            // IV(16) || 암호문 을 출력 파일에 바로 기록 (임시 파일/복사 없음)
+            rc = stream_encrypt_ctr_hmac_file_ex(engine,
                 data->inputFile,
-                tempFile,
+                data->outputFile,
                 data->aes_key,
                 data->aesKeyLen,
-                iv);
+                iv,
+                NULL,
+                0,
+                &streamOpt);
+            rc = stream_io_error(rc, 1, 0);
             if (rc != 0) {
-                remove(tempFile);
                 PostMessageA(data->hwnd, WM_WORKER_ERROR, rc, 0);
                 free_worker_data(data);
                 return 1;
             }
 
-            // 암호화 완료, 최종 파일 작성 시작 (90%)
-            PostMessageA(data->hwnd, WM_WORKER_PROGRESS, 90, 0);
-
-            // 최종 파일: IV(16) + 암호문
-            FILE* f_out = fopen(data->outputFile, "wb");
-            if (!f_out) {
-                remove(tempFile);
-                PostMessageA(data->hwnd, WM_WORKER_ERROR, -105, 0);
-                free_worker_data(data);
-                return 1;
-            }
-
-            // IV 쓰기
-            if (fwrite(iv, 1, 16, f_out) != 16) {
-                fclose(f_out);
-                remove(data->outputFile);
-                remove(tempFile);
-                PostMessageA(data->hwnd, WM_WORKER_ERROR, -111, 0);
-                free_worker_data(data);
-                return 1;
-            }
-
-            // 암호문 복사
-            FILE* f_temp = fopen(tempFile, "rb");
-            if (!f_temp) {
-                fclose(f_out);
-                remove(data->outputFile);
-                remove(tempFile);
-                PostMessageA(data->hwnd, WM_WORKER_ERROR, -104, 0);
-                free_worker_data(data);
-                return 1;
-            }
-
-            size_t buf_size = 1024 * 1024;
-            unsigned char* buf = (unsigned char*)malloc(buf_size);
-            if (!buf) {
-                fclose(f_temp);
-                fclose(f_out);
-                remove(data->outputFile);
-                remove(tempFile);
-                PostMessageA(data->hwnd, WM_WORKER_ERROR, -202, 0);
-                free_worker_data(data);
-                return 1;
-            }
-
-            size_t n;
-            while ((n = fread(buf, 1, buf_size, f_temp)) > 0) {
-                if (fwrite(buf, 1, n, f_out) != n) {
-                    free(buf);
-                    fclose(f_temp);
-                    fclose(f_out);
-                    remove(data->outputFile);
-                    remove(tempFile);
-                    PostMessageA(data->hwnd, WM_WORKER_ERROR, -112, 0);
-                    free_worker_data(data);
-                    return 1;
-                }
-            }
-            free(buf);
-            fclose(f_temp);
-            fflush(f_out);
-            if (fclose(f_out) != 0) {
-                remove(data->outputFile);
-                remove(tempFile);
-                PostMessageA(data->hwnd, WM_WORKER_ERROR, -114, 0);
-                free_worker_data(data);
-                return 1;
-            }
-
-            // 모니터 스레드가 임시 파일을 참조할 수 있으므로
-            // 최종 파일로 모니터링을 전환하기 위해 잠시 대기
-            // (모니터 스레드는 파일이 없으면 자동으로 건너뜀)
-            Sleep(200);  // 모니터 스레드가 마지막 업데이트를 완료할 시간 제공
-            
-            // 임시 파일 삭제
-            remove(tempFile);
-
             // 최종 파일 존재 확인
             FILE* f_check = fopen(data->outputFile, "rb");
             if (!f_check) {
@@ -749,137 +317,17 @@ DWORD WINAPI WorkerThreadProc(LPVOID lpParam) {
                 return 1;
             }
             
-            FILE* f_in = fopen(data->inputFile, "rb");
-            if (!f_in) {
-                PostMessageA(data->hwnd, WM_WORKER_ERROR, -106, 0);
-                free_worker_data(data);
-                return 1;
-            }
-
-            // 1. IV 읽기 (16 bytes)
-            if (fread(iv, 1, 16, f_in) != 16) {
-                fclose(f_in);
-                PostMessageA(data->hwnd, WM_WORKER_ERROR, -107, 0);
-                free_worker_data(data);
-                return 1;
-            }
-
-            // 2. 암호문을 임시 파일로 추출
-            // 시스템 임시 디렉토리에 고유한 임시 파일 생성 (입력/출력 파일과 절대 겹치지 않도록)
-            char tempFile[MAX_PATH + 20];
-            char tmpDir[MAX_PATH];
-            if (GetTempPathA(MAX_PATH, tmpDir) > 0) {
-                // 고유한 파일명 생성 (프로세스 ID + 타임스탬프 사용)
-                DWORD pid = GetCurrentProcessId();
-                DWORD tick = GetTickCount();
-                char* fileName = strrchr(data->inputFile, '\\');
-                if (!fileName) fileName = strrchr(data->inputFile, '/');
-                if (!fileName) fileName = (char*)data->inputFile;
-                else fileName++;
-                // 파일명에서 확장자 제거
-                char baseName[MAX_PATH];
-                strncpy(baseName, fileName, MAX_PATH - 1);
-                baseName[MAX_PATH - 1] = '\0';
-                char* ext = strrchr(baseName, '.');
-                if (ext) *ext = '\0';
-                snprintf(tempFile, MAX_PATH, "%s%s_%lu_%lu.decrypt.tmp", tmpDir, baseName, (unsigned long)pid, (unsigned long)tick);
-            }
-            else {
-                // GetTempPathA 실패 시 입력 파일과 다른 경로 사용
-                strncpy(tempFile, data->inputFile, MAX_PATH - 1);
-                tempFile[MAX_PATH - 1] = '\0';
-                char* ext = strrchr(tempFile, '.');
-                if (ext) *ext = '\0';
-                size_t tlen = strlen(tempFile);
-                if (tlen + 15 < MAX_PATH) {
-                    strcat(tempFile, ".decrypt.tmp");
-                }
-                else {
-                    // 최후의 수단: 현재 디렉토리에 생성
-                    strncpy(tempFile, "decrypt.tmp", MAX_PATH - 1);
-                    tempFile[MAX_PATH - 1] = '\0';
-                }
-            }
-
-            // 안전 체크: 임시 파일 경로가 입력 파일이나 출력 파일과 같으면 안 됨
-            if (strcmp(tempFile, data->inputFile) == 0 || 
-                strcmp(tempFile, data->outputFile) == 0) {
-                fclose(f_in);
-                PostMessageA(data->hwnd, WM_WORKER_ERROR, -117, 0);
-                free_worker_data(data);
-                return 1;
-            }
-
-            FILE* f_temp = fopen(tempFile, "wb");
-            if (!f_temp) {
-                fclose(f_in);
-                PostMessageA(data->hwnd, WM_WORKER_ERROR, -110, 0);
-                free_worker_data(data);
-                return 1;
-            }
-
-            size_t buf_size = 1024 * 1024;                              //1MB
-            unsigned char* buf = (unsigned char*)malloc(buf_size);
-            if (!buf) {
-                fclose(f_in);
-                fclose(f_temp);
-                remove(tempFile);
-                PostMessageA(data->hwnd, WM_WORKER_ERROR, -202, 0);
-                free_worker_data(data);
-                return 1;
-            }
-
-            size_t n;
-            while ((n = fread(buf, 1, buf_size, f_in)) > 0) {
-                if (fwrite(buf, 1, n, f_temp) != n) {
-                    free(buf);
-                    fclose(f_in);
-                    fclose(f_temp);
-                    remove(tempFile);
-                    PostMessageA(data->hwnd, WM_WORKER_ERROR, -112, 0);
-                    free_worker_data(data);
-                    return 1;
-                }
-            }
-            free(buf);
-            fclose(f_in);
-            fclose(f_temp);
-
-            // 임시 파일 크기 확인 (진행률 계산용)
-            long long tempSize = GetFileSizeBytes(tempFile);
-            
-            // 진행률 모니터 스레드 시작 (복호화 출력 파일 기준)
-            if (tempSize > 0) {
-                monitor_data_t* monitorData =
-                    (monitor_data_t*)malloc(sizeof(monitor_data_t));
-                if (monitorData) {
-                    monitorData->hwnd = data->hwnd;
-                    strncpy(monitorData->outputFile, data->outputFile, MAX_PATH + 19);  // 경로 복사
-                    monitorData->outputFile[MAX_PATH + 19] = '\0';
-                    monitorData->totalSize = tempSize;
-                    monitorData->running = &g_workerRunning;
-                    monitorData->isHashMode = 0;
-
-                    HANDLE hMonitorThread =
-                        CreateThread(NULL, 0, MonitorThreadProc, monitorData, 0, NULL);
-                    if (hMonitorThread) {
-                        CloseHandle(hMonitorThread); // detach
-                    }
-                    else {
-                        free(monitorData);
-                    }
-                }
-            }
-
-            // 3. 임시 파일을 복호화
-            rc = stream_decrypt_ctr_file(engine,
-                tempFile,
+            // IV는 입력 앞 16바이트에서 읽고 나머지를 한 번에 복호화 (암호문 임시 추출 없음)
+            rc = stream_decrypt_ctr_hmac_file_ex(engine,
+                data->inputFile,
                 data->outputFile,
                 data->aes_key,
                 data->aesKeyLen,
-                iv);
-            remove(tempFile);
-
+                NULL,
+                0,
+                &streamOpt);
+            if (rc == -13) rc = -107;   // IV보다 짧음
+            else rc = stream_io_error(rc, 0, 0);
             if (rc != 0) {
                 PostMessageA(data->hwnd, WM_WORKER_ERROR, rc, 0);
                 free_worker_data(data);
@@ -895,92 +343,21 @@ DWORD WINAPI WorkerThreadProc(LPVOID lpParam) {
      * =============================================================*/
     if (data->methodIndex == 2) {
         unsigned char hash[64];
-        size_t buf_size = 1024 * 1024;  // 1MB
-        unsigned char* file_buf = (unsigned char*)malloc(buf_size);
-        if (!file_buf) {
-            PostMessageA(data->hwnd, WM_WORKER_ERROR, -202, 0);
-            free_worker_data(data);
-            return 1;
-        }
 
-        FILE* fp = fopen(data->inputFile, "rb");
-        if (!fp) {
-            free(file_buf);
-            PostMessageA(data->hwnd, WM_WORKER_ERROR, -200, 0);
+        // 스트림 API로 해시 (진행률/취소는 콜백으로 처리)
+        rc = stream_hash_sha512_file_ex(data->inputFile, hash, &streamOpt);
+        if (rc != 0) {
+            // 입력 열기 -200, 읽기 -201, 메모리 -202, 취소 -16은 그대로
+            if (rc == -2) rc = -200;
+            else if (rc == -3) rc = -202;
+            else if (rc == -4) rc = -201;
+            PostMessageA(data->hwnd, WM_WORKER_ERROR, rc, 0);
             free_worker_data(data);
             return 1;
         }
 
-        sha512_ctx_t ctx;
-        sha512_init(&ctx);
-
-        long long processed = 0;
-        long long totalSize2 = GetFileSizeBytes(data->inputFile);
-        int last_percent = -1;
-        
-        // SHA-512 모드 메모리 샘플링 초기화
-        g_memSum = 0;
-        g_memSampleCount = 0;
-        g_lastMemCheck = GetTickCount();
-
-        if (totalSize2 > 0) {
-            PostMessageA(data->hwnd, WM_WORKER_PROGRESS, 0, 0);
-            last_percent = 0;
-        }
-
-        while (1) {
-            // 500ms마다 메모리 샘플링
-            DWORD now = GetTickCount();
-            if (now - g_lastMemCheck >= 500) {
-                SIZE_T mem = GetProcessMemoryUsageKB();
-                if (mem > 0) {
-                    g_memSum += mem;
-                    g_memSampleCount++;
-                }
-                g_lastMemCheck = now;
-            }
-            
-            size_t read_bytes = fread(file_buf, 1, buf_size, fp);
-
-            if (read_bytes > 0) {
-                sha512_update(&ctx, file_buf, read_bytes);
-                processed += (long long)read_bytes;
-
-                if (totalSize2 > 0) {
-                    int percent = (int)(processed * 100 / totalSize2);
-                    if (percent > 100) percent = 100;
-                    if (percent != last_percent) {
-                        PostMessageA(data->hwnd, WM_WORKER_PROGRESS, percent, 0);
-                        last_percent = percent;
-                    }
-                }
-            }
-
-            if (read_bytes < buf_size) {
-                if (feof(fp)) {
-                    break;
-                }
-                if (ferror(fp)) {
-                    free(file_buf);
-                    fclose(fp);
-                    PostMessageA(data->hwnd, WM_WORKER_ERROR, -201, 0);
-                    free_worker_data(data);
-                    return 1;
-                }
-                if (read_bytes == 0) {
-                    break;
-                }
-            }
-        }
-
-        free(file_buf);
-        fclose(fp);
-
-        // 최종 해시 계산
-        sha512_final(&ctx, hash);
-
         // 진행률 100% 보정
-        if (totalSize2 > 0 && last_percent < 100) {
+        if (totalSize > 0 && progress.lastPercent < 100) {
             PostMessageA(data->hwnd, WM_WORKER_PROGRESS, 100, 0);
         }
 
@@ -32,6 +32,9 @@ extern "C" {
     // 작업 진행 여부 플래그 (메인/워커/모니터 스레드가 공유)
     extern volatile int g_workerRunning;
 
+    // 작업 취소 요청 플래그 (메인 스레드가 세우고 워커의 취소 콜백이 확인)
+    extern volatile int g_workerCancel;
+
     // 작업 스레드 함수 (CreateThread에서 사용)
     DWORD WINAPI WorkerThreadProc(LPVOID lpParam);
 
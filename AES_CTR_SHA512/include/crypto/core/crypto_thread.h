@@ -0,0 +1,65 @@
+﻿#pragma once
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    // 플랫폼 독립 스레드 래퍼
+    // - Windows: CreateThread / WaitForSingleObject
+    // - POSIX  : pthread_create / pthread_join
+    // 암호 모듈 내부 병렬화(PBKDF2 블록, 파이프라인 등)에서 공통으로 사용
+
+    typedef void (*crypto_thread_fn)(void* arg);
+
+    typedef struct crypto_thread_t {
+#ifdef _WIN32
+        HANDLE handle;
+#else
+        pthread_t handle;
+#endif
+        crypto_thread_fn fn;   // 실행할 함수
+        void* arg;             // fn 인자
+        int started;           // 1 = join 필요
+    } crypto_thread_t;
+
+    // 스레드 시작 (t는 join 전까지 유효해야 함). 성공 0, 실패 -1
+    int crypto_thread_start(crypto_thread_t* t, crypto_thread_fn fn, void* arg);
+
+    // 스레드 종료 대기 (시작되지 않은 t는 무시)
+    void crypto_thread_join(crypto_thread_t* t);
+
+    // 사용 가능한 논리 CPU 수 (최소 1)
+    unsigned int crypto_cpu_count(void);
+
+    // 스레드 간 공유 카운터/플래그 (lock-free 링, 중단 플래그 등)
+    // - load는 acquire, store는 release 순서를 보장
+    // - Windows: Interlocked*, 그 외: GCC/Clang __atomic 내장 함수
+    typedef volatile long crypto_atomic_t;
+
+    long crypto_atomic_load(const crypto_atomic_t* p);
+    void crypto_atomic_store(crypto_atomic_t* p, long v);
+
+    // *p == expected 이면 desired로 바꾸고 1, 아니면 0 (전체 메모리 순서)
+    int crypto_atomic_cas(crypto_atomic_t* p, long expected, long desired);
+
+    // 단조 증가 시각 (나노초). 구간 측정용
+    uint64_t crypto_now_ns(void);
+
+    // 대기 루프용 양보/휴면
+    void crypto_thread_yield(void);
+    void crypto_thread_sleep_ms(unsigned int ms);
+
+#ifdef __cplusplus
+}
+#endif
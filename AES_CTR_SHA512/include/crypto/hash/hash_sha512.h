@@ -16,6 +16,14 @@ extern "C" {
 // 스트림 처리용 기본 버퍼 크기
 #define BUF_SIZE 4096
 
+// 다중 레인 압축에서 한 번에 처리하는 최대 독립 메시지 수
+#define SHA512_MAX_LANES       4
+
+// 직렬화된 중간 상태(midstate) 포맷
+//  magic "S512"(4) | version(4) | 처리 바이트 수(8) | H[0..7](64) | buffer_len(4) | 예약(4) | buffer(128)
+#define SHA512_STATE_VERSION   1
+#define SHA512_STATE_BYTES     (4 + 4 + 8 + 8 * SHA_WORD_NUMBER + 4 + 4 + SHA512_BLOCK_SIZE)
+
     // SHA-512 컨텍스트
     // - 64바이트의 출력 값을 만들기 위한 중간 상태를 버퍼에 저장
     // - 1024비트(128바이트)의 블록 단위로 처리
@@ -42,6 +50,36 @@ extern "C" {
     void sha512_final(sha512_ctx_t* ctx,
         unsigned char digest[64]);
 
+    // 블록 하나를 압축해 체이닝 값 H를 갱신 (패딩/길이 처리 없음)
+    // - HMAC 미드스테이트, PBKDF2처럼 블록을 직접 구성하는 상위 모듈용
+    void sha512_compress_block(uint64_t H[SHA_WORD_NUMBER],
+        const unsigned char block[SHA512_BLOCK_SIZE]);
+
+    // 서로 독립인 lanes개(<= SHA512_MAX_LANES)의 상태를 라운드 단위로 엮어서 한 블록씩 압축
+    // - 레인 간 의존성이 없어 CPU의 명령 수준 병렬성/자동 벡터화를 활용
+    // - 짧은 메시지 여러 개를 동시에 해시하는 배치 HMAC 등에서 사용
+    void sha512_compress_lanes(uint64_t* const H[],
+        const unsigned char* const blocks[],
+        size_t lanes);
+
+    // 미리 계산된 체이닝 값에서 시작 (bytes_processed는 블록 크기의 배수여야 함)
+    void sha512_init_midstate(sha512_ctx_t* ctx,
+        const uint64_t H[SHA_WORD_NUMBER],
+        uint64_t bytes_processed);
+
+    // 지금까지 입력된 바이트 수 (2^61 바이트 미만 가정)
+    uint64_t sha512_bytes_processed(const sha512_ctx_t* ctx);
+
+    // 중간 상태 내보내기/가져오기:
+    // - 파일 해시를 중단했다가 이어서 계산하거나, append-only 로그의 꼬리만 추가 해시할 때 사용
+    // - 모든 정수는 big-endian으로 저장되어 플랫폼 간 호환
+    // - 반환: CRYPTO_OK / CRYPTO_ERR_NULL / CRYPTO_ERR_INVALID(포맷·버전·길이 불일치)
+    int sha512_export_state(const sha512_ctx_t* ctx,
+        unsigned char out[SHA512_STATE_BYTES]);
+
+    int sha512_import_state(sha512_ctx_t* ctx,
+        const unsigned char in[SHA512_STATE_BYTES]);
+
 #ifdef __cplusplus
 }
 #endif
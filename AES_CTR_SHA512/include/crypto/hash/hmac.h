@@ -25,13 +25,39 @@ extern "C" {
     * HMAC — Message Authentication Code (HMAC-SHA-512)
     * ========================================================================================= */
 
+    /* 직렬화된 HMAC 중간 상태 크기
+        magic "H512"(4) | version(4) | 키 확인값(8) | 내부 SHA-512 상태(SHA512_STATE_BYTES)
+        - 키 자체는 저장하지 않으므로 가져올 때 같은 키를 다시 넘겨야 한다
+        - version 2: 키 확인값을 (K ⊕ opad) 미드스테이트에서 계산 (version 1 상태는 거부) */
+#define HMAC_STATE_VERSION      2
+#define HMAC_KEY_CHECK_BYTES    8
+#define HMAC_STATE_BYTES        (4 + 4 + HMAC_KEY_CHECK_BYTES + SHA512_STATE_BYTES)
+
+    /* 미리 계산된 HMAC 키
+        - (K ⊕ ipad), (K ⊕ opad) 블록을 각각 한 번씩 압축한 SHA-512 체이닝 값
+        - 같은 키로 여러 메시지를 MAC할 때 키 블록 압축 2회를 매번 반복하지 않도록 재사용 */
+    typedef struct {
+        uint64_t inner[SHA_WORD_NUMBER];     /* (K ⊕ ipad) 처리 후 상태 */
+        uint64_t outer[SHA_WORD_NUMBER];     /* (K ⊕ opad) 처리 후 상태 */
+    } hmac_key_t;
+
     /* HMAC-SHA-512 컨텍스트 구조체 */
     typedef struct {
         sha512_ctx_t ctx;                    /* 내부 SHA-512 연산 상태 저장 */
-        uint8_t      key[SHA512_BLOCK_SIZE]; /* 블록 크기(128바이트)로 확장된 키 */
+        uint64_t     outer[SHA_WORD_NUMBER]; /* 외부 해시 시작 상태 (K ⊕ opad 처리 후) */
     } hmac_ctx;
 
+    /* 키 전처리: 긴 키는 SHA-512로 해시, 짧은 키는 0 패딩 후 ipad/opad 미드스테이트 계산 */
+    void hmac_key_init(OUT hmac_key_t* k, IN const uint8_t* key, IN size_t key_len);
+
+    /* 미리 계산된 키로 새 메시지 MAC 시작 (압축 연산 없음) */
+    void hmac_start_from_key(OUT hmac_ctx* c, IN const hmac_key_t* k);
+
+    /* 키 미드스테이트 지우기 */
+    void hmac_key_clear(INOUT hmac_key_t* k);
+
     /* HMAC 초기화 함수
+        - hmac_key_init + hmac_start_from_key 와 동일
         - 긴 키는 SHA-512로 해시하여 사용
         - 짧은 키는 블록 크기까지 0으로 패딩 */
     void hmac_init(OUT hmac_ctx* c, IN const uint8_t* key, IN size_t key_len);
@@ -41,9 +67,50 @@ extern "C" {
     void hmac_update(INOUT hmac_ctx* c, IN const void* data, IN size_t len);
 
     /* HMAC 계산 종료
-        - 최종 MAC(64바이트)을 mac 버퍼에 저장 */
+        - 최종 MAC(64바이트)을 mac 버퍼에 저장
+        - 외부 해시는 미리 계산된 opad 상태에서 시작하므로 압축 1회만 추가 */
     void hmac_final(INOUT hmac_ctx* c, OUT uint8_t mac[SHA512_DIGEST_LENGTH]);
 
+    /* 한 번에 HMAC-SHA-512 계산 (init + update + final) */
+    void hmac_sha512(IN const uint8_t* key,
+        IN size_t key_len,
+        IN const void* data,
+        IN size_t len,
+        OUT uint8_t mac[SHA512_DIGEST_LENGTH]);
+
+    /* 배치 HMAC-SHA-512
+        - 레코드 n개를 같은 키로 MAC: 키 전처리는 한 번만 수행하고
+          SHA-512 다중 레인 압축으로 최대 SHA512_MAX_LANES개 레코드를 동시에 처리
+        - msgs[i]는 lens[i]가 0이면 NULL이어도 된다
+        - tags[i]에 64바이트 MAC 저장
+        - 반환: CRYPTO_OK / CRYPTO_ERR_NULL */
+    int hmac_sha512_batch(IN const uint8_t* key,
+        IN size_t key_len,
+        IN const uint8_t* const msgs[],
+        IN const size_t lens[],
+        OUT uint8_t tags[][SHA512_DIGEST_LENGTH],
+        IN size_t n);
+
+    /* 미리 계산된 키로 배치 MAC (키를 여러 배치에 걸쳐 재사용할 때) */
+    int hmac_sha512_batch_with_key(IN const hmac_key_t* k,
+        IN const uint8_t* const msgs[],
+        IN const size_t lens[],
+        OUT uint8_t tags[][SHA512_DIGEST_LENGTH],
+        IN size_t n);
+
+    /* HMAC 중간 상태 내보내기
+        - 내부 해시 상태와 키 확인값만 기록 (키 원문은 기록하지 않음)
+        - 반환: CRYPTO_OK / CRYPTO_ERR_NULL / CRYPTO_ERR_STATE */
+    int hmac_export_state(IN const hmac_ctx* c, OUT uint8_t out[HMAC_STATE_BYTES]);
+
+    /* HMAC 중간 상태 가져오기
+        - key로 컨텍스트를 다시 초기화한 뒤 내부 해시 상태를 복원
+        - 키 확인값이 다르면 CRYPTO_ERR_KEY, 포맷 불일치면 CRYPTO_ERR_INVALID */
+    int hmac_import_state(OUT hmac_ctx* c,
+        IN const uint8_t* key,
+        IN size_t key_len,
+        IN const uint8_t in[HMAC_STATE_BYTES]);
+
     /* HMAC-SHA-512 계산 후 결과를 바로 출력하는 함수 */
     void hmac_print(void);
 
@@ -0,0 +1,62 @@
+﻿#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "crypto/hash/hmac.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// PRK 크기 = HMAC-SHA512 출력 크기
+#ifndef HKDF_SHA512_PRK_BYTES
+#define HKDF_SHA512_PRK_BYTES 64
+#endif
+
+// Expand 최대 출력 길이: 255 * HashLen (RFC 5869)
+#ifndef HKDF_SHA512_MAX_OKM_BYTES
+#define HKDF_SHA512_MAX_OKM_BYTES (255 * HKDF_SHA512_PRK_BYTES)
+#endif
+
+    // HKDF-SHA512 (RFC 5869)
+    // - Extract: PRK = HMAC(salt, IKM)  (salt가 없으면 0x00 * 64)
+    // - Expand : T(i) = HMAC(PRK, T(i-1) || info || i)
+    // - 반환: CRYPTO_OK / CRYPTO_ERR_NULL / CRYPTO_ERR_INVALID
+
+    int hkdf_sha512_extract(const uint8_t* salt, size_t salt_len,
+        const uint8_t* ikm, size_t ikm_len,
+        uint8_t prk[HKDF_SHA512_PRK_BYTES]);
+
+    int hkdf_sha512_expand(const uint8_t prk[HKDF_SHA512_PRK_BYTES],
+        const uint8_t* info, size_t info_len,
+        uint8_t* okm, size_t okm_len);
+
+    int hkdf_sha512(const uint8_t* salt, size_t salt_len,
+        const uint8_t* ikm, size_t ikm_len,
+        const uint8_t* info, size_t info_len,
+        uint8_t* okm, size_t okm_len);
+
+    // PRK를 HMAC 키 미드스테이트로 캐시한 컨텍스트
+    // - 한 마스터 키에서 파일마다 다른 info로 여러 번 Expand할 때
+    //   Extract와 PRK 키 전처리를 반복하지 않도록 재사용
+    typedef struct hkdf_ctx_t {
+        hmac_key_t prk_key;   // HMAC(PRK, ·)의 ipad/opad 미드스테이트
+    } hkdf_ctx_t;
+
+    int hkdf_ctx_init(hkdf_ctx_t* ctx,
+        const uint8_t* salt, size_t salt_len,
+        const uint8_t* ikm, size_t ikm_len);
+
+    // 이미 추출된 PRK로 초기화
+    int hkdf_ctx_init_prk(hkdf_ctx_t* ctx, const uint8_t prk[HKDF_SHA512_PRK_BYTES]);
+
+    int hkdf_ctx_expand(const hkdf_ctx_t* ctx,
+        const uint8_t* info, size_t info_len,
+        uint8_t* okm, size_t okm_len);
+
+    void hkdf_ctx_clear(hkdf_ctx_t* ctx);
+
+#ifdef __cplusplus
+}
+#endif
@@ -3,6 +3,8 @@
 #include <stdint.h>
 #include <stddef.h>
 
+#include "crypto/key/hkdf.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -13,15 +15,35 @@ extern "C" {
 
 #ifndef KC_MAX_ENC_KEY_BYTES
 #define KC_MAX_ENC_KEY_BYTES 32
+#endif
+
+// 파일별 파생 HMAC 키 길이 (1024비트, GUI 권장 길이와 동일)
+#ifndef KC_FILE_HMAC_KEY_BYTES
+#define KC_FILE_HMAC_KEY_BYTES 128
+#endif
+
+#ifndef KC_FILE_IV_BYTES
+#define KC_FILE_IV_BYTES 16
 #endif
 
     // 최대 256비트 키까지 관리하는 간단한 키 컨텍스트
+    // - master_key가 정해지면 HKDF-Extract 결과(PRK)를 HMAC 미드스테이트로 캐시해 두고
+    //   이후 파생은 Expand만 수행한다.
     typedef struct key_context_t {
         unsigned char master_key[KC_MASTER_KEY_BYTES];  // 256-bit
         unsigned char enc_key[KC_MAX_ENC_KEY_BYTES];    // 파생된 키
         unsigned int  enc_key_len;     // enc_key 길이(바이트)
+        hkdf_ctx_t    kdf;             // master_key에서 추출한 PRK 캐시
     } key_context_t;
 
+    // 파일 하나에 쓰는 키 묶음 (AES 키 + HMAC 키 + IV)
+    typedef struct key_file_keys_t {
+        unsigned char aes_key[KC_MAX_ENC_KEY_BYTES];
+        unsigned int  aes_key_len;
+        unsigned char hmac_key[KC_FILE_HMAC_KEY_BYTES];
+        unsigned char iv[KC_FILE_IV_BYTES];
+    } key_file_keys_t;
+
     // 랜덤 master_key 생성
     void key_context_init_random(key_context_t* kc);
 
@@ -30,10 +52,50 @@ extern "C" {
         const unsigned char* seed,
         unsigned int seed_len);
 
-    // master_key에서 enc_key 파생
+    // 패스프레이즈 기반 master_key 생성 (PBKDF2-HMAC-SHA512)
+    // - iterations == 0 이면 PBKDF2_SHA512_DEFAULT_ITERATIONS
+    // - 반환: CRYPTO_OK 또는 crypto_status_t 오류 코드
+    int key_context_init_passphrase(key_context_t* kc,
+        const unsigned char* pass,
+        size_t pass_len,
+        const unsigned char* salt,
+        size_t salt_len,
+        uint32_t iterations);
+
+    // enc_key 파생 방식 버전
+    // - V1: master_key 앞부분을 그대로 잘라 씀 (이전 빌드와 같은 결과, 기존 암호문 복호화용)
+    // - V2: HKDF-SHA512 Expand (기본값). V1과 호환되지 않으므로 V1로 만든 암호문은 V1로 풀어야 한다.
+#define KC_DERIVE_V1        1
+#define KC_DERIVE_V2        2
+#define KC_DERIVE_VERSION   KC_DERIVE_V2
+
+    // master_key에서 지정한 버전으로 enc_key 파생
+    // key_len_bytes: 16(128) / 24(192) / 32(256)
+    // - 반환: CRYPTO_OK 또는 CRYPTO_ERR_NULL / CRYPTO_ERR_INVALID (알 수 없는 버전)
+    int key_context_derive_ex(key_context_t* kc, unsigned int key_len_bytes, int version);
+
+    // master_key에서 enc_key 파생 (KC_DERIVE_VERSION = V2, HKDF-SHA512 Expand)
     // key_len_bytes: 16(128) / 24(192) / 32(256)
     void key_context_derive(key_context_t* kc, unsigned int key_len_bytes);
 
+    // file_id마다 고유한 AES 키 + HMAC 키 + IV 파생
+    // - 캐시된 PRK로 Expand 한 번(짧은 file_id면 압축 6회 내외)만 수행
+    // - 같은 master_key + file_id + aes_key_len이면 항상 같은 결과 (IV도 같다)
+    // - 따라서 file_id는 파일마다가 아니라 "암호화할 때마다" 고유해야 한다. 경로처럼 다시
+    //   암호화해도 그대로인 값을 쓰면 수정된 내용이 같은 키/IV로 암호화된다 (CTR 키스트림 재사용).
+    //   암호화마다 새 무작위 nonce(16바이트 이상)나 증가하는 버전 번호를 file_id에 넣고,
+    //   복호화할 때 다시 파생할 수 있도록 그 값을 출력 헤더에 평문으로 저장할 것
+    //   (예외: stream_dedup은 내용 지문을 file_id로 써서 같은 내용에만 같은 키가 나온다)
+    // - 반환: CRYPTO_OK 또는 crypto_status_t 오류 코드
+    int key_context_derive_file(const key_context_t* kc,
+        const unsigned char* file_id,
+        size_t file_id_len,
+        unsigned int aes_key_len,
+        key_file_keys_t* out);
+
+    // master_key를 직접 채운 경우 PRK 캐시를 다시 계산
+    void key_context_refresh(key_context_t* kc);
+
     // 메모리 지우기
     void key_context_clear(key_context_t* kc);
 
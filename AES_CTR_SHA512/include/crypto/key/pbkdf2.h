@@ -0,0 +1,39 @@
+﻿#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 한 출력 블록 크기 = HMAC-SHA512 출력 크기
+#ifndef PBKDF2_SHA512_BLOCK_BYTES
+#define PBKDF2_SHA512_BLOCK_BYTES 64
+#endif
+
+// 패스프레이즈 파생 기본 반복 횟수
+#ifndef PBKDF2_SHA512_DEFAULT_ITERATIONS
+#define PBKDF2_SHA512_DEFAULT_ITERATIONS 210000u
+#endif
+
+    // PBKDF2-HMAC-SHA512 (RFC 8018)
+    // - 패스프레이즈의 ipad/opad 미드스테이트를 한 번만 계산하고,
+    //   반복마다 내부/외부 해시 각각 압축 1회(총 2회)만 수행
+    // - 출력 블록 T_1..T_n은 서로 독립이므로 여러 블록이면 스레드로 나눠 계산
+    // - 반환: CRYPTO_OK / CRYPTO_ERR_NULL / CRYPTO_ERR_INVALID / CRYPTO_ERR_MEMORY
+    int pbkdf2_hmac_sha512(const uint8_t* pass, size_t pass_len,
+        const uint8_t* salt, size_t salt_len,
+        uint32_t iterations,
+        uint8_t* out, size_t out_len);
+
+    // 스레드 수 지정 버전 (max_threads == 0 이면 CPU 수, 1 이면 단일 스레드)
+    int pbkdf2_hmac_sha512_ex(const uint8_t* pass, size_t pass_len,
+        const uint8_t* salt, size_t salt_len,
+        uint32_t iterations,
+        uint8_t* out, size_t out_len,
+        unsigned int max_threads);
+
+#ifdef __cplusplus
+}
+#endif
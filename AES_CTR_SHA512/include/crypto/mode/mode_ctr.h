@@ -1,4 +1,5 @@
 ﻿#pragma once
+#include <stdint.h>
 #include "crypto/core/blockcipher.h"
 
 #ifndef CTR_BLOCK_BYTES
@@ -15,7 +16,9 @@ extern "C" {
 
     typedef struct ctr_mode_ctx_t {
         blockcipher_t* bc;          // 블록암호 엔진
-        unsigned char counter[CTR_BLOCK_BYTES]; // 현재 카운터 블록
+        unsigned char counter[CTR_BLOCK_BYTES]; // 다음 keystream을 만들 카운터 블록
+        unsigned char keystream[CTR_BLOCK_BYTES]; // 마지막으로 만든 keystream 블록
+        int ks_pos;                 // keystream에서 다음에 쓸 위치 (CTR_BLOCK_BYTES면 남은 것 없음)
     } ctr_mode_ctx_t;
 
     // CTR 초기화: iv는 반드시 CTR_BLOCK_BYTES(블록 크기)
@@ -25,11 +28,20 @@ extern "C" {
         const unsigned char iv[CTR_BLOCK_BYTES]);
 
     // CTR update: in/out 버퍼가 같아도 동작(XOR 기반)
+    // - 블록 단위로 끊기지 않은 길이로 여러 번 나눠 호출해도 한 번에 처리한 결과와 같다
+    //   (남은 keystream을 다음 호출에서 이어서 사용)
     void ctr_mode_update(ctr_mode_ctx_t* ctx,
         const unsigned char* in,
         unsigned char* out,
         int len);
 
+    // 카운터를 iv + block_index 로 설정 (128비트 big-endian 덧셈, 남은 keystream은 버림)
+    // - 파일의 임의 위치(block_index * 16 바이트)부터 암/복호화할 때 사용
+    // - 같은 키로 다른 IV를 처리할 때 블록암호 키 스케줄을 재사용 (block_index = 0)
+    void ctr_mode_seek(ctr_mode_ctx_t* ctx,
+        const unsigned char iv[CTR_BLOCK_BYTES],
+        uint64_t block_index);
+
     // 해제
     void ctr_mode_free(ctr_mode_ctx_t* ctx);
 
@@ -14,7 +14,8 @@ extern "C" {
         CRYPTO_ERR_KEY = -3,    // 잘못된 키 또는 길이
         CRYPTO_ERR_INVALID = -4,// 잘못된 입력 인자
         CRYPTO_ERR_MEMORY = -5, // 메모리 할당 실패
-        CRYPTO_ERR_STATE = -6   // 잘못된 상태
+        CRYPTO_ERR_STATE = -6,  // 잘못된 상태
+        CRYPTO_ERR_AUTH = -7    // 인증(MAC) 검증 실패
     } crypto_status_t;
 
 #ifdef __cplusplus
@@ -0,0 +1,145 @@
+﻿#pragma once   // 헤더 중복 include 방지
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "crypto/core/blockcipher.h"
+#include "crypto/mode/mode_ctr.h"
+#include "crypto/hash/hash_sha512.h"
+#include "crypto/hash/hmac.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    // 푸시 방식 스트림 객체
+    //  - 파일 경로 대신 임의의 조각(소켓, 파이프, 압축기, 메모리 버퍼)을 update로 밀어 넣는다
+    //  - 조각 길이는 자유 (CTR 남은 keystream과 SHA-512 블록 버퍼가 경계를 이어 줌)
+    //  - CTR+HMAC 형식은 GUI와 같은 IV(16) || CT || HMAC(64), MAC 대상은 IV || CT
+    //      encrypt = 1: update 출력(암호문)을 MAC
+    //      encrypt = 0: update 입력(암호문)을 MAC (태그 검증은 호출 측이 final 결과로 비교)
+    //  - 반환 규약: crypto_status_t
+
+    typedef enum crypto_stream_kind_t {
+        CRYPTO_STREAM_CTR = 1,
+        CRYPTO_STREAM_CTR_HMAC = 2,
+        CRYPTO_STREAM_SHA512 = 3,
+        CRYPTO_STREAM_HMAC = 4,
+        CRYPTO_STREAM_CTR_HMAC_OPEN = 5
+    } crypto_stream_kind_t;
+
+    typedef struct crypto_stream_t {
+        int kind;               // crypto_stream_kind_t
+        int encrypt;            // CTR_HMAC 방향
+        int finished;           // final 이후 1
+        ctr_mode_ctx_t* ctr;    // CTR / CTR_HMAC
+        sha512_ctx_t sha;       // SHA512
+        hmac_ctx hmac;          // HMAC / CTR_HMAC
+        uint64_t total;         // 지금까지 처리한 입력 바이트
+
+        // CTR_HMAC_OPEN: 앞 16바이트(IV)와 뒤 tag_len바이트(태그 후보)는 보류
+        unsigned char iv[CTR_BLOCK_BYTES];
+        size_t iv_len;          // 지금까지 모은 IV 바이트
+        unsigned char tail[SHA512_DIGEST_LENGTH];
+        size_t tail_len;        // 지금까지 본 마지막 바이트 (최대 tag_len)
+        size_t tag_len;         // 64 (HMAC) 또는 0 (IV || CT만)
+    } crypto_stream_t;
+
+    // 생성 (실패 시 NULL). 키는 복사되지 않으며 키 스케줄/미드스테이트만 보관
+    crypto_stream_t* crypto_stream_ctr_new(const blockcipher_vtable_t* engine,
+        const unsigned char* key,
+        int key_len,
+        const unsigned char iv[CTR_BLOCK_BYTES]);
+
+    crypto_stream_t* crypto_stream_ctr_hmac_new(const blockcipher_vtable_t* engine,
+        const unsigned char* key,
+        int key_len,
+        const unsigned char iv[CTR_BLOCK_BYTES],
+        const unsigned char* hmac_key,
+        size_t hmac_key_len,
+        int encrypt);
+
+    crypto_stream_t* crypto_stream_sha512_new(void);
+
+    crypto_stream_t* crypto_stream_hmac_new(const unsigned char* key, size_t key_len);
+
+    // in[0..len-1] 처리
+    //  - CTR / CTR_HMAC: out에 같은 길이로 출력 (in == out 허용, out 필수)
+    //  - SHA512 / HMAC : out 무시 (NULL 가능)
+    int crypto_stream_update(crypto_stream_t* s,
+        const unsigned char* in,
+        size_t len,
+        unsigned char* out);
+
+    // 마무리
+    //  - SHA512 / HMAC / CTR_HMAC: tag[64]에 다이제스트/MAC 기록
+    //  - CTR: tag 무시 (NULL 가능)
+    //  - 이후 update/final은 CRYPTO_ERR_STATE
+    int crypto_stream_final(crypto_stream_t* s, unsigned char tag[SHA512_DIGEST_LENGTH]);
+
+    // 내부 상태를 지우고 해제
+    void crypto_stream_free(crypto_stream_t* s);
+
+    // -----------------------------------------------------------------
+    // IV(16) || CT || HMAC(64) 를 앞에서부터 한 번만 읽으며 검증/복호화 (열기)
+    //  - 전체 길이를 몰라도 되므로 파이프/표준 입력/소켓에서 바로 처리 가능
+    //  - 마지막 64바이트는 태그일 수 있으므로 다음 입력이 올 때까지 보류 (lookbehind)
+    //  - IV는 입력 앞 16바이트에서 읽는다
+    //  - hmac_key가 NULL이면 IV || CT 형식 (태그 없음, 검증 없음)
+    //  - 내보낸 평문은 open_final이 CRYPTO_OK를 돌려줄 때까지 인증되지 않은 데이터.
+    //    호출 측은 final 전까지 평문을 확정하지 말 것 (파일은 stream_decrypt_ctr_hmac_file_ex 참고)
+    // -----------------------------------------------------------------
+    crypto_stream_t* crypto_stream_ctr_hmac_open_new(const blockcipher_vtable_t* engine,
+        const unsigned char* key,
+        int key_len,
+        const unsigned char* hmac_key,
+        size_t hmac_key_len);
+
+    // in[0..len-1]을 밀어 넣고, 태그가 아님이 확정된 만큼 복호화해 out에 기록
+    //  - 기록량은 len을 넘지 않음 (보류분 + 새 입력 - 태그 길이), out은 in과 겹치면 안 됨
+    //  - *out_len: 이번에 기록한 평문 길이 (0일 수 있음)
+    int crypto_stream_open_update(crypto_stream_t* s,
+        const unsigned char* in,
+        size_t len,
+        unsigned char* out,
+        size_t* out_len);
+
+    // 입력 끝: 보류한 태그를 검증
+    // 반환: CRYPTO_OK, CRYPTO_ERR_AUTH(태그 불일치), CRYPTO_ERR_INVALID(IV + 태그보다 짧음)
+    int crypto_stream_open_final(crypto_stream_t* s);
+
+    // -----------------------------------------------------------------
+    // 콜백 연결: read → update → write 를 입력이 끝날 때까지 반복 (final은 호출하지 않음)
+    // -----------------------------------------------------------------
+
+    // 최대 cap 바이트를 buf에 채운다. 반환: 읽은 바이트 수, 0 = 끝, 음수 = 오류
+    typedef long long (*crypto_stream_read_fn)(void* ctx, unsigned char* buf, size_t cap);
+
+    // buf[0..len-1]을 모두 기록. 반환: 0 성공, 그 외 오류
+    typedef int (*crypto_stream_write_fn)(void* ctx, const unsigned char* buf, size_t len);
+
+    // write_fn은 해시 계열이면 NULL 가능. buf_size 0이면 64KB
+    // 반환: CRYPTO_OK, CRYPTO_ERR_IO(읽기/쓰기 콜백 실패), CRYPTO_ERR_MEMORY 등
+    int crypto_stream_pump(crypto_stream_t* s,
+        crypto_stream_read_fn read_fn,
+        void* read_ctx,
+        crypto_stream_write_fn write_fn,
+        void* write_ctx,
+        size_t buf_size);
+
+    // crypto_stream_open_update를 입력 끝까지 반복한 뒤 crypto_stream_open_final 결과를 반환
+    //  - write_fn은 인증 전 평문을 받으므로, 실패 시 받은 내용을 버려야 한다
+    int crypto_stream_open_pump(crypto_stream_t* s,
+        crypto_stream_read_fn read_fn,
+        void* read_ctx,
+        crypto_stream_write_fn write_fn,
+        void* write_ctx,
+        size_t buf_size);
+
+    // FILE* 어댑터 (ctx = FILE*)
+    long long crypto_stream_file_read(void* ctx, unsigned char* buf, size_t cap);
+    int crypto_stream_file_write(void* ctx, const unsigned char* buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -36,6 +36,224 @@ extern "C" {
         size_t key_len,
         unsigned char out_mac[64]);
 
+    // ---------------------------------------------------------------
+    // 스트림 옵션 (_ex 함수용, NULL이면 기본값)
+    //  - io_mode
+    //      STREAM_IO_STDIO: fread/fwrite + 힙 버퍼 (기본)
+    //      STREAM_IO_MMAP : 입력을 읽기 전용으로 매핑(순차 접근 힌트),
+    //                       CTR 출력은 파일 크기만큼 미리 할당해 매핑하고
+    //                       암호문을 출력 매핑에 바로 기록 (중간 버퍼 없음).
+    //                       매핑할 수 없는 입력(크기 초과, 특수 파일 등)은
+    //                       자동으로 STREAM_IO_STDIO 경로로 처리
+    //      STREAM_IO_PIPELINE: 읽기/연산/쓰기 스레드를 분리한 파이프라인
+    //                       (stream_pipeline.h). 디스크와 암호 연산이 겹쳐
+    //                       처리량이 둘 중 느린 쪽에 가까워진다.
+    //                       CTR은 threads개 연산 스레드, 해시는 연산 1개
+    //      STREAM_IO_URING: Linux io_uring으로 읽기/쓰기를 queue_depth개씩
+    //                       동시에 걸어 두고 한 번의 시스템 콜로 제출/수확
+    //                       (stream_uring.h). 커널/빌드가 지원하지 않거나
+    //                       버퍼 하나보다 작은 파일은 STREAM_IO_STDIO로 처리
+    //      STREAM_IO_DIRECT: 페이지 캐시를 거치지 않는 I/O (O_DIRECT /
+    //                       FILE_FLAG_NO_BUFFERING, stream_direct.h). 페이지 정렬
+    //                       버퍼와 정렬된 I/O 길이를 쓰고 마지막 조각은 0으로
+    //                       채워 기록한 뒤 실제 길이로 자른다. 수 GB 파일을 처리해도
+    //                       다른 프로세스의 캐시를 밀어내지 않는다.
+    //  - threads: 파이프라인 연산 스레드 수 (0이면 CPU 수 - 2, 최소 1)
+    //  - queue_depth: io_uring 동시 요청(버퍼) 수 (0이면 STREAM_URING_DEFAULT_DEPTH)
+    //  - buf_size: 버퍼 크기 (0이면 STREAM_DEFAULT_BUF_SIZE, 16바이트 배수로 올림,
+    //              최대 STREAM_MAX_BUF). 파일보다 큰 버퍼는 잡지 않는다.
+    //              adaptive면 키울 수 있는 최대 크기 (0이면 STREAM_ADAPTIVE_MAX_BUF)
+    //  - buf_count: 파이프라인 버퍼 개수 (0이면 연산 스레드 수 * 2 + 2)
+    //  - alignment: 파이프라인/직접 I/O 버퍼 정렬 (0이면 4096, 2의 거듭제곱)
+    //  - adaptive: 1이면 stdio 경로에서 STREAM_ADAPTIVE_MIN_BUF로 시작해
+    //              측정한 (읽기 + 연산) 처리량이 좋아지는 동안 버퍼를 두 배씩 키움
+    //  - progress / cancel / user: 버퍼 하나를 처리할 때마다 호출되는 콜백 (NULL 가능)
+    //      progress(user, done, total): 처리한 입력 바이트 / 전체 크기 (모르면 0)
+    //      cancel(user): 0 이외를 반환하면 그 버퍼까지 처리하고 -16으로 중단.
+    //                    출력 파일 정리는 호출 측 몫 (IV||CT||HMAC 경로는 자동 삭제)
+    //      파이프라인 모드에서는 쓰기(해시는 연산) 스레드에서 입력 순서대로 호출된다.
+    //      콜백이 없으면 확인 비용도 없음 (포인터 비교 1회)
+    //  - compress: 1이면 청크 컨테이너(stream_chunked.h)와 아카이브(stream_archive.h)를
+    //              청크별 LZ 압축으로 만든다. 그 밖의 _ex 함수는 compress가 켜져 있으면 -1.
+    //              압축된 청크 길이는 암호화되지 않으므로 평문이 얼마나 잘 압축되는지가
+    //              드러난다 (CRIME/BREACH류). 비밀과 공격자가 고른 데이터를 한 파일에 섞는
+    //              경우에는 켜지 않는다.
+    // ---------------------------------------------------------------
+#define STREAM_DEFAULT_BUF_SIZE  (1u << 20)
+#define STREAM_ADAPTIVE_MIN_BUF  (64u * 1024)
+#define STREAM_ADAPTIVE_MAX_BUF  (8u << 20)
+#define STREAM_MAX_BUF           (256u << 20)
+
+    // 작은 파일 빠른 경로 (CTR / IV||CT||HMAC 암호화, 복호화)
+    //  - 본문(IV, 태그 제외)이 STREAM_SMALL_FILE_MAX 이하이고 버퍼 하나에 들어가면
+    //    io_mode와 관계없이 파일을 통째로 읽어 메모리에서 처리하고 fwrite 한 번으로 기록
+    //  - 복호화는 태그를 먼저 확인하므로 인증 실패 시 평문을 한 바이트도 쓰지 않는다
+    //  - 진행률은 한 번 (done == total) 알린다
+#define STREAM_SMALL_FILE_MAX    (64u * 1024)
+
+    typedef enum stream_io_mode_t {
+        STREAM_IO_STDIO = 0,
+        STREAM_IO_MMAP = 1,
+        STREAM_IO_PIPELINE = 2,
+        STREAM_IO_URING = 3,
+        STREAM_IO_DIRECT = 4
+    } stream_io_mode_t;
+
+    typedef void (*stream_progress_fn)(void* user, uint64_t done, uint64_t total);
+    typedef int (*stream_cancel_fn)(void* user);
+
+    typedef struct stream_options_t {
+        int io_mode;                // stream_io_mode_t
+        unsigned int threads;       // STREAM_IO_PIPELINE 연산 스레드 수
+        unsigned int queue_depth;   // STREAM_IO_URING 동시 요청 수
+        size_t buf_size;            // 버퍼 크기 (적응 모드면 최대 크기)
+        size_t buf_count;           // 파이프라인 버퍼 개수
+        size_t alignment;           // 버퍼 정렬
+        int adaptive;               // 1 = 버퍼 크기 자동 조정
+        stream_progress_fn progress;// 진행률 콜백
+        stream_cancel_fn cancel;    // 취소 확인 콜백
+        void* user;                 // 콜백 인자
+        int compress;               // 1 = 청크별 LZ 압축 (청크 컨테이너/아카이브 전용, 길이 노출 주의)
+    } stream_options_t;
+
+    // 기본값으로 초기화 (STREAM_IO_STDIO, 1MB 고정 버퍼)
+    void stream_options_init(stream_options_t* opt);
+
+    // 옵션과 파일 크기(모르면 -1)로 정한 (시작) 버퍼 크기
+    // - 응용에서 직접 파일을 복사/해시할 때도 같은 규칙으로 버퍼를 잡도록 공개
+    size_t stream_effective_buf_size(const stream_options_t* opt, long long file_size);
+
+    int stream_encrypt_ctr_file_ex(const blockcipher_vtable_t* engine,
+        const char* in_path,
+        const char* out_path,
+        const unsigned char* key,
+        int key_len,
+        const unsigned char iv[CTR_BLOCK_BYTES],
+        const stream_options_t* opt);
+
+    int stream_decrypt_ctr_file_ex(const blockcipher_vtable_t* engine,
+        const char* in_path,
+        const char* out_path,
+        const unsigned char* key,
+        int key_len,
+        const unsigned char iv[CTR_BLOCK_BYTES],
+        const stream_options_t* opt);
+
+    // 한 번의 읽기로 IV(16) || CT || HMAC(64) 파일 작성 (GUI 암호화 형식)
+    //  - MAC 대상은 IV || CT, hmac_key가 NULL이면 태그 없이 IV || CT만 기록
+    //  - 임시 암호문 파일을 만들었다가 다시 읽어 MAC/복사하지 않는다 (crypto_stream.h)
+    //  - 실패하면 쓰다 만 출력 파일은 삭제
+    //  - 오류 코드: -1 인자, -2 입력 열기, -3 출력 열기, -4 컨텍스트, -5 메모리,
+    //              -6 쓰기, -7 읽기, -16 취소
+    int stream_encrypt_ctr_hmac_file_ex(const blockcipher_vtable_t* engine,
+        const char* in_path,
+        const char* out_path,
+        const unsigned char* key,
+        int key_len,
+        const unsigned char iv[CTR_BLOCK_BYTES],
+        const unsigned char* hmac_key,
+        size_t hmac_key_len,
+        const stream_options_t* opt);
+
+    // IV(16) || CT || HMAC(64) 파일을 앞에서부터 한 번만 읽어 검증 + 복호화
+    //  - 끝으로 seek해 태그를 먼저 읽지 않으므로 in_path가 파이프/FIFO/표준 입력이어도 된다
+    //    (crypto_stream_open_*: 마지막 64바이트를 보류하는 lookbehind)
+    //  - 평문은 out_path + STREAM_PARTIAL_SUFFIX 에 기록하고, 태그가 맞을 때만
+    //    out_path로 이름을 바꾼다. 실패하면 부분 파일을 지우고 out_path는 건드리지 않음
+    //  - hmac_key가 NULL이면 IV || CT 형식 (검증 없이 같은 방식으로 기록)
+    //  - 오류 코드: -1 인자, -2 입력 열기, -3 출력 열기, -4 컨텍스트, -5 메모리,
+    //              -6 쓰기, -7 읽기, -10 인증 실패, -13 입력이 IV(+태그)보다 짧음, -16 취소
+#define STREAM_PARTIAL_SUFFIX ".part"
+
+    int stream_decrypt_ctr_hmac_file_ex(const blockcipher_vtable_t* engine,
+        const char* in_path,
+        const char* out_path,
+        const unsigned char* key,
+        int key_len,
+        const unsigned char* hmac_key,
+        size_t hmac_key_len,
+        const stream_options_t* opt);
+
+    // 키 교체: IV || CT || HMAC 파일을 한 번만 읽어 새 키/IV/HMAC 키의 파일로 바꾼다
+    //  - 복호화 → 평문 파일 → 재암호화의 두 번 읽기/쓰기와 디스크 위 평문 없이,
+    //    버퍼마다 (이전 keystream ⊕ 새 keystream)을 CT에 XOR (평문은 메모리에도 만들지 않음)
+    //  - 이전 HMAC은 읽으면서 계산해 마지막 태그와 비교하고, 새 HMAC은 새 IV || CT'에 대해 계산
+    //  - 출력은 out_path + STREAM_PARTIAL_SUFFIX에 쓰고 이전 태그가 맞을 때만 이름을 바꾼다
+    //    (out_path == in_path 가능: 검증에 성공해야 원본이 교체됨)
+    //  - old_hmac_key가 NULL이면 입력은 태그 없는 IV || CT, new_hmac_key가 NULL이면 출력도 태그 없음
+    //  - 입력 크기로 태그 위치를 정하므로 in_path는 일반 파일이어야 한다
+    //  - 청크 컨테이너는 stream_chunked_rekey_file (stream_chunked.h)
+    //  - 오류 코드: -1 인자, -2 입력 열기, -3 출력 열기, -4 컨텍스트, -5 메모리,
+    //              -6 쓰기, -7 읽기, -10 인증 실패, -13 입력이 IV(+태그)보다 짧음, -16 취소
+    int stream_rekey_ctr_hmac_file(const blockcipher_vtable_t* engine,
+        const char* in_path,
+        const char* out_path,
+        const unsigned char* old_key,
+        int old_key_len,
+        const unsigned char* old_hmac_key,
+        size_t old_hmac_key_len,
+        const unsigned char* new_key,
+        int new_key_len,
+        const unsigned char new_iv[CTR_BLOCK_BYTES],
+        const unsigned char* new_hmac_key,
+        size_t new_hmac_key_len,
+        const stream_options_t* opt);
+
+    int stream_hash_sha512_file_ex(const char* in_path,
+        unsigned char out_digest[64],
+        const stream_options_t* opt);
+
+    int stream_hmac_sha512_file_ex(const char* in_path,
+        const unsigned char* key,
+        size_t key_len,
+        unsigned char out_mac[64],
+        const stream_options_t* opt);
+
+    // ---------------------------------------------------------------
+    // 체크포인트 기반 재개형 해시
+    //  - checkpoint_interval 바이트마다 중간 상태를 state_path(사이드카 파일)에 기록
+    //  - 다음 호출 시 사이드카가 유효하면 기록된 오프셋부터 이어서 계산
+    //    (append-only 로그는 새로 붙은 꼬리만 읽게 됨)
+    //  - 파일이 기록된 오프셋보다 짧아졌으면 처음부터 다시 계산
+    //  - 파일 앞부분이 수정된 경우는 감지하지 않으므로 append-only 파일에만 사용
+    //  - 사이드카는 임시 파일에 쓰고 fsync한 뒤 이름을 바꾼다. 아무것도 읽지 않은 상태
+    //    (빈 입력 등)는 기록하지 않고 이전 사이드카를 지운다
+    //  - HMAC 사이드카는 키에 준하는 비밀: 저장된 내부 상태는 K ⊕ ipad에서 이어진
+    //    SHA-512 중간값이라, 읽을 수 있는 쪽은 같은 키의 내부 해시를 이어 계산할 수 있다.
+    //    키와 같은 권한으로 보관하고 공유/백업 대상에서 빼며, 다 쓰면 지울 것
+    //  - checkpoint_interval == 0 이면 STREAM_CHECKPOINT_DEFAULT_INTERVAL
+    //  - 오류 코드: -1 인자, -2 입력 열기, -3 메모리, -4 읽기, -5 사이드카 기록 실패, -16 취소
+    // ---------------------------------------------------------------
+#define STREAM_CHECKPOINT_DEFAULT_INTERVAL (64ull * 1024 * 1024)
+
+    int stream_hash_sha512_file_resumable(const char* in_path,
+        const char* state_path,
+        uint64_t checkpoint_interval,
+        unsigned char out_digest[64]);
+
+    int stream_hmac_sha512_file_resumable(const char* in_path,
+        const unsigned char* key,
+        size_t key_len,
+        const char* state_path,
+        uint64_t checkpoint_interval,
+        unsigned char out_mac[64]);
+
+    // opt의 progress / cancel 콜백을 쓰는 변형 (다른 옵션은 무시, 취소 시 -16이며
+    // 마지막 체크포인트는 남으므로 다음 호출에서 이어서 계산)
+    int stream_hash_sha512_file_resumable_ex(const char* in_path,
+        const char* state_path,
+        uint64_t checkpoint_interval,
+        unsigned char out_digest[64],
+        const stream_options_t* opt);
+
+    int stream_hmac_sha512_file_resumable_ex(const char* in_path,
+        const unsigned char* key,
+        size_t key_len,
+        const char* state_path,
+        uint64_t checkpoint_interval,
+        unsigned char out_mac[64],
+        const stream_options_t* opt);
+
 #ifdef __cplusplus
 }
 #endif
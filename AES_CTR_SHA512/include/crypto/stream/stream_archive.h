@@ -0,0 +1,86 @@
+﻿#pragma once   // 헤더 중복 include 방지
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "crypto/core/blockcipher.h"
+#include "crypto/mode/mode_ctr.h"
+#include "crypto/stream/stream_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    // 여러 파일 묶음 아카이브 (작은 파일이 많은 디렉터리 트리용)
+    //  - 파일마다 출력 파일 열기 / 키 스케줄 / HMAC 마무리를 하지 않고, 모든 입력을
+    //    이어 붙인 스트림 하나를 청크 컨테이너(stream_chunked.h)로 암호화한다
+    //    (키 컨텍스트와 청크 병렬 처리는 한 번만 준비)
+    //  - 항목 하나를 꺼낼 때는 그 항목이 걸친 청크만 검증/복호화 (crypto_file_t)
+    //
+    //  평문 스트림 (청크 컨테이너 안쪽, big-endian)
+    //   항목 데이터 0 || 항목 데이터 1 || ... || 색인 || 트레일러(24)
+    //   색인 항목: 오프셋(8) | 크기(8) | 이름 길이(4) | 이름 (NUL 없음)
+    //   트레일러 : magic "SARC"(4) | version(4) | 색인 오프셋(8) | 항목 수(8)
+    //   - 색인/트레일러도 청크 태그로 인증되고, 마지막 청크 표시로 잘림을 검출
+    //
+    //  - 오류 코드: -1 인자, -2 입력 열기, -3 출력 열기, -4 컨텍스트, -5 메모리,
+    //              -6 쓰기, -7 읽기, -10 인증 실패, -13 잘림, -16 취소,
+    //              -17 컨테이너/아카이브 형식 불일치 (트레일러/색인이 깨짐 포함)
+#define STREAM_ARCHIVE_VERSION        1
+#define STREAM_ARCHIVE_TRAILER_BYTES  24
+#define STREAM_ARCHIVE_MAX_NAME       4096u
+
+    // in_paths[i]를 순서대로 묶어 out_path에 기록. names[i]는 색인에 넣을 이름
+    // (names가 NULL이거나 names[i]가 NULL이면 in_paths[i]). chunk_size는 stream_chunked 규칙.
+    // opt->compress면 압축 컨테이너로 묶는다 (열기/읽기는 그대로)
+    // 진행률 total은 입력 크기 합 + 색인 + 트레일러 (평문 스트림 길이)
+    // 실패하면 출력 삭제
+    int stream_archive_create(const blockcipher_vtable_t* engine,
+        const char* out_path,
+        const char* const* in_paths,
+        const char* const* names,
+        size_t count,
+        const unsigned char* key,
+        int key_len,
+        const unsigned char iv[CTR_BLOCK_BYTES],
+        const unsigned char* hmac_key,
+        size_t hmac_key_len,
+        size_t chunk_size,
+        const stream_options_t* opt);
+
+    typedef struct stream_archive_t stream_archive_t;
+
+    // 열기: 트레일러와 색인을 읽어 검증. 반환 0 성공(*out 설정) 또는 오류 코드
+    int stream_archive_open(stream_archive_t** out,
+        const blockcipher_vtable_t* engine,
+        const char* path,
+        const unsigned char* key,
+        int key_len,
+        const unsigned char* hmac_key,
+        size_t hmac_key_len);
+
+    size_t stream_archive_count(const stream_archive_t* ar);
+
+    // 항목 정보 (name은 ar을 닫을 때까지 유효). 반환 0, 범위 밖이면 -1
+    int stream_archive_entry(const stream_archive_t* ar, size_t index, const char** name, uint64_t* size);
+
+    // 이름으로 항목 번호 찾기. 없으면 -1
+    long long stream_archive_find(const stream_archive_t* ar, const char* name);
+
+    // 항목 index의 offset부터 최대 len바이트. 반환: 읽은 바이트 수 또는 음수 오류 (crypto_file_pread)
+    long long stream_archive_read(stream_archive_t* ar, size_t index, void* buf, size_t len, uint64_t offset);
+
+    // 항목 하나를 out_path로 꺼낸다 (out_path + STREAM_PARTIAL_SUFFIX에 쓰고 끝나면 이름 바꾸기)
+    int stream_archive_extract(stream_archive_t* ar, size_t index, const char* out_path);
+
+    // opt의 progress / cancel 콜백을 쓰는 변형 (다른 옵션은 무시)
+    //  - 항목을 시작하기 전과 복사 버퍼마다 cancel을 확인하고, 취소되면 .part를 지우고 -16
+    //  - progress(user, done, total)의 total은 항목 크기
+    int stream_archive_extract_ex(stream_archive_t* ar, size_t index, const char* out_path,
+        const stream_options_t* opt);
+
+    void stream_archive_close(stream_archive_t* ar);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,89 @@
+﻿#pragma once   // 헤더 중복 include 방지
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "crypto/core/blockcipher.h"
+#include "crypto/mode/mode_ctr.h"
+#include "crypto/hash/hash_sha512.h"
+#include "crypto/stream/stream_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    // 여러 파일 일괄 처리 (work-stealing 스레드 풀)
+    //  - 작업마다 스레드/버퍼/키 스케줄을 새로 만들지 않고, 스레드마다 버퍼 하나와
+    //    CTR 컨텍스트 / HMAC 키 미드스테이트를 두고 같은 키가 이어지면 재사용한다
+    //    (CTR은 ctr_mode_seek으로 IV만 바꿈)
+    //  - 스레드마다 작업 번호 구간을 나눠 받고, 자기 구간이 비면 다른 스레드 구간의
+    //    뒤쪽 절반을 가져온다 (파일 크기가 고르지 않아도 코어가 놀지 않도록)
+    //  - 작업 종류
+    //      STREAM_BATCH_CTR      : IV || CT (복호화는 앞 16바이트를 IV로 사용)
+    //      STREAM_BATCH_CTR_HMAC : IV || CT || HMAC
+    //      STREAM_BATCH_SHA512   : digest에 SHA-512 (out_path 사용 안 함)
+    //    암호화 작업에 want_digest를 켜면 암호화한 평문(읽은 그대로)의 SHA-512도 digest에
+    //    (한 번 읽은 바이트로 해시와 암호화를 함께 하므로 둘이 어긋나지 않는다. 조각으로 나누지 않음)
+    //    복호화는 out_path + STREAM_PARTIAL_SUFFIX에 쓰고 (HMAC이 맞을 때만) 이름을 바꾼다
+    //  - 같은 키 조합이 이어지는 순서로 jobs를 놓으면 키 스케줄 재사용이 늘어난다
+    //  - 실패한 작업의 출력은 지운다. job.rc에 stream_encrypt_ctr_hmac_file_ex /
+    //    stream_decrypt_ctr_hmac_file_ex와 같은 오류 코드 (-10 인증 실패, -13 짧은 입력 등)
+    //  - opt: threads (0이면 CPU 수), buf_size (스레드당 버퍼), progress / cancel
+    //      progress(user, 끝난 작업 수, 전체 작업 수), cancel은 작업 사이에서 확인하고
+    //      시작하지 않은 작업은 rc = -16
+    //  - 스레드를 일부 만들지 못해도 남은 스레드(최소 호출 스레드)가 모든 작업을 처리
+    //  - 반환: 실패한 작업 수 (0 = 모두 성공), -1 인자, -5 메모리
+    typedef enum stream_batch_kind_t {
+        STREAM_BATCH_CTR = 1,
+        STREAM_BATCH_CTR_HMAC = 2,
+        STREAM_BATCH_SHA512 = 3
+    } stream_batch_kind_t;
+
+    typedef struct stream_batch_job_t {
+        int kind;                           // stream_batch_kind_t
+        int encrypt;                        // 1 = 암호화, 0 = 복호화 (SHA512는 무시)
+        const char* in_path;
+        const char* out_path;
+        const blockcipher_vtable_t* engine;
+        const unsigned char* key;
+        int key_len;
+        unsigned char iv[CTR_BLOCK_BYTES];  // 암호화 IV
+        const unsigned char* hmac_key;      // CTR_HMAC
+        size_t hmac_key_len;
+        int want_digest;                    // 암호화: 평문 SHA-512도 digest에
+        unsigned char digest[SHA512_DIGEST_LENGTH];   // SHA512 결과
+        int rc;                             // 결과 (0 성공)
+    } stream_batch_job_t;
+
+    int stream_encrypt_batch(stream_batch_job_t* jobs,
+        size_t n,
+        const stream_options_t* opt);
+
+    // 큰 파일 / 작은 파일 혼합 스케줄링
+    //  - 작은 파일만 파일 단위로 나누면 큰 파일 몇 개를 맡은 스레드만 끝까지 일하고 나머지
+    //    코어는 논다. 버퍼 크기 * STREAM_BATCH_SPLIT_MIN_BUFS 이상인 STREAM_BATCH_CTR 작업은
+    //    구간(조각)으로 나눠 여러 스레드가 함께 처리하고, 작은 작업은 그 사이/뒤를 채운다
+    //  - 조각 크기는 스레드마다 측정한 처리량으로 정하고 남은 양이 줄수록 작게 잡는다
+    //  - CTR_HMAC / SHA512는 MAC/해시가 파일 전체에 대해 직렬이라 나누지 않는다
+    //    (큰 파일을 병렬로 인증하려면 청크 컨테이너 stream_chunked_* 사용)
+    //  - 스레드가 1개면 나누지 않는다
+#define STREAM_BATCH_SPLIT_MIN_BUFS 8u
+
+    typedef struct stream_batch_stats_t {
+        unsigned int threads;       // 실제로 실행한 스레드 수 (호출 스레드 포함)
+        size_t split_jobs;          // 조각으로 나눈 작업 수
+        uint64_t segments;          // 처리한 조각 수
+        uint64_t wall_ns;           // 전체 경과 시간
+        uint64_t busy_ns;           // 스레드들이 작업/조각을 처리한 시간의 합
+        double efficiency;          // 병렬 효율 busy_ns / (wall_ns * threads), 1.0이면 끝까지 모든 스레드가 일함
+    } stream_batch_stats_t;
+
+    // stream_encrypt_batch + 통계 (stats는 NULL 가능)
+    int stream_encrypt_batch_ex(stream_batch_job_t* jobs,
+        size_t n,
+        const stream_options_t* opt,
+        stream_batch_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,170 @@
+﻿#pragma once   // 헤더 중복 include 방지
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "crypto/core/blockcipher.h"
+#include "crypto/mode/mode_ctr.h"
+#include "crypto/stream/stream_api.h"
+#include "crypto/stream/crypto_stream.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    // 청크 단위 인증 컨테이너 (AES-CTR + 청크별 HMAC-SHA512)
+    //  - IV || CT || HMAC은 파일 전체에 MAC이 하나라 검증이 직렬이고 마지막 바이트까지
+    //    확인하기 전에는 평문을 내보낼 수 없다. 컨테이너는 고정 크기 청크마다 태그를 붙여
+    //    청크를 병렬로 암호화/검증/복호화하고, 검증된 청크부터 바로 내보낸다.
+    //
+    //  포맷 (big-endian)
+    //   헤더(48): magic "SCHK"(4) | version(4) | 플래그(1) | cipher(1, 1 = AES) | 키 비트 수(2) |
+    //             청크 크기(4) | 태그 길이(4, 64) | 예약(12, 0) | IV(16)
+    //   청크 i  : CT_i (청크 크기, 마지막 청크만 더 짧음, 0바이트 가능) || tag_i(64)
+    //   - CT_i = AES-CTR(key, IV, 카운터 = i * 청크 크기 / 16)
+    //   - tag_i = HMAC-SHA512(hmac_key, 헤더 || 청크 번호(8) || final(1) || CT_i)
+    //     헤더를 묶으므로 청크 크기/IV 변조, 청크 번호로 순서 바꾸기/복제,
+    //     final 플래그로 청크 경계에서 잘라 낸 경우를 검출
+    //   - 청크 크기보다 짧은 청크가 마지막(final = 1). 입력이 청크 크기의 배수면
+    //     빈 마지막 청크(태그만)가 붙는다
+    //
+    //  압축 컨테이너 (플래그 STREAM_CHUNKED_FLAG_LZ, opt->compress로 암호화)
+    //   청크 i  : 평문 길이(4) | 저장 길이(4) || CT_i (저장 길이) || tag_i(64)
+    //   - 청크마다 엔트로피 검사(stream_lz_probe) 후 LZ 압축해 줄어들 때만 압축본을,
+    //     아니면 평문 그대로 암호화 (저장 길이 < 평문 길이 = 압축됨)
+    //   - tag_i = HMAC-SHA512(hmac_key, 헤더 || 청크 번호(8) || final(1) || 길이(8) || CT_i)
+    //   - 평문 길이가 청크 크기보다 짧은 청크가 마지막. 카운터는 위와 같다
+    //     (저장 길이 <= 청크 크기라 청크끼리 keystream이 겹치지 않음)
+    //   - 플래그를 모르는 이전 버전은 -17로 거부
+    //   - 길이 필드는 태그로 인증되지만 암호화되지 않는다. 청크마다 평문이 얼마나
+    //     압축되는지 드러나므로, 비밀과 공격자가 고를 수 있는 데이터가 한 청크에
+    //     섞이는 입력은 압축하지 않는다 (CRIME/BREACH류 길이 부채널, stream_lz.h)
+    //
+    //  - opt->threads: 청크 처리 스레드 수 (0이면 CPU 수). 스레드는 호출마다 한 번 띄워 재사용하고,
+    //    호출 스레드는 그동안 다음 묶음을 읽고 앞 묶음을 기록한다
+    //  - opt->progress / cancel: 청크 묶음을 기록할 때마다 호출 (취소 시 -16).
+    //    마지막 청크까지 기록한 뒤에는 취소를 묻지 않는다
+    //  - 오류 코드: -1 인자, -2 입력 열기, -3 출력 열기, -4 컨텍스트, -5 메모리,
+    //              -6 쓰기, -7 읽기, -10 인증 실패, -12 스레드 생성 실패,
+    //              -13 입력이 잘림(헤더/마지막 청크 없음), -16 취소,
+    //              -17 헤더 형식/버전/키 길이 불일치
+#define STREAM_CHUNKED_VERSION        1
+#define STREAM_CHUNKED_CIPHER_AES     1
+#define STREAM_CHUNKED_HEADER_BYTES   48
+#define STREAM_CHUNKED_TAG_BYTES      64
+#define STREAM_CHUNKED_DEFAULT_CHUNK  (1u << 20)
+#define STREAM_CHUNKED_MIN_CHUNK      1024u
+#define STREAM_CHUNKED_MAX_CHUNK      (64u << 20)
+#define STREAM_CHUNKED_FLAG_LZ        0x01    // 헤더 플래그: 청크별 LZ 압축
+#define STREAM_CHUNKED_RECORD_HEAD    8       // 압축 컨테이너의 청크 길이 필드
+
+    // 암호화: chunk_size는 16의 배수, [MIN, MAX] (0이면 DEFAULT). 실패하면 출력 삭제
+    int stream_chunked_encrypt_file(const blockcipher_vtable_t* engine,
+        const char* in_path,
+        const char* out_path,
+        const unsigned char* key,
+        int key_len,
+        const unsigned char iv[CTR_BLOCK_BYTES],
+        const unsigned char* hmac_key,
+        size_t hmac_key_len,
+        size_t chunk_size,
+        const stream_options_t* opt);
+
+    // 스트리밍 암호화: read_fn(파이프, 여러 파일을 이어 붙인 입력 등)에서 읽어 out에 기록
+    //  - read_fn은 0을 반환할 때까지 호출 (음수는 -7). total은 진행률 전체 크기 (모르면 0)
+    //  - 실패해도 out은 닫거나 지우지 않는다 (호출 측 몫)
+    int stream_chunked_encrypt_stream(const blockcipher_vtable_t* engine,
+        crypto_stream_read_fn read_fn,
+        void* read_ctx,
+        FILE* out,
+        const unsigned char* key,
+        int key_len,
+        const unsigned char iv[CTR_BLOCK_BYTES],
+        const unsigned char* hmac_key,
+        size_t hmac_key_len,
+        size_t chunk_size,
+        uint64_t total,
+        const stream_options_t* opt);
+
+    // 복호화: 평문을 out_path + STREAM_PARTIAL_SUFFIX에 쓰고 모두 검증되면 이름을 바꾼다
+    int stream_chunked_decrypt_file(const blockcipher_vtable_t* engine,
+        const char* in_path,
+        const char* out_path,
+        const unsigned char* key,
+        int key_len,
+        const unsigned char* hmac_key,
+        size_t hmac_key_len,
+        const stream_options_t* opt);
+
+    // 스트리밍 복호화: in(파이프 가능)에서 읽어 검증된 청크의 평문을 순서대로 write_fn에 넘긴다
+    //  - write_fn이 받은 청크는 모두 인증된 것. 도중에 -10/-13이 나면 그 뒤 청크는 오지 않으며,
+    //    이미 받은 평문이 전체의 앞부분일 뿐임을 호출 측이 처리해야 한다
+    //  - total은 진행률 전체 크기 = 헤더를 포함한 컨테이너 크기 (모르면 0)
+    int stream_chunked_decrypt_stream(const blockcipher_vtable_t* engine,
+        FILE* in,
+        crypto_stream_write_fn write_fn,
+        void* write_ctx,
+        const unsigned char* key,
+        int key_len,
+        const unsigned char* hmac_key,
+        size_t hmac_key_len,
+        uint64_t total,
+        const stream_options_t* opt);
+
+    // 키 교체: 컨테이너를 한 번만 읽어 새 키/IV/HMAC 키의 컨테이너로 바꾼다 (청크 크기 유지)
+    //  - 청크마다 이전 태그 확인 → (이전 ⊕ 새 keystream) XOR → 새 태그를 병렬로 처리
+    //  - out_path + STREAM_PARTIAL_SUFFIX에 쓰고 모든 청크가 검증되면 이름을 바꾼다
+    //    (out_path == in_path 가능). 오류 코드는 복호화와 같음 (-17: 이전 키 길이 불일치 등)
+    int stream_chunked_rekey_file(const blockcipher_vtable_t* engine,
+        const char* in_path,
+        const char* out_path,
+        const unsigned char* old_key,
+        int old_key_len,
+        const unsigned char* old_hmac_key,
+        size_t old_hmac_key_len,
+        const unsigned char* new_key,
+        int new_key_len,
+        const unsigned char new_iv[CTR_BLOCK_BYTES],
+        const unsigned char* new_hmac_key,
+        size_t new_hmac_key_len,
+        const stream_options_t* opt);
+
+    // 임의 접근 읽기 (crypto_file_t)
+    //  - 컨테이너 파일을 열어 pread(offset, len)가 닿는 청크만 읽고 검증/복호화한다
+    //    (청크 i의 위치 = 헤더 + i * (청크 크기 + 태그), 카운터는 CTR seek으로 계산)
+    //  - 압축 컨테이너는 청크 길이가 달라 열 때 길이 필드만 따라가며 청크 위치를 모아 둔다
+    //  - 검증된 평문 청크를 cache_chunks개까지 LRU로 보관 (0이면 CRYPTO_FILE_DEFAULT_CACHE)
+    //  - 열 때 헤더와 파일 크기로 청크 수/평문 크기를 정하므로 마지막 청크가 없으면 -13,
+    //    태그가 맞지 않는 청크에 닿는 읽기는 -10 (다른 청크 읽기는 계속 가능)
+    //  - 핸들 하나를 여러 스레드가 동시에 쓰면 안 된다 (스레드마다 따로 열 것)
+#define CRYPTO_FILE_DEFAULT_CACHE 8u
+
+    typedef struct crypto_file_t crypto_file_t;
+
+    // 반환: 0 성공(*out 설정), -1 인자, -2 열기, -4 컨텍스트, -5 메모리, -7 읽기,
+    //       -10 길이 필드 변조 (압축 컨테이너), -13 잘림, -17 헤더 형식/버전/키 길이 불일치
+    int crypto_file_open(crypto_file_t** out,
+        const blockcipher_vtable_t* engine,
+        const char* path,
+        const unsigned char* key,
+        int key_len,
+        const unsigned char* hmac_key,
+        size_t hmac_key_len,
+        unsigned int cache_chunks);
+
+    // offset부터 최대 len바이트 평문. 반환: 읽은 바이트 수(끝을 넘으면 짧거나 0),
+    // 음수는 오류 (-1 인자, -5 메모리, -7 읽기, -10 인증 실패)
+    long long crypto_file_pread(crypto_file_t* cf, void* buf, size_t len, uint64_t offset);
+
+    // 평문 전체 크기
+    uint64_t crypto_file_size(const crypto_file_t* cf);
+
+    // 캐시 적중/실패 횟수 (청크 단위)
+    void crypto_file_cache_stats(const crypto_file_t* cf, uint64_t* hits, uint64_t* misses);
+
+    void crypto_file_close(crypto_file_t* cf);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,62 @@
+﻿#pragma once   // 헤더 중복 include 방지
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "crypto/core/blockcipher.h"
+#include "crypto/hash/hash_sha512.h"
+#include "crypto/key/key_context.h"
+#include "crypto/stream/stream_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    // 중복 제거 일괄 암호화 (백업처럼 같은 파일이 많은 묶음용)
+    //  1) 모든 입력의 SHA-512 지문을 병렬로 계산 (stream_encrypt_batch, STREAM_BATCH_SHA512)
+    //  2) 지문이 같은 입력끼리 묶어 내용마다 한 번만 IV || CT || HMAC으로 암호화
+    //     (stream_encrypt_batch, STREAM_BATCH_CTR_HMAC). 묶음의 첫 작업(번호가 가장 작은 것)만
+    //     out_path에 기록하고, 나머지는 dup_of로 그 작업을 가리킨다 (출력 파일 없음)
+    //  3) 키/IV는 마스터 키와 지문에서 결정적으로 파생 (key_context_derive_file,
+    //     file_id = "dedup" || 지문) → 같은 내용은 같은 마스터 키 아래에서 항상 같은 암호문
+    //  - 키가 마스터 키에 묶여 있으므로 마스터 키가 다른 사용자끼리는 내용을 확인할 수 없지만,
+    //    같은 마스터 키 안에서는 암호문이 같다는 사실로 내용이 같음이 드러난다
+    //  - digest는 복호화 키를 되살리는 값이므로 목록(매니페스트)에 키처럼 보관할 것
+    //  - opt: stream_encrypt_batch와 같음 (progress는 지문 단계와 암호화 단계에서 각각 호출)
+    //  - 암호화 단계에서 읽은 평문의 지문을 다시 계산해 1)과 비교한다. 그 사이 입력이 바뀌었으면
+    //    (다른 내용이 같은 키/IV로 암호화된 것) 출력을 지우고 job.rc = -14
+    //  - job.rc: 지문/암호화 오류 코드 (중복 작업은 원본 작업의 rc를 받는다)
+    //  - 반환: 실패한 작업 수 (0 = 모두 성공), -1 인자, -4 키 파생, -5 메모리
+    typedef struct stream_dedup_job_t {
+        const char* in_path;
+        const char* out_path;               // 고유 내용의 첫 작업만 기록
+        unsigned char digest[SHA512_DIGEST_LENGTH];   // 내용 지문 (SHA-512)
+        size_t dup_of;                      // 암호문을 가진 작업 번호 (자기 번호면 고유 내용)
+        int rc;
+    } stream_dedup_job_t;
+
+    typedef struct stream_dedup_stats_t {
+        size_t unique;          // 암호화한 고유 내용 수
+        size_t duplicates;      // 암호화를 건너뛴 중복 작업 수
+    } stream_dedup_stats_t;
+
+    // aes_key_len: 16 / 24 / 32. stats는 NULL 가능
+    int stream_encrypt_batch_dedup(const blockcipher_vtable_t* engine,
+        const key_context_t* kc,
+        unsigned int aes_key_len,
+        stream_dedup_job_t* jobs,
+        size_t n,
+        const stream_options_t* opt,
+        stream_dedup_stats_t* stats);
+
+    // 복원용: 지문에서 암호화에 쓴 키 묶음을 다시 파생
+    //  (stream_decrypt_ctr_hmac_file_ex에 aes_key / hmac_key 사용, IV는 파일 앞 16바이트)
+    //  반환: CRYPTO_OK 또는 crypto_status_t 오류 코드
+    int stream_dedup_keys(const key_context_t* kc,
+        const unsigned char digest[SHA512_DIGEST_LENGTH],
+        unsigned int aes_key_len,
+        key_file_keys_t* out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,53 @@
+﻿#pragma once   // 헤더 중복 include 방지
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    // 페이지 캐시를 거치지 않는 파일 I/O (stream_api의 STREAM_IO_DIRECT 모드용)
+    // - POSIX  : O_DIRECT
+    // - Windows: FILE_FLAG_NO_BUFFERING (+ 쓰기는 FILE_FLAG_WRITE_THROUGH)
+    // - 버퍼 주소, I/O 길이, 파일 오프셋이 모두 STREAM_DIRECT_ALIGNMENT의 배수여야 한다.
+    //   마지막 조각은 0으로 채워 정렬 길이로 기록한 뒤 stream_direct_close에서
+    //   실제 길이로 잘라낸다.
+    // - 파일시스템이 직접 I/O를 지원하지 않으면(tmpfs 등) 일반 I/O로 열고
+    //   처리한 범위마다 캐시 해제 힌트(POSIX_FADV_DONTNEED)를 준다 (direct = 0)
+
+#define STREAM_DIRECT_ALIGNMENT 4096u
+
+    typedef struct stream_direct_file_t {
+#ifdef _WIN32
+        void* handle;          // HANDLE
+#else
+        int fd;
+#endif
+        int direct;            // 1 = 캐시 우회 성공
+        int writable;
+        uint64_t pos;          // 다음 읽기/쓰기 오프셋
+    } stream_direct_file_t;
+
+    // 반환: 0 성공, -2 열기 실패
+    int stream_direct_open_read(stream_direct_file_t* f, const char* path);
+
+    // 반환: 0 성공, -3 생성 실패
+    int stream_direct_open_write(stream_direct_file_t* f, const char* path);
+
+    // buf_size(정렬 배수)만큼 채워 읽는다. 파일 끝이면 더 적게, 끝에 도달했으면 0.
+    // 반환: 읽은 바이트 수, 실패 시 -1
+    long long stream_direct_read(stream_direct_file_t* f, unsigned char* buf, size_t buf_size);
+
+    // len 바이트 기록. len이 정렬 배수가 아니면(마지막 조각) buf의 남는 부분을 0으로
+    // 채워 정렬 길이로 기록하므로 buf 용량은 정렬 배수로 올린 길이 이상이어야 한다.
+    // 반환: 0 성공, -1 실패
+    int stream_direct_write(stream_direct_file_t* f, unsigned char* buf, size_t len, size_t buf_cap);
+
+    // 닫기. 쓰기용이면 파일 길이를 logical_size로 맞춘다.
+    // 반환: 0 성공, -1 실패
+    int stream_direct_close(stream_direct_file_t* f, uint64_t logical_size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,49 @@
+﻿#pragma once   // 헤더 중복 include 방지
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "crypto/mode/mode_ctr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    // stream 모듈 공용 파일 유틸 (stream_*.c 내부용)
+    //  - 64비트 오프셋 / 크기 / 자르기 / 동기화 / 이름 바꾸기를 Windows와 POSIX에서 같은 형태로 제공
+    //  - 반환: 따로 적지 않으면 0 성공, -1 실패
+
+    // 2GB를 넘는 오프셋으로 이동 (SEEK_SET, Windows의 fseek은 long 32비트)
+    int stream_file_seek(FILE* f, uint64_t off);
+
+    // 파일 크기. 위치는 처음으로 되돌린다 (실패 시 -1)
+    long long stream_file_size(FILE* f);
+
+    // 경로로 파일 크기 (없거나 일반 파일이 아니면 -1)
+    long long stream_path_size(const char* path);
+
+    // 버퍼를 비우고 size 바이트로 자른다
+    int stream_file_truncate(FILE* f, uint64_t size);
+
+    // 버퍼를 비우고 디스크까지 기록 (fsync / _commit)
+    int stream_file_sync(FILE* f);
+
+    // tmp_path를 dst_path로 바꾼다 (dst_path가 있으면 덮어씀).
+    // 임시 파일에 다 쓴 뒤 바꾸므로 중간에 끊겨도 이전 dst_path는 그대로 남는다.
+    int stream_replace_file(const char* tmp_path, const char* dst_path);
+
+    // path || suffix 새 문자열 (".part", ".tmp" 등). free로 해제, 메모리 부족이면 NULL
+    char* stream_path_suffix(const char* path, const char* suffix);
+
+    // 키/IV 확인값: HMAC-SHA512(key, STREAM_KEY_CHECK_LABEL || IV)의 앞 8바이트.
+    // 상태 파일/저널이 같은 키와 IV로 만든 것인지 확인하는 용도.
+    // keystream에서 나온 값이 아니라 구분 라벨을 붙인 MAC이므로, 파일을 가진 쪽이 키 추측을
+    // 블록 암호 한 번으로 검사하거나 keystream에 대해 알아낼 수 없다
+#define STREAM_KEY_CHECK_LABEL "stream resume check"
+    void stream_key_check(const unsigned char* key, size_t key_len,
+        const unsigned char iv[CTR_BLOCK_BYTES], unsigned char check[8]);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,84 @@
+﻿#pragma once   // 헤더 중복 include 방지
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "crypto/hash/hash_sha512.h"
+#include "crypto/stream/stream_api.h"
+#include "crypto/stream/stream_batch.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    // 무결성 색인 (사이드카): 바뀌지 않은 파일의 SHA-512 / HMAC을 다시 읽지 않고 답한다
+    //  - 항목 = 경로 + 파일 메타데이터(크기, mtime, ctime, 장치/inode) → 지문
+    //    메타데이터가 기록 때와 모두 같으면 색인 값을 돌려주고, 다르거나 없으면 파일을 읽어
+    //    계산한 뒤 항목을 갱신한다 (주기적인 무결성 점검이 메타데이터 조회로 끝남)
+    //  - 경로는 받은 문자열 그대로 키로 쓴다 (같은 파일은 같은 경로 표기로 물을 것)
+    //  - 파일 시각 단위보다 짧은 간격의 수정을 놓치지 않도록, 기록 시작 시각과
+    //    STREAM_INDEX_RACY_SECONDS 안쪽에 수정된 파일의 항목은 다음 조회에서 믿지 않고 다시 계산
+    //  - 계산하는 동안 메타데이터가 바뀐 파일은 기록하지 않는다
+    //  - Windows는 inode 대신 0, ctime은 생성 시각 (크기/mtime으로 판단)
+    //  - 메타데이터를 그대로 되돌리며 내용을 바꾸는 변조는 검출하지 못한다
+    //    (주기 점검용. 완전한 재검증이 필요하면 색인 없이 계산할 것)
+    //
+    //  색인 파일 포맷 (big-endian)
+    //   헤더(16): magic "SIDX"(4) | version(4) | 항목 수(8)
+    //   항목    : 경로 길이(4) | 종류(4, 1 = SHA-512, 2 = HMAC) | 크기(8) | mtime ns(8) |
+    //             ctime ns(8) | 장치(8) | inode(8) | 기록 시각 s(8) | 키 id(16) | 지문(64) | 경로
+    //   트레일러: HMAC-SHA512(index_key, 헤더 || 항목들)
+    //   - 사이드카를 쓸 수 있는 쪽이 지문을 위조하지 못하도록 index_key는 필수
+    //     (키 없는 해시 트레일러는 누구나 다시 계산할 수 있으므로 지원하지 않음)
+    //   - 색인 파일이 없거나 형식/트레일러가 맞지 않으면 빈 색인으로 시작 (모두 다시 계산)
+    //   - HMAC 항목의 키 id = HMAC-SHA512(index_key, L || HMAC-SHA512(key, L))의 앞 16바이트,
+    //     L = "stream index key id" (다른 키로 물으면 색인을 쓰지 않음. index_key에 묶여 있어
+    //     색인 파일만으로는 키를 맞춰 보거나 색인 파일끼리 같은 키를 이어 볼 수 없다)
+    //   - 저장은 index_path + ".tmp"에 쓰고 디스크에 동기화한 뒤 이름 바꾸기
+#define STREAM_INDEX_VERSION        2
+#define STREAM_INDEX_RACY_SECONDS   2
+
+    typedef struct stream_index_t stream_index_t;
+
+    // index_key: 색인 파일 인증 키 (필수, 지문 계산용 키와 분리 권장). 반환 0, -1 인자(키 없음 포함), -5 메모리
+    int stream_index_open(stream_index_t** out,
+        const char* index_path,
+        const unsigned char* index_key,
+        size_t index_key_len);
+
+    // stream_hash_sha512_file_ex / stream_hmac_sha512_file_ex와 같은 결과와 오류 코드
+    int stream_index_sha512_file(stream_index_t* idx,
+        const char* in_path,
+        unsigned char out_digest[SHA512_DIGEST_LENGTH],
+        const stream_options_t* opt);
+
+    int stream_index_hmac_sha512_file(stream_index_t* idx,
+        const char* in_path,
+        const unsigned char* key,
+        size_t key_len,
+        unsigned char out_mac[SHA512_DIGEST_LENGTH],
+        const stream_options_t* opt);
+
+    // 일괄 검증용: STREAM_BATCH_SHA512 작업만 (다른 종류가 있으면 -1)
+    //  - 색인으로 답할 수 있는 작업은 바로 채우고, 나머지만 stream_encrypt_batch로 병렬 계산
+    //  - 반환: stream_encrypt_batch와 같음 (실패한 작업 수, -1 인자, -5 메모리)
+    int stream_index_batch(stream_index_t* idx,
+        stream_batch_job_t* jobs,
+        size_t n,
+        const stream_options_t* opt);
+
+    // 더 이상 없는 파일의 항목 삭제. 반환: 지운 항목 수
+    size_t stream_index_prune(stream_index_t* idx);
+
+    // 바뀐 내용이 있으면 색인 파일에 기록. 반환 0, -5 메모리, -6 쓰기
+    int stream_index_save(stream_index_t* idx);
+
+    // 항목 수 / 색인으로 답한 횟수 / 파일을 읽어 계산한 횟수
+    void stream_index_stats(const stream_index_t* idx, size_t* entries, uint64_t* hits, uint64_t* misses);
+
+    // 저장하지 않고 닫는다 (필요하면 먼저 stream_index_save)
+    void stream_index_close(stream_index_t* idx);
+
+#ifdef __cplusplus
+}
+#endif
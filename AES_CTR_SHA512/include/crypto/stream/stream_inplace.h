@@ -0,0 +1,64 @@
+﻿#pragma once   // 헤더 중복 include 방지
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "crypto/core/blockcipher.h"
+#include "crypto/mode/mode_ctr.h"
+#include "crypto/stream/stream_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    // 제자리(in-place) CTR 암/복호화
+    //  - CTR은 길이가 그대로이므로 파일을 새로 만들지 않고 같은 핸들에서
+    //    청크를 읽어(pread / ReadFile) 변환한 뒤 같은 위치에 덮어쓴다 (pwrite / WriteFile).
+    //    출력 사본이 없으므로 디스크 사용량과 쓰기량이 절반
+    //  - CTR 변환은 두 번 적용하면 원래대로 돌아오므로 암호화/복호화가 같은 연산
+    //  - 복구 저널(journal_path, NULL이면 path + STREAM_INPLACE_JOURNAL_SUFFIX)
+    //      청크를 덮어쓰기 전에 "이 청크 앞까지 확정" 오프셋과 청크의 섹터(512B)별
+    //      앞 8바이트를 기록하고 동기화한다 (청크당 약 1.5%). 평문이 저널에 새지 않도록
+    //      앞 8바이트는 항상 암호문 쪽(암호화: 변환 후, 복호화: 변환 전)이며, 복구할 때
+    //      같은 카운터로 변환해 평문 쪽을 다시 만든다.
+    //      중간에 끊긴 뒤 같은 키/IV, 같은 방향으로 다시 호출하면 저널의 청크에서 각 섹터가
+    //      원본인지 변환본인지 앞 8바이트로 판별해 마저 변환하고 이어서 진행.
+    //      끝나면 저널을 지운다 (저널 없이 다시 호출하면 다시 변환 = 원래대로)
+    //  - 섹터 단위 쓰기가 원자적이라고 가정한다. 한 섹터가 일부만 기록되어
+    //    원본/변환본 어느 쪽과도 맞지 않으면 -15로 멈추고 파일/저널은 그대로 둔다
+    //  - opt->buf_size: 청크 크기 (0이면 STREAM_INPLACE_DEFAULT_CHUNK, 섹터 배수로 올림)
+    //  - opt->progress / cancel: 청크마다 호출. 취소되면 저널을 남기고 -16 (다시 호출하면 이어서)
+    //  - 반환: 0 성공, -1 인자, -2 파일 열기, -4 컨텍스트, -5 메모리, -6 쓰기/동기화,
+    //          -7 읽기, -14 저널이 다른 키/IV/파일/방향의 것 (이전 버전 저널 포함), -15 복구 불가,
+    //          -16 취소
+    //
+    //  저널 포맷 (big-endian)
+    //   magic "SIPJ"(4) | version(4) | 키/IV 확인값(8) | 파일 크기(8) |
+    //   청크 오프셋(8) | 청크 길이(8) | 섹터 수(4) | 방향(4, 1 = 암호화) | 섹터별 암호문 앞 8바이트
+    //   - 확인값: stream_key_check (HMAC(key, 라벨 || IV)의 앞 8바이트, stream_fileutil.h)
+#define STREAM_INPLACE_SECTOR          512u
+#define STREAM_INPLACE_PREFIX          8u
+#define STREAM_INPLACE_DEFAULT_CHUNK   (16u << 20)
+#define STREAM_INPLACE_JOURNAL_SUFFIX  ".ijnl"
+#define STREAM_INPLACE_JOURNAL_VERSION 2
+#define STREAM_INPLACE_HEADER_BYTES    48
+
+    int stream_encrypt_ctr_file_inplace(const blockcipher_vtable_t* engine,
+        const char* path,
+        const unsigned char* key,
+        int key_len,
+        const unsigned char iv[CTR_BLOCK_BYTES],
+        const char* journal_path,
+        const stream_options_t* opt);
+
+    int stream_decrypt_ctr_file_inplace(const blockcipher_vtable_t* engine,
+        const char* path,
+        const unsigned char* key,
+        int key_len,
+        const unsigned char iv[CTR_BLOCK_BYTES],
+        const char* journal_path,
+        const stream_options_t* opt);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,37 @@
+﻿#pragma once   // 헤더 중복 include 방지
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    // 청크 압축용 경량 LZ77 (LZ4 계열 블록 포맷, 외부 라이브러리 없음)
+    //  - 시퀀스 = 토큰(1: 상위 4비트 리터럴 길이, 하위 4비트 매치 길이 - 4) |
+    //             리터럴 길이 확장 | 리터럴 | 오프셋(2, little-endian) | 매치 길이 확장
+    //    길이 필드가 15면 뒤따르는 바이트를 255가 아닐 때까지 더한다
+    //  - 마지막 시퀀스는 리터럴만 (입력을 다 읽으면 끝). 매치 거리 최대 65535
+    //  - 해시 테이블 하나로 찾는 탐욕적 매칭이라 압축률보다 속도 우선
+    //    (매치가 안 나는 구간은 점점 건너뛰며 찾는다)
+    //  - 보안 주의: 압축 후 암호화하면 암호문 길이가 평문의 압축률을 드러낸다.
+    //    공격자가 평문 일부를 넣고 길이 변화를 볼 수 있으면 같은 청크 안의 비밀을
+    //    한 바이트씩 알아낼 수 있다 (CRIME/BREACH). 청크 컨테이너는 청크별 저장 길이를
+    //    평문으로 기록하므로 그런 데이터에는 압축을 쓰지 않는다.
+#define STREAM_LZ_MIN_INPUT      64u     // 이보다 짧은 입력은 압축하지 않음
+#define STREAM_LZ_PROBE_SAMPLES  4096u   // 엔트로피 검사에 뽑는 바이트 수
+
+    // 엔트로피 검사: 입력에서 고르게 뽑은 바이트 분포의 충돌 확률(sum p^2)로
+    // Rényi 엔트로피를 어림해 7 bits/byte를 넘으면 (암호문/압축 파일/난수) 0
+    // 반환: 1 = 압축 시도, 0 = 그대로 저장
+    int stream_lz_probe(const unsigned char* in, size_t n);
+
+    // 압축: out[0..cap-1]에 기록. 반환: 압축 길이, cap 안에 들어가지 않으면 0
+    //  (cap을 n - 1로 주면 0 = 줄어들지 않음)
+    size_t stream_lz_compress(const unsigned char* in, size_t n, unsigned char* out, size_t cap);
+
+    // 해제: 반환 복원 길이, 형식 오류이거나 cap을 넘으면 -1
+    long long stream_lz_decompress(const unsigned char* in, size_t n, unsigned char* out, size_t cap);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,44 @@
+﻿#pragma once   // 헤더 중복 include 방지
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    // 파일 메모리 매핑 헬퍼 (stream_api의 STREAM_IO_MMAP 모드용)
+    // - Windows: CreateFileMapping / MapViewOfFile
+    // - POSIX  : mmap (+ madvise(MADV_SEQUENTIAL), posix_fallocate)
+    // - 길이 0 파일은 매핑하지 않고 data = NULL, size = 0 으로 성공 처리
+    // - 파일 전체를 한 번에 매핑하므로 주소 공간보다 큰 파일은 실패(-1)한다.
+    //   호출 측은 이 경우 일반 stdio 경로로 되돌아간다.
+
+    typedef struct stream_map_t {
+        unsigned char* data;   // 매핑 시작 주소
+        uint64_t size;         // 매핑 길이 (= 파일 크기)
+        int writable;          // 1 = 출력용 매핑
+#ifdef _WIN32
+        void* file;            // HANDLE
+        void* mapping;         // HANDLE
+#else
+        int fd;
+#endif
+    } stream_map_t;
+
+    // 입력 파일을 읽기 전용으로 매핑하고 순차 접근 힌트를 준다.
+    // 반환: 0 성공, -1 매핑 불가(크기 초과, 특수 파일 등), -2 열기 실패
+    int stream_map_open_read(stream_map_t* m, const char* path);
+
+    // 출력 파일을 size 바이트로 만들어(미리 할당) 쓰기용으로 매핑한다.
+    // 반환: 0 성공, -1 매핑 불가, -3 생성/할당 실패
+    int stream_map_create(stream_map_t* m, const char* path, uint64_t size);
+
+    // 매핑 해제 후 파일을 닫는다. 쓰기용 매핑의 내용은 일반 fclose와 같이
+    // OS 캐시를 거쳐 파일에 기록된다 (fsync 보장은 없음).
+    // 반환: 0 성공, -1 해제/닫기 실패
+    int stream_map_close(stream_map_t* m);
+
+#ifdef __cplusplus
+}
+#endif
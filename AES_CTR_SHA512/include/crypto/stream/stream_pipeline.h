@@ -0,0 +1,59 @@
+﻿#pragma once   // 헤더 중복 include 방지
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    // 3단계 스트림 파이프라인 (읽기 → 연산 → 쓰기)
+    //  - 읽기 스레드 1개, 연산 스레드 workers개, 쓰기 스레드 1개
+    //  - 단계 사이는 고정 크기 lock-free SPSC 링으로 연결되고,
+    //    buf_count개의 정렬된 버퍼를 재사용한다 (쓰기가 끝난 버퍼는 읽기로 반환)
+    //  - k번째 버퍼는 (k % workers)번 연산 스레드가 처리하고 쓰기 스레드는
+    //    같은 순서로 꺼내므로 출력 순서가 입력 순서와 같다
+    //  - 마지막 버퍼를 제외한 모든 버퍼는 buf_size를 꽉 채워 읽으므로
+    //    offset은 항상 buf_size의 배수 (CTR 카운터 계산에 사용)
+    //  - out == NULL 이면 쓰기 단계 없이 버퍼를 바로 반환 (해시 등)
+    //  - 처리 순서가 중요한 연산(해시)은 workers = 1로 사용
+
+    // 연산 콜백: buf[0..len-1]을 제자리에서 처리. worker는 0..workers-1 (스레드별 컨텍스트 선택용)
+    // 0 이외를 반환하면 파이프라인을 중단하고 -7을 돌려준다.
+    typedef int (*stream_pipeline_fn)(void* arg,
+        unsigned int worker,
+        unsigned char* buf,
+        size_t len,
+        uint64_t offset);
+
+    typedef struct stream_pipeline_t {
+        FILE* in;               // 입력 (필수)
+        FILE* out;              // 출력 (NULL 가능)
+        size_t buf_size;        // 버퍼 크기 (0이면 STREAM_PIPELINE_DEFAULT_BUF_SIZE)
+        size_t buf_count;       // 버퍼 개수 (workers + 2 이상 권장, 0이면 기본값)
+        size_t alignment;       // 버퍼 정렬 (0이면 STREAM_PIPELINE_DEFAULT_ALIGNMENT)
+        unsigned int workers;   // 연산 스레드 수 (0이면 1)
+        stream_pipeline_fn fn;  // 연산 콜백 (필수)
+        void* arg;              // 콜백 인자
+        stream_pipeline_fn done;// 버퍼 하나가 끝날 때마다 입력 순서대로 호출 (NULL 가능)
+                                // 쓰기 스레드(out == NULL이면 연산 스레드)에서 호출.
+                                // 0 이외를 반환하면 fn과 같이 중단 (-7)
+        void* done_arg;         // done 인자
+    } stream_pipeline_t;
+
+#define STREAM_PIPELINE_DEFAULT_BUF_SIZE  (1u << 20)
+#define STREAM_PIPELINE_DEFAULT_ALIGNMENT 4096u
+#define STREAM_PIPELINE_MAX_WORKERS       64u
+
+    // 파이프라인 실행 (모든 스레드가 끝난 뒤 반환)
+    // 반환: 0 성공, -1 인자, -3 메모리, -4 읽기, -6 쓰기, -7 콜백 실패, -12 스레드 생성 실패
+    int stream_pipeline_run(const stream_pipeline_t* p);
+
+    // 정렬된 버퍼 할당/해제 (alignment는 2의 거듭제곱)
+    void* stream_aligned_alloc(size_t size, size_t alignment);
+    void stream_aligned_free(void* p);
+
+#ifdef __cplusplus
+}
+#endif
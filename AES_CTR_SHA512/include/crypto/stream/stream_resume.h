@@ -0,0 +1,54 @@
+﻿#pragma once   // 헤더 중복 include 방지
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "crypto/core/blockcipher.h"
+#include "crypto/mode/mode_ctr.h"
+#include "crypto/stream/stream_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    // 재개형 IV || CT || HMAC 암호화 (큰 파일 백업용)
+    //  - stream_encrypt_ctr_hmac_file_ex와 같은 출력 형식. hmac_key가 NULL이면 IV || CT
+    //  - checkpoint_interval 바이트마다 출력 파일을 동기화한 뒤 상태 파일
+    //    (state_path, NULL이면 out_path + STREAM_RESUME_STATE_SUFFIX)에
+    //    입력 오프셋, CTR 카운터(블록 번호), HMAC 중간 상태를 tmp → 동기화 → 이름 바꾸기로 기록
+    //  - 상태 파일이 있으면 이어서 암호화:
+    //      출력 파일이 기록된 길이(16 + 오프셋) 이상인지 확인하고 그 길이로 자른 뒤
+    //      입력/카운터/HMAC을 그 위치부터 계속한다. IV는 출력 파일 앞 16바이트를 사용
+    //      (iv 인자는 새로 시작할 때만 사용)
+    //      출력이 기록보다 짧거나 상태 파일이 깨졌으면 처음부터 다시 암호화
+    //  - 끝나면 태그를 붙이고 상태 파일을 지운다. 실패/취소 시에는 출력과 상태 파일을
+    //    남기므로 같은 인자로 다시 호출하면 마지막 체크포인트부터 이어서 처리
+    //  - checkpoint_interval == 0 이면 STREAM_CHECKPOINT_DEFAULT_INTERVAL
+    //  - opt: buf_size / adaptive / progress / cancel만 사용 (stdio 경로)
+    //  - 오류 코드: -1 인자, -2 입력 열기, -3 출력 열기, -4 컨텍스트, -5 메모리,
+    //              -6 쓰기/동기화, -7 읽기, -14 상태 파일이 다른 키/입력의 것, -16 취소
+    //
+    //  상태 파일 포맷 (big-endian)
+    //   magic "SECP"(4) | version(4) | 플래그(4, bit0 = HMAC) | 예약(4) |
+    //   입력 오프셋(8) | CTR 카운터(8) | 키/IV 확인값(8) | 입력 크기(8) | HMAC 상태(HMAC_STATE_BYTES)
+    //   - 확인값: stream_key_check (HMAC(key, 라벨 || IV)의 앞 8바이트, stream_fileutil.h)
+    //   - 오프셋은 항상 블록(16바이트) 배수이므로 카운터 = 오프셋 / 16
+#define STREAM_RESUME_STATE_SUFFIX  ".eckp"
+#define STREAM_RESUME_STATE_VERSION 2
+#define STREAM_RESUME_HEADER_BYTES  48
+
+    int stream_encrypt_ctr_hmac_file_resumable(const blockcipher_vtable_t* engine,
+        const char* in_path,
+        const char* out_path,
+        const unsigned char* key,
+        int key_len,
+        const unsigned char iv[CTR_BLOCK_BYTES],
+        const unsigned char* hmac_key,
+        size_t hmac_key_len,
+        const char* state_path,
+        uint64_t checkpoint_interval,
+        const stream_options_t* opt);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,42 @@
+﻿#pragma once   // 헤더 중복 include 방지
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "crypto/stream/stream_pipeline.h"
+
+// io_uring 사용 여부
+//  - Linux에서 <linux/io_uring.h>가 있으면 자동으로 켜진다 (liburing 불필요, 시스템 콜 직접 호출)
+//  - STREAM_NO_IO_URING 을 정의하면 강제로 끈다
+//  - 그 외 플랫폼에서는 항상 "사용 불가"를 반환해 호출 측이 일반 I/O로 처리
+#if defined(__linux__) && !defined(STREAM_NO_IO_URING) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define STREAM_HAVE_IO_URING 1
+#endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define STREAM_URING_DEFAULT_DEPTH 8u
+#define STREAM_URING_MAX_DEPTH     64u
+
+    // io_uring 기반 파일 처리
+    //  - depth개의 등록 버퍼(IORING_REGISTER_BUFFERS)와 고정 파일(IORING_REGISTER_FILES)로
+    //    읽기/쓰기를 여러 개 동시에 걸어 두고, 완료된 버퍼부터 순서대로 fn으로 처리
+    //  - fn은 stream_pipeline_fn과 같은 형식 (worker는 항상 0, offset은 buf_size의 배수)
+    //  - fn이 처리한 버퍼는 out_path가 있으면 같은 오프셋에 기록
+    //  - 입력이 버퍼 하나보다 작으면 링을 만들 이유가 없으므로 사용 불가로 처리
+    // 반환: 0 성공, 1 사용 불가(커널/빌드 미지원, 작은 파일 등 → 호출 측이 다른 경로로 처리)
+    //       -2 입력 열기, -3 출력 열기/메모리, -4 읽기, -6 쓰기, -7 콜백 실패
+    int stream_uring_process_file(const char* in_path,
+        const char* out_path,
+        size_t buf_size,
+        unsigned int depth,
+        stream_pipeline_fn fn,
+        void* arg);
+
+#ifdef __cplusplus
+}
+#endif
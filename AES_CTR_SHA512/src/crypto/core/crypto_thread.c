@@ -0,0 +1,137 @@
+﻿// nanosleep, sched_yield 선언용
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "crypto/core/crypto_thread.h"
+
+#include <string.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <sched.h>
+#include <time.h>
+#endif
+
+#ifdef _WIN32
+// CreateThread 시그니처에 맞춘 트램펄린
+static DWORD WINAPI crypto_thread_entry(LPVOID param)
+{
+    crypto_thread_t* t = (crypto_thread_t*)param;
+    t->fn(t->arg);
+    return 0;
+}
+#else
+static void* crypto_thread_entry(void* param)
+{
+    crypto_thread_t* t = (crypto_thread_t*)param;
+    t->fn(t->arg);
+    return NULL;
+}
+#endif
+
+int crypto_thread_start(crypto_thread_t* t, crypto_thread_fn fn, void* arg)
+{
+    if (!t || !fn) return -1;
+
+    memset(t, 0, sizeof(*t));
+    t->fn = fn;
+    t->arg = arg;
+
+#ifdef _WIN32
+    t->handle = CreateThread(NULL, 0, crypto_thread_entry, t, 0, NULL);
+    if (!t->handle) return -1;
+#else
+    if (pthread_create(&t->handle, NULL, crypto_thread_entry, t) != 0) return -1;
+#endif
+    t->started = 1;
+    return 0;
+}
+
+void crypto_thread_join(crypto_thread_t* t)
+{
+    if (!t || !t->started) return;
+
+#ifdef _WIN32
+    WaitForSingleObject(t->handle, INFINITE);
+    CloseHandle(t->handle);
+#else
+    pthread_join(t->handle, NULL);
+#endif
+    t->started = 0;
+}
+
+unsigned int crypto_cpu_count(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return si.dwNumberOfProcessors > 0 ? (unsigned int)si.dwNumberOfProcessors : 1u;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (unsigned int)n : 1u;
+#endif
+}
+
+long crypto_atomic_load(const crypto_atomic_t* p)
+{
+#ifdef _WIN32
+    return InterlockedCompareExchange((volatile LONG*)p, 0, 0);
+#else
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+#endif
+}
+
+void crypto_atomic_store(crypto_atomic_t* p, long v)
+{
+#ifdef _WIN32
+    InterlockedExchange((volatile LONG*)p, (LONG)v);
+#else
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+#endif
+}
+
+int crypto_atomic_cas(crypto_atomic_t* p, long expected, long desired)
+{
+#ifdef _WIN32
+    return InterlockedCompareExchange((volatile LONG*)p, (LONG)desired, (LONG)expected) == (LONG)expected;
+#else
+    return __atomic_compare_exchange_n(p, &expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#endif
+}
+
+uint64_t crypto_now_ns(void)
+{
+#ifdef _WIN32
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER now;
+    if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (uint64_t)((double)now.QuadPart * 1e9 / (double)freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+void crypto_thread_yield(void)
+{
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+void crypto_thread_sleep_ms(unsigned int ms)
+{
+#ifdef _WIN32
+    Sleep(ms);
+#else
+    struct timespec ts;
+    ts.tv_sec = (time_t)(ms / 1000);
+    ts.tv_nsec = (long)(ms % 1000) * 1000000L;
+    nanosleep(&ts, NULL);
+#endif
+}
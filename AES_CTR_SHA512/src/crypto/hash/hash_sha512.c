@@ -1,5 +1,6 @@
 ﻿#include "crypto/hash/hash_sha512.h"
 #include "crypto/bytes.h"
+#include "crypto/status.h"
 #include <string.h>
 #include <stdint.h>
 
@@ -101,15 +102,15 @@ static void sha512_msg_schedule(uint64_t W[80],
 // =====================================================
 // Compression function (Merkle?Damg?rd core)
 // =====================================================
-static void sha512_compress(sha512_ctx_t* ctx,
-    const unsigned char block[128])
+void sha512_compress_block(uint64_t H[SHA_WORD_NUMBER],
+    const unsigned char block[SHA512_BLOCK_SIZE])
 {
     uint64_t W[80];
     sha512_msg_schedule(W, block);
 
     // Working variables
-    uint64_t a = ctx->H[0], b = ctx->H[1], c = ctx->H[2], d = ctx->H[3];
-    uint64_t e = ctx->H[4], f = ctx->H[5], g = ctx->H[6], h = ctx->H[7];
+    uint64_t a = H[0], b = H[1], c = H[2], d = H[3];
+    uint64_t e = H[4], f = H[5], g = H[6], h = H[7];
 
     // 80 rounds
     for (int t = 0; t < 80; t++) {
@@ -127,8 +128,75 @@ static void sha512_compress(sha512_ctx_t* ctx,
     }
 
     // Update chaining values
-    ctx->H[0] += a; ctx->H[1] += b; ctx->H[2] += c; ctx->H[3] += d;
-    ctx->H[4] += e; ctx->H[5] += f; ctx->H[6] += g; ctx->H[7] += h;
+    H[0] += a; H[1] += b; H[2] += c; H[3] += d;
+    H[4] += e; H[5] += f; H[6] += g; H[7] += h;
+}
+
+// =====================================================
+// Multi-lane compression (independent states, interleaved rounds)
+// =====================================================
+void sha512_compress_lanes(uint64_t* const H[],
+    const unsigned char* const blocks[],
+    size_t lanes)
+{
+    if (!H || !blocks || lanes == 0) return;
+    if (lanes == 1) {
+        sha512_compress_block(H[0], blocks[0]);
+        return;
+    }
+    if (lanes > SHA512_MAX_LANES) lanes = SHA512_MAX_LANES;
+
+    // 레인 수를 고정 크기로 맞춰 두면 내부 루프가 상수 길이라 컴파일러가 펼치기 쉽다.
+    // 비어 있는 레인은 0번 레인을 복제해 계산하고 결과는 버린다.
+    uint64_t W[80][SHA512_MAX_LANES];
+    uint64_t v[8][SHA512_MAX_LANES];
+
+    for (size_t l = 0; l < SHA512_MAX_LANES; l++) {
+        size_t src = (l < lanes) ? l : 0;
+        for (int i = 0; i < 16; i++) {
+            W[i][l] = load_be64(blocks[src] + 8 * i);
+        }
+        for (int i = 0; i < 8; i++) {
+            v[i][l] = H[src][i];
+        }
+    }
+
+    for (int t = 16; t < 80; t++) {
+        for (size_t l = 0; l < SHA512_MAX_LANES; l++) {
+            W[t][l] = sigma1(W[t - 2][l]) + W[t - 7][l] + sigma0(W[t - 15][l]) + W[t - 16][l];
+        }
+    }
+
+    for (int t = 0; t < 80; t++) {
+        for (size_t l = 0; l < SHA512_MAX_LANES; l++) {
+            uint64_t a = v[0][l], b = v[1][l], c = v[2][l], d = v[3][l];
+            uint64_t e = v[4][l], f = v[5][l], g = v[6][l], h = v[7][l];
+
+            uint64_t T1 = h + SIGMA1(e) + Ch(e, f, g) + K[t] + W[t][l];
+            uint64_t T2 = SIGMA0(a) + Maj(a, b, c);
+
+            v[7][l] = g;
+            v[6][l] = f;
+            v[5][l] = e;
+            v[4][l] = d + T1;
+            v[3][l] = c;
+            v[2][l] = b;
+            v[1][l] = a;
+            v[0][l] = T1 + T2;
+        }
+    }
+
+    for (size_t l = 0; l < lanes; l++) {
+        for (int i = 0; i < 8; i++) {
+            H[l][i] += v[i][l];
+        }
+    }
+}
+
+static void sha512_compress(sha512_ctx_t* ctx,
+    const unsigned char block[128])
+{
+    sha512_compress_block(ctx->H, block);
 }
 
 // =====================================================
@@ -151,6 +219,18 @@ void sha512_init(sha512_ctx_t* ctx)
     memcpy(ctx->H, H0, sizeof(H0));
 }
 
+void sha512_init_midstate(sha512_ctx_t* ctx,
+    const uint64_t H[SHA_WORD_NUMBER],
+    uint64_t bytes_processed)
+{
+    if (!ctx || !H) return;
+
+    memset(ctx, 0, sizeof(*ctx));
+    memcpy(ctx->H, H, sizeof(ctx->H));
+    ctx->total_bits_lo = bytes_processed << 3;
+    ctx->total_bits_hi = bytes_processed >> 61;
+}
+
 void sha512_update(sha512_ctx_t* ctx,
     const unsigned char* data,
     size_t len)
@@ -208,3 +288,70 @@ void sha512_final(sha512_ctx_t* ctx,
         store_be64(digest + 8 * i, ctx->H[i]);
     }
 }
+
+// =====================================================
+// Midstate serialization
+// =====================================================
+static const unsigned char SHA512_STATE_MAGIC[4] = { 'S', '5', '1', '2' };
+
+uint64_t sha512_bytes_processed(const sha512_ctx_t* ctx)
+{
+    if (!ctx) return 0;
+    // 128비트 비트 카운터를 바이트 단위로 환산
+    return (ctx->total_bits_hi << 61) | (ctx->total_bits_lo >> 3);
+}
+
+int sha512_export_state(const sha512_ctx_t* ctx,
+    unsigned char out[SHA512_STATE_BYTES])
+{
+    if (!ctx || !out) return CRYPTO_ERR_NULL;
+    if (ctx->buffer_len >= SHA512_BLOCK_SIZE) return CRYPTO_ERR_STATE;
+
+    unsigned char* p = out;
+    memcpy(p, SHA512_STATE_MAGIC, 4);                      p += 4;
+    store_be32(p, SHA512_STATE_VERSION);                   p += 4;
+    store_be64(p, sha512_bytes_processed(ctx));            p += 8;
+    for (int i = 0; i < SHA_WORD_NUMBER; i++) {
+        store_be64(p, ctx->H[i]);                          p += 8;
+    }
+    store_be32(p, (uint32_t)ctx->buffer_len);              p += 4;
+    store_be32(p, 0);                                      p += 4;
+
+    // 블록 미만 잔여 데이터만 의미가 있고 나머지는 0으로 채운다.
+    memset(p, 0, SHA512_BLOCK_SIZE);
+    memcpy(p, ctx->buffer, ctx->buffer_len);
+    return CRYPTO_OK;
+}
+
+int sha512_import_state(sha512_ctx_t* ctx,
+    const unsigned char in[SHA512_STATE_BYTES])
+{
+    if (!ctx || !in) return CRYPTO_ERR_NULL;
+
+    const unsigned char* p = in;
+    if (memcmp(p, SHA512_STATE_MAGIC, 4) != 0) return CRYPTO_ERR_INVALID;
+    p += 4;
+    if (load_be32(p) != SHA512_STATE_VERSION) return CRYPTO_ERR_INVALID;
+    p += 4;
+
+    uint64_t bytes = load_be64(p);                         p += 8;
+    uint64_t H[SHA_WORD_NUMBER];
+    for (int i = 0; i < SHA_WORD_NUMBER; i++) {
+        H[i] = load_be64(p);                               p += 8;
+    }
+    uint32_t buffer_len = load_be32(p);                    p += 8;
+
+    // 잔여 버퍼 길이는 처리 바이트 수와 반드시 일치해야 한다(손상/위조 감지).
+    if (buffer_len >= SHA512_BLOCK_SIZE ||
+        buffer_len != (uint32_t)(bytes % SHA512_BLOCK_SIZE)) {
+        return CRYPTO_ERR_INVALID;
+    }
+
+    memset(ctx, 0, sizeof(*ctx));
+    memcpy(ctx->H, H, sizeof(H));
+    ctx->total_bits_lo = bytes << 3;
+    ctx->total_bits_hi = bytes >> 61;
+    memcpy(ctx->buffer, p, buffer_len);
+    ctx->buffer_len = buffer_len;
+    return CRYPTO_OK;
+}
@@ -5,6 +5,8 @@
 
 #include "crypto/hash/hash_sha512.h"
 #include "crypto/hash/hmac.h"
+#include "crypto/bytes.h"
+#include "crypto/status.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -17,9 +19,9 @@ extern "C" {
      *  - 외부 해시: H( (K ⊕ opad) || 내부 해시 결과 )
      * ========================================================================================= */
 
-    // HMAC 초기화: 키를 블록 크기에 맞춰 전처리하고 (K ⊕ ipad)를 넣어 내부 해시를 시작
-    void hmac_init(OUT hmac_ctx* c, IN const uint8_t* key, IN size_t key_len) {
-        if (!c || !key) return;
+    // 키 전처리: 키를 블록 크기에 맞춘 뒤 (K ⊕ ipad), (K ⊕ opad)를 각각 한 블록씩 압축해 둔다.
+    void hmac_key_init(OUT hmac_key_t* k, IN const uint8_t* key, IN size_t key_len) {
+        if (!k || !key) return;
 
         uint8_t processed_key[SHA512_BLOCK_SIZE];
 
@@ -33,6 +35,8 @@ extern "C" {
             memcpy(processed_key, key_hash, SHA512_DIGEST_LENGTH);
             memset(processed_key + SHA512_DIGEST_LENGTH, 0,
                 SHA512_BLOCK_SIZE - SHA512_DIGEST_LENGTH);
+            memset(key_hash, 0, sizeof(key_hash));
+            memset(&temp_ctx, 0, sizeof(temp_ctx));
         }
         else {
             // 키가 블록 이하일 때는 그대로 복사
@@ -44,18 +48,49 @@ extern "C" {
             memset(processed_key + key_len, 0, SHA512_BLOCK_SIZE - key_len);
         }
 
-        // (K ⊕ ipad) 계산
-        uint8_t ipad_key[SHA512_BLOCK_SIZE];
+        // (K ⊕ ipad), (K ⊕ opad) 블록 계산
+        uint8_t pad_block[SHA512_BLOCK_SIZE];
+        sha512_ctx_t iv_ctx;
+        sha512_init(&iv_ctx);
+
         for (size_t i = 0; i < SHA512_BLOCK_SIZE; i++) {
-            ipad_key[i] = processed_key[i] ^ 0x36;
+            pad_block[i] = processed_key[i] ^ 0x36;
         }
+        memcpy(k->inner, iv_ctx.H, sizeof(k->inner));
+        sha512_compress_block(k->inner, pad_block);
+
+        for (size_t i = 0; i < SHA512_BLOCK_SIZE; i++) {
+            pad_block[i] = processed_key[i] ^ 0x5C;
+        }
+        memcpy(k->outer, iv_ctx.H, sizeof(k->outer));
+        sha512_compress_block(k->outer, pad_block);
+
+        memset(processed_key, 0, sizeof(processed_key));
+        memset(pad_block, 0, sizeof(pad_block));
+    }
+
+    // 미리 계산된 내부/외부 상태를 복사해 새 메시지를 시작
+    void hmac_start_from_key(OUT hmac_ctx* c, IN const hmac_key_t* k) {
+        if (!c || !k) return;
+
+        // 내부 해시: (K ⊕ ipad) 한 블록을 이미 처리한 상태에서 시작
+        sha512_init_midstate(&c->ctx, k->inner, SHA512_BLOCK_SIZE);
+        memcpy(c->outer, k->outer, sizeof(c->outer));
+    }
 
-        // 내부 해시 시작: H( (K ⊕ ipad) || 메시지 )
-        sha512_init(&c->ctx);
-        sha512_update(&c->ctx, ipad_key, SHA512_BLOCK_SIZE);
+    void hmac_key_clear(INOUT hmac_key_t* k) {
+        if (!k) return;
+        memset(k, 0, sizeof(*k));
+    }
+
+    // HMAC 초기화: 키 전처리 후 내부 해시를 시작
+    void hmac_init(OUT hmac_ctx* c, IN const uint8_t* key, IN size_t key_len) {
+        if (!c || !key) return;
 
-        // (K ⊕ opad)를 만들기 위해 처리된 키를 보관
-        memcpy(c->key, processed_key, SHA512_BLOCK_SIZE);
+        hmac_key_t k;
+        hmac_key_init(&k, key, key_len);
+        hmac_start_from_key(c, &k);
+        hmac_key_clear(&k);
     }
 
     // 메시지 입력 (여러 번 호출 가능)
@@ -64,23 +99,19 @@ extern "C" {
         sha512_update(&c->ctx, data, len);
     }
 
-    // HMAC 계산 완료: (K ⊕ opad)와 내부 해시 결과를 합쳐 최종 MAC 생성
+    // HMAC 계산 완료: (K ⊕ opad) 처리 후 상태에 내부 해시 결과를 이어 붙여 최종 MAC 생성
     void hmac_final(INOUT hmac_ctx* c, OUT uint8_t mac[SHA512_DIGEST_LENGTH]) {
         if (!c || !mac) return;
 
         uint8_t inner_hash[SHA512_DIGEST_LENGTH];
         sha512_final(&c->ctx, inner_hash);
 
-        uint8_t opad_key[SHA512_BLOCK_SIZE];
-        for (size_t i = 0; i < SHA512_BLOCK_SIZE; i++) {
-            opad_key[i] = c->key[i] ^ 0x5C;
-        }
-
         sha512_ctx_t outer_ctx;
-        sha512_init(&outer_ctx);
-        sha512_update(&outer_ctx, opad_key, SHA512_BLOCK_SIZE);
+        sha512_init_midstate(&outer_ctx, c->outer, SHA512_BLOCK_SIZE);
         sha512_update(&outer_ctx, inner_hash, SHA512_DIGEST_LENGTH);
         sha512_final(&outer_ctx, mac);
+
+        memset(inner_hash, 0, sizeof(inner_hash));
     }
 
     // 편의 함수: 한 번에 HMAC-SHA512 계산
@@ -101,6 +132,214 @@ extern "C" {
         hmac_final(&ctx, mac);
     }
 
+    /* -------------------------------------------------------------------------------------
+     * 배치 HMAC
+     *  - 레인마다 레코드 하나의 "다음 블록"을 공급하는 상태 머신을 두고,
+     *    매 단계 활성 레인의 블록을 모아 sha512_compress_lanes 한 번으로 압축
+     *  - 레코드가 끝난 레인은 곧바로 다음 레코드로 채워 길이가 섞여 있어도 레인이 놀지 않음
+     * ------------------------------------------------------------------------------------- */
+    enum { HMAC_LANE_INNER = 0, HMAC_LANE_OUTER = 1 };
+
+    typedef struct hmac_lane_t {
+        size_t   index;                        /* 처리 중인 레코드 번호 */
+        const uint8_t* msg;
+        size_t   full_blocks;                  /* 메시지에서 바로 읽는 완전한 블록 수 */
+        size_t   tail_blocks;                  /* 패딩 포함 꼬리 블록 수 (1 또는 2) */
+        size_t   next;                         /* 다음에 처리할 블록 번호 */
+        int      phase;                        /* HMAC_LANE_INNER / HMAC_LANE_OUTER */
+        uint64_t H[SHA_WORD_NUMBER];
+        uint8_t  tail[2 * SHA512_BLOCK_SIZE];  /* 남은 메시지 + 0x80 + 0 + 길이 */
+    } hmac_lane_t;
+
+    /* 메시지 끝부분과 SHA-512 패딩을 꼬리 블록에 미리 만들어 둔다.
+       total_len: 키 블록(128)을 포함한 전체 입력 바이트 수 */
+    static size_t hmac_build_tail(uint8_t tail[2 * SHA512_BLOCK_SIZE],
+        const uint8_t* rest, size_t rest_len, uint64_t total_len) {
+        size_t tail_len = (rest_len + 1 + 16 <= SHA512_BLOCK_SIZE)
+            ? SHA512_BLOCK_SIZE : 2 * SHA512_BLOCK_SIZE;
+
+        memset(tail, 0, tail_len);
+        if (rest_len > 0) memcpy(tail, rest, rest_len);
+        tail[rest_len] = 0x80;
+        store_be64(tail + tail_len - 16, total_len >> 61);
+        store_be64(tail + tail_len - 8, total_len << 3);
+        return tail_len / SHA512_BLOCK_SIZE;
+    }
+
+    static void hmac_lane_load(hmac_lane_t* lane, const hmac_key_t* k,
+        size_t index, const uint8_t* msg, size_t len) {
+        lane->index = index;
+        lane->msg = msg;
+        lane->full_blocks = len / SHA512_BLOCK_SIZE;
+        lane->next = 0;
+        lane->phase = HMAC_LANE_INNER;
+        memcpy(lane->H, k->inner, sizeof(lane->H));
+
+        size_t rest = len % SHA512_BLOCK_SIZE;
+        lane->tail_blocks = hmac_build_tail(lane->tail,
+            msg ? msg + lane->full_blocks * SHA512_BLOCK_SIZE : NULL, rest,
+            (uint64_t)SHA512_BLOCK_SIZE + len);
+    }
+
+    static const uint8_t* hmac_lane_block(const hmac_lane_t* lane) {
+        if (lane->phase == HMAC_LANE_OUTER) return lane->tail;
+        if (lane->next < lane->full_blocks) return lane->msg + lane->next * SHA512_BLOCK_SIZE;
+        return lane->tail + (lane->next - lane->full_blocks) * SHA512_BLOCK_SIZE;
+    }
+
+    /* 블록 하나를 처리한 뒤 상태 전이. 레코드가 끝나면 1 반환 */
+    static int hmac_lane_advance(hmac_lane_t* lane, const hmac_key_t* k,
+        uint8_t tag[SHA512_DIGEST_LENGTH]) {
+        if (lane->phase == HMAC_LANE_OUTER) {
+            for (int i = 0; i < SHA_WORD_NUMBER; i++) store_be64(tag + 8 * i, lane->H[i]);
+            return 1;
+        }
+
+        lane->next++;
+        if (lane->next < lane->full_blocks + lane->tail_blocks) return 0;
+
+        /* 내부 해시 완료 → 외부 해시 블록: 내부 결과(64) + 패딩, 전체 길이 128 + 64 */
+        uint8_t inner[SHA512_DIGEST_LENGTH];
+        for (int i = 0; i < SHA_WORD_NUMBER; i++) store_be64(inner + 8 * i, lane->H[i]);
+        hmac_build_tail(lane->tail, inner, sizeof(inner),
+            (uint64_t)SHA512_BLOCK_SIZE + SHA512_DIGEST_LENGTH);
+        memcpy(lane->H, k->outer, sizeof(lane->H));
+        lane->phase = HMAC_LANE_OUTER;
+        memset(inner, 0, sizeof(inner));
+        return 0;
+    }
+
+    int hmac_sha512_batch_with_key(IN const hmac_key_t* k,
+        IN const uint8_t* const msgs[],
+        IN const size_t lens[],
+        OUT uint8_t tags[][SHA512_DIGEST_LENGTH],
+        IN size_t n) {
+        if (n == 0) return CRYPTO_OK;
+        if (!k || !msgs || !lens || !tags) return CRYPTO_ERR_NULL;
+        for (size_t i = 0; i < n; i++) {
+            if (!msgs[i] && lens[i] > 0) return CRYPTO_ERR_NULL;
+        }
+
+        hmac_lane_t lanes[SHA512_MAX_LANES];
+        size_t active = 0;
+        size_t next_record = 0;
+
+        while (active < SHA512_MAX_LANES && next_record < n) {
+            hmac_lane_load(&lanes[active++], k, next_record, msgs[next_record], lens[next_record]);
+            next_record++;
+        }
+
+        while (active > 0) {
+            uint64_t* H[SHA512_MAX_LANES];
+            const unsigned char* blocks[SHA512_MAX_LANES];
+            for (size_t l = 0; l < active; l++) {
+                H[l] = lanes[l].H;
+                blocks[l] = hmac_lane_block(&lanes[l]);
+            }
+            sha512_compress_lanes(H, blocks, active);
+
+            /* 끝난 레인은 다음 레코드로 채우고, 남은 레코드가 없으면 마지막 레인과 교체해 압축 */
+            size_t l = 0;
+            while (l < active) {
+                if (!hmac_lane_advance(&lanes[l], k, tags[lanes[l].index])) {
+                    l++;
+                    continue;
+                }
+                if (next_record < n) {
+                    hmac_lane_load(&lanes[l], k, next_record, msgs[next_record], lens[next_record]);
+                    next_record++;
+                    l++;
+                }
+                else {
+                    lanes[l] = lanes[--active];
+                }
+            }
+        }
+
+        memset(lanes, 0, sizeof(lanes));
+        return CRYPTO_OK;
+    }
+
+    int hmac_sha512_batch(IN const uint8_t* key,
+        IN size_t key_len,
+        IN const uint8_t* const msgs[],
+        IN const size_t lens[],
+        OUT uint8_t tags[][SHA512_DIGEST_LENGTH],
+        IN size_t n) {
+        if (!key) return CRYPTO_ERR_NULL;
+
+        hmac_key_t k;
+        hmac_key_init(&k, key, key_len);
+        int rc = hmac_sha512_batch_with_key(&k, msgs, lens, tags, n);
+        hmac_key_clear(&k);
+        return rc;
+    }
+
+    /* -------------------------------------------------------------------------------------
+     * 중간 상태 직렬화
+     *  - 키 확인값: opad 미드스테이트를 SHA-512로 해시한 앞 8바이트
+     *    (다른 키로 잘못 이어 계산하는 것을 막기 위한 용도이며 키를 복원할 수 없다)
+     * ------------------------------------------------------------------------------------- */
+    static const uint8_t HMAC_STATE_MAGIC[4] = { 'H', '5', '1', '2' };
+
+    static void hmac_key_check(IN const hmac_ctx* c, OUT uint8_t check[HMAC_KEY_CHECK_BYTES]) {
+        static const char label[] = "HMAC-SHA512 state key check";
+        uint8_t digest[SHA512_DIGEST_LENGTH];
+        sha512_ctx_t t;
+        sha512_init(&t);
+        sha512_update(&t, (const unsigned char*)label, sizeof(label) - 1);
+        for (int i = 0; i < SHA_WORD_NUMBER; i++) {
+            uint8_t w[8];
+            store_be64(w, c->outer[i]);
+            sha512_update(&t, w, sizeof(w));
+        }
+        sha512_final(&t, digest);
+        memcpy(check, digest, HMAC_KEY_CHECK_BYTES);
+        memset(digest, 0, sizeof(digest));
+    }
+
+    int hmac_export_state(IN const hmac_ctx* c, OUT uint8_t out[HMAC_STATE_BYTES]) {
+        if (!c || !out) return CRYPTO_ERR_NULL;
+
+        memcpy(out, HMAC_STATE_MAGIC, 4);
+        store_be32(out + 4, HMAC_STATE_VERSION);
+        hmac_key_check(c, out + 8);
+        return sha512_export_state(&c->ctx, out + 8 + HMAC_KEY_CHECK_BYTES);
+    }
+
+    int hmac_import_state(OUT hmac_ctx* c,
+        IN const uint8_t* key,
+        IN size_t key_len,
+        IN const uint8_t in[HMAC_STATE_BYTES]) {
+        if (!c || !key || !in) return CRYPTO_ERR_NULL;
+        if (memcmp(in, HMAC_STATE_MAGIC, 4) != 0) return CRYPTO_ERR_INVALID;
+        if (load_be32(in + 4) != HMAC_STATE_VERSION) return CRYPTO_ERR_INVALID;
+
+        hmac_init(c, key, key_len);
+
+        uint8_t check[HMAC_KEY_CHECK_BYTES];
+        hmac_key_check(c, check);
+        if (memcmp(check, in + 8, HMAC_KEY_CHECK_BYTES) != 0) {
+            memset(c, 0, sizeof(*c));
+            return CRYPTO_ERR_KEY;
+        }
+
+        // 키 블록(ipad) 한 블록 이상이 처리된 상태여야 정상적인 HMAC 내부 상태다.
+        sha512_ctx_t inner;
+        int rc = sha512_import_state(&inner, in + 8 + HMAC_KEY_CHECK_BYTES);
+        if (rc != CRYPTO_OK) {
+            memset(c, 0, sizeof(*c));
+            return rc;
+        }
+        if (sha512_bytes_processed(&inner) < SHA512_BLOCK_SIZE) {
+            memset(c, 0, sizeof(*c));
+            return CRYPTO_ERR_INVALID;
+        }
+
+        c->ctx = inner;
+        return CRYPTO_OK;
+    }
+
     // 간단한 콘솔 데모: 키와 메시지를 입력받아 HMAC-SHA512를 출력
     void hmac_print(void) {
         printf("===== HMAC (Hash Message Authentication Code) =====\n");
@@ -0,0 +1,107 @@
+﻿#include "crypto/key/hkdf.h"
+#include "crypto/status.h"
+
+#include <string.h>
+
+int hkdf_sha512_extract(const uint8_t* salt, size_t salt_len,
+    const uint8_t* ikm, size_t ikm_len,
+    uint8_t prk[HKDF_SHA512_PRK_BYTES])
+{
+    if ((!ikm && ikm_len > 0) || (!salt && salt_len > 0) || !prk) return CRYPTO_ERR_NULL;
+
+    // salt가 비어 있으면 HashLen 길이의 0 바이트열을 사용 (HMAC 0 패딩과 동일한 결과)
+    static const uint8_t zero_salt[HKDF_SHA512_PRK_BYTES] = { 0 };
+    if (salt_len == 0) {
+        salt = zero_salt;
+        salt_len = sizeof(zero_salt);
+    }
+
+    hmac_ctx c;
+    hmac_init(&c, salt, salt_len);
+    if (ikm_len > 0) hmac_update(&c, ikm, ikm_len);
+    hmac_final(&c, prk);
+    memset(&c, 0, sizeof(c));
+    return CRYPTO_OK;
+}
+
+int hkdf_ctx_init_prk(hkdf_ctx_t* ctx, const uint8_t prk[HKDF_SHA512_PRK_BYTES])
+{
+    if (!ctx || !prk) return CRYPTO_ERR_NULL;
+    hmac_key_init(&ctx->prk_key, prk, HKDF_SHA512_PRK_BYTES);
+    return CRYPTO_OK;
+}
+
+int hkdf_ctx_init(hkdf_ctx_t* ctx,
+    const uint8_t* salt, size_t salt_len,
+    const uint8_t* ikm, size_t ikm_len)
+{
+    if (!ctx) return CRYPTO_ERR_NULL;
+
+    uint8_t prk[HKDF_SHA512_PRK_BYTES];
+    int rc = hkdf_sha512_extract(salt, salt_len, ikm, ikm_len, prk);
+    if (rc == CRYPTO_OK) rc = hkdf_ctx_init_prk(ctx, prk);
+    memset(prk, 0, sizeof(prk));
+    return rc;
+}
+
+int hkdf_ctx_expand(const hkdf_ctx_t* ctx,
+    const uint8_t* info, size_t info_len,
+    uint8_t* okm, size_t okm_len)
+{
+    if (!ctx || (!info && info_len > 0) || !okm) return CRYPTO_ERR_NULL;
+    if (okm_len > HKDF_SHA512_MAX_OKM_BYTES) return CRYPTO_ERR_INVALID;
+
+    uint8_t t[SHA512_DIGEST_LENGTH];
+    size_t t_len = 0;
+    size_t done = 0;
+    uint8_t counter = 1;
+
+    // 블록마다 캐시된 PRK 미드스테이트에서 시작하므로
+    // 짧은 info면 T(i) 하나에 내부/외부 압축 각 1회만 든다.
+    while (done < okm_len) {
+        hmac_ctx c;
+        hmac_start_from_key(&c, &ctx->prk_key);
+        if (t_len > 0) hmac_update(&c, t, t_len);
+        if (info_len > 0) hmac_update(&c, info, info_len);
+        hmac_update(&c, &counter, 1);
+        hmac_final(&c, t);
+        t_len = sizeof(t);
+
+        size_t take = (okm_len - done < t_len) ? (okm_len - done) : t_len;
+        memcpy(okm + done, t, take);
+        done += take;
+        counter++;
+    }
+
+    memset(t, 0, sizeof(t));
+    return CRYPTO_OK;
+}
+
+int hkdf_sha512_expand(const uint8_t prk[HKDF_SHA512_PRK_BYTES],
+    const uint8_t* info, size_t info_len,
+    uint8_t* okm, size_t okm_len)
+{
+    hkdf_ctx_t ctx;
+    int rc = hkdf_ctx_init_prk(&ctx, prk);
+    if (rc == CRYPTO_OK) rc = hkdf_ctx_expand(&ctx, info, info_len, okm, okm_len);
+    hkdf_ctx_clear(&ctx);
+    return rc;
+}
+
+int hkdf_sha512(const uint8_t* salt, size_t salt_len,
+    const uint8_t* ikm, size_t ikm_len,
+    const uint8_t* info, size_t info_len,
+    uint8_t* okm, size_t okm_len)
+{
+    hkdf_ctx_t ctx;
+    int rc = hkdf_ctx_init(&ctx, salt, salt_len, ikm, ikm_len);
+    if (rc == CRYPTO_OK) rc = hkdf_ctx_expand(&ctx, info, info_len, okm, okm_len);
+    hkdf_ctx_clear(&ctx);
+    return rc;
+}
+
+void hkdf_ctx_clear(hkdf_ctx_t* ctx)
+{
+    if (!ctx) return;
+    hmac_key_clear(&ctx->prk_key);
+}
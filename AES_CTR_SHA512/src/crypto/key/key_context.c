@@ -1,4 +1,7 @@
 ﻿#include "crypto/key/key_context.h"
+#include "crypto/key/pbkdf2.h"
+#include "crypto/key/hkdf.h"
+#include "crypto/status.h"
 #include <string.h>
 #include <time.h>
 #include <stdlib.h>
@@ -6,6 +9,11 @@
 #define KC_MASTER_KEY_BYTES 32
 #define KC_MAX_ENC_KEY_BYTES 32
 
+// HKDF domain separation 라벨
+static const char KC_HKDF_SALT[] = "AES_CTR_SHA512 key_context v1";
+static const char KC_INFO_ENC[] = "enc key";
+static const char KC_INFO_FILE[] = "file keys";
+
 static void fill_random(unsigned char* out, size_t len)
 {
     // 데모용 단순 난수. 실제 배포에서는 /dev/urandom, BCryptGenRandom 등 CSPRNG를 사용해야 안전하다.
@@ -28,6 +36,7 @@ void key_context_init_random(key_context_t* kc)
     fill_random(kc->master_key, sizeof(kc->master_key));
     kc->enc_key_len = 0;
     memset(kc->enc_key, 0, KC_MAX_ENC_KEY_BYTES);
+    key_context_refresh(kc);
 }
 
 void key_context_init_seed(key_context_t* kc,
@@ -46,23 +55,114 @@ void key_context_init_seed(key_context_t* kc,
     }
     kc->enc_key_len = 0;
     memset(kc->enc_key, 0, sizeof(kc->enc_key));
+    key_context_refresh(kc);
 }
 
-void key_context_derive(key_context_t* kc, unsigned int key_len_bytes)
+int key_context_init_passphrase(key_context_t* kc,
+    const unsigned char* pass,
+    size_t pass_len,
+    const unsigned char* salt,
+    size_t salt_len,
+    uint32_t iterations)
 {
-    // master_key 앞부분을 잘라 enc_key로 사용한다(데모).
-    // 실제 환경에서는 KDF를 사용해 key_len_bytes 만큼 생성해야 한다.
+    // 패스프레이즈 + salt를 PBKDF2로 늘려 master_key를 만든다.
+    // salt는 파일/사용자마다 달라야 하며 복호화 시 같은 값을 다시 제공해야 한다.
+    if (!kc) return CRYPTO_ERR_NULL;
+    if (iterations == 0) iterations = PBKDF2_SHA512_DEFAULT_ITERATIONS;
+
+    int rc = pbkdf2_hmac_sha512(pass, pass_len, salt, salt_len, iterations,
+        kc->master_key, sizeof(kc->master_key));
+    if (rc != CRYPTO_OK) {
+        memset(kc->master_key, 0, sizeof(kc->master_key));
+        return rc;
+    }
+    kc->enc_key_len = 0;
+    memset(kc->enc_key, 0, sizeof(kc->enc_key));
+    key_context_refresh(kc);
+    return CRYPTO_OK;
+}
+
+void key_context_refresh(key_context_t* kc)
+{
+    // master_key가 바뀔 때마다 한 번만 Extract하고 PRK 미드스테이트를 캐시한다.
     if (!kc) return;
-    if (key_len_bytes > sizeof(kc->master_key)) {
-        key_len_bytes = (unsigned int)KC_MASTER_KEY_BYTES;
+    hkdf_ctx_init(&kc->kdf,
+        (const uint8_t*)KC_HKDF_SALT, sizeof(KC_HKDF_SALT) - 1,
+        kc->master_key, sizeof(kc->master_key));
+}
+
+int key_context_derive_ex(key_context_t* kc, unsigned int key_len_bytes, int version)
+{
+    if (!kc) return CRYPTO_ERR_NULL;
+    if (version != KC_DERIVE_V1 && version != KC_DERIVE_V2) return CRYPTO_ERR_INVALID;
+    if (key_len_bytes > KC_MAX_ENC_KEY_BYTES) {
+        key_len_bytes = (unsigned int)KC_MAX_ENC_KEY_BYTES;
     }
+
     kc->enc_key_len = key_len_bytes;
+    memset(kc->enc_key, 0, KC_MAX_ENC_KEY_BYTES);
 
-    // 여기서는 그냥 master_key 앞부분을 enc_key로 사용 (데모)
-    memcpy(kc->enc_key, kc->master_key, key_len_bytes);
-    if (key_len_bytes < KC_MAX_ENC_KEY_BYTES) {
-        memset(kc->enc_key + key_len_bytes, 0, KC_MAX_ENC_KEY_BYTES - key_len_bytes);
+    if (version == KC_DERIVE_V1) {
+        // 이전 방식: master_key 앞부분을 잘라 enc_key로 사용한다.
+        memcpy(kc->enc_key, kc->master_key, key_len_bytes);
+        return CRYPTO_OK;
     }
+
+    // 캐시된 PRK에서 HKDF-Expand로 enc_key를 만든다.
+    // info에 키 길이를 넣어 128/192/256비트 키가 서로의 접두어가 되지 않도록 한다.
+    unsigned char info[sizeof(KC_INFO_ENC)];
+    memcpy(info, KC_INFO_ENC, sizeof(KC_INFO_ENC) - 1);
+    info[sizeof(KC_INFO_ENC) - 1] = (unsigned char)key_len_bytes;
+
+    if (key_len_bytes > 0) {
+        if (hkdf_ctx_expand(&kc->kdf, info, sizeof(info), kc->enc_key, key_len_bytes) != 0) {
+            return CRYPTO_ERR_INVALID;
+        }
+    }
+    return CRYPTO_OK;
+}
+
+void key_context_derive(key_context_t* kc, unsigned int key_len_bytes)
+{
+    (void)key_context_derive_ex(kc, key_len_bytes, KC_DERIVE_VERSION);
+}
+
+int key_context_derive_file(const key_context_t* kc,
+    const unsigned char* file_id,
+    size_t file_id_len,
+    unsigned int aes_key_len,
+    key_file_keys_t* out)
+{
+    // info = "file keys" || aes_key_len(1) || file_id
+    // 출력 = AES 키 || HMAC 키 || IV 를 한 번의 Expand로 잘라 쓴다.
+    if (!kc || !out || (!file_id && file_id_len > 0)) return CRYPTO_ERR_NULL;
+    if (aes_key_len != 16 && aes_key_len != 24 && aes_key_len != 32) return CRYPTO_ERR_KEY;
+
+    enum { HDR = sizeof(KC_INFO_FILE) - 1 + 1, STACK_ID = 256 };
+    unsigned char info_buf[HDR + STACK_ID];
+    unsigned char* info = info_buf;
+    if (file_id_len > STACK_ID) {
+        info = (unsigned char*)malloc(HDR + file_id_len);
+        if (!info) return CRYPTO_ERR_MEMORY;
+    }
+    memcpy(info, KC_INFO_FILE, HDR - 1);
+    info[HDR - 1] = (unsigned char)aes_key_len;
+    if (file_id_len > 0) memcpy(info + HDR, file_id, file_id_len);
+
+    unsigned char okm[KC_MAX_ENC_KEY_BYTES + KC_FILE_HMAC_KEY_BYTES + KC_FILE_IV_BYTES];
+    size_t okm_len = aes_key_len + KC_FILE_HMAC_KEY_BYTES + KC_FILE_IV_BYTES;
+    int rc = hkdf_ctx_expand(&kc->kdf, info, HDR + file_id_len, okm, okm_len);
+
+    if (info != info_buf) free(info);
+    if (rc != CRYPTO_OK) return rc;
+
+    memset(out, 0, sizeof(*out));
+    out->aes_key_len = aes_key_len;
+    memcpy(out->aes_key, okm, aes_key_len);
+    memcpy(out->hmac_key, okm + aes_key_len, KC_FILE_HMAC_KEY_BYTES);
+    memcpy(out->iv, okm + aes_key_len + KC_FILE_HMAC_KEY_BYTES, KC_FILE_IV_BYTES);
+    memset(okm, 0, sizeof(okm));
+    return CRYPTO_OK;
 }
 
 void key_context_clear(key_context_t* kc)
@@ -0,0 +1,184 @@
+﻿#include "crypto/key/pbkdf2.h"
+#include "crypto/hash/hmac.h"
+#include "crypto/core/crypto_thread.h"
+#include "crypto/bytes.h"
+#include "crypto/status.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// PBKDF2 반복 블록 한 개의 길이(비트): (K ⊕ pad) 128바이트 + 메시지 64바이트
+#define PBKDF2_PADDED_MSG_BITS ((SHA512_BLOCK_SIZE + SHA512_DIGEST_LENGTH) * 8)
+
+// 64바이트 메시지를 SHA-512 한 블록으로 패딩한 템플릿을 준비한다.
+// 앞 64바이트는 매 반복마다 덮어쓰고, 0x80과 길이 필드는 그대로 재사용한다.
+static void pbkdf2_prepare_block(unsigned char block[SHA512_BLOCK_SIZE])
+{
+    memset(block, 0, SHA512_BLOCK_SIZE);
+    block[SHA512_DIGEST_LENGTH] = 0x80;
+    store_be64(block + 112, 0);
+    store_be64(block + 120, PBKDF2_PADDED_MSG_BITS);
+}
+
+// HMAC(P, 64바이트 메시지) 1회: 미드스테이트에서 시작해 내부/외부 각각 압축 1회
+static void pbkdf2_hmac_iterate(const hmac_key_t* k,
+    unsigned char block[SHA512_BLOCK_SIZE],
+    uint64_t U[SHA_WORD_NUMBER])
+{
+    uint64_t H[SHA_WORD_NUMBER];
+
+    // 내부 해시: H((K ⊕ ipad) || U_{j-1})
+    for (int i = 0; i < SHA_WORD_NUMBER; i++) store_be64(block + 8 * i, U[i]);
+    memcpy(H, k->inner, sizeof(H));
+    sha512_compress_block(H, block);
+
+    // 외부 해시: H((K ⊕ opad) || inner)
+    for (int i = 0; i < SHA_WORD_NUMBER; i++) store_be64(block + 8 * i, H[i]);
+    memcpy(U, k->outer, sizeof(H));
+    sha512_compress_block(U, block);
+}
+
+// 출력 블록 T_index (1부터 시작) 계산
+static void pbkdf2_block(const hmac_key_t* k,
+    const uint8_t* salt, size_t salt_len,
+    uint32_t iterations,
+    uint32_t index,
+    uint8_t out[PBKDF2_SHA512_BLOCK_BYTES])
+{
+    unsigned char block[SHA512_BLOCK_SIZE];
+    unsigned char u_bytes[SHA512_DIGEST_LENGTH];
+    unsigned char be_index[4];
+    uint64_t U[SHA_WORD_NUMBER];
+    uint64_t T[SHA_WORD_NUMBER];
+
+    // U_1 = HMAC(P, S || INT(i)) : 일반 경로 (salt 길이가 가변)
+    hmac_ctx c;
+    store_be32(be_index, index);
+    hmac_start_from_key(&c, k);
+    hmac_update(&c, salt, salt_len);
+    hmac_update(&c, be_index, sizeof(be_index));
+    hmac_final(&c, u_bytes);
+
+    for (int i = 0; i < SHA_WORD_NUMBER; i++) {
+        U[i] = load_be64(u_bytes + 8 * i);
+        T[i] = U[i];
+    }
+
+    // U_j = HMAC(P, U_{j-1}), T ^= U_j : 워드 단위로 유지해 바이트 변환을 최소화
+    pbkdf2_prepare_block(block);
+    for (uint32_t j = 1; j < iterations; j++) {
+        pbkdf2_hmac_iterate(k, block, U);
+        for (int i = 0; i < SHA_WORD_NUMBER; i++) T[i] ^= U[i];
+    }
+
+    for (int i = 0; i < SHA_WORD_NUMBER; i++) store_be64(out + 8 * i, T[i]);
+
+    memset(block, 0, sizeof(block));
+    memset(u_bytes, 0, sizeof(u_bytes));
+    memset(U, 0, sizeof(U));
+    memset(T, 0, sizeof(T));
+    memset(&c, 0, sizeof(c));
+}
+
+// 스레드 하나가 맡는 블록: first, first + stride, first + 2*stride, ...
+typedef struct pbkdf2_job_t {
+    const hmac_key_t* key;
+    const uint8_t* salt;
+    size_t salt_len;
+    uint32_t iterations;
+    uint32_t first;        // 0 기반 블록 번호
+    uint32_t n_blocks;     // 전체 블록 수
+    uint32_t stride;       // 스레드 수 (블록을 번갈아 분배)
+    uint8_t* blocks;       // 전체 블록 출력 버퍼
+} pbkdf2_job_t;
+
+static void pbkdf2_worker(void* arg)
+{
+    pbkdf2_job_t* job = (pbkdf2_job_t*)arg;
+    for (uint32_t b = job->first; b < job->n_blocks; b += job->stride) {
+        pbkdf2_block(job->key, job->salt, job->salt_len, job->iterations,
+            b + 1, job->blocks + (size_t)b * PBKDF2_SHA512_BLOCK_BYTES);
+    }
+}
+
+int pbkdf2_hmac_sha512_ex(const uint8_t* pass, size_t pass_len,
+    const uint8_t* salt, size_t salt_len,
+    uint32_t iterations,
+    uint8_t* out, size_t out_len,
+    unsigned int max_threads)
+{
+    if ((!pass && pass_len > 0) || (!salt && salt_len > 0) || !out) return CRYPTO_ERR_NULL;
+    if (iterations == 0 || out_len == 0) return CRYPTO_ERR_INVALID;
+
+    // 블록 번호는 32비트 (RFC 8018: dkLen <= (2^32 - 1) * hLen)
+    size_t n_blocks = (out_len + PBKDF2_SHA512_BLOCK_BYTES - 1) / PBKDF2_SHA512_BLOCK_BYTES;
+    if (n_blocks > 0xFFFFFFFFu) return CRYPTO_ERR_INVALID;
+
+    static const uint8_t empty = 0;
+    hmac_key_t k;
+    hmac_key_init(&k, pass ? pass : &empty, pass_len);
+    if (!salt) salt = &empty;
+
+    uint8_t* blocks = (uint8_t*)malloc(n_blocks * PBKDF2_SHA512_BLOCK_BYTES);
+    if (!blocks) {
+        hmac_key_clear(&k);
+        return CRYPTO_ERR_MEMORY;
+    }
+
+    unsigned int threads = max_threads ? max_threads : crypto_cpu_count();
+    if (threads > n_blocks) threads = (unsigned int)n_blocks;
+    if (threads < 1) threads = 1;
+
+    pbkdf2_job_t* jobs = NULL;
+    crypto_thread_t* handles = NULL;
+    if (threads > 1) {
+        jobs = (pbkdf2_job_t*)calloc(threads, sizeof(pbkdf2_job_t));
+        handles = (crypto_thread_t*)calloc(threads, sizeof(crypto_thread_t));
+        if (!jobs || !handles) {
+            // 메모리가 부족하면 단일 스레드로 계산
+            free(jobs);
+            free(handles);
+            jobs = NULL;
+            handles = NULL;
+            threads = 1;
+        }
+    }
+
+    if (threads == 1) {
+        pbkdf2_job_t job = { &k, salt, salt_len, iterations, 0, (uint32_t)n_blocks, 1, blocks };
+        pbkdf2_worker(&job);
+    }
+    else {
+        for (unsigned int t = 0; t < threads; t++) {
+            pbkdf2_job_t job = { &k, salt, salt_len, iterations, t, (uint32_t)n_blocks, threads, blocks };
+            jobs[t] = job;
+        }
+        // 스레드 생성에 실패한 몫은 현재 스레드가 직접 계산
+        for (unsigned int t = 1; t < threads; t++) {
+            if (crypto_thread_start(&handles[t], pbkdf2_worker, &jobs[t]) != 0) {
+                pbkdf2_worker(&jobs[t]);
+            }
+        }
+        pbkdf2_worker(&jobs[0]);
+        for (unsigned int t = 1; t < threads; t++) {
+            crypto_thread_join(&handles[t]);
+        }
+        free(jobs);
+        free(handles);
+    }
+
+    memcpy(out, blocks, out_len);
+    memset(blocks, 0, n_blocks * PBKDF2_SHA512_BLOCK_BYTES);
+    free(blocks);
+    hmac_key_clear(&k);
+    return CRYPTO_OK;
+}
+
+int pbkdf2_hmac_sha512(const uint8_t* pass, size_t pass_len,
+    const uint8_t* salt, size_t salt_len,
+    uint32_t iterations,
+    uint8_t* out, size_t out_len)
+{
+    return pbkdf2_hmac_sha512_ex(pass, pass_len, salt, salt_len,
+        iterations, out, out_len, 0);
+}
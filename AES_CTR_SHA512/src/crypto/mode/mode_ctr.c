@@ -34,11 +34,13 @@ ctr_mode_ctx_t* ctr_mode_init(const blockcipher_vtable_t* engine,
     }
 
     memcpy(ctx->counter, iv, CTR_BLOCK_BYTES);
+    ctx->ks_pos = CTR_BLOCK_BYTES;
     return ctx;
 }
 
 // CTR update: keystream을 생성해 입력과 XOR하여 암/복호화한다.
 // in/out이 같은 버퍼여도 안전하며 len은 바이트 단위다.
+// 이전 호출에서 쓰고 남은 keystream부터 사용하므로 호출 경계가 블록과 맞지 않아도 된다.
 void ctr_mode_update(ctr_mode_ctx_t* ctx,
     const unsigned char* in,
     unsigned char* out,
@@ -47,26 +49,49 @@ void ctr_mode_update(ctr_mode_ctx_t* ctx,
     if (!ctx || !ctx->bc || !in || !out || len <= 0) return;
     if (!ctx->bc->vtable || !ctx->bc->vtable->encrypt_block || !ctx->bc->ctx) return;
 
-    unsigned char ks[CTR_BLOCK_BYTES]; // keystream 블록
     int offset = 0;
 
+    // 0) 지난 호출에서 남은 keystream 소진
+    while (offset < len && ctx->ks_pos < CTR_BLOCK_BYTES) {
+        out[offset] = in[offset] ^ ctx->keystream[ctx->ks_pos++];
+        offset++;
+    }
+
     while (offset < len) {
         // 1) 카운터를 암호화해 keystream 생성
-        ctx->bc->vtable->encrypt_block(ctx->bc->ctx, ctx->counter, ks);
+        ctx->bc->vtable->encrypt_block(ctx->bc->ctx, ctx->counter, ctx->keystream);
 
         // 2) 입력과 XOR
         int chunk = (len - offset >= CTR_BLOCK_BYTES) ? CTR_BLOCK_BYTES : (len - offset);
         for (int i = 0; i < chunk; i++) {
-            out[offset + i] = in[offset + i] ^ ks[i];
+            out[offset + i] = in[offset + i] ^ ctx->keystream[i];
         }
 
         offset += chunk;
+        ctx->ks_pos = chunk;   // 블록을 다 쓰지 못했으면 다음 호출에서 이어서 사용
 
         // 3) 카운터 증가
         ctr_increment(ctx->counter);
     }
 }
 
+// 카운터 = iv + block_index. 하위 바이트부터 더하며 자리올림을 전파한다.
+void ctr_mode_seek(ctr_mode_ctx_t* ctx,
+    const unsigned char iv[CTR_BLOCK_BYTES],
+    uint64_t block_index)
+{
+    if (!ctx || !iv) return;
+
+    unsigned int carry = 0;
+    for (int i = CTR_BLOCK_BYTES - 1; i >= 0; i--) {
+        unsigned int sum = (unsigned int)iv[i] + (unsigned int)(block_index & 0xFF) + carry;
+        ctx->counter[i] = (unsigned char)sum;
+        carry = sum >> 8;
+        block_index >>= 8;
+    }
+    ctx->ks_pos = CTR_BLOCK_BYTES;
+}
+
 // CTR 컨텍스트를 정리하고 내용을 지운다.
 void ctr_mode_free(ctr_mode_ctx_t* ctx)
 {
@@ -0,0 +1,333 @@
+﻿#include "crypto/stream/crypto_stream.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "crypto/status.h"
+
+#define CRYPTO_STREAM_DEFAULT_BUF (64u * 1024)
+
+// ctr_mode_update는 int 길이를 받으므로 큰 조각은 블록 배수 단위로 나눈다
+#define CRYPTO_STREAM_CTR_CHUNK (1u << 30)
+
+static crypto_stream_t* stream_alloc(int kind)
+{
+    crypto_stream_t* s = (crypto_stream_t*)calloc(1, sizeof(crypto_stream_t));
+    if (s) s->kind = kind;
+    return s;
+}
+
+crypto_stream_t* crypto_stream_ctr_new(const blockcipher_vtable_t* engine,
+    const unsigned char* key,
+    int key_len,
+    const unsigned char iv[CTR_BLOCK_BYTES])
+{
+    crypto_stream_t* s = stream_alloc(CRYPTO_STREAM_CTR);
+    if (!s) return NULL;
+
+    s->ctr = ctr_mode_init(engine, key, key_len, iv);
+    if (!s->ctr) {
+        free(s);
+        return NULL;
+    }
+    return s;
+}
+
+crypto_stream_t* crypto_stream_ctr_hmac_new(const blockcipher_vtable_t* engine,
+    const unsigned char* key,
+    int key_len,
+    const unsigned char iv[CTR_BLOCK_BYTES],
+    const unsigned char* hmac_key,
+    size_t hmac_key_len,
+    int encrypt)
+{
+    if (!hmac_key) return NULL;
+
+    crypto_stream_t* s = crypto_stream_ctr_new(engine, key, key_len, iv);
+    if (!s) return NULL;
+
+    s->kind = CRYPTO_STREAM_CTR_HMAC;
+    s->encrypt = encrypt ? 1 : 0;
+    hmac_init(&s->hmac, hmac_key, hmac_key_len);
+    hmac_update(&s->hmac, iv, CTR_BLOCK_BYTES);   // MAC 대상: IV || CT
+    return s;
+}
+
+crypto_stream_t* crypto_stream_sha512_new(void)
+{
+    crypto_stream_t* s = stream_alloc(CRYPTO_STREAM_SHA512);
+    if (s) sha512_init(&s->sha);
+    return s;
+}
+
+crypto_stream_t* crypto_stream_hmac_new(const unsigned char* key, size_t key_len)
+{
+    if (!key) return NULL;
+
+    crypto_stream_t* s = stream_alloc(CRYPTO_STREAM_HMAC);
+    if (s) hmac_init(&s->hmac, key, key_len);
+    return s;
+}
+
+static void stream_ctr(ctr_mode_ctx_t* ctr, const unsigned char* in, size_t len, unsigned char* out)
+{
+    while (len > 0) {
+        size_t n = len > CRYPTO_STREAM_CTR_CHUNK ? CRYPTO_STREAM_CTR_CHUNK : len;
+        ctr_mode_update(ctr, in, out, (int)n);
+        in += n;
+        out += n;
+        len -= n;
+    }
+}
+
+crypto_stream_t* crypto_stream_ctr_hmac_open_new(const blockcipher_vtable_t* engine,
+    const unsigned char* key,
+    int key_len,
+    const unsigned char* hmac_key,
+    size_t hmac_key_len)
+{
+    // IV는 입력에서 읽으므로 0 블록으로 초기화한 뒤 IV가 모이면 ctr_mode_seek
+    static const unsigned char zero_iv[CTR_BLOCK_BYTES] = { 0 };
+
+    crypto_stream_t* s = crypto_stream_ctr_new(engine, key, key_len, zero_iv);
+    if (!s) return NULL;
+
+    s->kind = CRYPTO_STREAM_CTR_HMAC_OPEN;
+    if (hmac_key) {
+        s->tag_len = SHA512_DIGEST_LENGTH;
+        hmac_init(&s->hmac, hmac_key, hmac_key_len);
+    }
+    return s;
+}
+
+int crypto_stream_update(crypto_stream_t* s,
+    const unsigned char* in,
+    size_t len,
+    unsigned char* out)
+{
+    if (!s) return CRYPTO_ERR_NULL;
+    if (s->finished) return CRYPTO_ERR_STATE;
+    if (len == 0) return CRYPTO_OK;
+    if (!in) return CRYPTO_ERR_NULL;
+
+    switch (s->kind) {
+    case CRYPTO_STREAM_CTR:
+        if (!out) return CRYPTO_ERR_NULL;
+        stream_ctr(s->ctr, in, len, out);
+        break;
+    case CRYPTO_STREAM_CTR_HMAC:
+        if (!out) return CRYPTO_ERR_NULL;
+        // 복호화는 in == out일 수 있으므로 변환 전에 암호문을 MAC
+        if (!s->encrypt) hmac_update(&s->hmac, in, len);
+        stream_ctr(s->ctr, in, len, out);
+        if (s->encrypt) hmac_update(&s->hmac, out, len);
+        break;
+    case CRYPTO_STREAM_SHA512:
+        sha512_update(&s->sha, in, len);
+        break;
+    case CRYPTO_STREAM_HMAC:
+        hmac_update(&s->hmac, in, len);
+        break;
+    default:    // CTR_HMAC_OPEN은 crypto_stream_open_update 사용
+        return CRYPTO_ERR_STATE;
+    }
+    s->total += len;
+    return CRYPTO_OK;
+}
+
+int crypto_stream_final(crypto_stream_t* s, unsigned char tag[SHA512_DIGEST_LENGTH])
+{
+    if (!s) return CRYPTO_ERR_NULL;
+    if (s->finished) return CRYPTO_ERR_STATE;
+    if (s->kind == CRYPTO_STREAM_CTR_HMAC_OPEN) return CRYPTO_ERR_STATE;
+    if (s->kind != CRYPTO_STREAM_CTR && !tag) return CRYPTO_ERR_NULL;
+
+    if (s->kind == CRYPTO_STREAM_SHA512) sha512_final(&s->sha, tag);
+    else if (s->kind != CRYPTO_STREAM_CTR) hmac_final(&s->hmac, tag);
+    s->finished = 1;
+    return CRYPTO_OK;
+}
+
+// 태그가 아님이 확정된 암호문: MAC 후 복호화
+static void open_release(crypto_stream_t* s, const unsigned char* ct, size_t len, unsigned char* out)
+{
+    if (len == 0) return;
+    if (s->tag_len) hmac_update(&s->hmac, ct, len);
+    stream_ctr(s->ctr, ct, len, out);
+}
+
+int crypto_stream_open_update(crypto_stream_t* s,
+    const unsigned char* in,
+    size_t len,
+    unsigned char* out,
+    size_t* out_len)
+{
+    if (!s || !out_len) return CRYPTO_ERR_NULL;
+    *out_len = 0;
+    if (s->kind != CRYPTO_STREAM_CTR_HMAC_OPEN || s->finished) return CRYPTO_ERR_STATE;
+    if (len == 0) return CRYPTO_OK;
+    if (!in || !out) return CRYPTO_ERR_NULL;
+    s->total += len;
+
+    // 1) 앞 16바이트: IV
+    if (s->iv_len < CTR_BLOCK_BYTES) {
+        size_t n = CTR_BLOCK_BYTES - s->iv_len;
+        if (n > len) n = len;
+        memcpy(s->iv + s->iv_len, in, n);
+        s->iv_len += n;
+        in += n;
+        len -= n;
+        if (s->iv_len < CTR_BLOCK_BYTES) return CRYPTO_OK;
+
+        ctr_mode_seek(s->ctr, s->iv, 0);
+        if (s->tag_len) hmac_update(&s->hmac, s->iv, CTR_BLOCK_BYTES);
+    }
+
+    // 2) 보류분 + 새 입력 중 마지막 tag_len바이트를 빼고 내보낸다
+    size_t avail = s->tail_len + len;
+    if (avail <= s->tag_len) {
+        memcpy(s->tail + s->tail_len, in, len);
+        s->tail_len += len;
+        return CRYPTO_OK;
+    }
+
+    size_t release = avail - s->tag_len;
+    size_t from_tail = release < s->tail_len ? release : s->tail_len;
+    size_t from_in = release - from_tail;
+
+    open_release(s, s->tail, from_tail, out);
+    open_release(s, in, from_in, out + from_tail);
+
+    // 남은 보류분 앞으로 당기고 새 입력의 나머지를 붙인다 (합계 tag_len)
+    memmove(s->tail, s->tail + from_tail, s->tail_len - from_tail);
+    s->tail_len -= from_tail;
+    memcpy(s->tail + s->tail_len, in + from_in, len - from_in);
+    s->tail_len += len - from_in;
+
+    *out_len = release;
+    return CRYPTO_OK;
+}
+
+int crypto_stream_open_final(crypto_stream_t* s)
+{
+    if (!s) return CRYPTO_ERR_NULL;
+    if (s->kind != CRYPTO_STREAM_CTR_HMAC_OPEN || s->finished) return CRYPTO_ERR_STATE;
+    s->finished = 1;
+
+    if (s->iv_len < CTR_BLOCK_BYTES || s->tail_len < s->tag_len) return CRYPTO_ERR_INVALID;
+    if (s->tag_len == 0) return CRYPTO_OK;
+
+    unsigned char mac[SHA512_DIGEST_LENGTH];
+    hmac_final(&s->hmac, mac);
+
+    // 일치 여부와 관계없이 전체를 비교 (상수 시간)
+    unsigned char diff = 0;
+    for (size_t i = 0; i < SHA512_DIGEST_LENGTH; i++) diff |= (unsigned char)(mac[i] ^ s->tail[i]);
+    memset(mac, 0, sizeof(mac));
+    return diff == 0 ? CRYPTO_OK : CRYPTO_ERR_AUTH;
+}
+
+void crypto_stream_free(crypto_stream_t* s)
+{
+    if (!s) return;
+    if (s->ctr) ctr_mode_free(s->ctr);
+    memset(s, 0, sizeof(*s));
+    free(s);
+}
+
+int crypto_stream_pump(crypto_stream_t* s,
+    crypto_stream_read_fn read_fn,
+    void* read_ctx,
+    crypto_stream_write_fn write_fn,
+    void* write_ctx,
+    size_t buf_size)
+{
+    if (!s || !read_fn) return CRYPTO_ERR_NULL;
+    int has_output = (s->kind == CRYPTO_STREAM_CTR || s->kind == CRYPTO_STREAM_CTR_HMAC);
+    if (has_output && !write_fn) return CRYPTO_ERR_NULL;
+    if (buf_size == 0) buf_size = CRYPTO_STREAM_DEFAULT_BUF;
+
+    unsigned char* buf = (unsigned char*)malloc(buf_size);
+    if (!buf) return CRYPTO_ERR_MEMORY;
+
+    int rc = CRYPTO_OK;
+    for (;;) {
+        long long n = read_fn(read_ctx, buf, buf_size);
+        if (n < 0 || (unsigned long long)n > buf_size) {
+            rc = CRYPTO_ERR_IO;
+            break;
+        }
+        if (n == 0) break;
+
+        rc = crypto_stream_update(s, buf, (size_t)n, buf);
+        if (rc != CRYPTO_OK) break;
+        if (write_fn && write_fn(write_ctx, buf, (size_t)n) != 0) {
+            rc = CRYPTO_ERR_IO;
+            break;
+        }
+    }
+
+    memset(buf, 0, buf_size);
+    free(buf);
+    return rc;
+}
+
+int crypto_stream_open_pump(crypto_stream_t* s,
+    crypto_stream_read_fn read_fn,
+    void* read_ctx,
+    crypto_stream_write_fn write_fn,
+    void* write_ctx,
+    size_t buf_size)
+{
+    if (!s || !read_fn || !write_fn) return CRYPTO_ERR_NULL;
+    if (s->kind != CRYPTO_STREAM_CTR_HMAC_OPEN) return CRYPTO_ERR_STATE;
+    if (buf_size == 0) buf_size = CRYPTO_STREAM_DEFAULT_BUF;
+
+    // 보류분이 있어 in을 제자리로 쓸 수 없으므로 출력 버퍼를 따로 둔다
+    unsigned char* in = (unsigned char*)malloc(buf_size);
+    unsigned char* out = (unsigned char*)malloc(buf_size);
+    if (!in || !out) {
+        free(in);
+        free(out);
+        return CRYPTO_ERR_MEMORY;
+    }
+
+    int rc = CRYPTO_OK;
+    for (;;) {
+        long long n = read_fn(read_ctx, in, buf_size);
+        if (n < 0 || (unsigned long long)n > buf_size) {
+            rc = CRYPTO_ERR_IO;
+            break;
+        }
+        if (n == 0) break;
+
+        size_t produced = 0;
+        rc = crypto_stream_open_update(s, in, (size_t)n, out, &produced);
+        if (rc != CRYPTO_OK) break;
+        if (produced > 0 && write_fn(write_ctx, out, produced) != 0) {
+            rc = CRYPTO_ERR_IO;
+            break;
+        }
+    }
+    if (rc == CRYPTO_OK) rc = crypto_stream_open_final(s);
+
+    memset(out, 0, buf_size);
+    free(in);
+    free(out);
+    return rc;
+}
+
+long long crypto_stream_file_read(void* ctx, unsigned char* buf, size_t cap)
+{
+    FILE* f = (FILE*)ctx;
+    size_t n = fread(buf, 1, cap, f);
+    if (n == 0 && ferror(f)) return -1;
+    return (long long)n;
+}
+
+int crypto_stream_file_write(void* ctx, const unsigned char* buf, size_t len)
+{
+    FILE* f = (FILE*)ctx;
+    return fwrite(buf, 1, len, f) == len ? 0 : -1;
+}
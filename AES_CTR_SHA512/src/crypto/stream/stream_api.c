@@ -2,7 +2,17 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "crypto/hash/hmac.h"
+#include "crypto/bytes.h"
+#include "crypto/status.h"
+#include "crypto/stream/stream_map.h"
+#include "crypto/stream/stream_pipeline.h"
+#include "crypto/stream/stream_uring.h"
+#include "crypto/stream/stream_direct.h"
+#include "crypto/stream/stream_fileutil.h"
+#include "crypto/stream/crypto_stream.h"
+#include "crypto/core/crypto_thread.h"
 
 #ifndef CTR_BLOCK_BYTES
 #define CTR_BLOCK_BYTES 16
@@ -12,8 +22,25 @@
 #include <windows.h>
 #endif
 
-// 스트림 I/O용 버퍼 크기 (1MB). 큰 파일도 일정 크기씩 잘라 처리한다.
-#define STREAM_BUF_SIZE (1u << 20)
+// 스트림 I/O용 기본 버퍼 크기 (1MB). 큰 파일도 일정 크기씩 잘라 처리한다.
+// (stream_options_t.buf_size로 바꿀 수 있음)
+#define STREAM_BUF_SIZE STREAM_DEFAULT_BUF_SIZE
+
+// 매핑 모드에서 ctr_mode_update(int len)에 넘기는 최대 길이.
+// 블록 크기의 배수여야 호출 경계에서 keystream이 어긋나지 않는다.
+#define STREAM_MMAP_CHUNK (1u << 30)
+
+static int stream_io_mode(const stream_options_t* opt)
+{
+    return opt ? opt->io_mode : STREAM_IO_STDIO;
+}
+
+void stream_options_init(stream_options_t* opt)
+{
+    if (!opt) return;
+    memset(opt, 0, sizeof(*opt));
+    opt->io_mode = STREAM_IO_STDIO;
+}
 
 // 안전한 free 헬퍼 (Windows에서 힙이 손상된 경우 크래시 방지)
 static void safe_free(void* ptr) {
@@ -30,22 +57,350 @@ static void safe_free(void* ptr) {
 #endif
 }
 
-// 파일 단위 AES-CTR 암호화/복호화 공통 처리
-static int ctr_process_file(const blockcipher_vtable_t* engine,
-                            const char* in_path,
+// -------------------------------------------------------------------
+// 버퍼 크기 결정
+//  - 고정 모드: opt->buf_size (없으면 STREAM_BUF_SIZE)
+//  - 적응 모드(stdio 경로): STREAM_ADAPTIVE_MIN_BUF에서 시작해 같은 크기로 두 번 처리할 때마다
+//    (읽기 + 연산) 처리량을 재고, 직전 크기보다 10% 이상 빨라졌으면 두 배로 키운다.
+//    더 이상 빨라지지 않거나 최대 크기에 닿으면 고정한다.
+//  - 어느 모드든 파일보다 큰 버퍼는 잡지 않는다 (작은 파일의 불필요한 할당 방지)
+//  - 크기는 항상 CTR 블록(16)과 정렬 단위의 배수 → 버퍼 경계에서 카운터가 이어진다
+// -------------------------------------------------------------------
+static size_t stream_round_up(size_t v, size_t unit)
+{
+    return (v + unit - 1) / unit * unit;
+}
+
+static size_t stream_alignment(const stream_options_t* opt)
+{
+    size_t a = (opt && opt->alignment) ? opt->alignment : STREAM_PIPELINE_DEFAULT_ALIGNMENT;
+    return a < CTR_BLOCK_BYTES ? CTR_BLOCK_BYTES : a;
+}
+
+// 직접 I/O 정렬: 옵션 정렬과 섹터 정렬 중 큰 값
+static size_t stream_direct_alignment(const stream_options_t* opt)
+{
+    size_t a = stream_alignment(opt);
+    return a < STREAM_DIRECT_ALIGNMENT ? STREAM_DIRECT_ALIGNMENT : a;
+}
+
+// 파일보다 큰 버퍼는 잡지 않는다 (file_size < 0 이면 크기 모름)
+static size_t stream_cap_to_file(size_t n, long long file_size)
+{
+    if (file_size >= 0 && (unsigned long long)file_size < n) {
+        n = stream_round_up((size_t)file_size, CTR_BLOCK_BYTES);
+        if (n == 0) n = CTR_BLOCK_BYTES;
+    }
+    return n;
+}
+
+// 고정 크기 (파이프라인 / io_uring / 직접 I/O / 적응 모드가 아닌 stdio)
+static size_t stream_fixed_buf_size(const stream_options_t* opt, long long file_size)
+{
+    size_t n = (opt && opt->buf_size) ? opt->buf_size : STREAM_BUF_SIZE;
+    if (n > STREAM_MAX_BUF) n = STREAM_MAX_BUF;
+    return stream_cap_to_file(stream_round_up(n, CTR_BLOCK_BYTES), file_size);
+}
+
+// 적응 모드에서 키울 수 있는 최대 크기
+static size_t stream_adaptive_max(const stream_options_t* opt, long long file_size)
+{
+    size_t n = (opt && opt->buf_size) ? opt->buf_size : STREAM_ADAPTIVE_MAX_BUF;
+    if (n > STREAM_MAX_BUF) n = STREAM_MAX_BUF;
+    return stream_cap_to_file(stream_round_up(n, CTR_BLOCK_BYTES), file_size);
+}
+
+size_t stream_effective_buf_size(const stream_options_t* opt, long long file_size)
+{
+    if (!opt || !opt->adaptive) return stream_fixed_buf_size(opt, file_size);
+
+    size_t max = stream_adaptive_max(opt, file_size);
+    return stream_cap_to_file(STREAM_ADAPTIVE_MIN_BUF < max ? STREAM_ADAPTIVE_MIN_BUF : max, file_size);
+}
+
+typedef struct stream_sizer_t {
+    size_t cur;          // 이번 읽기 크기
+    size_t max;          // 키울 수 있는 최대 크기
+    int adaptive;        // 0이면 cur 고정
+    unsigned int rounds; // 현재 크기로 처리한 횟수
+    uint64_t bytes;      // 현재 크기로 처리한 바이트
+    uint64_t ns;         // 현재 크기로 걸린 시간
+    double prev_rate;    // 직전 크기의 처리량 (바이트/ns)
+} stream_sizer_t;
+
+static void sizer_init(stream_sizer_t* z, const stream_options_t* opt, long long file_size)
+{
+    memset(z, 0, sizeof(*z));
+    z->cur = stream_effective_buf_size(opt, file_size);
+    z->max = (opt && opt->adaptive) ? stream_adaptive_max(opt, file_size) : z->cur;
+    z->adaptive = (opt && opt->adaptive && z->cur < z->max);
+}
+
+// 한 번 처리한 결과를 기록하고 다음 크기를 정한다
+static void sizer_record(stream_sizer_t* z, size_t n, uint64_t ns)
+{
+    if (!z->adaptive) return;
+    z->bytes += n;
+    z->ns += ns ? ns : 1;
+    if (++z->rounds < 2) return;
+
+    double rate = (double)z->bytes / (double)z->ns;
+    if (z->prev_rate == 0.0 || rate > z->prev_rate * 1.10) {
+        z->prev_rate = rate;
+        z->cur = (z->cur * 2 > z->max) ? z->max : z->cur * 2;
+        if (z->cur >= z->max) z->adaptive = 0;
+    }
+    else {
+        z->adaptive = 0;
+    }
+    z->rounds = 0;
+    z->bytes = 0;
+    z->ns = 0;
+}
+
+// 버퍼를 z->cur 이상으로 확보 (키울 때만 재할당). 실패 시 0
+static int sizer_reserve(const stream_sizer_t* z, unsigned char** buf, size_t* cap)
+{
+    if (*buf && *cap >= z->cur) return 1;
+    unsigned char* nb = (unsigned char*)malloc(z->cur);
+    if (!nb) return 0;
+    safe_free(*buf);
+    *buf = nb;
+    *cap = z->cur;
+    return 1;
+}
+
+// -------------------------------------------------------------------
+// 진행률 / 취소 콜백
+//  - 버퍼 하나를 마칠 때마다 stream_tick (콜백이 없으면 포인터 비교만 하고 반환)
+//  - 취소되면 cancelled = 1, 호출 측은 정리 후 STREAM_CANCELLED 반환
+// -------------------------------------------------------------------
+#define STREAM_CANCELLED (-16)
+
+typedef struct stream_ticker_t {
+    const stream_options_t* opt;    // 콜백이 없으면 NULL
+    uint64_t total;                 // 전체 입력 크기 (모르면 0)
+    uint64_t done;                  // 지금까지 처리한 입력 바이트
+    int cancelled;
+} stream_ticker_t;
+
+static void ticker_init(stream_ticker_t* t, const stream_options_t* opt, long long total)
+{
+    memset(t, 0, sizeof(*t));
+    if (opt && (opt->progress || opt->cancel)) t->opt = opt;
+    t->total = total > 0 ? (uint64_t)total : 0;
+}
+
+// 입력 n바이트 처리 완료. 반환: 0 계속, 1 취소
+static int stream_tick(stream_ticker_t* t, uint64_t n)
+{
+    t->done += n;
+    if (!t->opt) return 0;
+    if (t->opt->progress) t->opt->progress(t->opt->user, t->done, t->total);
+    if (t->opt->cancel && t->opt->cancel(t->opt->user)) {
+        t->cancelled = 1;
+        return 1;
+    }
+    return 0;
+}
+
+// 파이프라인 done / io_uring 연산 뒤에 붙이는 콜백 (arg = stream_ticker_t*)
+static int stream_tick_fn(void* arg, unsigned int worker,
+                          unsigned char* buf, size_t len, uint64_t offset)
+{
+    (void)worker; (void)buf; (void)offset;
+    return stream_tick((stream_ticker_t*)arg, len);
+}
+
+// 연산 콜백 + 진행률 (io_uring은 제출 스레드가 입력 순서대로 fn을 부르므로 여기서 센다)
+typedef struct stream_chain_arg_t {
+    stream_pipeline_fn fn;
+    void* arg;
+    stream_ticker_t* ticker;
+} stream_chain_arg_t;
+
+static int stream_chain_fn(void* arg, unsigned int worker,
+                           unsigned char* buf, size_t len, uint64_t offset)
+{
+    stream_chain_arg_t* c = (stream_chain_arg_t*)arg;
+    int rc = c->fn(c->arg, worker, buf, len, offset);
+    if (rc != 0) return rc;
+    return stream_tick(c->ticker, len);
+}
+
+// crypto_stream_pump용 읽기 어댑터: 읽은 만큼 진행률을 알리고 취소되면 읽기 실패로 멈춘다
+typedef struct stream_ticked_file_t {
+    FILE* f;
+    stream_ticker_t* ticker;
+    uint64_t pending;   // 직전에 읽어 준 바이트 (다음 읽기 시점에 처리 완료로 간주)
+} stream_ticked_file_t;
+
+static long long stream_ticked_read(void* ctx, unsigned char* buf, size_t cap)
+{
+    stream_ticked_file_t* tf = (stream_ticked_file_t*)ctx;
+    if (tf->pending && stream_tick(tf->ticker, tf->pending)) return -1;
+    long long n = crypto_stream_file_read(tf->f, buf, cap);
+    tf->pending = n > 0 ? (uint64_t)n : 0;
+    return n;
+}
+
+// -------------------------------------------------------------------
+// 작은 파일 빠른 경로
+//  - 본문이 STREAM_SMALL_FILE_MAX 이하이고 버퍼 하나에 들어가면 파일을 통째로 읽어
+//    메모리에서 CTR/HMAC 처리 후 결과를 fwrite 한 번으로 기록한다
+//    (큰 버퍼 malloc, 버퍼 루프, crypto_stream 할당이 작은 파일에서는 처리 시간 대부분)
+//  - 버퍼는 정적 슬롯 풀에서 빌리고 (모두 사용 중이면 malloc) 돌려줄 때 지운다
+// -------------------------------------------------------------------
+#define STREAM_SMALL_SLOT_BYTES (CTR_BLOCK_BYTES + STREAM_SMALL_FILE_MAX + SHA512_DIGEST_LENGTH)
+#define STREAM_SMALL_POOL_SLOTS 4
+
+static unsigned char g_small_pool[STREAM_SMALL_POOL_SLOTS][STREAM_SMALL_SLOT_BYTES];
+static crypto_atomic_t g_small_busy[STREAM_SMALL_POOL_SLOTS];
+
+static unsigned char* small_buf_get(void)
+{
+    for (int i = 0; i < STREAM_SMALL_POOL_SLOTS; i++)
+        if (crypto_atomic_cas(&g_small_busy[i], 0, 1)) return g_small_pool[i];
+    return (unsigned char*)malloc(STREAM_SMALL_SLOT_BYTES);
+}
+
+// 평문/키스트림이 남지 않도록 쓴 만큼 지우고 반납
+static void small_buf_put(unsigned char* buf, size_t used)
+{
+    memset(buf, 0, used);
+    for (int i = 0; i < STREAM_SMALL_POOL_SLOTS; i++) {
+        if (buf == g_small_pool[i]) {
+            crypto_atomic_store(&g_small_busy[i], 0);
+            return;
+        }
+    }
+    free(buf);
+}
+
+// 파일 크기에서 overhead(IV, 태그)를 뺀 본문이 빠른 경로 대상인지 (크기를 모르면 0)
+static int stream_small_file(const stream_options_t* opt, long long file_size, size_t overhead)
+{
+    if (file_size < (long long)overhead) return 0;
+    uint64_t body = (uint64_t)file_size - overhead;
+    return body <= STREAM_SMALL_FILE_MAX && body <= stream_effective_buf_size(opt, -1);
+}
+
+// [IV] || CT [|| HMAC(IV || CT)]를 버퍼 하나에 만들어 한 번에 기록
+//  - with_iv가 0이면 CT만 (stream_encrypt_ctr_file_ex 형식)
+static int small_encrypt(const blockcipher_vtable_t* engine, FILE* fin, FILE* fout, size_t len,
+                         const unsigned char* key, int key_len, const unsigned char iv[CTR_BLOCK_BYTES],
+                         int with_iv, const unsigned char* hmac_key, size_t hmac_key_len,
+                         const stream_options_t* opt)
+{
+    unsigned char* buf = small_buf_get();
+    if (!buf) return -5;
+
+    size_t head = with_iv ? CTR_BLOCK_BYTES : 0;
+    size_t total = head + len;
+    int rc = 0;
+    if (len && fread(buf + head, 1, len, fin) != len) rc = -7;
+
+    ctr_mode_ctx_t* ctx = NULL;
+    if (rc == 0) {
+        ctx = ctr_mode_init(engine, key, key_len, iv);
+        if (!ctx) rc = -4;
+    }
+    if (rc == 0) {
+        if (with_iv) memcpy(buf, iv, CTR_BLOCK_BYTES);
+        if (len) ctr_mode_update(ctx, buf + head, buf + head, (int)len);
+        if (hmac_key) {
+            hmac_sha512(hmac_key, hmac_key_len, buf, total, buf + total);
+            total += SHA512_DIGEST_LENGTH;
+        }
+
+        stream_ticker_t ticker;
+        ticker_init(&ticker, opt, (long long)len);
+        if (stream_tick(&ticker, len)) rc = STREAM_CANCELLED;
+    }
+    if (rc == 0 && fwrite(buf, 1, total, fout) != total) rc = -6;
+
+    if (ctx) ctr_mode_free(ctx);
+    small_buf_put(buf, total);
+    return rc;
+}
+
+// IV || CT [|| HMAC] 전체를 읽어 태그를 먼저 확인한 뒤 복호화해 평문을 한 번에 기록
+static int small_decrypt(const blockcipher_vtable_t* engine, FILE* fin, FILE* fout, size_t size,
+                         const unsigned char* key, int key_len,
+                         const unsigned char* hmac_key, size_t hmac_key_len,
+                         const stream_options_t* opt)
+{
+    unsigned char* buf = small_buf_get();
+    if (!buf) return -5;
+
+    size_t tail = hmac_key ? SHA512_DIGEST_LENGTH : 0;
+    size_t len = size - CTR_BLOCK_BYTES - tail;
+    int rc = 0;
+    if (fread(buf, 1, size, fin) != size) rc = -7;
+
+    if (rc == 0 && hmac_key) {
+        unsigned char expect[SHA512_DIGEST_LENGTH];
+        hmac_sha512(hmac_key, hmac_key_len, buf, CTR_BLOCK_BYTES + len, expect);
+        unsigned char diff = 0;
+        for (size_t i = 0; i < sizeof(expect); i++) diff |= (unsigned char)(expect[i] ^ buf[CTR_BLOCK_BYTES + len + i]);
+        if (diff) rc = -10;
+        memset(expect, 0, sizeof(expect));
+    }
+
+    ctr_mode_ctx_t* ctx = NULL;
+    if (rc == 0) {
+        ctx = ctr_mode_init(engine, key, key_len, buf);
+        if (!ctx) rc = -4;
+    }
+    if (rc == 0) {
+        if (len) ctr_mode_update(ctx, buf + CTR_BLOCK_BYTES, buf + CTR_BLOCK_BYTES, (int)len);
+
+        stream_ticker_t ticker;
+        ticker_init(&ticker, opt, (long long)size);
+        if (stream_tick(&ticker, size)) rc = STREAM_CANCELLED;
+    }
+    if (rc == 0 && len && fwrite(buf + CTR_BLOCK_BYTES, 1, len, fout) != len) rc = -6;
+
+    if (ctx) ctr_mode_free(ctx);
+    small_buf_put(buf, size);
+    return rc;
+}
+
+// 작은 파일 CTR 처리: 호출 측이 연 입력(fin)과 그 크기를 그대로 쓴다 (fin은 여기서 닫음)
+static int ctr_process_file_small(const blockcipher_vtable_t* engine,
+                                  FILE* fin,
+                                  long long file_size,
+                                  const char* out_path,
+                                  const unsigned char* key,
+                                  int key_len,
+                                  const unsigned char iv[CTR_BLOCK_BYTES],
+                                  const stream_options_t* opt)
+{
+    FILE* fout = fopen(out_path, "wb");
+    if (!fout) {
+        fclose(fin);
+        return -3;
+    }
+
+    int rc = small_encrypt(engine, fin, fout, (size_t)file_size, key, key_len, iv, 0, NULL, 0, opt);
+    fclose(fin);
+    if (fclose(fout) != 0 && rc == 0) rc = -6;
+    return rc;
+}
+
+// 파일 단위 AES-CTR 암호화/복호화 공통 처리 (fread/fwrite 경로)
+//  - 버퍼 하나에서 제자리로 처리한다 (CTR은 in == out 허용)
+//  - fin/file_size는 호출 측이 연 입력과 그 크기 (fin은 여기서 닫음)
+static int ctr_process_file_stdio(const blockcipher_vtable_t* engine,
+                            FILE* fin,
+                            long long file_size,
                             const char* out_path,
                             const unsigned char* key,
                             int key_len,
-                            const unsigned char iv[CTR_BLOCK_BYTES])
+                            const unsigned char iv[CTR_BLOCK_BYTES],
+                            const stream_options_t* opt)
 {
-    // 입력/출력 경로, 키, IV 유효성 확인
-    if (!engine || !in_path || !out_path || !key || key_len <= 0 || !iv)
-        return -1;
-
-    // 입력/출력 파일 열기
-    FILE* fin = fopen(in_path, "rb");
-    if (!fin) return -2;
-
+    // 출력 파일 열기
     FILE* fout = fopen(out_path, "wb");
     if (!fout) {
         fclose(fin);
@@ -61,39 +416,46 @@ static int ctr_process_file(const blockcipher_vtable_t* engine,
     }
 
     // 스택이 작은 환경(GUI)에서 스택 오버플로우를 피하기 위해 힙 버퍼를 사용
-    unsigned char* inbuf = (unsigned char*)malloc(STREAM_BUF_SIZE);
-    if (!inbuf) {
+    stream_sizer_t sizer;
+    sizer_init(&sizer, opt, file_size);
+    stream_ticker_t ticker;
+    ticker_init(&ticker, opt, file_size);
+    unsigned char* buf = NULL;
+    size_t cap = 0;
+    if (!sizer_reserve(&sizer, &buf, &cap)) {
         ctr_mode_free(ctx);
         fclose(fin);
         fclose(fout);
         return -5;
     }
 
-    unsigned char* outbuf = (unsigned char*)malloc(STREAM_BUF_SIZE);
-    if (!outbuf) {
-        safe_free(inbuf);
-        ctr_mode_free(ctx);
-        fclose(fin);
-        fclose(fout);
-        return -5;
-    }
+    for (;;) {
+        // 적응 모드에서 크기가 커졌으면 버퍼를 다시 잡는다
+        if (!sizer_reserve(&sizer, &buf, &cap)) {
+            safe_free(buf);
+            ctr_mode_free(ctx);
+            fclose(fin);
+            fclose(fout);
+            return -5;
+        }
+
+        uint64_t t0 = sizer.adaptive ? crypto_now_ns() : 0;
+        size_t n = fread(buf, 1, sizer.cur, fin);
+        if (n == 0) break;
 
-    size_t n;
-    while ((n = fread(inbuf, 1, STREAM_BUF_SIZE, fin)) > 0) {
         // 1) 입력 버퍼 읽기 성공 여부 확인
         if (ferror(fin)) {
-            safe_free(inbuf);
-            safe_free(outbuf);
+            safe_free(buf);
             ctr_mode_free(ctx);
             fclose(fin);
             fclose(fout);
             return -7;
         }
 
-        // 2) 읽은 길이 범위 확인
-        if (n > STREAM_BUF_SIZE) {
-            safe_free(inbuf);
-            safe_free(outbuf);
+        // 2) 읽은 길이 범위 / size_t → int 변환 안전성 확인
+        int n_int = (int)n;
+        if (n > cap || n_int <= 0 || (size_t)n_int != n) {
+            safe_free(buf);
             ctr_mode_free(ctx);
             fclose(fin);
             fclose(fout);
@@ -101,89 +463,353 @@ static int ctr_process_file(const blockcipher_vtable_t* engine,
         }
 
         // 3) CTR 컨텍스트와 vtable 유효성 재확인
-        if (!ctx || !ctx->bc || !ctx->bc->vtable || !ctx->bc->vtable->encrypt_block || !ctx->bc->ctx) {
-            safe_free(inbuf);
-            safe_free(outbuf);
-            if (ctx) ctr_mode_free(ctx);
-            fclose(fin);
-            fclose(fout);
-            return -9;
-        }
-
-        // 4) size_t → int 변환 안전성 체크
-        int n_int = (int)n;
-        if (n_int <= 0 || (size_t)n_int != n) {
-            safe_free(inbuf);
-            safe_free(outbuf);
+        if (!ctx->bc || !ctx->bc->vtable || !ctx->bc->vtable->encrypt_block || !ctx->bc->ctx) {
+            safe_free(buf);
             ctr_mode_free(ctx);
             fclose(fin);
             fclose(fout);
-            return -10;
+            return -9;
         }
 
-        // 5) 버퍼 포인터 NULL 여부 확인
-        if (!inbuf || !outbuf) {
-            safe_free(inbuf);
-            safe_free(outbuf);
-            ctr_mode_free(ctx);
-            fclose(fin);
-            fclose(fout);
-            return -13;
-        }
+        // 4) CTR 암/복호화 수행 (제자리)
+        ctr_mode_update(ctx, buf, buf, n_int);
+        if (sizer.adaptive) sizer_record(&sizer, n, crypto_now_ns() - t0);
 
-        // 6) 처리 길이 범위 확인
-        if (n_int > (int)STREAM_BUF_SIZE) {
-            safe_free(inbuf);
-            safe_free(outbuf);
+        // 5) 출력 파일에 기록
+        if (fwrite(buf, 1, n, fout) != n) {
+            safe_free(buf);
             ctr_mode_free(ctx);
             fclose(fin);
             fclose(fout);
-            return -14;
+            return -6;
         }
 
-        // 7) CTR 암/복호화 수행
-        ctr_mode_update(ctx, inbuf, outbuf, n_int);
-
-        // 8) 출력 파일에 기록
-        if (fwrite(outbuf, 1, n, fout) != n) {
-            safe_free(inbuf);
-            safe_free(outbuf);
+        // 6) fwrite 오류 확인
+        if (ferror(fout)) {
+            safe_free(buf);
             ctr_mode_free(ctx);
             fclose(fin);
             fclose(fout);
-            return -6;
+            return -11;
         }
 
-        // 9) fwrite 오류 확인
-        if (ferror(fout)) {
-            safe_free(inbuf);
-            safe_free(outbuf);
+        // 7) 진행률 / 취소 확인
+        if (stream_tick(&ticker, n)) {
+            safe_free(buf);
             ctr_mode_free(ctx);
             fclose(fin);
             fclose(fout);
-            return -11;
+            return STREAM_CANCELLED;
         }
     }
 
     // 루프 종료 후 fread 에러 확인
     if (ferror(fin)) {
-        safe_free(inbuf);
-        safe_free(outbuf);
+        safe_free(buf);
         ctr_mode_free(ctx);
         fclose(fin);
         fclose(fout);
         return -7;
     }
 
-    // 자원 정리
-    safe_free(inbuf);
-    safe_free(outbuf);
+    // 자원 정리 (버퍼에 남은 출력을 내보내지 못하면 쓰기 실패)
+    safe_free(buf);
     ctr_mode_free(ctx);
     fclose(fin);
-    fclose(fout);
+    if (fclose(fout) != 0) return -6;
     return 0;
 }
 
+// 매핑 경로: 입력 매핑 → 출력 매핑으로 바로 CTR 처리
+// 반환: 0 성공, 1 매핑 불가(호출 측이 stdio 경로로 재시도), 음수 오류
+static int ctr_process_file_mmap(const blockcipher_vtable_t* engine,
+                                 const char* in_path,
+                                 const char* out_path,
+                                 const unsigned char* key,
+                                 int key_len,
+                                 const unsigned char iv[CTR_BLOCK_BYTES],
+                                 const stream_options_t* opt)
+{
+    stream_map_t in_map, out_map;
+    int rc = stream_map_open_read(&in_map, in_path);
+    if (rc == -2) return -2;
+    if (rc != 0) return 1;
+
+    rc = stream_map_create(&out_map, out_path, in_map.size);
+    if (rc != 0) {
+        stream_map_close(&in_map);
+        return (rc == -1) ? 1 : -3;
+    }
+
+    ctr_mode_ctx_t* ctx = ctr_mode_init(engine, key, key_len, iv);
+    if (!ctx) {
+        stream_map_close(&out_map);
+        stream_map_close(&in_map);
+        return -4;
+    }
+
+    // 콜백이 있으면 버퍼 크기 단위로 끊어 진행률/취소를 확인
+    stream_ticker_t ticker;
+    ticker_init(&ticker, opt, (long long)in_map.size);
+    uint64_t step = ticker.opt ? stream_fixed_buf_size(opt, (long long)in_map.size) : STREAM_MMAP_CHUNK;
+
+    uint64_t off = 0;
+    while (off < in_map.size) {
+        uint64_t left = in_map.size - off;
+        int n = (int)(left > step ? step : left);
+        ctr_mode_update(ctx, in_map.data + off, out_map.data + off, n);
+        off += (uint64_t)n;
+        if (stream_tick(&ticker, (uint64_t)n)) break;
+    }
+
+    ctr_mode_free(ctx);
+    rc = stream_map_close(&out_map);
+    stream_map_close(&in_map);
+    if (ticker.cancelled) return STREAM_CANCELLED;
+    return (rc == 0) ? 0 : -6;
+}
+
+// 파이프라인 연산 스레드 수: 읽기/쓰기 스레드 몫으로 CPU 2개를 남긴다
+static unsigned int stream_pipeline_workers(const stream_options_t* opt)
+{
+    unsigned int n = opt ? opt->threads : 0;
+    if (n == 0) {
+        unsigned int cpus = crypto_cpu_count();
+        n = cpus > 2 ? cpus - 2 : 1;
+    }
+    if (n > STREAM_PIPELINE_MAX_WORKERS) n = STREAM_PIPELINE_MAX_WORKERS;
+    return n;
+}
+
+typedef struct ctr_pipeline_arg_t {
+    ctr_mode_ctx_t* ctx[STREAM_PIPELINE_MAX_WORKERS];   // 연산 스레드별 컨텍스트
+    const unsigned char* iv;
+} ctr_pipeline_arg_t;
+
+// 버퍼 오프셋으로 카운터를 맞춘 뒤 제자리 CTR
+static int ctr_pipeline_fn(void* arg, unsigned int worker,
+                           unsigned char* buf, size_t len, uint64_t offset)
+{
+    ctr_pipeline_arg_t* a = (ctr_pipeline_arg_t*)arg;
+    ctr_mode_seek(a->ctx[worker], a->iv, offset / CTR_BLOCK_BYTES);
+    ctr_mode_update(a->ctx[worker], buf, buf, (int)len);
+    return 0;
+}
+
+// 파이프라인 경로: 읽기 / CTR(연산 스레드 N개) / 쓰기를 겹쳐 처리
+static int ctr_process_file_pipeline(const blockcipher_vtable_t* engine,
+                                     const char* in_path,
+                                     const char* out_path,
+                                     const unsigned char* key,
+                                     int key_len,
+                                     const unsigned char iv[CTR_BLOCK_BYTES],
+                                     const stream_options_t* opt)
+{
+    FILE* fin = fopen(in_path, "rb");
+    if (!fin) return -2;
+
+    FILE* fout = fopen(out_path, "wb");
+    if (!fout) {
+        fclose(fin);
+        return -3;
+    }
+
+    ctr_pipeline_arg_t arg;
+    memset(&arg, 0, sizeof(arg));
+    arg.iv = iv;
+
+    unsigned int workers = stream_pipeline_workers(opt);
+    int rc = 0;
+    for (unsigned int i = 0; i < workers; i++) {
+        arg.ctx[i] = ctr_mode_init(engine, key, key_len, iv);
+        if (!arg.ctx[i]) {
+            rc = -4;
+            break;
+        }
+    }
+
+    if (rc == 0) {
+        stream_pipeline_t p;
+        memset(&p, 0, sizeof(p));
+        p.in = fin;
+        p.out = fout;
+        p.buf_size = stream_fixed_buf_size(opt, stream_file_size(fin));   // CTR 블록 크기의 배수
+        p.buf_count = opt ? opt->buf_count : 0;
+        p.alignment = stream_alignment(opt);
+        p.workers = workers;
+        p.fn = ctr_pipeline_fn;
+        p.arg = &arg;
+
+        stream_ticker_t ticker;
+        ticker_init(&ticker, opt, stream_file_size(fin));
+        if (ticker.opt) {
+            p.done = stream_tick_fn;
+            p.done_arg = &ticker;
+        }
+        rc = stream_pipeline_run(&p);
+        if (ticker.cancelled) rc = STREAM_CANCELLED;
+    }
+
+    for (unsigned int i = 0; i < workers; i++) {
+        if (arg.ctx[i]) ctr_mode_free(arg.ctx[i]);
+    }
+    fclose(fin);
+    if (fclose(fout) != 0 && rc == 0) rc = -6;
+    return rc;
+}
+
+// io_uring 경로: 제출 스레드가 순서대로 CTR을 처리하는 동안 다음 읽기/이전 쓰기가 진행
+// 반환: 0 성공, 1 사용 불가, 음수 오류
+static int ctr_process_file_uring(const blockcipher_vtable_t* engine,
+                                  const char* in_path,
+                                  const char* out_path,
+                                  const unsigned char* key,
+                                  int key_len,
+                                  const unsigned char iv[CTR_BLOCK_BYTES],
+                                  const stream_options_t* opt)
+{
+    ctr_pipeline_arg_t arg;
+    memset(&arg, 0, sizeof(arg));
+    arg.iv = iv;
+    arg.ctx[0] = ctr_mode_init(engine, key, key_len, iv);
+    if (!arg.ctx[0]) return -4;
+
+    stream_ticker_t ticker;
+    ticker_init(&ticker, opt, -1);
+    if (ticker.opt) {
+        long long size = stream_path_size(in_path);
+        ticker.total = size > 0 ? (uint64_t)size : 0;
+    }
+    stream_chain_arg_t chain = { ctr_pipeline_fn, &arg, &ticker };
+
+    int rc = stream_uring_process_file(in_path, out_path, stream_fixed_buf_size(opt, -1),
+        opt ? opt->queue_depth : 0, stream_chain_fn, &chain);
+    ctr_mode_free(arg.ctx[0]);
+    if (ticker.cancelled) rc = STREAM_CANCELLED;
+    return rc;
+}
+
+// 직접 I/O 경로: 정렬 버퍼 하나로 읽기 → 제자리 CTR → 정렬 길이 기록, 끝에서 실제 길이로 자름
+static int ctr_process_file_direct(const blockcipher_vtable_t* engine,
+                                   const char* in_path,
+                                   const char* out_path,
+                                   const unsigned char* key,
+                                   int key_len,
+                                   const unsigned char iv[CTR_BLOCK_BYTES],
+                                   const stream_options_t* opt)
+{
+    stream_direct_file_t fin, fout;
+    if (stream_direct_open_read(&fin, in_path) != 0) return -2;
+    if (stream_direct_open_write(&fout, out_path) != 0) {
+        stream_direct_close(&fin, 0);
+        return -3;
+    }
+
+    ctr_mode_ctx_t* ctx = ctr_mode_init(engine, key, key_len, iv);
+    size_t align = stream_direct_alignment(opt);
+    size_t buf_size = stream_round_up(stream_fixed_buf_size(opt, -1), align);
+    unsigned char* buf = (unsigned char*)stream_aligned_alloc(buf_size, align);
+    int rc = !ctx ? -4 : (!buf ? -5 : 0);
+
+    stream_ticker_t ticker;
+    ticker_init(&ticker, opt, -1);
+    if (ticker.opt) {
+        long long size = stream_path_size(in_path);
+        ticker.total = size > 0 ? (uint64_t)size : 0;
+    }
+
+    uint64_t total = 0;
+    while (rc == 0) {
+        long long n = stream_direct_read(&fin, buf, buf_size);
+        if (n < 0) {
+            rc = -7;
+            break;
+        }
+        if (n == 0) break;
+
+        // 가득 찬 버퍼는 블록 배수이므로 한 컨텍스트로 이어서 처리해도 카운터가 맞다
+        ctr_mode_update(ctx, buf, buf, (int)n);
+        if (stream_direct_write(&fout, buf, (size_t)n, buf_size) != 0) rc = -6;
+        total += (uint64_t)n;
+        if (rc == 0 && stream_tick(&ticker, (uint64_t)n)) rc = STREAM_CANCELLED;
+        if ((size_t)n < buf_size) break;
+    }
+
+    stream_aligned_free(buf);
+    if (ctx) ctr_mode_free(ctx);
+    stream_direct_close(&fin, 0);
+    if (stream_direct_close(&fout, total) != 0 && rc == 0) rc = -11;
+    return rc;
+}
+
+static int ctr_process_file(const blockcipher_vtable_t* engine,
+                            const char* in_path,
+                            const char* out_path,
+                            const unsigned char* key,
+                            int key_len,
+                            const unsigned char iv[CTR_BLOCK_BYTES],
+                            const stream_options_t* opt)
+{
+    if (!engine || !in_path || !out_path || !key || key_len <= 0 || !iv)
+        return -1;
+    if (opt && opt->compress) return -1;
+
+    // 입력은 한 번만 열어 크기를 재고, 작은 파일/stdio 경로는 이 핸들을 그대로 쓴다
+    FILE* fin = fopen(in_path, "rb");
+    if (!fin) return -2;
+    long long file_size = stream_file_size(fin);
+
+    // 작은 파일은 I/O 모드와 관계없이 한 번에 처리
+    if (stream_small_file(opt, file_size, 0))
+        return ctr_process_file_small(engine, fin, file_size, out_path, key, key_len, iv, opt);
+
+    if (stream_io_mode(opt) != STREAM_IO_STDIO) {
+        // 나머지 경로는 매핑 / io_uring / O_DIRECT 핸들을 직접 연다
+        fclose(fin);
+        if (stream_io_mode(opt) == STREAM_IO_MMAP) {
+            int rc = ctr_process_file_mmap(engine, in_path, out_path, key, key_len, iv, opt);
+            if (rc != 1) return rc;
+        }
+        if (stream_io_mode(opt) == STREAM_IO_URING) {
+            int rc = ctr_process_file_uring(engine, in_path, out_path, key, key_len, iv, opt);
+            if (rc != 1) return rc;
+        }
+        if (stream_io_mode(opt) == STREAM_IO_DIRECT)
+            return ctr_process_file_direct(engine, in_path, out_path, key, key_len, iv, opt);
+        if (stream_io_mode(opt) == STREAM_IO_PIPELINE)
+            return ctr_process_file_pipeline(engine, in_path, out_path, key, key_len, iv, opt);
+
+        // 매핑 / io_uring을 쓸 수 없으면 stdio 경로로 처리
+        fin = fopen(in_path, "rb");
+        if (!fin) return -2;
+        file_size = stream_file_size(fin);
+    }
+    return ctr_process_file_stdio(engine, fin, file_size, out_path, key, key_len, iv, opt);
+}
+
+int stream_encrypt_ctr_file_ex(const blockcipher_vtable_t* engine,
+                               const char* in_path,
+                               const char* out_path,
+                               const unsigned char* key,
+                               int key_len,
+                               const unsigned char iv[CTR_BLOCK_BYTES],
+                               const stream_options_t* opt)
+{
+    // CTR은 암호화/복호화 연산이 동일하므로 같은 함수 재사용
+    return ctr_process_file(engine, in_path, out_path, key, key_len, iv, opt);
+}
+
+int stream_decrypt_ctr_file_ex(const blockcipher_vtable_t* engine,
+                               const char* in_path,
+                               const char* out_path,
+                               const unsigned char* key,
+                               int key_len,
+                               const unsigned char iv[CTR_BLOCK_BYTES],
+                               const stream_options_t* opt)
+{
+    return ctr_process_file(engine, in_path, out_path, key, key_len, iv, opt);
+}
+
 int stream_encrypt_ctr_file(const blockcipher_vtable_t* engine,
                             const char* in_path,
                             const char* out_path,
@@ -191,8 +817,7 @@ int stream_encrypt_ctr_file(const blockcipher_vtable_t* engine,
                             int key_len,
                             const unsigned char iv[CTR_BLOCK_BYTES])
 {
-    // CTR은 암호화/복호화 연산이 동일하므로 같은 함수 재사용
-    return ctr_process_file(engine, in_path, out_path, key, key_len, iv);
+    return stream_encrypt_ctr_file_ex(engine, in_path, out_path, key, key_len, iv, NULL);
 }
 
 int stream_decrypt_ctr_file(const blockcipher_vtable_t* engine,
@@ -202,70 +827,692 @@ int stream_decrypt_ctr_file(const blockcipher_vtable_t* engine,
                             int key_len,
                             const unsigned char iv[CTR_BLOCK_BYTES])
 {
-    // CTR은 암호화/복호화 연산이 동일하므로 같은 함수 재사용
-    return ctr_process_file(engine, in_path, out_path, key, key_len, iv);
+    return stream_decrypt_ctr_file_ex(engine, in_path, out_path, key, key_len, iv, NULL);
 }
 
-int stream_hash_sha512_file(const char* in_path,
-                            unsigned char out_digest[64])
+int stream_encrypt_ctr_hmac_file_ex(const blockcipher_vtable_t* engine,
+                                    const char* in_path,
+                                    const char* out_path,
+                                    const unsigned char* key,
+                                    int key_len,
+                                    const unsigned char iv[CTR_BLOCK_BYTES],
+                                    const unsigned char* hmac_key,
+                                    size_t hmac_key_len,
+                                    const stream_options_t* opt)
 {
-    // 파일을 스트리밍으로 읽어 SHA-512를 계산한다.
-    if (!in_path || !out_digest) return -1;
-
-    FILE* f = fopen(in_path, "rb");
-    if (!f) return -2;
+    if (!engine || !in_path || !out_path || !key || key_len <= 0 || !iv)
+        return -1;
+    if (opt && opt->compress) return -1;
 
-    sha512_ctx_t ctx;
-    sha512_init(&ctx);
+    FILE* fin = fopen(in_path, "rb");
+    if (!fin) return -2;
 
-    // 큰 버퍼는 힙에 할당해 스택 사용을 줄인다.
-    unsigned char* buf = (unsigned char*)malloc(STREAM_BUF_SIZE);
-    if (!buf) {
-        fclose(f);
+    FILE* fout = fopen(out_path, "wb");
+    if (!fout) {
+        fclose(fin);
         return -3;
     }
 
-    size_t n;
-    while ((n = fread(buf, 1, STREAM_BUF_SIZE, f)) > 0) {
-        sha512_update(&ctx, buf, n);
+    long long file_size = stream_file_size(fin);
+    if (stream_small_file(opt, file_size, 0)) {
+        int rc = small_encrypt(engine, fin, fout, (size_t)file_size, key, key_len, iv, 1,
+                               hmac_key, hmac_key_len, opt);
+        fclose(fin);
+        if (fclose(fout) != 0 && rc == 0) rc = -6;
+        if (rc != 0) remove(out_path);
+        return rc;
     }
 
-    if (ferror(f)) {
-        free(buf);
-        fclose(f);
+    crypto_stream_t* cs = hmac_key
+        ? crypto_stream_ctr_hmac_new(engine, key, key_len, iv, hmac_key, hmac_key_len, 1)
+        : crypto_stream_ctr_new(engine, key, key_len, iv);
+    if (!cs) {
+        fclose(fin);
+        fclose(fout);
+        remove(out_path);
         return -4;
     }
 
+    int rc = 0;
+    if (fwrite(iv, 1, CTR_BLOCK_BYTES, fout) != CTR_BLOCK_BYTES) rc = -6;
+
+    if (rc == 0) {
+        stream_ticker_t ticker;
+        ticker_init(&ticker, opt, file_size);
+        stream_ticked_file_t src = { fin, &ticker, 0 };
+
+        int prc = crypto_stream_pump(cs, stream_ticked_read, &src,
+                                     crypto_stream_file_write, fout,
+                                     stream_effective_buf_size(opt, file_size));
+        // 마지막 버퍼는 EOF 읽기 전에 이미 알렸으므로 끝난 뒤 한 번 더 알릴 필요 없음
+        if (ticker.cancelled) rc = STREAM_CANCELLED;
+        else if (prc == CRYPTO_ERR_MEMORY) rc = -5;
+        else if (prc != CRYPTO_OK) rc = ferror(fin) ? -7 : -6;
+    }
+
+    if (rc == 0 && hmac_key) {
+        unsigned char tag[SHA512_DIGEST_LENGTH];
+        crypto_stream_final(cs, tag);
+        if (fwrite(tag, 1, sizeof(tag), fout) != sizeof(tag)) rc = -6;
+        memset(tag, 0, sizeof(tag));
+    }
+
+    crypto_stream_free(cs);
+    fclose(fin);
+    if (fclose(fout) != 0 && rc == 0) rc = -6;
+    if (rc != 0) remove(out_path);
+    return rc;
+}
+
+int stream_decrypt_ctr_hmac_file_ex(const blockcipher_vtable_t* engine,
+                                    const char* in_path,
+                                    const char* out_path,
+                                    const unsigned char* key,
+                                    int key_len,
+                                    const unsigned char* hmac_key,
+                                    size_t hmac_key_len,
+                                    const stream_options_t* opt)
+{
+    if (!engine || !in_path || !out_path || !key || key_len <= 0)
+        return -1;
+    if (opt && opt->compress) return -1;
+
+    char* part_path = stream_path_suffix(out_path, STREAM_PARTIAL_SUFFIX);
+    if (!part_path) return -5;
+
+    FILE* fin = fopen(in_path, "rb");
+    if (!fin) {
+        free(part_path);
+        return -2;
+    }
+
+    FILE* fout = fopen(part_path, "wb");
+    if (!fout) {
+        fclose(fin);
+        free(part_path);
+        return -3;
+    }
+
+    int rc = 0;
+    crypto_stream_t* cs = NULL;
+
+    // 파이프면 크기를 알 수 없으므로(-1) 기본 크기, 진행률 total은 0
+    long long file_size = stream_file_size(fin);
+    size_t overhead = CTR_BLOCK_BYTES + (hmac_key ? SHA512_DIGEST_LENGTH : 0);
+    if (stream_small_file(opt, file_size, overhead)) {
+        rc = small_decrypt(engine, fin, fout, (size_t)file_size, key, key_len, hmac_key, hmac_key_len, opt);
+    }
+    else {
+        cs = crypto_stream_ctr_hmac_open_new(engine, key, key_len, hmac_key, hmac_key_len);
+        if (!cs) rc = -4;
+    }
+
+    if (rc == 0 && cs) {
+        stream_ticker_t ticker;
+        ticker_init(&ticker, opt, file_size);
+        stream_ticked_file_t src = { fin, &ticker, 0 };
+
+        int prc = crypto_stream_open_pump(cs, stream_ticked_read, &src,
+                                          crypto_stream_file_write, fout,
+                                          stream_effective_buf_size(opt, file_size));
+        if (ticker.cancelled) rc = STREAM_CANCELLED;
+        else if (prc == CRYPTO_ERR_AUTH) rc = -10;
+        else if (prc == CRYPTO_ERR_INVALID) rc = -13;
+        else if (prc == CRYPTO_ERR_MEMORY) rc = -5;
+        else if (prc != CRYPTO_OK) rc = ferror(fin) ? -7 : -6;
+    }
+
+    crypto_stream_free(cs);
+    fclose(fin);
+    if (fclose(fout) != 0 && rc == 0) rc = -6;
+
+    // 인증이 끝난 평문만 out_path에 나타난다
+    if (rc == 0 && stream_replace_file(part_path, out_path) != 0) rc = -6;
+    if (rc != 0) remove(part_path);
+    free(part_path);
+    return rc;
+}
+
+// 키 교체 (IV || CT || HMAC → 새 IV || CT' || 새 HMAC)
+int stream_rekey_ctr_hmac_file(const blockcipher_vtable_t* engine,
+                               const char* in_path,
+                               const char* out_path,
+                               const unsigned char* old_key,
+                               int old_key_len,
+                               const unsigned char* old_hmac_key,
+                               size_t old_hmac_key_len,
+                               const unsigned char* new_key,
+                               int new_key_len,
+                               const unsigned char new_iv[CTR_BLOCK_BYTES],
+                               const unsigned char* new_hmac_key,
+                               size_t new_hmac_key_len,
+                               const stream_options_t* opt)
+{
+    if (!engine || !in_path || !out_path || !old_key || old_key_len <= 0 ||
+        !new_key || new_key_len <= 0 || !new_iv)
+        return -1;
+    if (opt && opt->compress) return -1;
+
+    char* part_path = stream_path_suffix(out_path, STREAM_PARTIAL_SUFFIX);
+    if (!part_path) return -5;
+
+    FILE* fin = fopen(in_path, "rb");
+    if (!fin) {
+        free(part_path);
+        return -2;
+    }
+
+    // 1) 크기로 CT 길이 결정, 이전 IV 읽기
+    int rc = 0;
+    size_t old_tail = old_hmac_key ? SHA512_DIGEST_LENGTH : 0;
+    long long file_size = stream_file_size(fin);
+    unsigned char old_iv[CTR_BLOCK_BYTES];
+    if (file_size < 0) rc = -7;
+    else if ((uint64_t)file_size < CTR_BLOCK_BYTES + old_tail) rc = -13;
+    else if (fread(old_iv, 1, CTR_BLOCK_BYTES, fin) != CTR_BLOCK_BYTES) rc = -7;
+
+    FILE* fout = NULL;
+    if (rc == 0) {
+        fout = fopen(part_path, "wb");
+        if (!fout) rc = -3;
+    }
+
+    ctr_mode_ctx_t* old_ctr = NULL;
+    ctr_mode_ctx_t* new_ctr = NULL;
+    if (rc == 0) {
+        old_ctr = ctr_mode_init(engine, old_key, old_key_len, old_iv);
+        new_ctr = ctr_mode_init(engine, new_key, new_key_len, new_iv);
+        if (!old_ctr || !new_ctr) rc = -4;
+    }
+
+    size_t cap = stream_effective_buf_size(opt, file_size);
+    unsigned char* buf = NULL;
+    unsigned char* ks = NULL;
+    if (rc == 0) {
+        buf = (unsigned char*)malloc(cap);
+        ks = (unsigned char*)malloc(cap);
+        if (!buf || !ks) rc = -5;
+    }
+
+    hmac_ctx old_mac, new_mac;
+    if (rc == 0) {
+        if (old_hmac_key) {
+            hmac_init(&old_mac, old_hmac_key, old_hmac_key_len);
+            hmac_update(&old_mac, old_iv, CTR_BLOCK_BYTES);
+        }
+        if (new_hmac_key) {
+            hmac_init(&new_mac, new_hmac_key, new_hmac_key_len);
+            hmac_update(&new_mac, new_iv, CTR_BLOCK_BYTES);
+        }
+        if (fwrite(new_iv, 1, CTR_BLOCK_BYTES, fout) != CTR_BLOCK_BYTES) rc = -6;
+    }
+
+    // 2) 버퍼마다: 이전 MAC ← CT, CT' = CT ⊕ (이전 ks ⊕ 새 ks), 새 MAC ← CT'
+    stream_ticker_t ticker;
+    ticker_init(&ticker, opt, file_size);
+    uint64_t left = (rc == 0) ? (uint64_t)file_size - CTR_BLOCK_BYTES - old_tail : 0;
+    while (rc == 0 && left > 0) {
+        size_t n = (size_t)(left < cap ? left : cap);
+        if (fread(buf, 1, n, fin) != n) {
+            rc = -7;
+            break;
+        }
+        if (old_hmac_key) hmac_update(&old_mac, buf, n);
+
+        memset(ks, 0, n);
+        ctr_mode_update(old_ctr, ks, ks, (int)n);
+        ctr_mode_update(new_ctr, ks, ks, (int)n);
+        for (size_t i = 0; i < n; i++) buf[i] ^= ks[i];
+
+        if (new_hmac_key) hmac_update(&new_mac, buf, n);
+        if (fwrite(buf, 1, n, fout) != n) rc = -6;
+        left -= n;
+        if (rc == 0 && stream_tick(&ticker, n)) rc = STREAM_CANCELLED;
+    }
+
+    // 3) 이전 태그 확인 → 새 태그
+    if (rc == 0 && old_hmac_key) {
+        unsigned char tag[SHA512_DIGEST_LENGTH];
+        unsigned char expect[SHA512_DIGEST_LENGTH];
+        if (fread(tag, 1, sizeof(tag), fin) != sizeof(tag)) rc = -7;
+        hmac_final(&old_mac, expect);
+        if (rc == 0) {
+            unsigned char diff = 0;
+            for (size_t i = 0; i < sizeof(tag); i++) diff |= (unsigned char)(tag[i] ^ expect[i]);
+            if (diff) rc = -10;
+        }
+        memset(expect, 0, sizeof(expect));
+    }
+    if (rc == 0 && new_hmac_key) {
+        unsigned char tag[SHA512_DIGEST_LENGTH];
+        hmac_final(&new_mac, tag);
+        if (fwrite(tag, 1, sizeof(tag), fout) != sizeof(tag)) rc = -6;
+        memset(tag, 0, sizeof(tag));
+    }
+    memset(&old_mac, 0, sizeof(old_mac));
+    memset(&new_mac, 0, sizeof(new_mac));
+
+    if (ks) {
+        memset(ks, 0, cap);
+        free(ks);
+    }
     free(buf);
-    fclose(f);
-    sha512_final(&ctx, out_digest);
+    if (old_ctr) ctr_mode_free(old_ctr);
+    if (new_ctr) ctr_mode_free(new_ctr);
+    fclose(fin);
+    if (fout && fclose(fout) != 0 && rc == 0) rc = -6;
+
+    // 이전 태그가 맞을 때만 교체 (in_path == out_path여도 원본은 여기까지 그대로)
+    if (rc == 0 && stream_replace_file(part_path, out_path) != 0) rc = -6;
+    if (rc != 0 && fout) remove(part_path);
+    free(part_path);
+    return rc;
+}
+
+// 매핑 경로 해시: 매핑된 입력을 그대로 update에 넘긴다 (복사 없음)
+// 반환: 0 성공, 1 매핑 불가, -2 열기 실패
+static int hash_file_mmap(const char* in_path, sha512_ctx_t* sha, hmac_ctx* hmac,
+                          const stream_options_t* opt)
+{
+    stream_map_t m;
+    int rc = stream_map_open_read(&m, in_path);
+    if (rc == -2) return -2;
+    if (rc != 0) return 1;
+
+    // 콜백이 없으면 한 번에, 있으면 버퍼 크기 단위로 나눠 update
+    stream_ticker_t ticker;
+    ticker_init(&ticker, opt, (long long)m.size);
+    uint64_t step = ticker.opt ? stream_fixed_buf_size(opt, (long long)m.size) : m.size;
+
+    uint64_t off = 0;
+    while (off < m.size) {
+        size_t n = (size_t)(m.size - off > step ? step : m.size - off);
+        if (hmac) hmac_update(hmac, m.data + off, n);
+        else sha512_update(sha, m.data + off, n);
+        off += n;
+        if (stream_tick(&ticker, n)) break;
+    }
+    stream_map_close(&m);
+    return ticker.cancelled ? STREAM_CANCELLED : 0;
+}
+
+typedef struct hash_pipeline_arg_t {
+    sha512_ctx_t* sha;
+    hmac_ctx* hmac;
+} hash_pipeline_arg_t;
+
+static int hash_pipeline_fn(void* arg, unsigned int worker,
+                            unsigned char* buf, size_t len, uint64_t offset)
+{
+    hash_pipeline_arg_t* a = (hash_pipeline_arg_t*)arg;
+    (void)worker; (void)offset;
+    if (a->hmac) hmac_update(a->hmac, buf, len);
+    else sha512_update(a->sha, buf, len);
     return 0;
 }
 
+// 파이프라인 경로 해시: 읽기 스레드가 다음 버퍼를 채우는 동안 압축 (연산 1개, 순서 유지)
+static int hash_file_pipeline(const char* in_path, sha512_ctx_t* sha, hmac_ctx* hmac,
+                              const stream_options_t* opt)
+{
+    FILE* f = fopen(in_path, "rb");
+    if (!f) return -2;
+
+    hash_pipeline_arg_t arg;
+    arg.sha = sha;
+    arg.hmac = hmac;
+
+    stream_pipeline_t p;
+    memset(&p, 0, sizeof(p));
+    p.in = f;
+    p.buf_size = stream_fixed_buf_size(opt, stream_file_size(f));
+    p.buf_count = (opt && opt->buf_count) ? opt->buf_count : 3;
+    p.alignment = stream_alignment(opt);
+    p.workers = 1;
+    p.fn = hash_pipeline_fn;
+    p.arg = &arg;
+
+    stream_ticker_t ticker;
+    ticker_init(&ticker, opt, stream_file_size(f));
+    if (ticker.opt) {
+        p.done = stream_tick_fn;
+        p.done_arg = &ticker;
+    }
+    int rc = stream_pipeline_run(&p);
+    if (ticker.cancelled) rc = STREAM_CANCELLED;
+
+    fclose(f);
+    return rc;
+}
+
+// io_uring 경로 해시 (반환 1이면 사용 불가, 상태는 건드리지 않음)
+static int hash_file_uring(const char* in_path, sha512_ctx_t* sha, hmac_ctx* hmac,
+                           const stream_options_t* opt)
+{
+    hash_pipeline_arg_t arg;
+    arg.sha = sha;
+    arg.hmac = hmac;
+
+    stream_ticker_t ticker;
+    ticker_init(&ticker, opt, -1);
+    if (ticker.opt) {
+        long long size = stream_path_size(in_path);
+        ticker.total = size > 0 ? (uint64_t)size : 0;
+    }
+    stream_chain_arg_t chain = { hash_pipeline_fn, &arg, &ticker };
+
+    int rc = stream_uring_process_file(in_path, NULL, stream_fixed_buf_size(opt, -1),
+        opt ? opt->queue_depth : 0, stream_chain_fn, &chain);
+    return ticker.cancelled ? STREAM_CANCELLED : rc;
+}
+
+// 직접 I/O 경로 해시
+static int hash_file_direct(const char* in_path, sha512_ctx_t* sha, hmac_ctx* hmac,
+                            const stream_options_t* opt)
+{
+    stream_direct_file_t f;
+    if (stream_direct_open_read(&f, in_path) != 0) return -2;
+
+    size_t align = stream_direct_alignment(opt);
+    size_t buf_size = stream_round_up(stream_fixed_buf_size(opt, -1), align);
+    unsigned char* buf = (unsigned char*)stream_aligned_alloc(buf_size, align);
+    int rc = buf ? 0 : -3;
+
+    stream_ticker_t ticker;
+    ticker_init(&ticker, opt, -1);
+    if (ticker.opt) {
+        long long size = stream_path_size(in_path);
+        ticker.total = size > 0 ? (uint64_t)size : 0;
+    }
+
+    while (rc == 0) {
+        long long n = stream_direct_read(&f, buf, buf_size);
+        if (n < 0) rc = -4;
+        if (n <= 0) break;
+        if (hmac) hmac_update(hmac, buf, (size_t)n);
+        else sha512_update(sha, buf, (size_t)n);
+        if (stream_tick(&ticker, (uint64_t)n)) rc = STREAM_CANCELLED;
+        if ((size_t)n < buf_size) break;
+    }
+
+    stream_aligned_free(buf);
+    stream_direct_close(&f, 0);
+    return rc;
+}
+
+// fread 경로 해시 (적응 모드면 버퍼 크기를 측정값에 따라 키운다)
+static int hash_file_stdio(const char* in_path, sha512_ctx_t* sha, hmac_ctx* hmac,
+                           const stream_options_t* opt)
+{
+    FILE* f = fopen(in_path, "rb");
+    if (!f) return -2;
+
+    // 큰 버퍼는 힙에 할당해 스택 사용을 줄인다.
+    long long file_size = stream_file_size(f);
+    stream_sizer_t sizer;
+    sizer_init(&sizer, opt, file_size);
+    stream_ticker_t ticker;
+    ticker_init(&ticker, opt, file_size);
+    unsigned char* buf = NULL;
+    size_t cap = 0;
+
+    int rc = 0;
+    for (;;) {
+        if (!sizer_reserve(&sizer, &buf, &cap)) {
+            rc = -3;
+            break;
+        }
+        uint64_t t0 = sizer.adaptive ? crypto_now_ns() : 0;
+        size_t n = fread(buf, 1, sizer.cur, f);
+        if (n == 0) break;
+        if (hmac) hmac_update(hmac, buf, n);
+        else sha512_update(sha, buf, n);
+        if (sizer.adaptive) sizer_record(&sizer, n, crypto_now_ns() - t0);
+        if (stream_tick(&ticker, n)) {
+            rc = STREAM_CANCELLED;
+            break;
+        }
+    }
+
+    if (rc == 0 && ferror(f)) rc = -4;
+    safe_free(buf);
+    fclose(f);
+    return rc;
+}
+
+// 입출력 방식에 따라 파일 전체를 sha 또는 hmac에 공급
+// (매핑/io_uring을 쓸 수 없으면 stdio 경로로 처리)
+static int hash_file(const char* in_path, sha512_ctx_t* sha, hmac_ctx* hmac,
+                     const stream_options_t* opt)
+{
+    int rc = 1;
+    switch (stream_io_mode(opt)) {
+    case STREAM_IO_MMAP:
+        rc = hash_file_mmap(in_path, sha, hmac, opt);
+        break;
+    case STREAM_IO_URING:
+        rc = hash_file_uring(in_path, sha, hmac, opt);
+        break;
+    case STREAM_IO_DIRECT:
+        return hash_file_direct(in_path, sha, hmac, opt);
+    case STREAM_IO_PIPELINE:
+        return hash_file_pipeline(in_path, sha, hmac, opt);
+    default:
+        break;
+    }
+    if (rc != 1) return rc;
+    return hash_file_stdio(in_path, sha, hmac, opt);
+}
+
+int stream_hash_sha512_file_ex(const char* in_path,
+                               unsigned char out_digest[64],
+                               const stream_options_t* opt)
+{
+    // 파일을 스트리밍으로 읽어 SHA-512를 계산한다.
+    if (!in_path || !out_digest) return -1;
+    if (opt && opt->compress) return -1;
+
+    sha512_ctx_t ctx;
+    sha512_init(&ctx);
+
+    int rc = hash_file(in_path, &ctx, NULL, opt);
+    if (rc == 0) sha512_final(&ctx, out_digest);
+    return rc;
+}
+
+int stream_hmac_sha512_file_ex(const char* in_path,
+                               const unsigned char* key,
+                               size_t key_len,
+                               unsigned char out_mac[64],
+                               const stream_options_t* opt)
+{
+    // 파일을 스트리밍으로 읽으며 HMAC-SHA512를 계산한다.
+    if (!in_path || !key || !out_mac) return -1;
+    if (opt && opt->compress) return -1;
+
+    hmac_ctx ctx;
+    hmac_init(&ctx, key, key_len);
+
+    int rc = hash_file(in_path, NULL, &ctx, opt);
+    if (rc == 0) hmac_final(&ctx, out_mac);
+    memset(&ctx, 0, sizeof(ctx));
+    return rc;
+}
+
+int stream_hash_sha512_file(const char* in_path,
+                            unsigned char out_digest[64])
+{
+    return stream_hash_sha512_file_ex(in_path, out_digest, NULL);
+}
+
 int stream_hmac_sha512_file(const char* in_path,
                             const unsigned char* key,
                             size_t key_len,
                             unsigned char out_mac[64])
 {
-    // 파일을 스트리밍으로 읽으며 HMAC-SHA512를 계산한다.
-    if (!in_path || !key || !out_mac) return -1;
+    return stream_hmac_sha512_file_ex(in_path, key, key_len, out_mac, NULL);
+}
+
+// ===================================================================
+// 체크포인트 기반 재개형 SHA-512 / HMAC-SHA512
+// ===================================================================
+
+// 사이드카 파일 포맷
+//  magic "SCKP"(4) | version(4) | kind(4) | 예약(4) | 입력 오프셋(8) | 상태 blob(HMAC_STATE_BYTES)
+//  - SHA-512 상태는 HMAC 상태보다 작으므로 남는 영역은 0
+#define CKPT_VERSION      1
+#define CKPT_KIND_SHA512  1
+#define CKPT_KIND_HMAC    2
+#define CKPT_HEADER_BYTES 24
+#define CKPT_FILE_BYTES   (CKPT_HEADER_BYTES + HMAC_STATE_BYTES)
+
+static const unsigned char CKPT_MAGIC[4] = { 'S', 'C', 'K', 'P' };
+
+typedef struct resumable_hash_t {
+    int kind;                  // CKPT_KIND_*
+    sha512_ctx_t sha;          // kind == SHA512
+    hmac_ctx hmac;             // kind == HMAC
+    const unsigned char* key;  // HMAC 키 (재개 시 상태 복원용)
+    size_t key_len;
+} resumable_hash_t;
+
+static int ckpt_write(const resumable_hash_t* rh, const char* state_path, uint64_t offset)
+{
+    // 오프셋 0의 HMAC 상태는 K ⊕ ipad 압축 결과 그 자체(키와 같은 값)이므로 남기지 않는다.
+    // 이어 갈 상태가 없으니 이전 내용의 사이드카만 지운다.
+    if (offset == 0) {
+        remove(state_path);
+        return 0;
+    }
+
+    unsigned char rec[CKPT_FILE_BYTES];
+    memset(rec, 0, sizeof(rec));
+    memcpy(rec, CKPT_MAGIC, 4);
+    store_be32(rec + 4, CKPT_VERSION);
+    store_be32(rec + 8, (uint32_t)rh->kind);
+    store_be64(rec + 16, offset);
+
+    int rc = (rh->kind == CKPT_KIND_HMAC)
+        ? hmac_export_state(&rh->hmac, rec + CKPT_HEADER_BYTES)
+        : sha512_export_state(&rh->sha, rec + CKPT_HEADER_BYTES);
+    if (rc != CRYPTO_OK) return -5;
+
+    char* tmp_path = stream_path_suffix(state_path, ".tmp");
+    if (!tmp_path) return -3;
+
+    FILE* f = fopen(tmp_path, "wb");
+    if (!f) {
+        free(tmp_path);
+        return -5;
+    }
+    int ok = (fwrite(rec, 1, sizeof(rec), f) == sizeof(rec));
+    ok = (stream_file_sync(f) == 0) && ok;
+    ok = (fclose(f) == 0) && ok;
+    if (ok) ok = (stream_replace_file(tmp_path, state_path) == 0);
+    if (!ok) remove(tmp_path);
+
+    free(tmp_path);
+    memset(rec, 0, sizeof(rec));
+    return ok ? 0 : -5;
+}
+
+// 사이드카를 읽어 상태를 복원하고 재개 오프셋을 돌려준다.
+// 사이드카가 없거나 맞지 않으면 0을 반환하고 rh는 처음 상태로 초기화된다.
+static uint64_t ckpt_load(resumable_hash_t* rh, const char* state_path, long long file_size)
+{
+    unsigned char rec[CKPT_FILE_BYTES];
+    uint64_t offset = 0;
+    int restored = 0;
+
+    FILE* f = fopen(state_path, "rb");
+    if (f) {
+        size_t n = fread(rec, 1, sizeof(rec), f);
+        fclose(f);
+
+        if (n == sizeof(rec) &&
+            memcmp(rec, CKPT_MAGIC, 4) == 0 &&
+            load_be32(rec + 4) == CKPT_VERSION &&
+            load_be32(rec + 8) == (uint32_t)rh->kind) {
+            offset = load_be64(rec + 16);
+
+            if (file_size >= 0 && offset <= (uint64_t)file_size) {
+                if (rh->kind == CKPT_KIND_HMAC) {
+                    restored = (hmac_import_state(&rh->hmac, rh->key, rh->key_len,
+                        rec + CKPT_HEADER_BYTES) == CRYPTO_OK) &&
+                        sha512_bytes_processed(&rh->hmac.ctx) == offset + SHA512_BLOCK_SIZE;
+                }
+                else {
+                    restored = (sha512_import_state(&rh->sha, rec + CKPT_HEADER_BYTES) == CRYPTO_OK) &&
+                        sha512_bytes_processed(&rh->sha) == offset;
+                }
+            }
+        }
+        memset(rec, 0, sizeof(rec));
+    }
+
+    if (!restored) {
+        offset = 0;
+        if (rh->kind == CKPT_KIND_HMAC) hmac_init(&rh->hmac, rh->key, rh->key_len);
+        else sha512_init(&rh->sha);
+    }
+    return offset;
+}
+
+static int resumable_hash_file(resumable_hash_t* rh,
+                               const char* in_path,
+                               const char* state_path,
+                               uint64_t checkpoint_interval,
+                               unsigned char out[64],
+                               const stream_options_t* opt)
+{
+    if (checkpoint_interval == 0) checkpoint_interval = STREAM_CHECKPOINT_DEFAULT_INTERVAL;
 
     FILE* f = fopen(in_path, "rb");
     if (!f) return -2;
 
-    hmac_ctx ctx;
-    hmac_init(&ctx, key, key_len);
+    long long file_size = stream_file_size(f);
+    uint64_t offset = ckpt_load(rh, state_path, file_size);
+
+    // 진행률은 파일 전체 기준 (재개한 앞부분은 이미 처리한 것으로 센다)
+    stream_ticker_t ticker;
+    ticker_init(&ticker, opt, file_size);
+    ticker.done = offset;
+    if (stream_file_seek(f, offset) != 0) {
+        fclose(f);
+        return -4;
+    }
 
-    // 큰 버퍼는 힙에 할당해 스택 사용을 줄인다.
     unsigned char* buf = (unsigned char*)malloc(STREAM_BUF_SIZE);
     if (!buf) {
         fclose(f);
         return -3;
     }
 
+    uint64_t since_ckpt = 0;
     size_t n;
     while ((n = fread(buf, 1, STREAM_BUF_SIZE, f)) > 0) {
-        hmac_update(&ctx, buf, n);
+        if (rh->kind == CKPT_KIND_HMAC) hmac_update(&rh->hmac, buf, n);
+        else sha512_update(&rh->sha, buf, n);
+        offset += n;
+        since_ckpt += n;
+
+        if (since_ckpt >= checkpoint_interval) {
+            int rc = ckpt_write(rh, state_path, offset);
+            if (rc != 0) {
+                free(buf);
+                fclose(f);
+                return rc;
+            }
+            since_ckpt = 0;
+        }
+
+        // 취소: 지금까지 처리한 위치를 남겨 다음 호출에서 이어서 계산
+        if (stream_tick(&ticker, n)) {
+            int rc = ckpt_write(rh, state_path, offset);
+            free(buf);
+            fclose(f);
+            return rc != 0 ? rc : STREAM_CANCELLED;
+        }
     }
 
     if (ferror(f)) {
@@ -273,9 +1520,73 @@ int stream_hmac_sha512_file(const char* in_path,
         fclose(f);
         return -4;
     }
-
     free(buf);
     fclose(f);
-    hmac_final(&ctx, out_mac);
+
+    // EOF 시점 상태를 남겨 두면 다음 호출은 새로 추가된 꼬리만 처리한다.
+    // (아무것도 읽지 않았으면 ckpt_write는 이전 사이드카를 지우기만 한다)
+    if (since_ckpt > 0 || offset == 0) {
+        int rc = ckpt_write(rh, state_path, offset);
+        if (rc != 0) return rc;
+    }
+
+    if (rh->kind == CKPT_KIND_HMAC) hmac_final(&rh->hmac, out);
+    else sha512_final(&rh->sha, out);
     return 0;
 }
+
+int stream_hash_sha512_file_resumable(const char* in_path,
+                                      const char* state_path,
+                                      uint64_t checkpoint_interval,
+                                      unsigned char out_digest[64])
+{
+    return stream_hash_sha512_file_resumable_ex(in_path, state_path, checkpoint_interval,
+                                                out_digest, NULL);
+}
+
+int stream_hash_sha512_file_resumable_ex(const char* in_path,
+                                         const char* state_path,
+                                         uint64_t checkpoint_interval,
+                                         unsigned char out_digest[64],
+                                         const stream_options_t* opt)
+{
+    if (!in_path || !state_path || !out_digest) return -1;
+    if (opt && opt->compress) return -1;
+
+    resumable_hash_t rh;
+    memset(&rh, 0, sizeof(rh));
+    rh.kind = CKPT_KIND_SHA512;
+    return resumable_hash_file(&rh, in_path, state_path, checkpoint_interval, out_digest, opt);
+}
+
+int stream_hmac_sha512_file_resumable(const char* in_path,
+                                      const unsigned char* key,
+                                      size_t key_len,
+                                      const char* state_path,
+                                      uint64_t checkpoint_interval,
+                                      unsigned char out_mac[64])
+{
+    return stream_hmac_sha512_file_resumable_ex(in_path, key, key_len, state_path,
+                                                checkpoint_interval, out_mac, NULL);
+}
+
+int stream_hmac_sha512_file_resumable_ex(const char* in_path,
+                                         const unsigned char* key,
+                                         size_t key_len,
+                                         const char* state_path,
+                                         uint64_t checkpoint_interval,
+                                         unsigned char out_mac[64],
+                                         const stream_options_t* opt)
+{
+    if (!in_path || !key || !state_path || !out_mac) return -1;
+    if (opt && opt->compress) return -1;
+
+    resumable_hash_t rh;
+    memset(&rh, 0, sizeof(rh));
+    rh.kind = CKPT_KIND_HMAC;
+    rh.key = key;
+    rh.key_len = key_len;
+    int rc = resumable_hash_file(&rh, in_path, state_path, checkpoint_interval, out_mac, opt);
+    memset(&rh, 0, sizeof(rh));
+    return rc;
+}
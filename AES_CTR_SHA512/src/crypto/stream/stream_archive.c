@@ -0,0 +1,377 @@
+﻿#include "crypto/stream/stream_archive.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "crypto/bytes.h"
+#include "crypto/stream/stream_chunked.h"
+#include "crypto/stream/stream_fileutil.h"
+
+static const unsigned char ARCHIVE_MAGIC[4] = { 'S', 'A', 'R', 'C' };
+
+#define ARCHIVE_ENTRY_FIXED 20u     // 오프셋(8) | 크기(8) | 이름 길이(4)
+#define ARCHIVE_COPY_BYTES  (1u << 20)
+
+// -------------------------------------------------------------------
+// 만들기: 입력 파일들 → 색인 → 트레일러를 차례로 내주는 읽기 함수
+// -------------------------------------------------------------------
+
+typedef struct archive_src_t {
+    const char* const* paths;
+    const char* const* names;
+    size_t count;
+
+    size_t cur;             // 읽고 있는 입력 번호
+    FILE* f;
+    uint64_t entry_start;   // 현재 항목 시작 오프셋
+    uint64_t pos;           // 지금까지 내준 데이터 바이트 (= 색인 오프셋)
+
+    unsigned char* tail;    // 색인 || 트레일러
+    size_t tail_len;
+    size_t tail_cap;
+    size_t tail_pos;        // 내준 바이트
+    int sealed;             // 트레일러까지 만들었음
+
+    int rc;                 // 읽기 함수가 -1을 반환한 이유
+} archive_src_t;
+
+static int tail_reserve(archive_src_t* s, size_t extra)
+{
+    if (s->tail_len + extra <= s->tail_cap) return 0;
+    size_t cap = s->tail_cap ? s->tail_cap : 4096;
+    while (cap < s->tail_len + extra) cap *= 2;
+    unsigned char* p = (unsigned char*)realloc(s->tail, cap);
+    if (!p) return -5;
+    s->tail = p;
+    s->tail_cap = cap;
+    return 0;
+}
+
+static int tail_add_entry(archive_src_t* s, uint64_t offset, uint64_t size, const char* name)
+{
+    size_t name_len = strlen(name);
+    if (name_len > STREAM_ARCHIVE_MAX_NAME) return -1;
+    if (tail_reserve(s, ARCHIVE_ENTRY_FIXED + name_len) != 0) return -5;
+
+    unsigned char* p = s->tail + s->tail_len;
+    store_be64(p, offset);
+    store_be64(p + 8, size);
+    store_be32(p + 16, (uint32_t)name_len);
+    memcpy(p + ARCHIVE_ENTRY_FIXED, name, name_len);
+    s->tail_len += ARCHIVE_ENTRY_FIXED + name_len;
+    return 0;
+}
+
+static int tail_seal(archive_src_t* s)
+{
+    if (tail_reserve(s, STREAM_ARCHIVE_TRAILER_BYTES) != 0) return -5;
+    unsigned char* p = s->tail + s->tail_len;
+    memcpy(p, ARCHIVE_MAGIC, 4);
+    store_be32(p + 4, STREAM_ARCHIVE_VERSION);
+    store_be64(p + 8, s->pos);
+    store_be64(p + 16, (uint64_t)s->count);
+    s->tail_len += STREAM_ARCHIVE_TRAILER_BYTES;
+    s->sealed = 1;
+    return 0;
+}
+
+// crypto_stream_read_fn: cap을 최대한 채워 준다 (0 = 끝, -1 = s->rc에 이유)
+static long long archive_src_read(void* ctx, unsigned char* buf, size_t cap)
+{
+    archive_src_t* s = (archive_src_t*)ctx;
+    size_t filled = 0;
+
+    while (filled < cap && !s->sealed) {
+        if (s->cur == s->count) {
+            s->rc = tail_seal(s);
+            if (s->rc != 0) return -1;
+            break;
+        }
+        if (!s->f) {
+            s->f = fopen(s->paths[s->cur], "rb");
+            if (!s->f) {
+                s->rc = -2;
+                return -1;
+            }
+            s->entry_start = s->pos;
+        }
+
+        size_t n = fread(buf + filled, 1, cap - filled, s->f);
+        filled += n;
+        s->pos += n;
+        if (n > 0) continue;
+
+        // 입력 하나 끝: 실제로 읽은 크기로 색인 항목 추가
+        int err = ferror(s->f);
+        fclose(s->f);
+        s->f = NULL;
+        if (err) {
+            s->rc = -7;
+            return -1;
+        }
+        const char* name = (s->names && s->names[s->cur]) ? s->names[s->cur] : s->paths[s->cur];
+        s->rc = tail_add_entry(s, s->entry_start, s->pos - s->entry_start, name);
+        if (s->rc != 0) return -1;
+        s->cur++;
+    }
+
+    if (s->sealed && filled < cap) {
+        size_t n = s->tail_len - s->tail_pos;
+        if (n > cap - filled) n = cap - filled;
+        memcpy(buf + filled, s->tail + s->tail_pos, n);
+        s->tail_pos += n;
+        filled += n;
+    }
+    return (long long)filled;
+}
+
+int stream_archive_create(const blockcipher_vtable_t* engine,
+                          const char* out_path,
+                          const char* const* in_paths,
+                          const char* const* names,
+                          size_t count,
+                          const unsigned char* key,
+                          int key_len,
+                          const unsigned char iv[CTR_BLOCK_BYTES],
+                          const unsigned char* hmac_key,
+                          size_t hmac_key_len,
+                          size_t chunk_size,
+                          const stream_options_t* opt)
+{
+    if (!engine || !out_path || (!in_paths && count) || !key || key_len <= 0 || !iv || !hmac_key)
+        return -1;
+    for (size_t i = 0; i < count; i++)
+        if (!in_paths[i]) return -1;
+
+    FILE* fout = fopen(out_path, "wb");
+    if (!fout) return -3;
+
+    archive_src_t src;
+    memset(&src, 0, sizeof(src));
+    src.paths = in_paths;
+    src.names = names;
+    src.count = count;
+
+    // 진행률 전체 크기 = 평문 스트림 길이 (입력 크기 합 + 색인 + 트레일러)
+    uint64_t total = 0;
+    if (opt && opt->progress) {
+        total = STREAM_ARCHIVE_TRAILER_BYTES;
+        for (size_t i = 0; i < count; i++) {
+            long long size = stream_path_size(in_paths[i]);
+            const char* name = (names && names[i]) ? names[i] : in_paths[i];
+            if (size > 0) total += (uint64_t)size;
+            total += ARCHIVE_ENTRY_FIXED + strlen(name);
+        }
+    }
+
+    int rc = stream_chunked_encrypt_stream(engine, archive_src_read, &src, fout, key, key_len, iv,
+                                           hmac_key, hmac_key_len, chunk_size, total, opt);
+    // 읽기 실패는 원인 코드(-2 입력 열기, -5 메모리 등)로 돌려준다
+    if (rc == -7 && src.rc != 0) rc = src.rc;
+
+    if (src.f) fclose(src.f);
+    free(src.tail);
+    if (fclose(fout) != 0 && rc == 0) rc = -6;
+    if (rc != 0) remove(out_path);
+    return rc;
+}
+
+// -------------------------------------------------------------------
+// 읽기
+// -------------------------------------------------------------------
+
+typedef struct archive_entry_t {
+    uint64_t offset;
+    uint64_t size;
+    char* name;             // names 블록 안 (NUL 종료)
+} archive_entry_t;
+
+struct stream_archive_t {
+    crypto_file_t* cf;
+    archive_entry_t* entries;
+    size_t count;
+    char* names;
+};
+
+void stream_archive_close(stream_archive_t* ar)
+{
+    if (!ar) return;
+    crypto_file_close(ar->cf);
+    free(ar->entries);
+    free(ar->names);
+    free(ar);
+}
+
+// 색인 파싱: 항목 범위가 데이터 영역(index_off) 안에 있고 색인을 정확히 다 쓰는지 확인
+static int archive_parse_index(stream_archive_t* ar, const unsigned char* idx, size_t idx_len,
+                               uint64_t index_off, uint64_t count)
+{
+    // 항목당 최소 ARCHIVE_ENTRY_FIXED 바이트이므로 count가 크면 색인 길이와 맞지 않음
+    if (count > idx_len / ARCHIVE_ENTRY_FIXED) return -17;
+
+    ar->entries = (archive_entry_t*)calloc(count ? (size_t)count : 1, sizeof(archive_entry_t));
+    ar->names = (char*)malloc(idx_len + (size_t)count + 1);     // 이름 + NUL
+    if (!ar->entries || !ar->names) return -5;
+    ar->count = (size_t)count;
+
+    size_t pos = 0, npos = 0;
+    for (size_t i = 0; i < ar->count; i++) {
+        if (idx_len - pos < ARCHIVE_ENTRY_FIXED) return -17;
+        uint64_t off = load_be64(idx + pos);
+        uint64_t size = load_be64(idx + pos + 8);
+        uint32_t name_len = load_be32(idx + pos + 16);
+        pos += ARCHIVE_ENTRY_FIXED;
+        if (name_len > STREAM_ARCHIVE_MAX_NAME || name_len > idx_len - pos) return -17;
+        if (off > index_off || size > index_off - off) return -17;
+
+        ar->entries[i].offset = off;
+        ar->entries[i].size = size;
+        ar->entries[i].name = ar->names + npos;
+        memcpy(ar->names + npos, idx + pos, name_len);
+        npos += name_len;
+        ar->names[npos++] = '\0';
+        pos += name_len;
+    }
+    return pos == idx_len ? 0 : -17;
+}
+
+int stream_archive_open(stream_archive_t** out,
+                        const blockcipher_vtable_t* engine,
+                        const char* path,
+                        const unsigned char* key,
+                        int key_len,
+                        const unsigned char* hmac_key,
+                        size_t hmac_key_len)
+{
+    if (!out) return -1;
+    *out = NULL;
+
+    stream_archive_t* ar = (stream_archive_t*)calloc(1, sizeof(stream_archive_t));
+    if (!ar) return -5;
+    int rc = crypto_file_open(&ar->cf, engine, path, key, key_len, hmac_key, hmac_key_len, 0);
+    if (rc != 0) {
+        stream_archive_close(ar);
+        return rc;
+    }
+
+    uint64_t total = crypto_file_size(ar->cf);
+    unsigned char trailer[STREAM_ARCHIVE_TRAILER_BYTES];
+    if (total < STREAM_ARCHIVE_TRAILER_BYTES) rc = -17;
+    if (rc == 0) {
+        long long n = crypto_file_pread(ar->cf, trailer, sizeof(trailer), total - sizeof(trailer));
+        if (n < 0) rc = (int)n;
+        else if (n != (long long)sizeof(trailer)) rc = -7;
+    }
+    if (rc == 0 && (memcmp(trailer, ARCHIVE_MAGIC, 4) != 0 ||
+                    load_be32(trailer + 4) != STREAM_ARCHIVE_VERSION))
+        rc = -17;
+
+    uint64_t index_off = 0, count = 0;
+    if (rc == 0) {
+        index_off = load_be64(trailer + 8);
+        count = load_be64(trailer + 16);
+        if (index_off > total - sizeof(trailer)) rc = -17;
+    }
+
+    unsigned char* idx = NULL;
+    size_t idx_len = 0;
+    if (rc == 0) {
+        uint64_t len64 = total - sizeof(trailer) - index_off;
+        idx_len = (size_t)len64;
+        if ((uint64_t)idx_len != len64) rc = -5;
+        else if (!(idx = (unsigned char*)malloc(idx_len ? idx_len : 1))) rc = -5;
+    }
+    if (rc == 0 && idx_len) {
+        long long n = crypto_file_pread(ar->cf, idx, idx_len, index_off);
+        if (n < 0) rc = (int)n;
+        else if ((size_t)n != idx_len) rc = -7;
+    }
+    if (rc == 0) rc = archive_parse_index(ar, idx, idx_len, index_off, count);
+
+    free(idx);
+    if (rc != 0) {
+        stream_archive_close(ar);
+        return rc;
+    }
+    *out = ar;
+    return 0;
+}
+
+size_t stream_archive_count(const stream_archive_t* ar)
+{
+    return ar ? ar->count : 0;
+}
+
+int stream_archive_entry(const stream_archive_t* ar, size_t index, const char** name, uint64_t* size)
+{
+    if (!ar || index >= ar->count) return -1;
+    if (name) *name = ar->entries[index].name;
+    if (size) *size = ar->entries[index].size;
+    return 0;
+}
+
+long long stream_archive_find(const stream_archive_t* ar, const char* name)
+{
+    if (!ar || !name) return -1;
+    for (size_t i = 0; i < ar->count; i++)
+        if (strcmp(ar->entries[i].name, name) == 0) return (long long)i;
+    return -1;
+}
+
+long long stream_archive_read(stream_archive_t* ar, size_t index, void* buf, size_t len, uint64_t offset)
+{
+    if (!ar || index >= ar->count || (!buf && len)) return -1;
+    const archive_entry_t* e = &ar->entries[index];
+    if (offset >= e->size) return 0;
+    if (len > e->size - offset) len = (size_t)(e->size - offset);
+    return crypto_file_pread(ar->cf, buf, len, e->offset + offset);
+}
+
+int stream_archive_extract_ex(stream_archive_t* ar, size_t index, const char* out_path,
+                              const stream_options_t* opt)
+{
+    if (!ar || index >= ar->count || !out_path) return -1;
+
+    char* part_path = stream_path_suffix(out_path, STREAM_PARTIAL_SUFFIX);
+    unsigned char* buf = (unsigned char*)malloc(ARCHIVE_COPY_BYTES);
+    if (!part_path || !buf) {
+        free(part_path);
+        free(buf);
+        return -5;
+    }
+
+    int rc = 0;
+    FILE* fout = fopen(part_path, "wb");
+    if (!fout) rc = -3;
+
+    // 항목을 시작하기 전과 버퍼마다 취소를 확인한다 (취소되면 .part는 지운다)
+    uint64_t size = ar->entries[index].size, off = 0;
+    if (rc == 0 && opt && opt->cancel && opt->cancel(opt->user)) rc = -16;
+    while (rc == 0 && off < size) {
+        long long n = stream_archive_read(ar, index, buf, ARCHIVE_COPY_BYTES, off);
+        if (n < 0) rc = (int)n;
+        else if (n == 0) rc = -13;
+        else if (fwrite(buf, 1, (size_t)n, fout) != (size_t)n) rc = -6;
+        else off += (uint64_t)n;
+
+        if (rc == 0 && opt) {
+            if (opt->progress) opt->progress(opt->user, off, size);
+            if (off < size && opt->cancel && opt->cancel(opt->user)) rc = -16;
+        }
+    }
+
+    if (fout && fclose(fout) != 0 && rc == 0) rc = -6;
+    if (rc == 0 && stream_replace_file(part_path, out_path) != 0) rc = -6;
+    if (rc != 0 && fout) remove(part_path);
+
+    memset(buf, 0, ARCHIVE_COPY_BYTES);
+    free(buf);
+    free(part_path);
+    return rc;
+}
+
+int stream_archive_extract(stream_archive_t* ar, size_t index, const char* out_path)
+{
+    return stream_archive_extract_ex(ar, index, out_path, NULL);
+}
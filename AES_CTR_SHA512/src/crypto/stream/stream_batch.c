@@ -0,0 +1,669 @@
+﻿#include "crypto/stream/stream_batch.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "crypto/core/crypto_thread.h"
+#include "crypto/hash/hmac.h"
+#include "crypto/stream/stream_fileutil.h"
+#include "crypto/stream/stream_pipeline.h"
+
+#define BATCH_TAG_BYTES SHA512_DIGEST_LENGTH
+
+// 조각 하나의 목표 처리 시간 (측정한 처리량 * 이 시간 = 조각 크기)
+#define BATCH_SEGMENT_TARGET_NS (50ull * 1000 * 1000)
+
+// -------------------------------------------------------------------
+// 스레드별 상태
+// -------------------------------------------------------------------
+
+struct batch_t;
+
+typedef struct batch_worker_t {
+    struct batch_t* b;
+    unsigned int id;
+
+    // 자기 작업 구간 [lo, hi) (lock으로 보호, 다른 스레드가 뒤쪽을 가져감)
+    crypto_atomic_t lock;
+    size_t lo;
+    size_t hi;
+
+    unsigned char* buf;
+    size_t buf_size;
+
+    // 마지막으로 쓴 CTR 키 스케줄 (같은 엔진/키면 IV만 바꿔 재사용)
+    ctr_mode_ctx_t* ctr;
+    const blockcipher_vtable_t* ctr_engine;
+    const unsigned char* ctr_key;
+    int ctr_key_len;
+
+    // 마지막으로 쓴 HMAC 키 (ipad/opad 압축 결과)
+    hmac_key_t hk;
+    const unsigned char* hk_key;
+    size_t hk_len;
+    int hk_valid;
+
+    // 조각 처리량 측정 (다음 조각 크기 결정) / 통계
+    uint64_t seg_bytes;
+    uint64_t seg_ns;
+    uint64_t segments;
+    uint64_t busy_ns;
+} batch_worker_t;
+
+// 조각으로 나눠 여러 스레드가 함께 처리하는 큰 CTR 작업
+typedef struct batch_split_t {
+    size_t job;                         // jobs 인덱스
+    crypto_atomic_t lock;
+    uint64_t len;                       // 평문/CT 길이
+    uint64_t next;                      // 다음 조각 시작 (len이면 더 나눠 줄 조각 없음)
+    unsigned int active;                // 처리 중인 조각 수
+    int rc;
+    int finished;
+    unsigned char iv[CTR_BLOCK_BYTES];
+    char* part_path;                    // 복호화 출력 (.part)
+} batch_split_t;
+
+typedef struct batch_t {
+    stream_batch_job_t* jobs;
+    size_t n;
+    unsigned int workers;
+    batch_worker_t w[STREAM_PIPELINE_MAX_WORKERS];
+
+    size_t* order;                      // 통째로 처리할 작업 인덱스 (스레드 구간은 이 배열 위치)
+    size_t n_whole;
+    batch_split_t* split;
+    size_t n_split;
+
+    // 진행률/취소 콜백은 한 번에 한 스레드만 호출
+    const stream_options_t* opt;
+    crypto_atomic_t cb_lock;
+    uint64_t done;
+    crypto_atomic_t cancelled;
+} batch_t;
+
+static void spin_lock(crypto_atomic_t* l)
+{
+    while (!crypto_atomic_cas(l, 0, 1)) crypto_thread_yield();
+}
+
+static void spin_unlock(crypto_atomic_t* l)
+{
+    crypto_atomic_store(l, 0);
+}
+
+// -------------------------------------------------------------------
+// 작업 분배 (work stealing)
+// -------------------------------------------------------------------
+
+// 자기 구간 앞에서 하나. 없으면 0
+static int batch_pop(batch_worker_t* w, size_t* idx)
+{
+    int got = 0;
+    spin_lock(&w->lock);
+    if (w->lo < w->hi) {
+        *idx = w->b->order[w->lo++];
+        got = 1;
+    }
+    spin_unlock(&w->lock);
+    return got;
+}
+
+// 다른 스레드 구간의 뒤쪽 절반을 가져와 자기 구간으로. 모두 비었으면 0
+static int batch_steal(batch_worker_t* w)
+{
+    batch_t* b = w->b;
+    for (unsigned int k = 1; k < b->workers; k++) {
+        batch_worker_t* v = &b->w[(w->id + k) % b->workers];
+        size_t lo = 0, hi = 0;
+
+        spin_lock(&v->lock);
+        if (v->lo < v->hi) {
+            size_t take = (v->hi - v->lo + 1) / 2;
+            hi = v->hi;
+            lo = hi - take;
+            v->hi = lo;
+        }
+        spin_unlock(&v->lock);
+
+        if (lo < hi) {
+            spin_lock(&w->lock);
+            w->lo = lo;
+            w->hi = hi;
+            spin_unlock(&w->lock);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// 작업 하나 끝: 진행률 보고 + 취소 확인
+static void batch_finish(batch_t* b)
+{
+    const stream_options_t* opt = b->opt;
+    if (!opt || (!opt->progress && !opt->cancel)) return;
+
+    spin_lock(&b->cb_lock);
+    b->done++;
+    if (opt->progress) opt->progress(opt->user, b->done, (uint64_t)b->n);
+    if (opt->cancel && opt->cancel(opt->user)) crypto_atomic_store(&b->cancelled, 1);
+    spin_unlock(&b->cb_lock);
+}
+
+// -------------------------------------------------------------------
+// 키 컨텍스트 재사용
+// -------------------------------------------------------------------
+
+static ctr_mode_ctx_t* worker_ctr(batch_worker_t* w, const stream_batch_job_t* job,
+                                  const unsigned char iv[CTR_BLOCK_BYTES])
+{
+    if (w->ctr && w->ctr_engine == job->engine && w->ctr_key_len == job->key_len &&
+        (w->ctr_key == job->key || memcmp(w->ctr_key, job->key, (size_t)job->key_len) == 0)) {
+        ctr_mode_seek(w->ctr, iv, 0);
+        return w->ctr;
+    }
+
+    if (w->ctr) ctr_mode_free(w->ctr);
+    w->ctr = ctr_mode_init(job->engine, job->key, job->key_len, iv);
+    w->ctr_engine = job->engine;
+    w->ctr_key = job->key;
+    w->ctr_key_len = job->key_len;
+    return w->ctr;
+}
+
+static void worker_hmac(batch_worker_t* w, const stream_batch_job_t* job, hmac_ctx* c)
+{
+    if (!w->hk_valid || w->hk_len != job->hmac_key_len ||
+        (w->hk_key != job->hmac_key && memcmp(w->hk_key, job->hmac_key, job->hmac_key_len) != 0)) {
+        hmac_key_init(&w->hk, job->hmac_key, job->hmac_key_len);
+        w->hk_key = job->hmac_key;
+        w->hk_len = job->hmac_key_len;
+        w->hk_valid = 1;
+    }
+    hmac_start_from_key(c, &w->hk);
+}
+
+// -------------------------------------------------------------------
+// 작업 처리
+// -------------------------------------------------------------------
+
+static int job_hash(batch_worker_t* w, stream_batch_job_t* job)
+{
+    FILE* fin = fopen(job->in_path, "rb");
+    if (!fin) return -2;
+
+    sha512_ctx_t sc;
+    sha512_init(&sc);
+    size_t got;
+    while ((got = fread(w->buf, 1, w->buf_size, fin)) > 0) sha512_update(&sc, w->buf, got);
+
+    int rc = ferror(fin) ? -7 : 0;
+    fclose(fin);
+    if (rc == 0) sha512_final(&sc, job->digest);
+    return rc;
+}
+
+// IV || CT (|| HMAC)
+static int job_encrypt(batch_worker_t* w, stream_batch_job_t* job, int with_mac)
+{
+    FILE* fin = fopen(job->in_path, "rb");
+    if (!fin) return -2;
+    FILE* fout = fopen(job->out_path, "wb");
+    if (!fout) {
+        fclose(fin);
+        return -3;
+    }
+
+    int rc = 0;
+    hmac_ctx hmac;
+    sha512_ctx_t sc;
+    if (job->want_digest) sha512_init(&sc);
+    ctr_mode_ctx_t* ctr = worker_ctr(w, job, job->iv);
+    if (!ctr) rc = -4;
+
+    if (rc == 0) {
+        if (with_mac) {
+            worker_hmac(w, job, &hmac);
+            hmac_update(&hmac, job->iv, CTR_BLOCK_BYTES);
+        }
+        if (fwrite(job->iv, 1, CTR_BLOCK_BYTES, fout) != CTR_BLOCK_BYTES) rc = -6;
+    }
+
+    size_t got;
+    while (rc == 0 && (got = fread(w->buf, 1, w->buf_size, fin)) > 0) {
+        if (job->want_digest) sha512_update(&sc, w->buf, got);
+        ctr_mode_update(ctr, w->buf, w->buf, (int)got);
+        if (with_mac) hmac_update(&hmac, w->buf, got);
+        if (fwrite(w->buf, 1, got, fout) != got) rc = -6;
+    }
+    if (rc == 0 && ferror(fin)) rc = -7;
+
+    if (rc == 0 && with_mac) {
+        unsigned char tag[BATCH_TAG_BYTES];
+        hmac_final(&hmac, tag);
+        if (fwrite(tag, 1, sizeof(tag), fout) != sizeof(tag)) rc = -6;
+    }
+    if (with_mac) memset(&hmac, 0, sizeof(hmac));
+    if (rc == 0 && job->want_digest) sha512_final(&sc, job->digest);
+
+    fclose(fin);
+    if (fclose(fout) != 0 && rc == 0) rc = -6;
+    if (rc != 0) remove(job->out_path);
+    return rc;
+}
+
+// out_path + ".part"에 복호화, (태그가 맞으면) 이름 바꾸기
+static int job_decrypt(batch_worker_t* w, stream_batch_job_t* job, int with_mac)
+{
+    char* part_path = stream_path_suffix(job->out_path, STREAM_PARTIAL_SUFFIX);
+    if (!part_path) return -5;
+
+    FILE* fin = fopen(job->in_path, "rb");
+    if (!fin) {
+        free(part_path);
+        return -2;
+    }
+
+    int rc = 0;
+    size_t tail = with_mac ? BATCH_TAG_BYTES : 0;
+    long long size = stream_file_size(fin);
+    if (size < 0) rc = -7;
+    else if ((uint64_t)size < CTR_BLOCK_BYTES + tail) rc = -13;
+
+    unsigned char iv[CTR_BLOCK_BYTES];
+    if (rc == 0 && fread(iv, 1, CTR_BLOCK_BYTES, fin) != CTR_BLOCK_BYTES) rc = -7;
+
+    FILE* fout = NULL;
+    if (rc == 0) {
+        fout = fopen(part_path, "wb");
+        if (!fout) rc = -3;
+    }
+
+    hmac_ctx hmac;
+    ctr_mode_ctx_t* ctr = NULL;
+    if (rc == 0) {
+        ctr = worker_ctr(w, job, iv);
+        if (!ctr) rc = -4;
+    }
+    if (rc == 0 && with_mac) {
+        worker_hmac(w, job, &hmac);
+        hmac_update(&hmac, iv, CTR_BLOCK_BYTES);
+    }
+
+    // 크기로 CT 길이를 정하고 태그 앞까지만 읽는다
+    uint64_t left = (rc == 0) ? (uint64_t)size - CTR_BLOCK_BYTES - tail : 0;
+    while (rc == 0 && left > 0) {
+        size_t want = (size_t)(left < w->buf_size ? left : w->buf_size);
+        if (fread(w->buf, 1, want, fin) != want) {
+            rc = -7;
+            break;
+        }
+        if (with_mac) hmac_update(&hmac, w->buf, want);
+        ctr_mode_update(ctr, w->buf, w->buf, (int)want);
+        if (fwrite(w->buf, 1, want, fout) != want) rc = -6;
+        left -= want;
+    }
+
+    if (rc == 0 && with_mac) {
+        unsigned char tag[BATCH_TAG_BYTES];
+        unsigned char expect[BATCH_TAG_BYTES];
+        if (fread(tag, 1, sizeof(tag), fin) != sizeof(tag)) rc = -7;
+        hmac_final(&hmac, expect);
+        if (rc == 0) {
+            unsigned char diff = 0;
+            for (size_t i = 0; i < sizeof(tag); i++) diff |= (unsigned char)(tag[i] ^ expect[i]);
+            if (diff) rc = -10;
+        }
+        memset(expect, 0, sizeof(expect));
+    }
+    if (with_mac) memset(&hmac, 0, sizeof(hmac));
+
+    fclose(fin);
+    if (fout && fclose(fout) != 0 && rc == 0) rc = -6;
+
+    // 인증이 끝난 평문만 out_path에 나타난다
+    if (rc == 0 && stream_replace_file(part_path, job->out_path) != 0) rc = -6;
+    if (rc != 0 && fout) remove(part_path);
+    free(part_path);
+    return rc;
+}
+
+static int job_run(batch_worker_t* w, stream_batch_job_t* job)
+{
+    if (!job->in_path) return -1;
+    if (job->kind == STREAM_BATCH_SHA512) return job_hash(w, job);
+
+    if (job->kind != STREAM_BATCH_CTR && job->kind != STREAM_BATCH_CTR_HMAC) return -1;
+    if (!job->out_path || !job->engine || !job->key || job->key_len <= 0) return -1;
+
+    int with_mac = (job->kind == STREAM_BATCH_CTR_HMAC);
+    if (with_mac && !job->hmac_key) return -1;
+    return job->encrypt ? job_encrypt(w, job, with_mac) : job_decrypt(w, job, with_mac);
+}
+
+// -------------------------------------------------------------------
+// 큰 작업 나누기 (여러 스레드가 같은 파일의 다른 구간을 처리)
+//  - CTR은 카운터를 위치로 계산할 수 있어 구간마다 따로 처리 가능 (ctr_mode_seek)
+//  - 출력 파일은 미리 최종 크기로 만들어 두고 각 조각이 자기 위치에 쓴다
+//  - 조각 크기 = 그 스레드가 측정한 처리량 * BATCH_SEGMENT_TARGET_NS, 남은 양의
+//    1/(2 * 스레드 수)를 넘지 않게 해 끝으로 갈수록 작아진다 (마지막 조각끼리 끝나는 시각이 비슷)
+// -------------------------------------------------------------------
+
+static uint64_t split_segment_size(const batch_worker_t* w, uint64_t remain, unsigned int workers)
+{
+    uint64_t seg = w->seg_ns ? (uint64_t)((double)w->seg_bytes / (double)w->seg_ns * (double)BATCH_SEGMENT_TARGET_NS)
+                             : w->buf_size;
+    uint64_t fair = remain / (2 * (uint64_t)workers);
+    if (seg > fair) seg = fair;
+    if (seg < w->buf_size) seg = w->buf_size;
+    seg &= ~(uint64_t)(CTR_BLOCK_BYTES - 1);    // 조각 시작이 블록 경계가 되도록
+    if (seg < CTR_BLOCK_BYTES) seg = CTR_BLOCK_BYTES;
+    return seg < remain ? seg : remain;
+}
+
+// 작업이 모두 끝난 뒤 한 번: 결과 반영, 출력 정리
+static void split_finish(batch_t* b, batch_split_t* s)
+{
+    stream_batch_job_t* job = &b->jobs[s->job];
+    int rc = s->rc;
+    if (job->encrypt) {
+        if (rc != 0) remove(job->out_path);
+    }
+    else {
+        // 인증이 없는 형식이지만 단일 파일 복호화와 같이 다 쓴 뒤에만 out_path에 나타난다
+        if (rc == 0 && stream_replace_file(s->part_path, job->out_path) != 0) rc = -6;
+        if (rc != 0) remove(s->part_path);
+    }
+    job->rc = rc;
+    batch_finish(b);
+}
+
+// 조각 하나가 끝났거나(was_active) 더 나눠 줄 조각이 없을 때 호출. 마지막이면 마무리
+static void split_release(batch_t* b, batch_split_t* s, int seg_rc, int was_active)
+{
+    int finish = 0;
+    spin_lock(&s->lock);
+    if (was_active) s->active--;
+    if (seg_rc != 0 && s->rc == 0) s->rc = seg_rc;
+    if (s->rc != 0) s->next = s->len;          // 실패/취소 후에는 새 조각을 나눠 주지 않음
+    if (s->next >= s->len && s->active == 0 && !s->finished) {
+        s->finished = 1;
+        finish = 1;
+    }
+    spin_unlock(&s->lock);
+    if (finish) split_finish(b, s);
+}
+
+static int split_claim(batch_worker_t* w, batch_split_t* s, uint64_t* off, uint64_t* len)
+{
+    batch_t* b = w->b;
+    int got = 0;
+    spin_lock(&s->lock);
+    if (crypto_atomic_load(&b->cancelled) && s->rc == 0) s->rc = -16;
+    if (s->rc == 0 && s->next < s->len) {
+        *off = s->next;
+        *len = split_segment_size(w, s->len - s->next, b->workers);
+        s->next += *len;
+        s->active++;
+        got = 1;
+    }
+    spin_unlock(&s->lock);
+    return got;
+}
+
+// [off, off + len) 구간 암/복호화 (off는 블록 경계)
+static int split_run(batch_worker_t* w, batch_split_t* s, uint64_t off, uint64_t len)
+{
+    stream_batch_job_t* job = &w->b->jobs[s->job];
+    const char* out_path = job->encrypt ? job->out_path : s->part_path;
+    uint64_t in_off = job->encrypt ? off : CTR_BLOCK_BYTES + off;
+    uint64_t out_off = job->encrypt ? CTR_BLOCK_BYTES + off : off;
+
+    FILE* fin = fopen(job->in_path, "rb");
+    if (!fin) return -2;
+    FILE* fout = fopen(out_path, "r+b");
+    if (!fout) {
+        fclose(fin);
+        return -3;
+    }
+
+    int rc = 0;
+    if (stream_file_seek(fin, in_off) != 0) rc = -7;
+    else if (stream_file_seek(fout, out_off) != 0) rc = -6;
+
+    ctr_mode_ctx_t* ctr = NULL;
+    if (rc == 0) {
+        ctr = worker_ctr(w, job, s->iv);
+        if (!ctr) rc = -4;
+        else ctr_mode_seek(ctr, s->iv, off / CTR_BLOCK_BYTES);
+    }
+
+    uint64_t left = len;
+    while (rc == 0 && left > 0) {
+        size_t want = (size_t)(left < w->buf_size ? left : w->buf_size);
+        if (fread(w->buf, 1, want, fin) != want) {
+            rc = -7;
+            break;
+        }
+        ctr_mode_update(ctr, w->buf, w->buf, (int)want);
+        if (fwrite(w->buf, 1, want, fout) != want) rc = -6;
+        left -= want;
+    }
+
+    fclose(fin);
+    if (fclose(fout) != 0 && rc == 0) rc = -6;
+    return rc;
+}
+
+// 나눠 줄 조각이 남은 큰 작업을 하나 처리. 없으면 0
+static int batch_help_split(batch_worker_t* w)
+{
+    batch_t* b = w->b;
+    for (size_t k = 0; k < b->n_split; k++) {
+        batch_split_t* s = &b->split[(w->id + k) % b->n_split];
+        uint64_t off = 0, len = 0;
+        if (!split_claim(w, s, &off, &len)) {
+            split_release(b, s, 0, 0);
+            continue;
+        }
+
+        uint64_t t0 = crypto_now_ns();
+        int rc = split_run(w, s, off, len);
+        uint64_t dt = crypto_now_ns() - t0;
+        w->busy_ns += dt;
+        w->segments++;
+        if (rc == 0) {
+            w->seg_bytes += len;
+            w->seg_ns += dt;
+        }
+        split_release(b, s, rc, 1);
+        return 1;
+    }
+    return 0;
+}
+
+// 나눌 작업 준비 (호출 스레드, 작업 시작 전): 출력을 최종 크기로 만든다
+//  - 크기는 stat으로만 확인하므로 나누지 않을 작은 파일은 열지 않는다
+//    (작은 파일이 많은 묶음에서 호출 스레드가 파일마다 직렬로 여닫지 않도록)
+//  반환: 1 나눔, 0 통째로 처리, 음수 = 작업 실패 (rc)
+static int split_prepare(batch_split_t* s, const stream_batch_job_t* job, uint64_t min_len)
+{
+    if (job->kind != STREAM_BATCH_CTR || !job->in_path || !job->out_path ||
+        !job->engine || !job->key || job->key_len <= 0 || job->want_digest)
+        return 0;
+
+    long long size = stream_path_size(job->in_path);
+    uint64_t head = job->encrypt ? 0 : CTR_BLOCK_BYTES;
+    if (size < 0 || (uint64_t)size < head + min_len) return 0;
+
+    memset(s, 0, sizeof(*s));
+    s->len = (uint64_t)size - head;
+    if (job->encrypt) memcpy(s->iv, job->iv, CTR_BLOCK_BYTES);
+    else {
+        FILE* fin = fopen(job->in_path, "rb");
+        if (!fin) return 0;
+        size_t got = fread(s->iv, 1, CTR_BLOCK_BYTES, fin);
+        fclose(fin);
+        if (got != CTR_BLOCK_BYTES) return 0;
+    }
+
+    const char* out_path = job->out_path;
+    if (!job->encrypt) {
+        s->part_path = stream_path_suffix(job->out_path, STREAM_PARTIAL_SUFFIX);
+        if (!s->part_path) return -5;
+        out_path = s->part_path;
+    }
+
+    FILE* fout = fopen(out_path, "wb");
+    if (!fout) return -3;
+    int rc = 0;
+    if (job->encrypt && fwrite(job->iv, 1, CTR_BLOCK_BYTES, fout) != CTR_BLOCK_BYTES) rc = -6;
+    if (rc == 0 && stream_file_truncate(fout, (job->encrypt ? CTR_BLOCK_BYTES : 0) + s->len) != 0) rc = -6;
+    if (fclose(fout) != 0 && rc == 0) rc = -6;
+    if (rc != 0) remove(out_path);
+    return rc == 0 ? 1 : rc;
+}
+
+static void batch_worker(void* arg)
+{
+    batch_worker_t* w = (batch_worker_t*)arg;
+    batch_t* b = w->b;
+    size_t idx;
+
+    // 큰 작업의 조각을 먼저, 작은 작업은 그 뒤 (끝부분을 작은 작업들이 고르게 채움)
+    for (;;) {
+        if (batch_help_split(w)) continue;
+        if (!batch_pop(w, &idx)) {
+            if (!batch_steal(w)) break;
+            continue;
+        }
+
+        stream_batch_job_t* job = &b->jobs[idx];
+        if (crypto_atomic_load(&b->cancelled)) {
+            job->rc = -16;
+            continue;
+        }
+        uint64_t t0 = crypto_now_ns();
+        job->rc = job_run(w, job);
+        w->busy_ns += crypto_now_ns() - t0;
+        batch_finish(b);
+    }
+}
+
+// -------------------------------------------------------------------
+// 공개 API
+// -------------------------------------------------------------------
+
+static void batch_free(batch_t* b)
+{
+    for (unsigned int i = 0; i < b->workers; i++) {
+        batch_worker_t* w = &b->w[i];
+        if (w->buf) {
+            memset(w->buf, 0, w->buf_size);
+            free(w->buf);
+        }
+        if (w->ctr) ctr_mode_free(w->ctr);
+        if (w->hk_valid) hmac_key_clear(&w->hk);
+    }
+    for (size_t i = 0; i < b->n_split; i++) free(b->split[i].part_path);
+    free(b->split);
+    free(b->order);
+    free(b);
+}
+
+int stream_encrypt_batch_ex(stream_batch_job_t* jobs, size_t n, const stream_options_t* opt,
+                            stream_batch_stats_t* stats)
+{
+    if (stats) memset(stats, 0, sizeof(*stats));
+    if (!jobs && n) return -1;
+    if (opt && opt->compress) return -1;
+    if (n == 0) return 0;
+
+    uint64_t t_start = crypto_now_ns();
+    batch_t* b = (batch_t*)calloc(1, sizeof(batch_t));
+    if (!b) return -5;
+    b->jobs = jobs;
+    b->n = n;
+    b->opt = opt;
+    b->order = (size_t*)malloc(n * sizeof(size_t));
+    b->split = (batch_split_t*)calloc(n, sizeof(batch_split_t));
+    if (!b->order || !b->split) {
+        batch_free(b);
+        return -5;
+    }
+
+    unsigned int workers = opt ? opt->threads : 0;
+    if (workers == 0) workers = crypto_cpu_count();
+    if (workers > STREAM_PIPELINE_MAX_WORKERS) workers = STREAM_PIPELINE_MAX_WORKERS;
+    if (workers == 0) workers = 1;
+    size_t buf_size = stream_effective_buf_size(opt, -1);
+
+    // 버퍼 BATCH_SPLIT_MIN_BUFS개 이상인 CTR 작업은 조각으로 나누고, 나머지는 통째로
+    for (size_t i = 0; i < n; i++) {
+        jobs[i].rc = -16;
+        int r = (workers > 1) ? split_prepare(&b->split[b->n_split], &jobs[i], (uint64_t)buf_size * STREAM_BATCH_SPLIT_MIN_BUFS) : 0;
+        if (r == 1) b->split[b->n_split++].job = i;
+        else if (r < 0) {
+            free(b->split[b->n_split].part_path);
+            b->split[b->n_split].part_path = NULL;
+            jobs[i].rc = r;
+            batch_finish(b);
+        }
+        else b->order[b->n_whole++] = i;
+    }
+    if (b->n_split == 0 && (size_t)workers > b->n_whole) workers = b->n_whole ? (unsigned int)b->n_whole : 1;
+    b->workers = workers;
+
+    // 통째로 처리할 작업은 고르게 나눠 두고, 먼저 끝난 스레드가 나머지를 가져간다
+    for (unsigned int i = 0; i < workers; i++) {
+        batch_worker_t* w = &b->w[i];
+        w->b = b;
+        w->id = i;
+        w->lo = b->n_whole * i / workers;
+        w->hi = b->n_whole * (i + 1) / workers;
+        w->buf_size = buf_size;
+        w->buf = (unsigned char*)malloc(buf_size);
+        if (!w->buf) {
+            // 준비해 둔 출력은 정리
+            for (size_t k = 0; k < b->n_split; k++) {
+                b->split[k].rc = -5;
+                b->split[k].next = b->split[k].len;
+                split_release(b, &b->split[k], 0, 0);
+            }
+            batch_free(b);
+            return -5;
+        }
+    }
+
+    // 시작하지 못한 스레드의 구간은 다른 스레드가 가져가므로 계속 진행
+    crypto_thread_t threads[STREAM_PIPELINE_MAX_WORKERS];
+    unsigned int started = 1;
+    for (; started < workers; started++)
+        if (crypto_thread_start(&threads[started], batch_worker, &b->w[started]) != 0) break;
+    batch_worker(&b->w[0]);
+    for (unsigned int i = 1; i < started; i++) crypto_thread_join(&threads[i]);
+
+    int failed = 0;
+    for (size_t i = 0; i < n; i++)
+        if (jobs[i].rc != 0) failed++;
+
+    if (stats) {
+        stats->threads = started;
+        stats->split_jobs = b->n_split;
+        stats->wall_ns = crypto_now_ns() - t_start;
+        for (unsigned int i = 0; i < workers; i++) {
+            stats->segments += b->w[i].segments;
+            stats->busy_ns += b->w[i].busy_ns;
+        }
+        if (stats->wall_ns)
+            stats->efficiency = (double)stats->busy_ns / ((double)stats->wall_ns * started);
+    }
+
+    batch_free(b);
+    return failed;
+}
+
+int stream_encrypt_batch(stream_batch_job_t* jobs, size_t n, const stream_options_t* opt)
+{
+    return stream_encrypt_batch_ex(jobs, n, opt, NULL);
+}
@@ -0,0 +1,996 @@
+﻿#include "crypto/stream/stream_chunked.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "crypto/bytes.h"
+#include "crypto/status.h"
+#include "crypto/core/crypto_thread.h"
+#include "crypto/hash/hmac.h"
+#include "crypto/stream/stream_fileutil.h"
+#include "crypto/stream/stream_lz.h"
+#include "crypto/stream/stream_pipeline.h"
+
+static const unsigned char CHUNKED_MAGIC[4] = { 'S', 'C', 'H', 'K' };
+
+// 묶음 하나의 청크 수 = 스레드 수 * CHUNKED_GROUP_PER_WORKER
+// (묶음 두 개를 번갈아 써서 한 묶음을 처리하는 동안 다른 묶음을 읽고 기록)
+#define CHUNKED_GROUP_PER_WORKER 2u
+
+// -------------------------------------------------------------------
+// 청크 묶음 병렬 처리
+// -------------------------------------------------------------------
+
+typedef struct chunk_job_t {
+    unsigned char* rec;     // CT || tag (chunk_size + TAG 바이트 버퍼)
+    size_t len;             // CT 길이 (압축 컨테이너는 저장 길이)
+    size_t plain;           // 평문 길이 (압축하지 않았으면 len과 같음)
+    unsigned char head[STREAM_CHUNKED_RECORD_HEAD];   // 압축 컨테이너: 평문 길이 | 저장 길이
+    uint64_t index;         // 청크 번호
+    uint64_t in_bytes;      // 진행률: 이 청크로 읽은 입력 바이트
+    int final;              // 마지막 청크
+    int rc;                 // 복호화: 0 성공 / -10 태그 불일치
+} chunk_job_t;
+
+typedef struct chunk_shared_t {
+    const struct chunk_shared_t* from;  // 키 교체: 이전 키/헤더의 상태 (NULL이면 일반 암/복호화)
+    const unsigned char* iv;
+    hmac_ctx base;          // 헤더까지 MAC한 상태 (청크마다 복사해서 시작)
+    uint64_t blocks_per_chunk;
+    int encrypt;
+    int lz;                 // 압축 컨테이너 (헤더 플래그 STREAM_CHUNKED_FLAG_LZ)
+    chunk_job_t* jobs;      // 이번 묶음 (chunked_dispatch가 설정)
+    size_t count;           // 이번 묶음의 청크 수
+    unsigned int workers;
+    crypto_atomic_t gen;    // 풀에 넘긴 묶음 세대 (바뀌면 스레드가 jobs/count를 처리)
+    crypto_atomic_t stop;   // 풀 종료
+} chunk_shared_t;
+
+typedef struct chunk_worker_t {
+    chunk_shared_t* sh;
+    ctr_mode_ctx_t* ctr;    // 스레드별 CTR 컨텍스트 (seek으로 재사용)
+    ctr_mode_ctx_t* from_ctr;   // 키 교체: 이전 키 CTR 컨텍스트
+    unsigned char* ks;          // 키 교체: 이전 ⊕ 새 keystream (청크 크기)
+    unsigned char* lz_buf;      // 압축 컨테이너: 압축/해제 작업 버퍼 (청크 크기)
+    unsigned int index;
+    crypto_atomic_t done;       // 처리를 마친 묶음 세대
+} chunk_worker_t;
+
+static void chunk_tag(const chunk_shared_t* sh, const chunk_job_t* job, unsigned char tag[STREAM_CHUNKED_TAG_BYTES])
+{
+    unsigned char meta[9];
+    store_be64(meta, job->index);
+    meta[8] = (unsigned char)(job->final ? 1 : 0);
+
+    hmac_ctx h = sh->base;
+    hmac_update(&h, meta, sizeof(meta));
+    if (sh->lz) hmac_update(&h, job->head, STREAM_CHUNKED_RECORD_HEAD);
+    hmac_update(&h, job->rec, job->len);
+    hmac_final(&h, tag);
+    memset(&h, 0, sizeof(h));
+}
+
+// 압축 컨테이너: 엔트로피 검사를 통과하고 실제로 줄어들 때만 압축본으로 바꾸고 길이 필드 기록
+static void chunk_compress(chunk_job_t* job, unsigned char* scratch)
+{
+    job->plain = job->len;
+    if (stream_lz_probe(job->rec, job->len)) {
+        size_t n = stream_lz_compress(job->rec, job->len, scratch, job->len - 1);
+        if (n) {
+            memcpy(job->rec, scratch, n);
+            job->len = n;
+        }
+    }
+    store_be32(job->head, (uint32_t)job->plain);
+    store_be32(job->head + 4, (uint32_t)job->len);
+}
+
+// scratch: 압축 컨테이너의 압축/해제 버퍼 (청크 크기, 일반 컨테이너는 NULL 가능)
+static void chunk_process(const chunk_shared_t* sh, ctr_mode_ctx_t* ctr, unsigned char* scratch, chunk_job_t* job)
+{
+    ctr_mode_seek(ctr, sh->iv, job->index * sh->blocks_per_chunk);
+
+    if (sh->encrypt) {
+        // (압축 후) 암호화하고 CT에 태그
+        if (sh->lz) chunk_compress(job, scratch);
+        if (job->len) ctr_mode_update(ctr, job->rec, job->rec, (int)job->len);
+        chunk_tag(sh, job, job->rec + job->len);
+        job->rc = 0;
+        return;
+    }
+
+    // 검증이 끝난 청크만 복호화 (상수 시간 비교)
+    unsigned char tag[STREAM_CHUNKED_TAG_BYTES];
+    chunk_tag(sh, job, tag);
+    unsigned char diff = 0;
+    for (size_t i = 0; i < STREAM_CHUNKED_TAG_BYTES; i++) diff |= (unsigned char)(tag[i] ^ job->rec[job->len + i]);
+    memset(tag, 0, sizeof(tag));
+
+    job->rc = diff ? -10 : 0;
+    if (diff == 0 && job->len) ctr_mode_update(ctr, job->rec, job->rec, (int)job->len);
+
+    // 인증된 압축본이 풀리지 않으면 (키를 가진 쪽이 만든 잘못된 청크) 인증 실패로 처리
+    if (diff == 0 && sh->lz && job->len < job->plain) {
+        long long n = stream_lz_decompress(job->rec, job->len, scratch, job->plain);
+        if (n != (long long)job->plain) {
+            job->rc = -10;
+            return;
+        }
+        memcpy(job->rec, scratch, job->plain);
+        job->len = job->plain;
+    }
+}
+
+// 키 교체: 이전 키 태그 확인 → (이전 keystream ⊕ 새 keystream)을 CT에 한 번 XOR → 새 태그
+//  - 평문은 메모리에도 만들어지지 않는다
+static void chunk_rekey(const chunk_shared_t* sh, chunk_worker_t* w, chunk_job_t* job)
+{
+    const chunk_shared_t* from = sh->from;
+    unsigned char tag[STREAM_CHUNKED_TAG_BYTES];
+    chunk_tag(from, job, tag);
+    unsigned char diff = 0;
+    for (size_t i = 0; i < STREAM_CHUNKED_TAG_BYTES; i++) diff |= (unsigned char)(tag[i] ^ job->rec[job->len + i]);
+    memset(tag, 0, sizeof(tag));
+    if (diff) {
+        job->rc = -10;
+        return;
+    }
+
+    if (job->len) {
+        memset(w->ks, 0, job->len);
+        ctr_mode_seek(w->from_ctr, from->iv, job->index * from->blocks_per_chunk);
+        ctr_mode_update(w->from_ctr, w->ks, w->ks, (int)job->len);
+        ctr_mode_seek(w->ctr, sh->iv, job->index * sh->blocks_per_chunk);
+        ctr_mode_update(w->ctr, w->ks, w->ks, (int)job->len);
+        for (size_t i = 0; i < job->len; i++) job->rec[i] ^= w->ks[i];
+    }
+    chunk_tag(sh, job, job->rec + job->len);
+    job->rc = 0;
+}
+
+// stream_pipeline과 같은 단계적 대기 (잠깐 돌다가 양보, 그 뒤로는 1ms씩 휴면)
+static void chunk_backoff(unsigned int* spins)
+{
+    unsigned int n = (*spins)++;
+    if (n < 64) return;
+    if (n < 256) crypto_thread_yield();
+    else crypto_thread_sleep_ms(1);
+}
+
+// 풀 스레드: 세대(gen)가 바뀔 때마다 이번 묶음의 k번째 청크 중 (k % workers)번 몫을 처리하고
+// 처리한 세대를 done에 기록. stop이 켜지면 종료
+static void chunk_worker(void* arg)
+{
+    chunk_worker_t* w = (chunk_worker_t*)arg;
+    const chunk_shared_t* sh = w->sh;
+    long seen = 0;
+    for (;;) {
+        unsigned int spins = 0;
+        long gen;
+        while ((gen = crypto_atomic_load(&sh->gen)) == seen) {
+            if (crypto_atomic_load(&sh->stop)) return;
+            chunk_backoff(&spins);
+        }
+        seen = gen;
+        for (size_t k = w->index; k < sh->count; k += sh->workers) {
+            if (sh->from) chunk_rekey(sh, w, &sh->jobs[k]);
+            else chunk_process(sh, w->ctr, w->lz_buf, &sh->jobs[k]);
+        }
+        crypto_atomic_store(&w->done, gen);
+    }
+}
+
+// -------------------------------------------------------------------
+// 공통 준비: 스레드별 컨텍스트, 청크 버퍼, 스레드 풀
+// -------------------------------------------------------------------
+
+typedef struct chunked_t {
+    chunk_shared_t sh;
+    chunk_worker_t workers[STREAM_PIPELINE_MAX_WORKERS];
+    crypto_thread_t threads[STREAM_PIPELINE_MAX_WORKERS];
+    unsigned int started;   // 시작한 풀 스레드 수
+    chunk_job_t* jobs;      // 묶음 버퍼 2개 (처리 중인 묶음 / 읽기·기록 중인 묶음)
+    size_t group;           // 묶음당 청크 수
+    size_t chunk_size;
+    unsigned char iv[CTR_BLOCK_BYTES];
+} chunked_t;
+
+static unsigned int chunked_workers(const stream_options_t* opt)
+{
+    unsigned int n = opt ? opt->threads : 0;
+    if (n == 0) n = crypto_cpu_count();
+    if (n > STREAM_PIPELINE_MAX_WORKERS) n = STREAM_PIPELINE_MAX_WORKERS;
+    return n ? n : 1;
+}
+
+static void chunked_free(chunked_t* c)
+{
+    // 처리 중인 묶음이 있으면 끝낸 뒤 종료하므로 버퍼는 join 뒤에 해제
+    crypto_atomic_store(&c->sh.stop, 1);
+    for (unsigned int i = 0; i < c->started; i++) crypto_thread_join(&c->threads[i]);
+
+    for (unsigned int i = 0; i < STREAM_PIPELINE_MAX_WORKERS; i++) {
+        if (c->workers[i].ctr) ctr_mode_free(c->workers[i].ctr);
+        if (c->workers[i].from_ctr) ctr_mode_free(c->workers[i].from_ctr);
+        if (c->workers[i].ks) {
+            memset(c->workers[i].ks, 0, c->chunk_size);
+            free(c->workers[i].ks);
+        }
+        if (c->workers[i].lz_buf) {
+            memset(c->workers[i].lz_buf, 0, c->chunk_size);
+            free(c->workers[i].lz_buf);
+        }
+    }
+    if (c->jobs) {
+        for (size_t i = 0; i < c->group * 2; i++) {
+            if (c->jobs[i].rec) {
+                memset(c->jobs[i].rec, 0, c->chunk_size + STREAM_CHUNKED_TAG_BYTES);
+                free(c->jobs[i].rec);
+            }
+        }
+        free(c->jobs);
+    }
+    memset(c, 0, sizeof(*c));
+}
+
+// 헤더가 정해진 뒤 호출 (iv, chunk_size 설정 완료). 스레드는 chunked_start에서 시작
+static int chunked_init(chunked_t* c, const blockcipher_vtable_t* engine,
+                        const unsigned char* key, int key_len,
+                        const unsigned char header[STREAM_CHUNKED_HEADER_BYTES],
+                        const unsigned char* hmac_key, size_t hmac_key_len,
+                        int encrypt, const stream_options_t* opt)
+{
+    unsigned int workers = chunked_workers(opt);
+    c->sh.iv = c->iv;
+    c->sh.blocks_per_chunk = c->chunk_size / CTR_BLOCK_BYTES;
+    c->sh.encrypt = encrypt;
+    c->sh.lz = (header[8] & STREAM_CHUNKED_FLAG_LZ) != 0;
+    c->sh.workers = workers;
+    hmac_init(&c->sh.base, hmac_key, hmac_key_len);
+    hmac_update(&c->sh.base, header, STREAM_CHUNKED_HEADER_BYTES);
+
+    for (unsigned int i = 0; i < workers; i++) {
+        c->workers[i].sh = &c->sh;
+        c->workers[i].index = i;
+        c->workers[i].ctr = ctr_mode_init(engine, key, key_len, c->iv);
+        if (!c->workers[i].ctr) return -4;
+        if (c->sh.lz) {
+            c->workers[i].lz_buf = (unsigned char*)malloc(c->chunk_size);
+            if (!c->workers[i].lz_buf) return -5;
+        }
+    }
+
+    c->group = (size_t)workers * CHUNKED_GROUP_PER_WORKER;
+    c->jobs = (chunk_job_t*)calloc(c->group * 2, sizeof(chunk_job_t));
+    if (!c->jobs) return -5;
+    for (size_t i = 0; i < c->group * 2; i++) {
+        c->jobs[i].rec = (unsigned char*)malloc(c->chunk_size + STREAM_CHUNKED_TAG_BYTES);
+        if (!c->jobs[i].rec) return -5;
+    }
+    return 0;
+}
+
+// 풀 스레드 시작 (스레드별 컨텍스트를 모두 준비한 뒤). 실패하면 -12 (정리는 chunked_free)
+static int chunked_start(chunked_t* c)
+{
+    for (; c->started < c->sh.workers; c->started++) {
+        if (crypto_thread_start(&c->threads[c->started], chunk_worker, &c->workers[c->started]) != 0)
+            return -12;
+    }
+    return 0;
+}
+
+// 묶음을 풀에 넘긴다 (이전 묶음은 chunked_wait로 끝난 상태여야 함)
+static void chunked_dispatch(chunked_t* c, chunk_job_t* jobs, size_t count)
+{
+    c->sh.jobs = jobs;
+    c->sh.count = count;
+    crypto_atomic_store(&c->sh.gen, crypto_atomic_load(&c->sh.gen) + 1);
+}
+
+// 마지막으로 넘긴 묶음을 모든 풀 스레드가 끝낼 때까지 대기
+static void chunked_wait(chunked_t* c)
+{
+    long gen = crypto_atomic_load(&c->sh.gen);
+    for (unsigned int i = 0; i < c->started; i++) {
+        unsigned int spins = 0;
+        while (crypto_atomic_load(&c->workers[i].done) != gen) chunk_backoff(&spins);
+    }
+}
+
+static void header_build(unsigned char h[STREAM_CHUNKED_HEADER_BYTES], int key_len,
+                         size_t chunk_size, unsigned char flags, const unsigned char iv[CTR_BLOCK_BYTES])
+{
+    memset(h, 0, STREAM_CHUNKED_HEADER_BYTES);
+    memcpy(h, CHUNKED_MAGIC, 4);
+    store_be32(h + 4, STREAM_CHUNKED_VERSION);
+    h[8] = flags;
+    h[9] = STREAM_CHUNKED_CIPHER_AES;
+    h[10] = (unsigned char)((key_len * 8) >> 8);
+    h[11] = (unsigned char)(key_len * 8);
+    store_be32(h + 12, (uint32_t)chunk_size);
+    store_be32(h + 16, STREAM_CHUNKED_TAG_BYTES);
+    memcpy(h + 32, iv, CTR_BLOCK_BYTES);
+}
+
+static int chunk_size_valid(size_t chunk_size)
+{
+    return chunk_size >= STREAM_CHUNKED_MIN_CHUNK &&
+        chunk_size <= STREAM_CHUNKED_MAX_CHUNK &&
+        chunk_size % CTR_BLOCK_BYTES == 0;
+}
+
+// 반환: 0 정상, -17 형식/버전/키 길이 불일치 (모르는 플래그 포함)
+static int header_parse(const unsigned char h[STREAM_CHUNKED_HEADER_BYTES], int key_len,
+                        size_t* chunk_size, unsigned char iv[CTR_BLOCK_BYTES])
+{
+    static const unsigned char zero[12] = { 0 };
+    if (memcmp(h, CHUNKED_MAGIC, 4) != 0 ||
+        load_be32(h + 4) != STREAM_CHUNKED_VERSION ||
+        (h[8] & ~STREAM_CHUNKED_FLAG_LZ) != 0 || h[9] != STREAM_CHUNKED_CIPHER_AES ||
+        (((int)h[10] << 8) | h[11]) != key_len * 8 ||
+        load_be32(h + 16) != STREAM_CHUNKED_TAG_BYTES ||
+        memcmp(h + 20, zero, sizeof(zero)) != 0)
+        return -17;
+
+    *chunk_size = load_be32(h + 12);
+    if (!chunk_size_valid(*chunk_size)) return -17;
+    memcpy(iv, h + 32, CTR_BLOCK_BYTES);
+    return 0;
+}
+
+// 진행률 / 취소 (반환: 1 취소)
+//  - final: 마지막 청크까지 기록함. 완성된 출력을 취소로 지우지 않도록 취소는 묻지 않는다
+static int chunked_tick(const stream_options_t* opt, uint64_t done, uint64_t total, int final)
+{
+    if (!opt) return 0;
+    if (opt->progress) opt->progress(opt->user, done, total);
+    return (!final && opt->cancel && opt->cancel(opt->user)) ? 1 : 0;
+}
+
+// 레코드 하나 읽기 (index 제외한 job 필드 설정, in_bytes = 레코드 크기)
+//  - 일반: 레코드보다 짧게 읽힌 것이 마지막 청크
+//  - 압축: 길이 필드를 먼저 읽고, 평문 길이가 청크 크기보다 짧은 것이 마지막 청크
+// 반환: 0, -7 읽기, -10 길이 필드 변조, -13 잘림 (마지막 청크 없이 끝남)
+static int chunk_read_record(FILE* in, size_t chunk_size, int lz, chunk_job_t* job)
+{
+    if (!lz) {
+        const size_t rec_size = chunk_size + STREAM_CHUNKED_TAG_BYTES;
+        size_t n = fread(job->rec, 1, rec_size, in);
+        if (n < STREAM_CHUNKED_TAG_BYTES) return ferror(in) ? -7 : -13;
+        job->len = job->plain = n - STREAM_CHUNKED_TAG_BYTES;
+        job->in_bytes = n;
+        job->final = (n < rec_size);
+        return 0;
+    }
+
+    if (fread(job->head, 1, STREAM_CHUNKED_RECORD_HEAD, in) != STREAM_CHUNKED_RECORD_HEAD)
+        return ferror(in) ? -7 : -13;
+    job->plain = load_be32(job->head);
+    job->len = load_be32(job->head + 4);
+    if (job->plain > chunk_size || job->len > job->plain) return -10;
+    size_t n = job->len + STREAM_CHUNKED_TAG_BYTES;
+    if (fread(job->rec, 1, n, in) != n) return ferror(in) ? -7 : -13;
+    job->in_bytes = STREAM_CHUNKED_RECORD_HEAD + n;
+    job->final = (job->plain < chunk_size);
+    return 0;
+}
+
+static int chunk_write_record(FILE* out, int lz, const chunk_job_t* job)
+{
+    size_t n = job->len + STREAM_CHUNKED_TAG_BYTES;
+    if (lz && fwrite(job->head, 1, STREAM_CHUNKED_RECORD_HEAD, out) != STREAM_CHUNKED_RECORD_HEAD) return -6;
+    return fwrite(job->rec, 1, n, out) == n ? 0 : -6;
+}
+
+// 청크 하나 읽기 / 처리된 청크 하나 기록 (암호화, 복호화, 키 교체가 각자 정의)
+typedef int (*chunk_read_fn)(void* ctx, const chunked_t* c, chunk_job_t* job);
+typedef int (*chunk_write_fn)(void* ctx, const chunked_t* c, const chunk_job_t* job);
+
+// 묶음 채우기: 가득 차거나 마지막 청크를 읽으면 멈춤. 반환: 0 또는 읽기 오류
+static int chunked_fill(const chunked_t* c, chunk_job_t* jobs, size_t* count,
+                        uint64_t* index, int* final, chunk_read_fn rd, void* ctx)
+{
+    *count = 0;
+    while (*count < c->group && !*final) {
+        chunk_job_t* job = &jobs[*count];
+        int rc = rd(ctx, c, job);
+        if (rc != 0) return rc;
+        job->index = (*index)++;
+        *final = job->final;
+        (*count)++;
+    }
+    return 0;
+}
+
+// 묶음 두 개를 번갈아 쓰며 읽기 / 병렬 처리 / 기록을 겹친다
+//  - 풀이 묶음 k를 처리하는 동안 호출 스레드는 묶음 k+1을 읽고, k가 끝나면 k+1을 넘긴 뒤 k를 기록
+//  - 읽기 오류가 나면 그 앞까지 읽은 청크는 처리/기록하고 오류를 반환 (앞선 청크의 오류가 우선)
+//  - done: 진행률 시작 값 (이미 읽은 헤더 등). 진행률/취소는 묶음을 기록할 때마다
+static int chunked_run(chunked_t* c, chunk_read_fn rd, chunk_write_fn wr, void* ctx,
+                       uint64_t done, uint64_t total, const stream_options_t* opt)
+{
+    int rc = chunked_start(c);
+    if (rc != 0) return rc;
+
+    chunk_job_t* cur = c->jobs;
+    chunk_job_t* next = c->jobs + c->group;
+    size_t cur_n = 0;
+    uint64_t index = 0;
+    int final = 0;
+    int read_rc = chunked_fill(c, cur, &cur_n, &index, &final, rd, ctx);
+    if (cur_n > 0) chunked_dispatch(c, cur, cur_n);
+
+    while (rc == 0 && cur_n > 0) {
+        size_t next_n = 0;
+        if (read_rc == 0 && !final) read_rc = chunked_fill(c, next, &next_n, &index, &final, rd, ctx);
+        chunked_wait(c);
+        if (next_n > 0) chunked_dispatch(c, next, next_n);
+
+        for (size_t i = 0; rc == 0 && i < cur_n; i++) {
+            rc = wr(ctx, c, &cur[i]);
+            if (rc == 0) done += cur[i].in_bytes;
+        }
+        if (rc == 0 && chunked_tick(opt, done, total, cur[cur_n - 1].final)) rc = -16;
+
+        chunk_job_t* t = cur;
+        cur = next;
+        next = t;
+        cur_n = next_n;
+    }
+    // 처리 중인 묶음은 chunked_free가 기다린 뒤 정리
+    return rc != 0 ? rc : read_rc;
+}
+
+// chunked_run 콜백 인자
+typedef struct chunk_io_t {
+    crypto_stream_read_fn read_fn;      // 암호화 입력
+    void* read_ctx;
+    FILE* in;                           // 복호화 / 키 교체 입력 (컨테이너)
+    crypto_stream_write_fn write_fn;    // 복호화 출력
+    void* write_ctx;
+    FILE* out;                          // 암호화 / 키 교체 출력 (컨테이너)
+} chunk_io_t;
+
+// 평문 청크 읽기: 청크 크기보다 짧게 읽힌 청크가 마지막
+static int chunk_read_plain(void* ctx, const chunked_t* c, chunk_job_t* job)
+{
+    chunk_io_t* io = (chunk_io_t*)ctx;
+    job->len = 0;
+    while (job->len < c->chunk_size) {
+        long long n = io->read_fn(io->read_ctx, job->rec + job->len, c->chunk_size - job->len);
+        if (n < 0) return -7;
+        if (n == 0) break;
+        job->len += (size_t)n;
+    }
+    job->in_bytes = job->len;
+    job->final = (job->len < c->chunk_size);
+    return 0;
+}
+
+static int chunk_read_sealed(void* ctx, const chunked_t* c, chunk_job_t* job)
+{
+    return chunk_read_record(((chunk_io_t*)ctx)->in, c->chunk_size, c->sh.lz, job);
+}
+
+// 검증된 평문만 내보냄 (실패한 청크에서 멈춤)
+static int chunk_write_plain(void* ctx, const chunked_t* c, const chunk_job_t* job)
+{
+    chunk_io_t* io = (chunk_io_t*)ctx;
+    (void)c;
+    if (job->rc != 0) return job->rc;
+    if (job->len && io->write_fn(io->write_ctx, job->rec, job->len) != 0) return -6;
+    return 0;
+}
+
+static int chunk_write_sealed(void* ctx, const chunked_t* c, const chunk_job_t* job)
+{
+    if (job->rc != 0) return job->rc;
+    return chunk_write_record(((chunk_io_t*)ctx)->out, c->sh.lz, job);
+}
+
+// -------------------------------------------------------------------
+// 암호화
+// -------------------------------------------------------------------
+
+int stream_chunked_encrypt_stream(const blockcipher_vtable_t* engine,
+                                  crypto_stream_read_fn read_fn,
+                                  void* read_ctx,
+                                  FILE* out,
+                                  const unsigned char* key,
+                                  int key_len,
+                                  const unsigned char iv[CTR_BLOCK_BYTES],
+                                  const unsigned char* hmac_key,
+                                  size_t hmac_key_len,
+                                  size_t chunk_size,
+                                  uint64_t total,
+                                  const stream_options_t* opt)
+{
+    if (chunk_size == 0) chunk_size = STREAM_CHUNKED_DEFAULT_CHUNK;
+    if (!engine || !read_fn || !out || !key || key_len <= 0 || !iv || !hmac_key ||
+        !chunk_size_valid(chunk_size))
+        return -1;
+
+    unsigned char header[STREAM_CHUNKED_HEADER_BYTES];
+    header_build(header, key_len, chunk_size,
+                 (unsigned char)((opt && opt->compress) ? STREAM_CHUNKED_FLAG_LZ : 0), iv);
+
+    chunked_t c;
+    memset(&c, 0, sizeof(c));
+    c.chunk_size = chunk_size;
+    memcpy(c.iv, iv, CTR_BLOCK_BYTES);
+    int rc = chunked_init(&c, engine, key, key_len, header, hmac_key, hmac_key_len, 1, opt);
+    if (rc == 0 && fwrite(header, 1, sizeof(header), out) != sizeof(header)) rc = -6;
+
+    // (압축 +) 암호화 + 태그는 풀에서, 읽기와 순서대로 기록은 호출 스레드에서
+    chunk_io_t io;
+    memset(&io, 0, sizeof(io));
+    io.read_fn = read_fn;
+    io.read_ctx = read_ctx;
+    io.out = out;
+    if (rc == 0) rc = chunked_run(&c, chunk_read_plain, chunk_write_sealed, &io, 0, total, opt);
+
+    chunked_free(&c);
+    memset(header, 0, sizeof(header));
+    return rc;
+}
+
+int stream_chunked_encrypt_file(const blockcipher_vtable_t* engine,
+                                const char* in_path,
+                                const char* out_path,
+                                const unsigned char* key,
+                                int key_len,
+                                const unsigned char iv[CTR_BLOCK_BYTES],
+                                const unsigned char* hmac_key,
+                                size_t hmac_key_len,
+                                size_t chunk_size,
+                                const stream_options_t* opt)
+{
+    if (chunk_size == 0) chunk_size = STREAM_CHUNKED_DEFAULT_CHUNK;
+    if (!engine || !in_path || !out_path || !key || key_len <= 0 || !iv || !hmac_key ||
+        !chunk_size_valid(chunk_size))
+        return -1;
+
+    FILE* fin = fopen(in_path, "rb");
+    if (!fin) return -2;
+    FILE* fout = fopen(out_path, "wb");
+    if (!fout) {
+        fclose(fin);
+        return -3;
+    }
+    long long total = stream_file_size(fin);
+
+    int rc = stream_chunked_encrypt_stream(engine, crypto_stream_file_read, fin, fout, key, key_len, iv,
+                                           hmac_key, hmac_key_len, chunk_size,
+                                           total > 0 ? (uint64_t)total : 0, opt);
+    fclose(fin);
+    if (fclose(fout) != 0 && rc == 0) rc = -6;
+    if (rc != 0) remove(out_path);
+    return rc;
+}
+
+// -------------------------------------------------------------------
+// 복호화
+// -------------------------------------------------------------------
+
+int stream_chunked_decrypt_stream(const blockcipher_vtable_t* engine,
+                                  FILE* in,
+                                  crypto_stream_write_fn write_fn,
+                                  void* write_ctx,
+                                  const unsigned char* key,
+                                  int key_len,
+                                  const unsigned char* hmac_key,
+                                  size_t hmac_key_len,
+                                  uint64_t total,
+                                  const stream_options_t* opt)
+{
+    if (!engine || !in || !write_fn || !key || key_len <= 0 || !hmac_key)
+        return -1;
+
+    unsigned char header[STREAM_CHUNKED_HEADER_BYTES];
+    size_t hn = fread(header, 1, sizeof(header), in);
+    if (hn != sizeof(header)) return ferror(in) ? -7 : -13;
+
+    chunked_t c;
+    memset(&c, 0, sizeof(c));
+    int rc = header_parse(header, key_len, &c.chunk_size, c.iv);
+    if (rc == 0) rc = chunked_init(&c, engine, key, key_len, header, hmac_key, hmac_key_len, 0, opt);
+
+    // 검증 + 복호화 (+ 압축 해제)는 풀에서, 검증된 청크를 순서대로 내보냄
+    // (마지막 청크 없이 끝나면 -13, 청크 경계에서 잘림 포함)
+    chunk_io_t io;
+    memset(&io, 0, sizeof(io));
+    io.in = in;
+    io.write_fn = write_fn;
+    io.write_ctx = write_ctx;
+    if (rc == 0) rc = chunked_run(&c, chunk_read_sealed, chunk_write_plain, &io, STREAM_CHUNKED_HEADER_BYTES, total, opt);
+
+    // 마지막 청크 뒤에 덧붙은 데이터는 변조로 본다
+    if (rc == 0 && fgetc(in) != EOF) rc = -10;
+
+    chunked_free(&c);
+    memset(header, 0, sizeof(header));
+    return rc;
+}
+
+int stream_chunked_decrypt_file(const blockcipher_vtable_t* engine,
+                                const char* in_path,
+                                const char* out_path,
+                                const unsigned char* key,
+                                int key_len,
+                                const unsigned char* hmac_key,
+                                size_t hmac_key_len,
+                                const stream_options_t* opt)
+{
+    if (!engine || !in_path || !out_path || !key || key_len <= 0 || !hmac_key)
+        return -1;
+
+    char* part = stream_path_suffix(out_path, STREAM_PARTIAL_SUFFIX);
+    if (!part) return -5;
+
+    FILE* fin = fopen(in_path, "rb");
+    if (!fin) {
+        free(part);
+        return -2;
+    }
+    FILE* fout = fopen(part, "wb");
+    if (!fout) {
+        fclose(fin);
+        free(part);
+        return -3;
+    }
+    long long total = stream_file_size(fin);
+
+    int rc = stream_chunked_decrypt_stream(engine, fin, crypto_stream_file_write, fout,
+                                           key, key_len, hmac_key, hmac_key_len,
+                                           total > 0 ? (uint64_t)total : 0, opt);
+    fclose(fin);
+    if (fclose(fout) != 0 && rc == 0) rc = -6;
+    if (rc == 0 && stream_replace_file(part, out_path) != 0) rc = -6;
+    if (rc != 0) remove(part);
+    free(part);
+    return rc;
+}
+
+// -------------------------------------------------------------------
+// 키 교체
+// -------------------------------------------------------------------
+
+int stream_chunked_rekey_file(const blockcipher_vtable_t* engine,
+                              const char* in_path,
+                              const char* out_path,
+                              const unsigned char* old_key,
+                              int old_key_len,
+                              const unsigned char* old_hmac_key,
+                              size_t old_hmac_key_len,
+                              const unsigned char* new_key,
+                              int new_key_len,
+                              const unsigned char new_iv[CTR_BLOCK_BYTES],
+                              const unsigned char* new_hmac_key,
+                              size_t new_hmac_key_len,
+                              const stream_options_t* opt)
+{
+    if (!engine || !in_path || !out_path || !old_key || old_key_len <= 0 || !old_hmac_key ||
+        !new_key || new_key_len <= 0 || !new_iv || !new_hmac_key)
+        return -1;
+
+    char* part = stream_path_suffix(out_path, STREAM_PARTIAL_SUFFIX);
+    if (!part) return -5;
+
+    FILE* fin = fopen(in_path, "rb");
+    if (!fin) {
+        free(part);
+        return -2;
+    }
+    long long total = stream_file_size(fin);
+    FILE* fout = fopen(part, "wb");
+    if (!fout) {
+        fclose(fin);
+        free(part);
+        return -3;
+    }
+
+    // 1) 이전 헤더 → 청크 크기 / IV, 새 헤더 (청크 경계와 번호는 그대로)
+    unsigned char old_header[STREAM_CHUNKED_HEADER_BYTES];
+    unsigned char new_header[STREAM_CHUNKED_HEADER_BYTES];
+    unsigned char old_iv[CTR_BLOCK_BYTES];
+    chunk_shared_t from;
+    chunked_t c;
+    memset(&from, 0, sizeof(from));
+    memset(&c, 0, sizeof(c));
+
+    int rc = 0;
+    size_t hn = fread(old_header, 1, sizeof(old_header), fin);
+    if (hn != sizeof(old_header)) rc = ferror(fin) ? -7 : -13;
+    if (rc == 0) rc = header_parse(old_header, old_key_len, &c.chunk_size, old_iv);
+    if (rc == 0) {
+        header_build(new_header, new_key_len, c.chunk_size, old_header[8], new_iv);
+        memcpy(c.iv, new_iv, CTR_BLOCK_BYTES);
+        rc = chunked_init(&c, engine, new_key, new_key_len, new_header, new_hmac_key, new_hmac_key_len, 1, opt);
+    }
+    if (rc == 0) {
+        from.iv = old_iv;
+        from.blocks_per_chunk = c.sh.blocks_per_chunk;
+        from.lz = c.sh.lz;
+        hmac_init(&from.base, old_hmac_key, old_hmac_key_len);
+        hmac_update(&from.base, old_header, STREAM_CHUNKED_HEADER_BYTES);
+        c.sh.from = &from;
+        for (unsigned int i = 0; rc == 0 && i < c.sh.workers; i++) {
+            c.workers[i].from_ctr = ctr_mode_init(engine, old_key, old_key_len, old_iv);
+            c.workers[i].ks = (unsigned char*)malloc(c.chunk_size);
+            if (!c.workers[i].from_ctr) rc = -4;
+            else if (!c.workers[i].ks) rc = -5;
+        }
+    }
+    if (rc == 0 && fwrite(new_header, 1, sizeof(new_header), fout) != sizeof(new_header)) rc = -6;
+
+    // 2) 묶음마다 병렬 변환, 순서대로 기록
+    //    (압축 컨테이너도 저장된 CT를 그대로 바꾸므로 압축을 풀지 않고 길이 필드도 유지)
+    chunk_io_t io;
+    memset(&io, 0, sizeof(io));
+    io.in = fin;
+    io.out = fout;
+    if (rc == 0) rc = chunked_run(&c, chunk_read_sealed, chunk_write_sealed, &io, STREAM_CHUNKED_HEADER_BYTES,
+                                  total > 0 ? (uint64_t)total : 0, opt);
+    if (rc == 0 && fgetc(fin) != EOF) rc = -10;
+
+    chunked_free(&c);
+    memset(&from, 0, sizeof(from));
+    memset(old_header, 0, sizeof(old_header));
+    fclose(fin);
+    if (fclose(fout) != 0 && rc == 0) rc = -6;
+    if (rc == 0 && stream_replace_file(part, out_path) != 0) rc = -6;
+    if (rc != 0) remove(part);
+    free(part);
+    return rc;
+}
+
+// -------------------------------------------------------------------
+// 임의 접근 읽기 (crypto_file_t)
+// -------------------------------------------------------------------
+
+typedef struct crypto_file_slot_t {
+    uint64_t index;         // 캐시된 청크 번호
+    uint64_t used;          // 마지막 사용 시각 (LRU)
+    size_t len;             // 평문 길이
+    int valid;
+    unsigned char* data;    // 검증된 평문 (chunk_size)
+} crypto_file_slot_t;
+
+struct crypto_file_t {
+    FILE* f;
+    chunk_shared_t sh;      // iv / 헤더 MAC 상태 / 청크당 블록 수 (jobs는 사용 안 함)
+    ctr_mode_ctx_t* ctr;
+    unsigned char iv[CTR_BLOCK_BYTES];
+    size_t chunk_size;
+    uint64_t chunks;        // 청크 수 (마지막 청크 포함)
+    size_t last_len;        // 마지막 청크 평문 길이
+    uint64_t size;          // 전체 평문 크기
+    unsigned char* rec;     // 읽기용 CT || tag 버퍼
+    unsigned char* scratch; // 압축 컨테이너: 압축 해제 버퍼
+    uint64_t* offs;         // 압축 컨테이너: 청크별 레코드 위치 (열 때 수집)
+    crypto_file_slot_t* slots;
+    unsigned int slot_count;
+    uint64_t clock;
+    uint64_t hits;
+    uint64_t misses;
+};
+
+void crypto_file_close(crypto_file_t* cf)
+{
+    if (!cf) return;
+    if (cf->slots) {
+        for (unsigned int i = 0; i < cf->slot_count; i++) {
+            if (cf->slots[i].data) {
+                memset(cf->slots[i].data, 0, cf->chunk_size);
+                free(cf->slots[i].data);
+            }
+        }
+        free(cf->slots);
+    }
+    if (cf->rec) {
+        memset(cf->rec, 0, cf->chunk_size + STREAM_CHUNKED_TAG_BYTES);
+        free(cf->rec);
+    }
+    if (cf->scratch) {
+        memset(cf->scratch, 0, cf->chunk_size);
+        free(cf->scratch);
+    }
+    free(cf->offs);
+    if (cf->ctr) ctr_mode_free(cf->ctr);
+    if (cf->f) fclose(cf->f);
+    memset(cf, 0, sizeof(*cf));
+    free(cf);
+}
+
+// 압축 컨테이너: 길이 필드만 따라가며 청크 위치를 모은다 (파일 위치는 임의)
+// 반환: 0, -5 메모리, -7 읽기, -10 길이 필드 변조 / 마지막 청크 뒤 데이터, -13 잘림
+static int crypto_file_scan(crypto_file_t* cf, uint64_t fsize)
+{
+    unsigned char head[STREAM_CHUNKED_RECORD_HEAD];
+    uint64_t pos = STREAM_CHUNKED_HEADER_BYTES;
+    uint64_t cap = 0;
+    for (;;) {
+        if (fsize - pos < STREAM_CHUNKED_RECORD_HEAD + STREAM_CHUNKED_TAG_BYTES) return -13;
+        if (stream_file_seek(cf->f, pos) != 0 || fread(head, 1, sizeof(head), cf->f) != sizeof(head)) return -7;
+        uint64_t plain = load_be32(head);
+        uint64_t stored = load_be32(head + 4);
+        if (plain > cf->chunk_size || stored > plain) return -10;
+
+        if (cf->chunks == cap) {
+            cap = cap ? cap * 2 : 64;
+            uint64_t* offs = (uint64_t*)realloc(cf->offs, (size_t)cap * sizeof(uint64_t));
+            if (!offs) return -5;
+            cf->offs = offs;
+        }
+        cf->offs[cf->chunks++] = pos;
+        pos += STREAM_CHUNKED_RECORD_HEAD + stored + STREAM_CHUNKED_TAG_BYTES;
+        if (pos > fsize) return -13;
+        if (plain < cf->chunk_size) {
+            cf->last_len = (size_t)plain;
+            break;
+        }
+    }
+    if (pos != fsize) return -10;
+    cf->size = (cf->chunks - 1) * cf->chunk_size + cf->last_len;
+    return 0;
+}
+
+int crypto_file_open(crypto_file_t** out,
+                     const blockcipher_vtable_t* engine,
+                     const char* path,
+                     const unsigned char* key,
+                     int key_len,
+                     const unsigned char* hmac_key,
+                     size_t hmac_key_len,
+                     unsigned int cache_chunks)
+{
+    if (!out) return -1;
+    *out = NULL;
+    if (!engine || !path || !key || key_len <= 0 || !hmac_key) return -1;
+    if (cache_chunks == 0) cache_chunks = CRYPTO_FILE_DEFAULT_CACHE;
+
+    crypto_file_t* cf = (crypto_file_t*)calloc(1, sizeof(crypto_file_t));
+    if (!cf) return -5;
+    cf->f = fopen(path, "rb");
+    if (!cf->f) {
+        crypto_file_close(cf);
+        return -2;
+    }
+
+    // 헤더 확인 후 파일 크기로 청크 수와 평문 크기 계산
+    //  - 레코드 = 청크 + 태그, 마지막 레코드만 짧다 (빈 마지막 청크는 태그만)
+    unsigned char header[STREAM_CHUNKED_HEADER_BYTES];
+    long long fsize = stream_file_size(cf->f);
+    int rc = 0;
+    if (fsize < 0) rc = -7;
+    else if (fread(header, 1, sizeof(header), cf->f) != sizeof(header)) rc = -13;
+    if (rc == 0) rc = header_parse(header, key_len, &cf->chunk_size, cf->iv);
+    if (rc == 0) cf->sh.lz = (header[8] & STREAM_CHUNKED_FLAG_LZ) != 0;
+    if (rc == 0 && cf->sh.lz) {
+        rc = crypto_file_scan(cf, (uint64_t)fsize);
+    }
+    else if (rc == 0) {
+        uint64_t body = (uint64_t)fsize - STREAM_CHUNKED_HEADER_BYTES;
+        uint64_t rec = cf->chunk_size + STREAM_CHUNKED_TAG_BYTES;
+        uint64_t last_rec = body % rec;
+        if (last_rec < STREAM_CHUNKED_TAG_BYTES) {
+            rc = -13;   // 마지막(짧은) 청크가 없음
+        }
+        else {
+            cf->chunks = body / rec + 1;
+            cf->last_len = (size_t)(last_rec - STREAM_CHUNKED_TAG_BYTES);
+            cf->size = (cf->chunks - 1) * cf->chunk_size + cf->last_len;
+        }
+    }
+
+    if (rc == 0) {
+        cf->sh.iv = cf->iv;
+        cf->sh.blocks_per_chunk = cf->chunk_size / CTR_BLOCK_BYTES;
+        hmac_init(&cf->sh.base, hmac_key, hmac_key_len);
+        hmac_update(&cf->sh.base, header, sizeof(header));
+        cf->ctr = ctr_mode_init(engine, key, key_len, cf->iv);
+        if (!cf->ctr) rc = -4;
+    }
+    if (rc == 0) {
+        if ((uint64_t)cache_chunks > cf->chunks) cache_chunks = (unsigned int)cf->chunks;
+        cf->slot_count = cache_chunks;
+        cf->rec = (unsigned char*)malloc(cf->chunk_size + STREAM_CHUNKED_TAG_BYTES);
+        cf->slots = (crypto_file_slot_t*)calloc(cache_chunks, sizeof(crypto_file_slot_t));
+        if (cf->sh.lz) cf->scratch = (unsigned char*)malloc(cf->chunk_size);
+        if (!cf->rec || !cf->slots || (cf->sh.lz && !cf->scratch)) rc = -5;
+    }
+    memset(header, 0, sizeof(header));
+
+    if (rc != 0) {
+        crypto_file_close(cf);
+        return rc;
+    }
+    *out = cf;
+    return 0;
+}
+
+uint64_t crypto_file_size(const crypto_file_t* cf)
+{
+    return cf ? cf->size : 0;
+}
+
+void crypto_file_cache_stats(const crypto_file_t* cf, uint64_t* hits, uint64_t* misses)
+{
+    if (hits) *hits = cf ? cf->hits : 0;
+    if (misses) *misses = cf ? cf->misses : 0;
+}
+
+// 청크 하나를 캐시에서 찾거나, 가장 오래 안 쓴 슬롯에 읽어 검증/복호화
+static int crypto_file_chunk(crypto_file_t* cf, uint64_t index, crypto_file_slot_t** slot)
+{
+    crypto_file_slot_t* victim = &cf->slots[0];
+    for (unsigned int i = 0; i < cf->slot_count; i++) {
+        crypto_file_slot_t* s = &cf->slots[i];
+        if (s->valid && s->index == index) {
+            s->used = ++cf->clock;
+            cf->hits++;
+            *slot = s;
+            return 0;
+        }
+        if (!s->valid || (victim->valid && s->used < victim->used)) victim = s;
+    }
+    cf->misses++;
+
+    if (!victim->data) {
+        victim->data = (unsigned char*)malloc(cf->chunk_size);
+        if (!victim->data) return -5;
+    }
+    victim->valid = 0;
+
+    // 열 때 정한 청크 배치와 다르면 (파일이 바뀜 / 길이 필드 변조) 읽기 실패로 본다
+    chunk_job_t job;
+    job.rec = cf->rec;
+    job.index = index;
+    uint64_t off = cf->offs ? cf->offs[index]
+        : STREAM_CHUNKED_HEADER_BYTES + index * (uint64_t)(cf->chunk_size + STREAM_CHUNKED_TAG_BYTES);
+    if (stream_file_seek(cf->f, off) != 0) return -7;
+    int rc = chunk_read_record(cf->f, cf->chunk_size, cf->sh.lz, &job);
+    if (rc == -10) return rc;
+    if (rc != 0 || job.final != (index == cf->chunks - 1) ||
+        job.plain != (job.final ? cf->last_len : cf->chunk_size))
+        return -7;
+
+    cf->sh.encrypt = 0;
+    chunk_process(&cf->sh, cf->ctr, cf->scratch, &job);
+    if (job.rc != 0) return job.rc;
+
+    memcpy(victim->data, cf->rec, job.len);
+    victim->index = index;
+    victim->len = job.len;
+    victim->used = ++cf->clock;
+    victim->valid = 1;
+    *slot = victim;
+    return 0;
+}
+
+long long crypto_file_pread(crypto_file_t* cf, void* buf, size_t len, uint64_t offset)
+{
+    if (!cf || (!buf && len)) return -1;
+    if (offset >= cf->size) return 0;
+    if (len > cf->size - offset) len = (size_t)(cf->size - offset);
+
+    unsigned char* dst = (unsigned char*)buf;
+    size_t done = 0;
+    while (done < len) {
+        uint64_t pos = offset + done;
+        uint64_t index = pos / cf->chunk_size;
+        size_t in_chunk = (size_t)(pos % cf->chunk_size);
+
+        crypto_file_slot_t* slot = NULL;
+        int rc = crypto_file_chunk(cf, index, &slot);
+        if (rc != 0) return rc;
+
+        size_t n = slot->len - in_chunk;
+        if (n > len - done) n = len - done;
+        memcpy(dst + done, slot->data + in_chunk, n);
+        done += n;
+    }
+    return (long long)done;
+}
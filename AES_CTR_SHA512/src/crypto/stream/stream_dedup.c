@@ -0,0 +1,149 @@
+﻿#include "crypto/stream/stream_dedup.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "crypto/status.h"
+#include "crypto/stream/stream_batch.h"
+
+// 지문 file_id 앞에 붙이는 구분자 (일반 파일 식별자와 파생 키가 겹치지 않도록)
+static const unsigned char DEDUP_ID_PREFIX[5] = { 'd', 'e', 'd', 'u', 'p' };
+
+int stream_dedup_keys(const key_context_t* kc,
+                      const unsigned char digest[SHA512_DIGEST_LENGTH],
+                      unsigned int aes_key_len,
+                      key_file_keys_t* out)
+{
+    if (!kc || !digest || !out) return CRYPTO_ERR_NULL;
+
+    unsigned char id[sizeof(DEDUP_ID_PREFIX) + SHA512_DIGEST_LENGTH];
+    memcpy(id, DEDUP_ID_PREFIX, sizeof(DEDUP_ID_PREFIX));
+    memcpy(id + sizeof(DEDUP_ID_PREFIX), digest, SHA512_DIGEST_LENGTH);
+    int rc = key_context_derive_file(kc, id, sizeof(id), aes_key_len, out);
+    memset(id, 0, sizeof(id));
+    return rc;
+}
+
+// 지문 순, 같으면 작업 번호 순 (묶음의 첫 작업 = 번호가 가장 작은 작업)
+static int dedup_cmp(const void* a, const void* b)
+{
+    const stream_dedup_job_t* x = *(const stream_dedup_job_t* const*)a;
+    const stream_dedup_job_t* y = *(const stream_dedup_job_t* const*)b;
+    int c = memcmp(x->digest, y->digest, SHA512_DIGEST_LENGTH);
+    if (c != 0) return c;
+    return (x < y) ? -1 : (x > y) ? 1 : 0;
+}
+
+int stream_encrypt_batch_dedup(const blockcipher_vtable_t* engine,
+                               const key_context_t* kc,
+                               unsigned int aes_key_len,
+                               stream_dedup_job_t* jobs,
+                               size_t n,
+                               const stream_options_t* opt,
+                               stream_dedup_stats_t* stats)
+{
+    if (stats) memset(stats, 0, sizeof(*stats));
+    if (!engine || !kc || (!jobs && n) ||
+        (aes_key_len != 16 && aes_key_len != 24 && aes_key_len != 32))
+        return -1;
+    if (opt && opt->compress) return -1;
+    for (size_t i = 0; i < n; i++) {
+        if (!jobs[i].in_path || !jobs[i].out_path) return -1;
+    }
+    if (n == 0) return 0;
+
+    stream_batch_job_t* bj = (stream_batch_job_t*)calloc(n, sizeof(stream_batch_job_t));
+    stream_dedup_job_t** order = (stream_dedup_job_t**)malloc(n * sizeof(stream_dedup_job_t*));
+    key_file_keys_t* keys = (key_file_keys_t*)calloc(n, sizeof(key_file_keys_t));
+    size_t* owner_of = (size_t*)malloc(n * sizeof(size_t));   // 암호화 작업 k → 원래 작업 번호
+    if (!bj || !order || !keys || !owner_of) {
+        free(bj);
+        free(order);
+        free(keys);
+        free(owner_of);
+        return -5;
+    }
+
+    // 1) 지문 (병렬)
+    for (size_t i = 0; i < n; i++) {
+        bj[i].kind = STREAM_BATCH_SHA512;
+        bj[i].in_path = jobs[i].in_path;
+    }
+    int brc = stream_encrypt_batch(bj, n, opt);
+    size_t hashed = 0;
+    for (size_t i = 0; brc >= 0 && i < n; i++) {
+        jobs[i].rc = bj[i].rc;
+        jobs[i].dup_of = i;
+        memcpy(jobs[i].digest, bj[i].digest, SHA512_DIGEST_LENGTH);
+        if (jobs[i].rc == 0) order[hashed++] = &jobs[i];
+    }
+
+    // 2) 같은 지문끼리 묶고, 묶음의 첫 작업만 암호화 작업으로
+    size_t unique = 0;
+    int rc = brc < 0 ? brc : 0;
+    if (rc == 0) {
+        qsort(order, hashed, sizeof(order[0]), dedup_cmp);
+        memset(bj, 0, n * sizeof(stream_batch_job_t));
+        for (size_t k = 0; k < hashed; k++) {
+            size_t idx = (size_t)(order[k] - jobs);
+            if (k > 0 && memcmp(order[k]->digest, order[k - 1]->digest, SHA512_DIGEST_LENGTH) == 0) {
+                jobs[idx].dup_of = jobs[(size_t)(order[k - 1] - jobs)].dup_of;
+                continue;
+            }
+            if (stream_dedup_keys(kc, jobs[idx].digest, aes_key_len, &keys[unique]) != CRYPTO_OK) {
+                rc = -4;
+                break;
+            }
+            stream_batch_job_t* e = &bj[unique];
+            e->kind = STREAM_BATCH_CTR_HMAC;
+            e->encrypt = 1;
+            e->in_path = jobs[idx].in_path;
+            e->out_path = jobs[idx].out_path;
+            e->engine = engine;
+            e->key = keys[unique].aes_key;
+            e->key_len = (int)aes_key_len;
+            memcpy(e->iv, keys[unique].iv, CTR_BLOCK_BYTES);
+            e->hmac_key = keys[unique].hmac_key;
+            e->hmac_key_len = KC_FILE_HMAC_KEY_BYTES;
+            e->want_digest = 1;
+            owner_of[unique++] = idx;
+        }
+    }
+
+    // 3) 고유 내용만 암호화 (병렬), 중복 작업은 원본의 결과를 받는다
+    //  암호화하면서 읽은 평문의 지문이 1)과 다르면 (그 사이에 파일이 바뀜) 다른 내용을
+    //  같은 키/IV로 암호화한 것이므로 출력을 지우고 실패 (-14)
+    if (rc == 0) brc = stream_encrypt_batch(bj, unique, opt);
+    if (rc == 0 && brc < 0) rc = brc;
+    if (rc == 0) {
+        for (size_t k = 0; k < unique; k++) {
+            size_t idx = owner_of[k];
+            jobs[idx].rc = bj[k].rc;
+            if (bj[k].rc == 0 &&
+                memcmp(bj[k].digest, jobs[idx].digest, SHA512_DIGEST_LENGTH) != 0) {
+                remove(jobs[idx].out_path);
+                jobs[idx].rc = -14;
+            }
+        }
+        for (size_t i = 0; i < n; i++) {
+            if (jobs[i].dup_of != i) jobs[i].rc = jobs[jobs[i].dup_of].rc;
+        }
+        if (stats) {
+            stats->unique = unique;
+            stats->duplicates = hashed - unique;
+        }
+    }
+
+    size_t failed = 0;
+    for (size_t i = 0; rc == 0 && i < n; i++) {
+        if (jobs[i].rc != 0) failed++;
+    }
+
+    memset(keys, 0, n * sizeof(key_file_keys_t));
+    free(keys);
+    free(bj);
+    free(order);
+    free(owner_of);
+    return rc != 0 ? rc : (int)failed;
+}
@@ -0,0 +1,188 @@
+﻿// O_DIRECT, posix_fadvise 선언용
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "crypto/stream/stream_direct.h"
+
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+#define DIRECT_ROUND_UP(x) (((x) + STREAM_DIRECT_ALIGNMENT - 1) & ~(size_t)(STREAM_DIRECT_ALIGNMENT - 1))
+
+#ifdef _WIN32
+
+static int direct_open(stream_direct_file_t* f, const char* path, int write)
+{
+    memset(f, 0, sizeof(*f));
+    DWORD access = write ? GENERIC_WRITE : GENERIC_READ;
+    DWORD disp = write ? CREATE_ALWAYS : OPEN_EXISTING;
+    DWORD share = write ? 0 : FILE_SHARE_READ;
+    DWORD flags = FILE_FLAG_NO_BUFFERING | (write ? FILE_FLAG_WRITE_THROUGH : FILE_FLAG_SEQUENTIAL_SCAN);
+
+    HANDLE h = CreateFileA(path, access, share, NULL, disp, flags, NULL);
+    f->direct = 1;
+    if (h == INVALID_HANDLE_VALUE) {
+        h = CreateFileA(path, access, share, NULL, disp, FILE_ATTRIBUTE_NORMAL, NULL);
+        f->direct = 0;
+    }
+    if (h == INVALID_HANDLE_VALUE) return -1;
+    f->handle = h;
+    f->writable = write;
+    return 0;
+}
+
+static long long direct_read_once(stream_direct_file_t* f, unsigned char* buf, size_t len)
+{
+    DWORD got = 0;
+    if (!ReadFile((HANDLE)f->handle, buf, (DWORD)len, &got, NULL)) return -1;
+    return (long long)got;
+}
+
+static long long direct_write_once(stream_direct_file_t* f, const unsigned char* buf, size_t len)
+{
+    DWORD put = 0;
+    if (!WriteFile((HANDLE)f->handle, buf, (DWORD)len, &put, NULL)) return -1;
+    return (long long)put;
+}
+
+static void direct_drop_cache(stream_direct_file_t* f, uint64_t off, size_t len)
+{
+    (void)f; (void)off; (void)len;   // 일반 핸들로 열린 경우 Windows는 별도 힌트 없음
+}
+
+static int direct_close_handle(stream_direct_file_t* f, uint64_t logical_size)
+{
+    int rc = 0;
+    if (f->writable) {
+        // 정렬 길이로 기록된 꼬리를 실제 길이로 자른다
+        LARGE_INTEGER li;
+        li.QuadPart = (LONGLONG)logical_size;
+        if (!SetFilePointerEx((HANDLE)f->handle, li, NULL, FILE_BEGIN) ||
+            !SetEndOfFile((HANDLE)f->handle)) rc = -1;
+    }
+    if (!CloseHandle((HANDLE)f->handle)) rc = -1;
+    return rc;
+}
+
+#else
+
+static int direct_open(stream_direct_file_t* f, const char* path, int write)
+{
+    memset(f, 0, sizeof(*f));
+    int flags = write ? (O_WRONLY | O_CREAT | O_TRUNC) : O_RDONLY;
+
+    int fd = -1;
+#ifdef O_DIRECT
+    fd = open(path, flags | O_DIRECT, 0644);
+    f->direct = (fd >= 0);
+#endif
+    if (fd < 0) {
+        fd = open(path, flags, 0644);
+        f->direct = 0;
+    }
+    if (fd < 0) return -1;
+#ifdef POSIX_FADV_SEQUENTIAL
+    if (!f->direct && !write) posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    f->fd = fd;
+    f->writable = write;
+    return 0;
+}
+
+static long long direct_read_once(stream_direct_file_t* f, unsigned char* buf, size_t len)
+{
+    for (;;) {
+        ssize_t n = pread(f->fd, buf, len, (off_t)f->pos);
+        if (n >= 0 || errno != EINTR) return (long long)n;
+    }
+}
+
+static long long direct_write_once(stream_direct_file_t* f, const unsigned char* buf, size_t len)
+{
+    for (;;) {
+        ssize_t n = pwrite(f->fd, buf, len, (off_t)f->pos);
+        if (n >= 0 || errno != EINTR) return (long long)n;
+    }
+}
+
+// 직접 I/O가 안 될 때: 다 쓴 범위를 캐시에서 내려 달라고 요청
+// (쓰기는 기록이 끝난 페이지부터 해제되므로 best-effort)
+static void direct_drop_cache(stream_direct_file_t* f, uint64_t off, size_t len)
+{
+#ifdef POSIX_FADV_DONTNEED
+    if (!f->direct) posix_fadvise(f->fd, (off_t)off, (off_t)len, POSIX_FADV_DONTNEED);
+#else
+    (void)f; (void)off; (void)len;
+#endif
+}
+
+static int direct_close_handle(stream_direct_file_t* f, uint64_t logical_size)
+{
+    int rc = 0;
+    if (f->writable && ftruncate(f->fd, (off_t)logical_size) != 0) rc = -1;
+    if (close(f->fd) != 0) rc = -1;
+    return rc;
+}
+
+#endif
+
+int stream_direct_open_read(stream_direct_file_t* f, const char* path)
+{
+    return direct_open(f, path, 0) == 0 ? 0 : -2;
+}
+
+int stream_direct_open_write(stream_direct_file_t* f, const char* path)
+{
+    return direct_open(f, path, 1) == 0 ? 0 : -3;
+}
+
+long long stream_direct_read(stream_direct_file_t* f, unsigned char* buf, size_t buf_size)
+{
+    size_t total = 0;
+    while (total < buf_size) {
+        long long n = direct_read_once(f, buf + total, buf_size - total);
+        if (n < 0) return -1;
+        if (n == 0) break;
+        total += (size_t)n;
+        f->pos += (uint64_t)n;
+        // 정렬되지 않은 짧은 읽기는 파일 끝에서만 생긴다 (다음 오프셋이 정렬을 벗어나므로 중단)
+        if ((size_t)n % STREAM_DIRECT_ALIGNMENT != 0) break;
+    }
+    direct_drop_cache(f, f->pos - total, total);
+    return (long long)total;
+}
+
+int stream_direct_write(stream_direct_file_t* f, unsigned char* buf, size_t len, size_t buf_cap)
+{
+    size_t padded = f->direct ? DIRECT_ROUND_UP(len) : len;
+    if (padded > buf_cap) return -1;
+    if (padded > len) memset(buf + len, 0, padded - len);
+
+    uint64_t start = f->pos;
+    size_t done = 0;
+    while (done < padded) {
+        long long n = direct_write_once(f, buf + done, padded - done);
+        if (n <= 0) return -1;
+        done += (size_t)n;
+        f->pos += (uint64_t)n;
+    }
+    direct_drop_cache(f, start, padded);
+    return 0;
+}
+
+int stream_direct_close(stream_direct_file_t* f, uint64_t logical_size)
+{
+    int rc = direct_close_handle(f, logical_size);
+    memset(f, 0, sizeof(*f));
+    return rc;
+}
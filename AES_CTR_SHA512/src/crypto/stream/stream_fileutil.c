@@ -0,0 +1,125 @@
+﻿// fseeko, ftruncate, fsync 선언용
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "crypto/stream/stream_fileutil.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "crypto/hash/hash_sha512.h"
+#include "crypto/hash/hmac.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+int stream_file_seek(FILE* f, uint64_t off)
+{
+    return _fseeki64(f, (long long)off, SEEK_SET) == 0 ? 0 : -1;
+}
+
+long long stream_file_size(FILE* f)
+{
+    if (_fseeki64(f, 0, SEEK_END) != 0) return -1;
+    long long size = _ftelli64(f);
+    return (_fseeki64(f, 0, SEEK_SET) == 0) ? size : -1;
+}
+
+long long stream_path_size(const char* path)
+{
+    struct _stat64 st;
+    if (_stat64(path, &st) != 0 || !(st.st_mode & _S_IFREG)) return -1;
+    return (long long)st.st_size;
+}
+
+int stream_file_truncate(FILE* f, uint64_t size)
+{
+    if (fflush(f) != 0) return -1;
+    return _chsize_s(_fileno(f), (long long)size) == 0 ? 0 : -1;
+}
+
+int stream_file_sync(FILE* f)
+{
+    if (fflush(f) != 0) return -1;
+    return _commit(_fileno(f)) == 0 ? 0 : -1;
+}
+
+int stream_replace_file(const char* tmp_path, const char* dst_path)
+{
+    return MoveFileExA(tmp_path, dst_path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) ? 0 : -1;
+}
+
+#else
+
+int stream_file_seek(FILE* f, uint64_t off)
+{
+    return fseeko(f, (off_t)off, SEEK_SET) == 0 ? 0 : -1;
+}
+
+long long stream_file_size(FILE* f)
+{
+    if (fseeko(f, 0, SEEK_END) != 0) return -1;
+    long long size = (long long)ftello(f);
+    return (fseeko(f, 0, SEEK_SET) == 0) ? size : -1;
+}
+
+long long stream_path_size(const char* path)
+{
+    struct stat st;
+    if (stat(path, &st) != 0 || !S_ISREG(st.st_mode)) return -1;
+    return (long long)st.st_size;
+}
+
+int stream_file_truncate(FILE* f, uint64_t size)
+{
+    if (fflush(f) != 0) return -1;
+    return ftruncate(fileno(f), (off_t)size) == 0 ? 0 : -1;
+}
+
+int stream_file_sync(FILE* f)
+{
+    if (fflush(f) != 0) return -1;
+    return fsync(fileno(f)) == 0 ? 0 : -1;
+}
+
+int stream_replace_file(const char* tmp_path, const char* dst_path)
+{
+    return rename(tmp_path, dst_path);
+}
+
+#endif
+
+char* stream_path_suffix(const char* path, const char* suffix)
+{
+    size_t plen = strlen(path);
+    size_t slen = strlen(suffix);
+    char* out = (char*)malloc(plen + slen + 1);
+    if (!out) return NULL;
+    memcpy(out, path, plen);
+    memcpy(out + plen, suffix, slen + 1);
+    return out;
+}
+
+void stream_key_check(const unsigned char* key, size_t key_len,
+                      const unsigned char iv[CTR_BLOCK_BYTES], unsigned char check[8])
+{
+    unsigned char mac[SHA512_DIGEST_LENGTH];
+    hmac_ctx h;
+    hmac_init(&h, key, key_len);
+    hmac_update(&h, (const unsigned char*)STREAM_KEY_CHECK_LABEL, sizeof(STREAM_KEY_CHECK_LABEL) - 1);
+    hmac_update(&h, iv, CTR_BLOCK_BYTES);
+    hmac_final(&h, mac);
+    memcpy(check, mac, 8);
+
+    memset(&h, 0, sizeof(h));
+    memset(mac, 0, sizeof(mac));
+}
@@ -0,0 +1,575 @@
+﻿// stat의 st_mtim / st_ctim 선언용
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "crypto/stream/stream_index.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "crypto/bytes.h"
+#include "crypto/hash/hmac.h"
+#include "crypto/stream/stream_fileutil.h"
+
+static const unsigned char INDEX_MAGIC[4] = { 'S', 'I', 'D', 'X' };
+static const char INDEX_KEY_ID_LABEL[] = "stream index key id";
+
+#define INDEX_HEADER_BYTES  16
+#define INDEX_ENTRY_FIXED   136u    // 경로 앞의 고정 필드
+#define INDEX_KEY_ID_BYTES  16
+#define INDEX_KIND_SHA512   1u
+#define INDEX_KIND_HMAC     2u
+#define INDEX_MAX_PATH      65536u  // 색인 파일에서 받아들이는 경로 길이 상한
+
+typedef struct index_meta_t {
+    uint64_t size;
+    int64_t mtime_ns;
+    int64_t ctime_ns;
+    uint64_t dev;
+    uint64_t ino;
+} index_meta_t;
+
+typedef struct index_entry_t {
+    char* path;
+    uint32_t path_len;
+    uint32_t kind;                              // INDEX_KIND_*
+    unsigned char key_id[INDEX_KEY_ID_BYTES];   // SHA-512는 0
+    index_meta_t meta;
+    int64_t recorded;                           // 계산을 시작한 시각 (초)
+    unsigned char digest[SHA512_DIGEST_LENGTH];
+} index_entry_t;
+
+struct stream_index_t {
+    char* path;
+    hmac_key_t key;         // 색인 파일 인증 키
+    index_entry_t* entries;
+    size_t count;
+    size_t cap;
+    uint32_t* slots;        // 열린 주소 해시 테이블 (항목 번호 + 1, 0 = 빈 칸)
+    size_t slot_count;      // 2의 거듭제곱
+    int dirty;
+    uint64_t hits;
+    uint64_t misses;
+};
+
+// HMAC 항목의 키 id = HMAC(index_key, 라벨 || HMAC(key, 라벨))
+//  - index_key 없이는 계산할 수 없어 색인 파일만으로 약한 키를 오프라인으로 맞춰 보거나
+//    다른 색인 파일의 항목과 같은 키인지 이어 볼 수 없다
+static void index_key_id(const stream_index_t* idx, const unsigned char* key, size_t key_len,
+                         unsigned char id[SHA512_DIGEST_LENGTH])
+{
+    unsigned char inner[SHA512_DIGEST_LENGTH];
+    hmac_sha512(key, key_len, INDEX_KEY_ID_LABEL, sizeof(INDEX_KEY_ID_LABEL) - 1, inner);
+
+    hmac_ctx c;
+    hmac_start_from_key(&c, &idx->key);
+    hmac_update(&c, INDEX_KEY_ID_LABEL, sizeof(INDEX_KEY_ID_LABEL) - 1);
+    hmac_update(&c, inner, sizeof(inner));
+    hmac_final(&c, id);
+    memset(&c, 0, sizeof(c));
+    memset(inner, 0, sizeof(inner));
+}
+
+// -------------------------------------------------------------------
+// 파일 메타데이터
+// -------------------------------------------------------------------
+
+// 반환: 0, -1 없음 / 일반 파일 아님
+static int index_stat(const char* path, index_meta_t* m)
+{
+    memset(m, 0, sizeof(*m));
+#ifdef _WIN32
+    struct _stat64 st;
+    if (_stat64(path, &st) != 0 || !(st.st_mode & _S_IFREG)) return -1;
+    m->size = (uint64_t)st.st_size;
+    m->mtime_ns = (int64_t)st.st_mtime * 1000000000;
+    m->ctime_ns = (int64_t)st.st_ctime * 1000000000;
+    m->dev = (uint64_t)st.st_dev;
+#else
+    struct stat st;
+    if (stat(path, &st) != 0 || !S_ISREG(st.st_mode)) return -1;
+    m->size = (uint64_t)st.st_size;
+#if defined(__APPLE__)
+    m->mtime_ns = (int64_t)st.st_mtimespec.tv_sec * 1000000000 + st.st_mtimespec.tv_nsec;
+    m->ctime_ns = (int64_t)st.st_ctimespec.tv_sec * 1000000000 + st.st_ctimespec.tv_nsec;
+#else
+    m->mtime_ns = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+    m->ctime_ns = (int64_t)st.st_ctim.tv_sec * 1000000000 + st.st_ctim.tv_nsec;
+#endif
+    m->dev = (uint64_t)st.st_dev;
+    m->ino = (uint64_t)st.st_ino;
+#endif
+    return 0;
+}
+
+static int index_meta_equal(const index_meta_t* a, const index_meta_t* b)
+{
+    return a->size == b->size && a->mtime_ns == b->mtime_ns && a->ctime_ns == b->ctime_ns &&
+        a->dev == b->dev && a->ino == b->ino;
+}
+
+// -------------------------------------------------------------------
+// 항목 테이블 (경로 + 종류 + 키 id → 항목)
+// -------------------------------------------------------------------
+
+// FNV-1a 64
+static uint64_t index_hash(const char* path, size_t len, uint32_t kind, const unsigned char* key_id)
+{
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < len; i++) h = (h ^ (unsigned char)path[i]) * 0x100000001b3ull;
+    h = (h ^ kind) * 0x100000001b3ull;
+    for (size_t i = 0; i < INDEX_KEY_ID_BYTES; i++) h = (h ^ key_id[i]) * 0x100000001b3ull;
+    return h;
+}
+
+static size_t index_slot_of(const stream_index_t* idx, const index_entry_t* e)
+{
+    return (size_t)index_hash(e->path, e->path_len, e->kind, e->key_id) & (idx->slot_count - 1);
+}
+
+// 항목 수의 두 배 이상인 테이블을 다시 만든다. 반환 0, -5 메모리
+static int index_rehash(stream_index_t* idx)
+{
+    size_t want = 64;
+    while (want < idx->count * 2 + 2) want *= 2;
+    uint32_t* slots = (uint32_t*)calloc(want, sizeof(uint32_t));
+    if (!slots) return -5;
+    free(idx->slots);
+    idx->slots = slots;
+    idx->slot_count = want;
+    for (size_t i = 0; i < idx->count; i++) {
+        size_t s = index_slot_of(idx, &idx->entries[i]);
+        while (idx->slots[s]) s = (s + 1) & (want - 1);
+        idx->slots[s] = (uint32_t)(i + 1);
+    }
+    return 0;
+}
+
+static index_entry_t* index_find(const stream_index_t* idx, const char* path, size_t len,
+                                 uint32_t kind, const unsigned char* key_id)
+{
+    if (!idx->slots) return NULL;
+    size_t s = (size_t)index_hash(path, len, kind, key_id) & (idx->slot_count - 1);
+    for (; idx->slots[s]; s = (s + 1) & (idx->slot_count - 1)) {
+        index_entry_t* e = &idx->entries[idx->slots[s] - 1];
+        if (e->kind == kind && e->path_len == len && memcmp(e->path, path, len) == 0 &&
+            memcmp(e->key_id, key_id, INDEX_KEY_ID_BYTES) == 0)
+            return e;
+    }
+    return NULL;
+}
+
+// 항목 추가 (테이블은 갱신하지 않음). path는 그대로 넘겨받는다. 반환 0, -5 메모리
+static int index_append(stream_index_t* idx, const index_entry_t* e)
+{
+    if (idx->count == idx->cap) {
+        size_t cap = idx->cap ? idx->cap * 2 : 64;
+        index_entry_t* entries = (index_entry_t*)realloc(idx->entries, cap * sizeof(index_entry_t));
+        if (!entries) return -5;
+        idx->entries = entries;
+        idx->cap = cap;
+    }
+    idx->entries[idx->count++] = *e;
+    return 0;
+}
+
+static void index_clear_entries(stream_index_t* idx)
+{
+    for (size_t i = 0; i < idx->count; i++) free(idx->entries[i].path);
+    idx->count = 0;
+    free(idx->slots);
+    idx->slots = NULL;
+    idx->slot_count = 0;
+}
+
+// -------------------------------------------------------------------
+// 조회 / 기록
+// -------------------------------------------------------------------
+
+// 색인으로 답할 수 있으면 1 (out 설정). meta / have_meta는 계산 후 기록할 때 비교용
+static int index_lookup(stream_index_t* idx, const char* path, uint32_t kind, const unsigned char* key_id,
+                        index_meta_t* meta, int* have_meta, unsigned char out[SHA512_DIGEST_LENGTH])
+{
+    *have_meta = (index_stat(path, meta) == 0);
+    if (!*have_meta) return 0;
+    const index_entry_t* e = index_find(idx, path, strlen(path), kind, key_id);
+    if (!e || !index_meta_equal(&e->meta, meta)) return 0;
+
+    // 기록 시작 직전에 수정된 파일은 같은 시각 단위 안에서 또 바뀌었을 수 있다
+    if (e->meta.mtime_ns / 1000000000 + STREAM_INDEX_RACY_SECONDS > e->recorded) return 0;
+    memcpy(out, e->digest, SHA512_DIGEST_LENGTH);
+    return 1;
+}
+
+// 계산 전후 메타데이터가 같을 때만 기록 (메모리가 모자라면 기록만 건너뜀)
+static void index_record(stream_index_t* idx, const char* path, uint32_t kind, const unsigned char* key_id,
+                         const index_meta_t* before, int have_before, int64_t started,
+                         const unsigned char digest[SHA512_DIGEST_LENGTH])
+{
+    index_meta_t after;
+    if (!have_before || index_stat(path, &after) != 0 || !index_meta_equal(before, &after)) return;
+
+    size_t len = strlen(path);
+    index_entry_t* e = index_find(idx, path, len, kind, key_id);
+    if (!e) {
+        if (len > INDEX_MAX_PATH) return;
+        index_entry_t ne;
+        memset(&ne, 0, sizeof(ne));
+        ne.path = (char*)malloc(len + 1);
+        if (!ne.path) return;
+        memcpy(ne.path, path, len + 1);
+        ne.path_len = (uint32_t)len;
+        ne.kind = kind;
+        memcpy(ne.key_id, key_id, INDEX_KEY_ID_BYTES);
+        if (index_append(idx, &ne) != 0) {
+            free(ne.path);
+            return;
+        }
+        e = &idx->entries[idx->count - 1];
+        if (idx->count * 2 + 2 > idx->slot_count) {
+            if (index_rehash(idx) != 0) {
+                free(e->path);
+                idx->count--;
+                return;
+            }
+        }
+        else {
+            size_t s = index_slot_of(idx, e);
+            while (idx->slots[s]) s = (s + 1) & (idx->slot_count - 1);
+            idx->slots[s] = (uint32_t)idx->count;
+        }
+    }
+    e->meta = after;
+    e->recorded = started;
+    memcpy(e->digest, digest, SHA512_DIGEST_LENGTH);
+    idx->dirty = 1;
+}
+
+// -------------------------------------------------------------------
+// 색인 파일 (헤더 || 항목들 || 트레일러)
+// -------------------------------------------------------------------
+
+static void entry_encode(const index_entry_t* e, unsigned char b[INDEX_ENTRY_FIXED])
+{
+    store_be32(b, e->path_len);
+    store_be32(b + 4, e->kind);
+    store_be64(b + 8, e->meta.size);
+    store_be64(b + 16, (uint64_t)e->meta.mtime_ns);
+    store_be64(b + 24, (uint64_t)e->meta.ctime_ns);
+    store_be64(b + 32, e->meta.dev);
+    store_be64(b + 40, e->meta.ino);
+    store_be64(b + 48, (uint64_t)e->recorded);
+    memcpy(b + 56, e->key_id, INDEX_KEY_ID_BYTES);
+    memcpy(b + 72, e->digest, SHA512_DIGEST_LENGTH);
+}
+
+static void entry_decode(const unsigned char b[INDEX_ENTRY_FIXED], index_entry_t* e)
+{
+    e->path_len = load_be32(b);
+    e->kind = load_be32(b + 4);
+    e->meta.size = load_be64(b + 8);
+    e->meta.mtime_ns = (int64_t)load_be64(b + 16);
+    e->meta.ctime_ns = (int64_t)load_be64(b + 24);
+    e->meta.dev = load_be64(b + 32);
+    e->meta.ino = load_be64(b + 40);
+    e->recorded = (int64_t)load_be64(b + 48);
+    memcpy(e->key_id, b + 56, INDEX_KEY_ID_BYTES);
+    memcpy(e->digest, b + 72, SHA512_DIGEST_LENGTH);
+}
+
+// 색인 파일 읽기. 없거나 맞지 않으면 빈 색인 (반환 0), 메모리 부족은 -5
+static int index_load(stream_index_t* idx)
+{
+    FILE* f = fopen(idx->path, "rb");
+    if (!f) return 0;
+
+    hmac_ctx m;
+    hmac_start_from_key(&m, &idx->key);
+    unsigned char b[INDEX_ENTRY_FIXED];
+    int ok = (fread(b, 1, INDEX_HEADER_BYTES, f) == INDEX_HEADER_BYTES) &&
+        memcmp(b, INDEX_MAGIC, 4) == 0 && load_be32(b + 4) == STREAM_INDEX_VERSION;
+    uint64_t count = ok ? load_be64(b + 8) : 0;
+    if (ok) hmac_update(&m, b, INDEX_HEADER_BYTES);
+
+    int rc = 0;
+    for (uint64_t i = 0; ok && rc == 0 && i < count; i++) {
+        index_entry_t e;
+        memset(&e, 0, sizeof(e));
+        ok = (fread(b, 1, INDEX_ENTRY_FIXED, f) == INDEX_ENTRY_FIXED);
+        if (ok) {
+            entry_decode(b, &e);
+            ok = (e.kind == INDEX_KIND_SHA512 || e.kind == INDEX_KIND_HMAC) && e.path_len <= INDEX_MAX_PATH;
+        }
+        if (!ok) break;
+        e.path = (char*)malloc((size_t)e.path_len + 1);
+        if (!e.path) {
+            rc = -5;
+            break;
+        }
+        ok = (fread(e.path, 1, e.path_len, f) == e.path_len);
+        e.path[e.path_len] = '\0';
+        if (ok) {
+            hmac_update(&m, b, INDEX_ENTRY_FIXED);
+            hmac_update(&m, e.path, e.path_len);
+            rc = index_append(idx, &e);
+        }
+        if (!ok || rc != 0) free(e.path);
+    }
+
+    // 트레일러 확인 (상수 시간 비교) 후 뒤에 남은 데이터가 없어야 한다
+    unsigned char tag[SHA512_DIGEST_LENGTH], want[SHA512_DIGEST_LENGTH];
+    hmac_final(&m, want);
+    memset(&m, 0, sizeof(m));
+    if (ok && rc == 0) {
+        ok = (fread(tag, 1, sizeof(tag), f) == sizeof(tag));
+        unsigned char diff = 0;
+        for (size_t i = 0; ok && i < sizeof(tag); i++) diff |= (unsigned char)(tag[i] ^ want[i]);
+        ok = ok && diff == 0 && fgetc(f) == EOF;
+    }
+    fclose(f);
+
+    if (rc == 0 && ok) rc = index_rehash(idx);
+    if (rc != 0 || !ok) index_clear_entries(idx);
+    return rc;
+}
+
+int stream_index_save(stream_index_t* idx)
+{
+    if (!idx) return -1;
+    if (!idx->dirty) return 0;
+
+    char* tmp = stream_path_suffix(idx->path, ".tmp");
+    if (!tmp) return -5;
+
+    FILE* f = fopen(tmp, "wb");
+    if (!f) {
+        free(tmp);
+        return -6;
+    }
+
+    hmac_ctx m;
+    hmac_start_from_key(&m, &idx->key);
+    unsigned char b[INDEX_ENTRY_FIXED];
+    memcpy(b, INDEX_MAGIC, 4);
+    store_be32(b + 4, STREAM_INDEX_VERSION);
+    store_be64(b + 8, (uint64_t)idx->count);
+    int ok = (fwrite(b, 1, INDEX_HEADER_BYTES, f) == INDEX_HEADER_BYTES);
+    hmac_update(&m, b, INDEX_HEADER_BYTES);
+    for (size_t i = 0; ok && i < idx->count; i++) {
+        const index_entry_t* e = &idx->entries[i];
+        entry_encode(e, b);
+        ok = fwrite(b, 1, INDEX_ENTRY_FIXED, f) == INDEX_ENTRY_FIXED &&
+            fwrite(e->path, 1, e->path_len, f) == e->path_len;
+        hmac_update(&m, b, INDEX_ENTRY_FIXED);
+        hmac_update(&m, e->path, e->path_len);
+    }
+    unsigned char tag[SHA512_DIGEST_LENGTH];
+    hmac_final(&m, tag);
+    memset(&m, 0, sizeof(m));
+    ok = ok && fwrite(tag, 1, sizeof(tag), f) == sizeof(tag);
+    ok = ok && (stream_file_sync(f) == 0);
+    ok = (fclose(f) == 0) && ok;
+    if (ok) ok = (stream_replace_file(tmp, idx->path) == 0);
+    if (!ok) remove(tmp);
+    free(tmp);
+
+    if (!ok) return -6;
+    idx->dirty = 0;
+    return 0;
+}
+
+// -------------------------------------------------------------------
+// 공개 함수
+// -------------------------------------------------------------------
+
+void stream_index_close(stream_index_t* idx)
+{
+    if (!idx) return;
+    index_clear_entries(idx);
+    free(idx->entries);
+    free(idx->path);
+    hmac_key_clear(&idx->key);
+    memset(idx, 0, sizeof(*idx));
+    free(idx);
+}
+
+int stream_index_open(stream_index_t** out,
+                      const char* index_path,
+                      const unsigned char* index_key,
+                      size_t index_key_len)
+{
+    if (!out) return -1;
+    *out = NULL;
+    if (!index_path || !index_key || index_key_len == 0) return -1;
+
+    stream_index_t* idx = (stream_index_t*)calloc(1, sizeof(stream_index_t));
+    if (!idx) return -5;
+    size_t plen = strlen(index_path);
+    idx->path = (char*)malloc(plen + 1);
+    if (!idx->path) {
+        stream_index_close(idx);
+        return -5;
+    }
+    memcpy(idx->path, index_path, plen + 1);
+    hmac_key_init(&idx->key, index_key, index_key_len);
+
+    int rc = index_load(idx);
+    if (rc == 0 && !idx->slots) rc = index_rehash(idx);
+    if (rc != 0) {
+        stream_index_close(idx);
+        return rc;
+    }
+    *out = idx;
+    return 0;
+}
+
+int stream_index_sha512_file(stream_index_t* idx,
+                             const char* in_path,
+                             unsigned char out_digest[SHA512_DIGEST_LENGTH],
+                             const stream_options_t* opt)
+{
+    static const unsigned char no_key[INDEX_KEY_ID_BYTES] = { 0 };
+    if (!idx || !in_path || !out_digest) return -1;
+    if (opt && opt->compress) return -1;
+
+    index_meta_t meta;
+    int have_meta = 0;
+    if (index_lookup(idx, in_path, INDEX_KIND_SHA512, no_key, &meta, &have_meta, out_digest)) {
+        idx->hits++;
+        return 0;
+    }
+    idx->misses++;
+    int64_t started = (int64_t)time(NULL);
+    int rc = stream_hash_sha512_file_ex(in_path, out_digest, opt);
+    if (rc == 0) index_record(idx, in_path, INDEX_KIND_SHA512, no_key, &meta, have_meta, started, out_digest);
+    return rc;
+}
+
+int stream_index_hmac_sha512_file(stream_index_t* idx,
+                                  const char* in_path,
+                                  const unsigned char* key,
+                                  size_t key_len,
+                                  unsigned char out_mac[SHA512_DIGEST_LENGTH],
+                                  const stream_options_t* opt)
+{
+    if (!idx || !in_path || !key || !out_mac) return -1;
+    if (opt && opt->compress) return -1;
+
+    unsigned char id[SHA512_DIGEST_LENGTH];
+    index_key_id(idx, key, key_len, id);
+
+    index_meta_t meta;
+    int have_meta = 0;
+    int rc = 0;
+    if (index_lookup(idx, in_path, INDEX_KIND_HMAC, id, &meta, &have_meta, out_mac)) {
+        idx->hits++;
+    }
+    else {
+        idx->misses++;
+        int64_t started = (int64_t)time(NULL);
+        rc = stream_hmac_sha512_file_ex(in_path, key, key_len, out_mac, opt);
+        if (rc == 0) index_record(idx, in_path, INDEX_KIND_HMAC, id, &meta, have_meta, started, out_mac);
+    }
+    memset(id, 0, sizeof(id));
+    return rc;
+}
+
+int stream_index_batch(stream_index_t* idx,
+                       stream_batch_job_t* jobs,
+                       size_t n,
+                       const stream_options_t* opt)
+{
+    static const unsigned char no_key[INDEX_KEY_ID_BYTES] = { 0 };
+    if (!idx || (!jobs && n)) return -1;
+    if (opt && opt->compress) return -1;
+    for (size_t i = 0; i < n; i++) {
+        if (jobs[i].kind != STREAM_BATCH_SHA512 || !jobs[i].in_path) return -1;
+    }
+    if (n == 0) return 0;
+
+    // 1) 색인 조회 (메타데이터만), 답하지 못한 작업을 모은다
+    stream_batch_job_t* sub = (stream_batch_job_t*)calloc(n, sizeof(stream_batch_job_t));
+    size_t* miss = (size_t*)malloc(n * sizeof(size_t));
+    index_meta_t* meta = (index_meta_t*)malloc(n * sizeof(index_meta_t));
+    int* have_meta = (int*)malloc(n * sizeof(int));
+    if (!sub || !miss || !meta || !have_meta) {
+        free(sub);
+        free(miss);
+        free(meta);
+        free(have_meta);
+        return -5;
+    }
+    size_t m = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (index_lookup(idx, jobs[i].in_path, INDEX_KIND_SHA512, no_key, &meta[m], &have_meta[m], jobs[i].digest)) {
+            jobs[i].rc = 0;
+            idx->hits++;
+            continue;
+        }
+        sub[m] = jobs[i];
+        miss[m++] = i;
+    }
+
+    // 2) 나머지만 병렬 계산 후 기록
+    int64_t started = (int64_t)time(NULL);
+    int rc = m ? stream_encrypt_batch(sub, m, opt) : 0;
+    if (rc >= 0) {
+        for (size_t k = 0; k < m; k++) {
+            stream_batch_job_t* job = &jobs[miss[k]];
+            job->rc = sub[k].rc;
+            memcpy(job->digest, sub[k].digest, SHA512_DIGEST_LENGTH);
+            idx->misses++;
+            if (job->rc == 0)
+                index_record(idx, job->in_path, INDEX_KIND_SHA512, no_key, &meta[k], have_meta[k], started, job->digest);
+        }
+        rc = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (jobs[i].rc != 0) rc++;
+        }
+    }
+
+    free(sub);
+    free(miss);
+    free(meta);
+    free(have_meta);
+    return rc;
+}
+
+size_t stream_index_prune(stream_index_t* idx)
+{
+    if (!idx) return 0;
+    size_t kept = 0;
+    for (size_t i = 0; i < idx->count; i++) {
+        index_meta_t meta;
+        if (index_stat(idx->entries[i].path, &meta) != 0) {
+            free(idx->entries[i].path);
+            continue;
+        }
+        idx->entries[kept++] = idx->entries[i];
+    }
+    size_t removed = idx->count - kept;
+    idx->count = kept;
+    if (removed) {
+        idx->dirty = 1;
+        // 줄어드는 쪽이라 기존 테이블 크기로 다시 채울 수 있다 (할당 실패 시에도 유지)
+        memset(idx->slots, 0, idx->slot_count * sizeof(uint32_t));
+        for (size_t i = 0; i < idx->count; i++) {
+            size_t s = index_slot_of(idx, &idx->entries[i]);
+            while (idx->slots[s]) s = (s + 1) & (idx->slot_count - 1);
+            idx->slots[s] = (uint32_t)(i + 1);
+        }
+    }
+    return removed;
+}
+
+void stream_index_stats(const stream_index_t* idx, size_t* entries, uint64_t* hits, uint64_t* misses)
+{
+    if (entries) *entries = idx ? idx->count : 0;
+    if (hits) *hits = idx ? idx->hits : 0;
+    if (misses) *misses = idx ? idx->misses : 0;
+}
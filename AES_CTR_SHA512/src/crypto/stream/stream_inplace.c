@@ -0,0 +1,444 @@
+﻿// pread/pwrite, fdatasync 선언용
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "crypto/stream/stream_inplace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "crypto/bytes.h"
+#include "crypto/stream/stream_fileutil.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+static const unsigned char JOURNAL_MAGIC[4] = { 'S', 'I', 'P', 'J' };
+
+// -------------------------------------------------------------------
+// 같은 핸들에서 위치 지정 읽기/쓰기
+// -------------------------------------------------------------------
+#ifdef _WIN32
+
+typedef HANDLE ip_file_t;
+#define IP_INVALID INVALID_HANDLE_VALUE
+
+static ip_file_t ip_open(const char* path)
+{
+    return CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, NULL,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+}
+
+static long long ip_size(ip_file_t f)
+{
+    LARGE_INTEGER li;
+    return GetFileSizeEx(f, &li) ? (long long)li.QuadPart : -1;
+}
+
+// 청크는 STREAM_MAX_BUF 이하이므로 DWORD 한 번으로 처리
+static int ip_pread(ip_file_t f, unsigned char* buf, size_t len, uint64_t off)
+{
+    OVERLAPPED ov;
+    memset(&ov, 0, sizeof(ov));
+    ov.Offset = (DWORD)off;
+    ov.OffsetHigh = (DWORD)(off >> 32);
+    DWORD got = 0;
+    return (ReadFile(f, buf, (DWORD)len, &got, &ov) && got == (DWORD)len) ? 0 : -1;
+}
+
+static int ip_pwrite(ip_file_t f, const unsigned char* buf, size_t len, uint64_t off)
+{
+    OVERLAPPED ov;
+    memset(&ov, 0, sizeof(ov));
+    ov.Offset = (DWORD)off;
+    ov.OffsetHigh = (DWORD)(off >> 32);
+    DWORD put = 0;
+    return (WriteFile(f, buf, (DWORD)len, &put, &ov) && put == (DWORD)len) ? 0 : -1;
+}
+
+static int ip_sync(ip_file_t f)
+{
+    return FlushFileBuffers(f) ? 0 : -1;
+}
+
+static void ip_close(ip_file_t f)
+{
+    CloseHandle(f);
+}
+
+#else
+
+typedef int ip_file_t;
+#define IP_INVALID (-1)
+
+static ip_file_t ip_open(const char* path)
+{
+    return open(path, O_RDWR);
+}
+
+static long long ip_size(ip_file_t f)
+{
+    struct stat st;
+    return fstat(f, &st) == 0 ? (long long)st.st_size : -1;
+}
+
+static int ip_pread(ip_file_t f, unsigned char* buf, size_t len, uint64_t off)
+{
+    while (len > 0) {
+        ssize_t n = pread(f, buf, len, (off_t)off);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        buf += n;
+        len -= (size_t)n;
+        off += (uint64_t)n;
+    }
+    return 0;
+}
+
+static int ip_pwrite(ip_file_t f, const unsigned char* buf, size_t len, uint64_t off)
+{
+    while (len > 0) {
+        ssize_t n = pwrite(f, buf, len, (off_t)off);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        buf += n;
+        len -= (size_t)n;
+        off += (uint64_t)n;
+    }
+    return 0;
+}
+
+static int ip_sync(ip_file_t f)
+{
+    return fdatasync(f) == 0 ? 0 : -1;
+}
+
+static void ip_close(ip_file_t f)
+{
+    close(f);
+}
+
+#endif
+
+// -------------------------------------------------------------------
+// 저널
+// -------------------------------------------------------------------
+
+typedef struct inplace_journal_t {
+    unsigned char check[8];     // 키/IV 확인값
+    uint64_t file_size;
+    uint64_t chunk_off;
+    uint64_t chunk_len;
+    uint32_t sectors;
+    uint32_t encrypt;           // 1 = 암호화, 0 = 복호화 (재개는 같은 방향으로만)
+    unsigned char* prefixes;    // sectors * STREAM_INPLACE_PREFIX (암호문 쪽)
+} inplace_journal_t;
+
+static uint32_t sector_count(uint64_t len)
+{
+    return (uint32_t)((len + STREAM_INPLACE_SECTOR - 1) / STREAM_INPLACE_SECTOR);
+}
+
+static size_t prefix_len(uint64_t chunk_len, uint32_t sector)
+{
+    uint64_t left = chunk_len - (uint64_t)sector * STREAM_INPLACE_SECTOR;
+    return left < STREAM_INPLACE_PREFIX ? (size_t)left : STREAM_INPLACE_PREFIX;
+}
+
+// 섹터별 앞부분 (짧은 마지막 섹터는 0으로 채움). 호출 측은 암호문 쪽 버퍼를 넘긴다
+static void collect_prefixes(const unsigned char* chunk, uint64_t len, unsigned char* prefixes)
+{
+    uint32_t n = sector_count(len);
+    memset(prefixes, 0, (size_t)n * STREAM_INPLACE_PREFIX);
+    for (uint32_t i = 0; i < n; i++) {
+        memcpy(prefixes + (size_t)i * STREAM_INPLACE_PREFIX,
+            chunk + (size_t)i * STREAM_INPLACE_SECTOR, prefix_len(len, i));
+    }
+}
+
+// tmp에 기록 → 동기화 → 이름 바꾸기 (저널 자체가 반쯤 기록된 상태로 남지 않도록)
+static int journal_write(const inplace_journal_t* j, const char* journal_path)
+{
+    unsigned char hdr[STREAM_INPLACE_HEADER_BYTES];
+    memset(hdr, 0, sizeof(hdr));
+    memcpy(hdr, JOURNAL_MAGIC, 4);
+    store_be32(hdr + 4, STREAM_INPLACE_JOURNAL_VERSION);
+    memcpy(hdr + 8, j->check, 8);
+    store_be64(hdr + 16, j->file_size);
+    store_be64(hdr + 24, j->chunk_off);
+    store_be64(hdr + 32, j->chunk_len);
+    store_be32(hdr + 40, j->sectors);
+    store_be32(hdr + 44, j->encrypt);
+
+    char* tmp_path = stream_path_suffix(journal_path, ".tmp");
+    if (!tmp_path) return -5;
+
+    FILE* f = fopen(tmp_path, "wb");
+    if (!f) {
+        free(tmp_path);
+        return -6;
+    }
+    size_t body = (size_t)j->sectors * STREAM_INPLACE_PREFIX;
+    int ok = (fwrite(hdr, 1, sizeof(hdr), f) == sizeof(hdr));
+    ok = ok && (body == 0 || fwrite(j->prefixes, 1, body, f) == body);
+    ok = ok && (stream_file_sync(f) == 0);
+    ok = (fclose(f) == 0) && ok;
+    if (ok) ok = (stream_replace_file(tmp_path, journal_path) == 0);
+    if (!ok) remove(tmp_path);
+
+    free(tmp_path);
+    return ok ? 0 : -6;
+}
+
+// 반환: 1 저널 있음(j 채움, prefixes는 호출 측이 free), 0 없음, -14 형식/대상 불일치, -5 메모리
+static int journal_load(inplace_journal_t* j, const char* journal_path,
+                        const unsigned char check[8], uint64_t file_size, uint64_t chunk_cap,
+                        int encrypt)
+{
+    memset(j, 0, sizeof(*j));
+    FILE* f = fopen(journal_path, "rb");
+    if (!f) return 0;
+
+    unsigned char hdr[STREAM_INPLACE_HEADER_BYTES];
+    int rc = -14;
+    if (fread(hdr, 1, sizeof(hdr), f) == sizeof(hdr) &&
+        memcmp(hdr, JOURNAL_MAGIC, 4) == 0 &&
+        load_be32(hdr + 4) == STREAM_INPLACE_JOURNAL_VERSION &&
+        memcmp(hdr + 8, check, 8) == 0 &&
+        load_be64(hdr + 16) == file_size &&
+        load_be32(hdr + 44) == (uint32_t)encrypt) {
+        memcpy(j->check, hdr + 8, 8);
+        j->file_size = file_size;
+        j->chunk_off = load_be64(hdr + 24);
+        j->chunk_len = load_be64(hdr + 32);
+        j->sectors = load_be32(hdr + 40);
+        j->encrypt = (uint32_t)encrypt;
+
+        // 오프셋은 섹터 정렬, 청크는 파일 안, 섹터 수는 길이와 일치해야 함
+        if (j->chunk_off % STREAM_INPLACE_SECTOR == 0 &&
+            j->chunk_len > 0 && j->chunk_len <= chunk_cap &&
+            j->chunk_off <= file_size && j->chunk_len <= file_size - j->chunk_off &&
+            j->sectors == sector_count(j->chunk_len)) {
+            size_t body = (size_t)j->sectors * STREAM_INPLACE_PREFIX;
+            j->prefixes = (unsigned char*)malloc(body);
+            if (!j->prefixes) rc = -5;
+            else if (fread(j->prefixes, 1, body, f) == body) rc = 1;
+        }
+    }
+    fclose(f);
+
+    if (rc != 1) {
+        free(j->prefixes);
+        j->prefixes = NULL;
+    }
+    return rc;
+}
+
+// -------------------------------------------------------------------
+// 본체
+// -------------------------------------------------------------------
+
+// buf = 파일의 [off, off+len) (off는 블록 정렬)
+static void transform(ctr_mode_ctx_t* ctx, const unsigned char iv[CTR_BLOCK_BYTES],
+                      unsigned char* buf, size_t len, uint64_t off)
+{
+    ctr_mode_seek(ctx, iv, off / CTR_BLOCK_BYTES);
+    ctr_mode_update(ctx, buf, buf, (int)len);
+}
+
+// 끊긴 청크 복구: 섹터마다 원본이면 변환, 변환본이면 그대로 → 청크 전체를 변환본으로 기록
+//  - 저널의 암호문 쪽 앞부분을 같은 카운터로 변환해 평문 쪽을 만든다
+//    (암호화: 원본 = 평문 쪽, 변환본 = 저널 / 복호화: 원본 = 저널, 변환본 = 평문 쪽)
+static int recover_chunk(ip_file_t fd, ctr_mode_ctx_t* ctx, const unsigned char iv[CTR_BLOCK_BYTES],
+                         const inplace_journal_t* j, unsigned char* buf)
+{
+    size_t len = (size_t)j->chunk_len;
+    if (ip_pread(fd, buf, len, j->chunk_off) != 0) return -7;
+
+    for (uint32_t i = 0; i < j->sectors; i++) {
+        size_t soff = (size_t)i * STREAM_INPLACE_SECTOR;
+        size_t slen = len - soff < STREAM_INPLACE_SECTOR ? len - soff : STREAM_INPLACE_SECTOR;
+        size_t plen = prefix_len(j->chunk_len, i);
+        const unsigned char* sealed = j->prefixes + (size_t)i * STREAM_INPLACE_PREFIX;
+
+        unsigned char plain[STREAM_INPLACE_PREFIX];
+        memcpy(plain, sealed, plen);
+        transform(ctx, iv, plain, plen, j->chunk_off + soff);
+        const unsigned char* orig = j->encrypt ? plain : sealed;
+        const unsigned char* done = j->encrypt ? sealed : plain;
+
+        if (memcmp(buf + soff, orig, plen) == 0) {
+            transform(ctx, iv, buf + soff, slen, j->chunk_off + soff);   // 아직 원본
+        }
+        else if (memcmp(buf + soff, done, plen) != 0) {
+            memset(plain, 0, sizeof(plain));
+            return -15;   // 어느 쪽도 아님: 섹터가 일부만 기록됨
+        }
+        memset(plain, 0, sizeof(plain));
+    }
+
+    if (ip_pwrite(fd, buf, len, j->chunk_off) != 0 || ip_sync(fd) != 0) return -6;
+    return 0;
+}
+
+static int ctr_inplace(const blockcipher_vtable_t* engine,
+                       const char* path,
+                       const unsigned char* key,
+                       int key_len,
+                       const unsigned char iv[CTR_BLOCK_BYTES],
+                       const char* journal_path,
+                       int encrypt,
+                       const stream_options_t* opt)
+{
+    if (!engine || !path || !key || key_len <= 0 || !iv)
+        return -1;
+    if (opt && opt->compress) return -1;
+
+    // 청크 크기: 섹터(= CTR 블록의 배수) 정렬
+    size_t chunk = (opt && opt->buf_size) ? opt->buf_size : STREAM_INPLACE_DEFAULT_CHUNK;
+    if (chunk > STREAM_MAX_BUF) chunk = STREAM_MAX_BUF;
+    chunk = (chunk + STREAM_INPLACE_SECTOR - 1) / STREAM_INPLACE_SECTOR * STREAM_INPLACE_SECTOR;
+
+    char* jpath = NULL;
+    if (!journal_path) {
+        jpath = stream_path_suffix(path, STREAM_INPLACE_JOURNAL_SUFFIX);
+        if (!jpath) return -5;
+        journal_path = jpath;
+    }
+
+    ip_file_t fd = ip_open(path);
+    if (fd == IP_INVALID) {
+        free(jpath);
+        return -2;
+    }
+
+    int rc = 0;
+    long long size = ip_size(fd);
+    if (size < 0) rc = -7;
+
+    ctr_mode_ctx_t* ctx = NULL;
+    if (rc == 0) {
+        ctx = ctr_mode_init(engine, key, key_len, iv);
+        if (!ctx) rc = -4;
+    }
+
+    if (rc == 0 && (uint64_t)size < chunk) {
+        chunk = (size_t)((uint64_t)size + STREAM_INPLACE_SECTOR - 1) / STREAM_INPLACE_SECTOR * STREAM_INPLACE_SECTOR;
+        if (chunk == 0) chunk = STREAM_INPLACE_SECTOR;
+    }
+
+    inplace_journal_t j;
+    memset(&j, 0, sizeof(j));
+    unsigned char* buf = NULL;
+    if (rc == 0) {
+        buf = (unsigned char*)malloc(chunk);
+        j.prefixes = (unsigned char*)malloc((size_t)sector_count(chunk) * STREAM_INPLACE_PREFIX);
+        if (!buf || !j.prefixes) rc = -5;
+    }
+
+    // 1) 이전 실행이 남긴 저널이 있으면 끊긴 청크부터 마무리
+    uint64_t off = 0;
+    if (rc == 0) {
+        stream_key_check(key, (size_t)key_len, iv, j.check);
+        j.file_size = (uint64_t)size;
+        j.encrypt = (uint32_t)encrypt;
+
+        inplace_journal_t old;
+        int lr = journal_load(&old, journal_path, j.check, (uint64_t)size, STREAM_MAX_BUF, encrypt);
+        if (lr == 1) {
+            if (old.chunk_len > chunk) {
+                // 이전 실행이 더 큰 청크를 썼으면 그 크기로 복구
+                unsigned char* nb = (unsigned char*)realloc(buf, (size_t)old.chunk_len);
+                if (nb) buf = nb;
+                else rc = -5;
+            }
+            if (rc == 0) rc = recover_chunk(fd, ctx, iv, &old, buf);
+            if (rc == 0) off = old.chunk_off + old.chunk_len;
+            free(old.prefixes);
+            if (old.chunk_len > chunk) memset(buf, 0, (size_t)old.chunk_len);
+        }
+        else if (lr < 0) {
+            rc = lr;
+        }
+    }
+
+    // 2) 청크마다: 섹터 앞부분을 저널에 확정 → 같은 위치에 기록 → 동기화
+    //    저널에는 암호문 쪽만 남긴다 (암호화: 변환 후, 복호화: 변환 전의 앞부분)
+    while (rc == 0 && off < (uint64_t)size) {
+        size_t n = (uint64_t)size - off < chunk ? (size_t)((uint64_t)size - off) : chunk;
+        if (ip_pread(fd, buf, n, off) != 0) {
+            rc = -7;
+            break;
+        }
+
+        j.chunk_off = off;
+        j.chunk_len = n;
+        j.sectors = sector_count(n);
+        if (!encrypt) collect_prefixes(buf, n, j.prefixes);
+        transform(ctx, iv, buf, n, off);
+        if (encrypt) collect_prefixes(buf, n, j.prefixes);
+        rc = journal_write(&j, journal_path);
+        if (rc != 0) break;
+
+        if (ip_pwrite(fd, buf, n, off) != 0 || ip_sync(fd) != 0) {
+            rc = -6;
+            break;
+        }
+        off += n;
+
+        // 진행률 / 취소: 저널은 방금 끝낸 청크를 가리키므로 같은 인자로 다시 호출하면 이어서 처리
+        if (opt && opt->progress) opt->progress(opt->user, off, (uint64_t)size);
+        if (opt && opt->cancel && off < (uint64_t)size && opt->cancel(opt->user)) {
+            rc = -16;
+            break;
+        }
+    }
+
+    // 3) 끝까지 처리했으면 저널 삭제 (오류/취소 시에는 재개용으로 남긴다)
+    if (rc == 0) remove(journal_path);
+
+    if (buf) {
+        memset(buf, 0, chunk);
+        free(buf);
+    }
+    if (j.prefixes) {
+        memset(j.prefixes, 0, (size_t)sector_count(chunk) * STREAM_INPLACE_PREFIX);
+        free(j.prefixes);
+    }
+    if (ctx) ctr_mode_free(ctx);
+    ip_close(fd);
+    free(jpath);
+    return rc;
+}
+
+int stream_encrypt_ctr_file_inplace(const blockcipher_vtable_t* engine,
+                                    const char* path,
+                                    const unsigned char* key,
+                                    int key_len,
+                                    const unsigned char iv[CTR_BLOCK_BYTES],
+                                    const char* journal_path,
+                                    const stream_options_t* opt)
+{
+    return ctr_inplace(engine, path, key, key_len, iv, journal_path, 1, opt);
+}
+
+int stream_decrypt_ctr_file_inplace(const blockcipher_vtable_t* engine,
+                                    const char* path,
+                                    const unsigned char* key,
+                                    int key_len,
+                                    const unsigned char iv[CTR_BLOCK_BYTES],
+                                    const char* journal_path,
+                                    const stream_options_t* opt)
+{
+    // CTR은 암호화/복호화 연산이 동일 (방향은 저널에 어느 쪽을 남길지만 정한다)
+    return ctr_inplace(engine, path, key, key_len, iv, journal_path, 0, opt);
+}
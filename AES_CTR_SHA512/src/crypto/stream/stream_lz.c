@@ -0,0 +1,161 @@
+﻿#include "crypto/stream/stream_lz.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define LZ_MIN_MATCH   4
+#define LZ_HASH_BITS   12
+#define LZ_MAX_OFFSET  65535u
+#define LZ_SKIP_SHIFT  6     // 매치 없이 2^6바이트 지날 때마다 탐색 간격 +1
+
+static uint32_t lz_read32(const unsigned char* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint32_t lz_hash(const unsigned char* p)
+{
+    return (lz_read32(p) * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+// 길이 확장 바이트 (len은 15를 뺀 나머지)
+static unsigned char* lz_put_len(unsigned char* op, size_t len)
+{
+    while (len >= 255) {
+        *op++ = 255;
+        len -= 255;
+    }
+    *op++ = (unsigned char)len;
+    return op;
+}
+
+// 시퀀스 하나 기록 (mlen == 0이면 리터럴만). 반환: 다음 위치, 공간이 모자라면 NULL
+static unsigned char* lz_put_seq(unsigned char* op, const unsigned char* oend,
+                                 const unsigned char* lit, size_t lit_len,
+                                 size_t offset, size_t mlen)
+{
+    size_t ml = mlen ? mlen - LZ_MIN_MATCH : 0;
+    size_t need = 1 + lit_len + (lit_len >= 15 ? (lit_len - 15) / 255 + 1 : 0) +
+        (mlen ? 2 + (ml >= 15 ? (ml - 15) / 255 + 1 : 0) : 0);
+    if ((size_t)(oend - op) < need) return NULL;
+
+    unsigned char* token = op++;
+    *token = (unsigned char)(((lit_len < 15 ? lit_len : 15) << 4) | (ml < 15 ? ml : 15));
+    if (lit_len >= 15) op = lz_put_len(op, lit_len - 15);
+    memcpy(op, lit, lit_len);
+    op += lit_len;
+    if (mlen) {
+        op[0] = (unsigned char)offset;
+        op[1] = (unsigned char)(offset >> 8);
+        op += 2;
+        if (ml >= 15) op = lz_put_len(op, ml - 15);
+    }
+    return op;
+}
+
+int stream_lz_probe(const unsigned char* in, size_t n)
+{
+    if (!in || n < STREAM_LZ_MIN_INPUT) return 0;
+
+    uint32_t hist[256];
+    memset(hist, 0, sizeof(hist));
+    size_t step = n / STREAM_LZ_PROBE_SAMPLES;
+    if (step == 0) step = 1;
+    uint64_t m = 0;
+    for (size_t i = 0; i < n && m < STREAM_LZ_PROBE_SAMPLES; i += step, m++) hist[in[i]]++;
+
+    // sum p^2 >= 2^-7  <=>  sum c^2 * 128 >= m^2
+    uint64_t sq = 0;
+    for (int i = 0; i < 256; i++) sq += (uint64_t)hist[i] * hist[i];
+    return sq * 128 >= m * m;
+}
+
+size_t stream_lz_compress(const unsigned char* in, size_t n, unsigned char* out, size_t cap)
+{
+    if (!in || !out || cap == 0) return 0;
+
+    uint32_t table[1u << LZ_HASH_BITS];
+    memset(table, 0, sizeof(table));
+
+    const unsigned char* ip = in;
+    const unsigned char* anchor = in;
+    const unsigned char* const iend = in + n;
+    unsigned char* op = out;
+    const unsigned char* const oend = out + cap;
+
+    if (n >= LZ_MIN_MATCH) {
+        const unsigned char* const mlimit = iend - LZ_MIN_MATCH;
+        while (ip <= mlimit) {
+            uint32_t h = lz_hash(ip);
+            const unsigned char* ref = in + table[h];
+            table[h] = (uint32_t)(ip - in);
+            if (ref < ip && (size_t)(ip - ref) <= LZ_MAX_OFFSET && lz_read32(ref) == lz_read32(ip)) {
+                size_t mlen = LZ_MIN_MATCH;
+                while (ip + mlen < iend && ref[mlen] == ip[mlen]) mlen++;
+                op = lz_put_seq(op, oend, anchor, (size_t)(ip - anchor), (size_t)(ip - ref), mlen);
+                if (!op) return 0;
+                ip += mlen;
+                anchor = ip;
+            }
+            else {
+                ip += 1 + ((size_t)(ip - anchor) >> LZ_SKIP_SHIFT);
+            }
+        }
+    }
+
+    op = lz_put_seq(op, oend, anchor, (size_t)(iend - anchor), 0, 0);
+    return op ? (size_t)(op - out) : 0;
+}
+
+long long stream_lz_decompress(const unsigned char* in, size_t n, unsigned char* out, size_t cap)
+{
+    if (!in || (!out && cap)) return -1;
+
+    const unsigned char* ip = in;
+    const unsigned char* const iend = in + n;
+    unsigned char* op = out;
+    unsigned char* const oend = out + cap;
+
+    for (;;) {
+        if (ip >= iend) return -1;
+        unsigned int token = *ip++;
+
+        size_t lit = token >> 4;
+        if (lit == 15) {
+            unsigned char b;
+            do {
+                if (ip >= iend) return -1;
+                b = *ip++;
+                lit += b;
+            } while (b == 255);
+        }
+        if (lit > (size_t)(iend - ip) || lit > (size_t)(oend - op)) return -1;
+        memcpy(op, ip, lit);
+        op += lit;
+        ip += lit;
+        if (ip == iend) break;  // 마지막 시퀀스
+
+        if (iend - ip < 2) return -1;
+        size_t offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (size_t)(op - out)) return -1;
+
+        size_t mlen = token & 15;
+        if (mlen == 15) {
+            unsigned char b;
+            do {
+                if (ip >= iend) return -1;
+                b = *ip++;
+                mlen += b;
+            } while (b == 255);
+        }
+        mlen += LZ_MIN_MATCH;
+        if (mlen > (size_t)(oend - op)) return -1;
+
+        // 겹치는 복사 (offset < mlen이면 반복 패턴)
+        const unsigned char* ref = op - offset;
+        for (size_t i = 0; i < mlen; i++) op[i] = ref[i];
+        op += mlen;
+    }
+    return (long long)(op - out);
+}
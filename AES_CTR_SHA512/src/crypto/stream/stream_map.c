@@ -0,0 +1,194 @@
+﻿// posix_fallocate, madvise 선언용
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "crypto/stream/stream_map.h"
+
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+// 매핑 길이가 size_t로 표현되는지 (32비트 빌드에서 4GB 이상 파일 차단)
+static int map_size_ok(uint64_t size)
+{
+    return size <= (uint64_t)(size_t)-1;
+}
+
+#ifdef _WIN32
+
+int stream_map_open_read(stream_map_t* m, const char* path)
+{
+    memset(m, 0, sizeof(*m));
+
+    // FILE_FLAG_SEQUENTIAL_SCAN: madvise(MADV_SEQUENTIAL)에 해당하는 캐시 힌트
+    HANDLE f = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (f == INVALID_HANDLE_VALUE) return -2;
+
+    LARGE_INTEGER sz;
+    if (!GetFileSizeEx(f, &sz) || !map_size_ok((uint64_t)sz.QuadPart)) {
+        CloseHandle(f);
+        return -1;
+    }
+    m->file = f;
+    m->size = (uint64_t)sz.QuadPart;
+    if (m->size == 0) return 0;
+
+    HANDLE mp = CreateFileMappingA(f, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mp) {
+        CloseHandle(f);
+        memset(m, 0, sizeof(*m));
+        return -1;
+    }
+    m->mapping = mp;
+    m->data = (unsigned char*)MapViewOfFile(mp, FILE_MAP_READ, 0, 0, 0);
+    if (!m->data) {
+        CloseHandle(mp);
+        CloseHandle(f);
+        memset(m, 0, sizeof(*m));
+        return -1;
+    }
+    return 0;
+}
+
+int stream_map_create(stream_map_t* m, const char* path, uint64_t size)
+{
+    memset(m, 0, sizeof(*m));
+    if (!map_size_ok(size)) return -1;
+
+    HANDLE f = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, NULL,
+        CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (f == INVALID_HANDLE_VALUE) return -3;
+    m->file = f;
+    m->size = size;
+    m->writable = 1;
+    if (size == 0) return 0;
+
+    // 매핑 객체 크기를 지정하면 파일이 그 길이로 확장된다 (미리 할당)
+    HANDLE mp = CreateFileMappingA(f, NULL, PAGE_READWRITE,
+        (DWORD)(size >> 32), (DWORD)(size & 0xFFFFFFFFu), NULL);
+    if (!mp) {
+        CloseHandle(f);
+        memset(m, 0, sizeof(*m));
+        return -3;
+    }
+    m->mapping = mp;
+    m->data = (unsigned char*)MapViewOfFile(mp, FILE_MAP_WRITE, 0, 0, 0);
+    if (!m->data) {
+        CloseHandle(mp);
+        CloseHandle(f);
+        memset(m, 0, sizeof(*m));
+        return -1;
+    }
+    return 0;
+}
+
+int stream_map_close(stream_map_t* m)
+{
+    int rc = 0;
+    if (m->data) {
+        // 더티 페이지는 뷰를 닫아도 시스템 캐시를 거쳐 파일에 기록된다
+        if (!UnmapViewOfFile(m->data)) rc = -1;
+    }
+    if (m->mapping) CloseHandle((HANDLE)m->mapping);
+    if (m->file) CloseHandle((HANDLE)m->file);
+    memset(m, 0, sizeof(*m));
+    return rc;
+}
+
+#else
+
+int stream_map_open_read(stream_map_t* m, const char* path)
+{
+    memset(m, 0, sizeof(*m));
+    m->fd = -1;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -2;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || !map_size_ok((uint64_t)st.st_size)) {
+        close(fd);
+        return -1;
+    }
+    m->fd = fd;
+    m->size = (uint64_t)st.st_size;
+    if (m->size == 0) return 0;
+
+    void* p = mmap(NULL, (size_t)m->size, PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+        close(fd);
+        m->fd = -1;
+        m->size = 0;
+        return -1;
+    }
+    m->data = (unsigned char*)p;
+
+    // 한 번 앞에서부터 읽고 버리는 패턴: 미리 읽기를 늘리고 지난 페이지는 빨리 회수
+    madvise(p, (size_t)m->size, MADV_SEQUENTIAL);
+    return 0;
+}
+
+int stream_map_create(stream_map_t* m, const char* path, uint64_t size)
+{
+    memset(m, 0, sizeof(*m));
+    m->fd = -1;
+    if (!map_size_ok(size)) return -1;
+
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return -3;
+
+    if (size > 0) {
+        // 블록을 실제로 확보해 두어야 매핑에 쓰는 도중 공간 부족(SIGBUS)이 나지 않는다.
+        // posix_fallocate를 지원하지 않는 파일시스템은 ftruncate로 길이만 맞춘다.
+        int rc = posix_fallocate(fd, 0, (off_t)size);
+        if (rc != 0 && (rc != EINVAL && rc != EOPNOTSUPP)) {
+            close(fd);
+            return -3;
+        }
+        if (rc != 0 && ftruncate(fd, (off_t)size) != 0) {
+            close(fd);
+            return -3;
+        }
+    }
+    m->fd = fd;
+    m->size = size;
+    m->writable = 1;
+    if (size == 0) return 0;
+
+    void* p = mmap(NULL, (size_t)size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+        close(fd);
+        memset(m, 0, sizeof(*m));
+        m->fd = -1;
+        return -1;
+    }
+    m->data = (unsigned char*)p;
+    madvise(p, (size_t)size, MADV_SEQUENTIAL);
+    return 0;
+}
+
+int stream_map_close(stream_map_t* m)
+{
+    int rc = 0;
+    if (m->data) {
+        // MAP_SHARED 페이지는 munmap 후에도 페이지 캐시에 남아 기록된다 (fclose와 같은 보장)
+        if (munmap(m->data, (size_t)m->size) != 0) rc = -1;
+    }
+    if (m->fd >= 0 && close(m->fd) != 0) rc = -1;
+    memset(m, 0, sizeof(*m));
+    m->fd = -1;
+    return rc;
+}
+
+#endif
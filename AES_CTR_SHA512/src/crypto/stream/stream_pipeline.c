@@ -0,0 +1,322 @@
+﻿// posix_memalign 선언용
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "crypto/stream/stream_pipeline.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "crypto/core/crypto_thread.h"
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+void* stream_aligned_alloc(size_t size, size_t alignment)
+{
+    if (alignment < sizeof(void*)) alignment = sizeof(void*);
+#ifdef _WIN32
+    return _aligned_malloc(size, alignment);
+#else
+    void* p = NULL;
+    if (posix_memalign(&p, alignment, size) != 0) return NULL;
+    return p;
+#endif
+}
+
+void stream_aligned_free(void* p)
+{
+    if (!p) return;
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+// -------------------------------------------------------------------
+// 단일 생산자/단일 소비자 링
+//  - tail은 생산자만, head는 소비자만 기록 (서로의 값은 atomic load로 확인)
+//  - 한 칸을 비워 두어 가득 참과 비어 있음을 구분
+// -------------------------------------------------------------------
+typedef struct spsc_ring_t {
+    void** slots;
+    long cap;
+    crypto_atomic_t head;
+    crypto_atomic_t tail;
+} spsc_ring_t;
+
+static int ring_init(spsc_ring_t* r, long entries)
+{
+    r->cap = entries + 1;
+    r->slots = (void**)calloc((size_t)r->cap, sizeof(void*));
+    r->head = 0;
+    r->tail = 0;
+    return r->slots ? 0 : -1;
+}
+
+static int ring_try_push(spsc_ring_t* r, void* v)
+{
+    long t = r->tail;
+    long next = (t + 1) % r->cap;
+    if (next == crypto_atomic_load(&r->head)) return 0;
+    r->slots[t] = v;
+    crypto_atomic_store(&r->tail, next);
+    return 1;
+}
+
+static int ring_try_pop(spsc_ring_t* r, void** v)
+{
+    long h = r->head;
+    if (h == crypto_atomic_load(&r->tail)) return 0;
+    *v = r->slots[h];
+    crypto_atomic_store(&r->head, (h + 1) % r->cap);
+    return 1;
+}
+
+// 대기 백오프: 잠깐 스핀 → 양보 → 1ms 휴면 (디스크 대기 중 CPU를 태우지 않도록)
+static void ring_backoff(unsigned int* spins)
+{
+    unsigned int n = (*spins)++;
+    if (n < 64) return;
+    if (n < 256) crypto_thread_yield();
+    else crypto_thread_sleep_ms(1);
+}
+
+// -------------------------------------------------------------------
+// 파이프라인 상태
+// -------------------------------------------------------------------
+typedef struct pipe_buf_t {
+    unsigned char* data;
+    size_t len;
+    uint64_t offset;
+} pipe_buf_t;
+
+typedef struct pipe_state_t {
+    const stream_pipeline_t* cfg;
+    size_t buf_size;
+    unsigned int workers;
+    spsc_ring_t free_ring;                              // 쓰기(또는 연산) → 읽기
+    spsc_ring_t work_ring[STREAM_PIPELINE_MAX_WORKERS]; // 읽기 → 연산 i
+    spsc_ring_t done_ring[STREAM_PIPELINE_MAX_WORKERS]; // 연산 i → 쓰기
+    crypto_atomic_t failed;                             // 0 이외면 오류 코드
+} pipe_state_t;
+
+// 링에 넣을 때까지 대기. 중단되면 0
+static int pipe_push(pipe_state_t* ps, spsc_ring_t* r, void* v)
+{
+    unsigned int spins = 0;
+    while (!ring_try_push(r, v)) {
+        if (crypto_atomic_load(&ps->failed)) return 0;
+        ring_backoff(&spins);
+    }
+    return 1;
+}
+
+static void pipe_fail(pipe_state_t* ps, long code)
+{
+    // 처음 발생한 오류만 남긴다 (경합 시 어느 쪽이 남아도 오류로 끝남)
+    if (!crypto_atomic_load(&ps->failed)) crypto_atomic_store(&ps->failed, code);
+}
+
+// 반환된 버퍼(free_ring)를 꺼낸다. 중단되면 NULL
+static pipe_buf_t* pipe_take_free(pipe_state_t* ps)
+{
+    void* v = NULL;
+    unsigned int spins = 0;
+    while (!ring_try_pop(&ps->free_ring, &v)) {
+        if (crypto_atomic_load(&ps->failed)) return NULL;
+        ring_backoff(&spins);
+    }
+    return (pipe_buf_t*)v;
+}
+
+static void pipe_reader(void* arg)
+{
+    pipe_state_t* ps = (pipe_state_t*)arg;
+    uint64_t offset = 0;
+    uint64_t seq = 0;
+
+    for (;;) {
+        pipe_buf_t* b = pipe_take_free(ps);
+        if (!b) break;
+
+        size_t n = fread(b->data, 1, ps->buf_size, ps->cfg->in);
+        if (n == 0) {
+            if (ferror(ps->cfg->in)) pipe_fail(ps, -4);
+            // 마지막으로 꺼낸 버퍼는 더 쓰지 않으므로 링에 돌려놓지 않는다 (해제는 일괄 처리)
+            break;
+        }
+        b->len = n;
+        b->offset = offset;
+        offset += n;
+
+        if (!pipe_push(ps, &ps->work_ring[seq % ps->workers], b)) break;
+        seq++;
+        if (n < ps->buf_size) {
+            if (ferror(ps->cfg->in)) pipe_fail(ps, -4);
+            break;
+        }
+    }
+
+    // 종료 표시(NULL)를 다음 차례 연산 스레드부터 하나씩 보낸다.
+    // 링 용량이 버퍼 수 + 1 이라 종료 표시는 항상 들어간다.
+    for (unsigned int i = 0; i < ps->workers; i++) {
+        spsc_ring_t* r = &ps->work_ring[(seq + i) % ps->workers];
+        unsigned int spins = 0;
+        while (!ring_try_push(r, NULL)) ring_backoff(&spins);
+    }
+}
+
+typedef struct pipe_worker_arg_t {
+    pipe_state_t* ps;
+    unsigned int index;
+} pipe_worker_arg_t;
+
+static void pipe_worker(void* arg)
+{
+    pipe_worker_arg_t* wa = (pipe_worker_arg_t*)arg;
+    pipe_state_t* ps = wa->ps;
+    spsc_ring_t* in = &ps->work_ring[wa->index];
+    spsc_ring_t* out = ps->cfg->out ? &ps->done_ring[wa->index] : &ps->free_ring;
+
+    for (;;) {
+        void* v = NULL;
+        unsigned int spins = 0;
+        while (!ring_try_pop(in, &v)) ring_backoff(&spins);
+
+        pipe_buf_t* b = (pipe_buf_t*)v;
+        if (b && !crypto_atomic_load(&ps->failed)) {
+            if (ps->cfg->fn(ps->cfg->arg, wa->index, b->data, b->len, b->offset) != 0)
+                pipe_fail(ps, -7);
+            else if (!ps->cfg->out && ps->cfg->done &&
+                     ps->cfg->done(ps->cfg->done_arg, wa->index, b->data, b->len, b->offset) != 0)
+                pipe_fail(ps, -7);
+        }
+
+        if (!b) {
+            // 종료 표시는 쓰기 스레드로 넘긴다
+            if (ps->cfg->out) {
+                spins = 0;
+                while (!ring_try_push(out, NULL)) ring_backoff(&spins);
+            }
+            break;
+        }
+
+        // 쓰기 단계가 없을 때는 free_ring 생산자가 둘(쓰기 자리) 이상이 되면 안 되므로
+        // 이 경우 workers는 1로 제한된다 (stream_pipeline_run에서 보장)
+        spins = 0;
+        while (!ring_try_push(out, b)) ring_backoff(&spins);
+    }
+}
+
+static void pipe_writer(void* arg)
+{
+    pipe_state_t* ps = (pipe_state_t*)arg;
+    uint64_t seq = 0;
+
+    for (;;) {
+        void* v = NULL;
+        unsigned int spins = 0;
+        spsc_ring_t* r = &ps->done_ring[seq % ps->workers];
+        while (!ring_try_pop(r, &v)) ring_backoff(&spins);
+
+        pipe_buf_t* b = (pipe_buf_t*)v;
+        if (!b) break;
+        seq++;
+
+        if (!crypto_atomic_load(&ps->failed)) {
+            if (fwrite(b->data, 1, b->len, ps->cfg->out) != b->len || ferror(ps->cfg->out))
+                pipe_fail(ps, -6);
+            else if (ps->cfg->done &&
+                     ps->cfg->done(ps->cfg->done_arg, 0, b->data, b->len, b->offset) != 0)
+                pipe_fail(ps, -7);
+        }
+
+        spins = 0;
+        while (!ring_try_push(&ps->free_ring, b)) ring_backoff(&spins);
+    }
+}
+
+int stream_pipeline_run(const stream_pipeline_t* p)
+{
+    if (!p || !p->in || !p->fn) return -1;
+
+    pipe_state_t* ps = (pipe_state_t*)calloc(1, sizeof(pipe_state_t));
+    if (!ps) return -3;
+
+    ps->cfg = p;
+    ps->buf_size = p->buf_size ? p->buf_size : STREAM_PIPELINE_DEFAULT_BUF_SIZE;
+    ps->workers = p->workers ? p->workers : 1;
+    if (ps->workers > STREAM_PIPELINE_MAX_WORKERS) ps->workers = STREAM_PIPELINE_MAX_WORKERS;
+    if (!p->out) ps->workers = 1;
+
+    size_t count = p->buf_count ? p->buf_count : (size_t)ps->workers * 2 + 2;
+    if (count < 2) count = 2;
+    size_t align = p->alignment ? p->alignment : STREAM_PIPELINE_DEFAULT_ALIGNMENT;
+
+    int rc = 0;
+    pipe_buf_t* bufs = (pipe_buf_t*)calloc(count, sizeof(pipe_buf_t));
+    if (!bufs) rc = -3;
+
+    // 링 용량: 모든 버퍼 + 종료 표시 1개
+    if (rc == 0 && ring_init(&ps->free_ring, (long)count) != 0) rc = -3;
+    for (unsigned int i = 0; rc == 0 && i < ps->workers; i++) {
+        if (ring_init(&ps->work_ring[i], (long)count + 1) != 0 ||
+            ring_init(&ps->done_ring[i], (long)count + 1) != 0) rc = -3;
+    }
+    for (size_t i = 0; rc == 0 && i < count; i++) {
+        bufs[i].data = (unsigned char*)stream_aligned_alloc(ps->buf_size, align);
+        if (!bufs[i].data) rc = -3;
+        else ring_try_push(&ps->free_ring, &bufs[i]);
+    }
+
+    crypto_thread_t reader, writer;
+    crypto_thread_t workers[STREAM_PIPELINE_MAX_WORKERS];
+    pipe_worker_arg_t wargs[STREAM_PIPELINE_MAX_WORKERS];
+    memset(&reader, 0, sizeof(reader));
+    memset(&writer, 0, sizeof(writer));
+    memset(workers, 0, sizeof(workers));
+
+    if (rc == 0) {
+        // 소비자부터 시작해야 생성 실패 시 생산자 없이 정리할 수 있다
+        unsigned int started = 0;
+        if (p->out && crypto_thread_start(&writer, pipe_writer, ps) != 0) rc = -12;
+        for (unsigned int i = 0; rc == 0 && i < ps->workers; i++) {
+            wargs[i].ps = ps;
+            wargs[i].index = i;
+            if (crypto_thread_start(&workers[i], pipe_worker, &wargs[i]) != 0) rc = -12;
+            else started++;
+        }
+        if (rc == 0 && crypto_thread_start(&reader, pipe_reader, ps) != 0) rc = -12;
+
+        if (rc != 0) {
+            // 이미 시작한 스레드는 종료 표시를 보내 정리한다
+            pipe_fail(ps, rc);
+            for (unsigned int i = 0; i < started; i++) ring_try_push(&ps->work_ring[i], NULL);
+            if (p->out && started < ps->workers) {
+                for (unsigned int i = started; i < ps->workers; i++) ring_try_push(&ps->done_ring[i], NULL);
+            }
+        }
+
+        crypto_thread_join(&reader);
+        for (unsigned int i = 0; i < ps->workers; i++) crypto_thread_join(&workers[i]);
+        crypto_thread_join(&writer);
+
+        if (rc == 0) rc = (int)crypto_atomic_load(&ps->failed);
+    }
+
+    if (bufs) {
+        for (size_t i = 0; i < count; i++) stream_aligned_free(bufs[i].data);
+        free(bufs);
+    }
+    free(ps->free_ring.slots);
+    for (unsigned int i = 0; i < ps->workers; i++) {
+        free(ps->work_ring[i].slots);
+        free(ps->done_ring[i].slots);
+    }
+    free(ps);
+    return rc;
+}
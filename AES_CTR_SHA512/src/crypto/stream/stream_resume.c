@@ -0,0 +1,255 @@
+﻿#include "crypto/stream/stream_resume.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "crypto/bytes.h"
+#include "crypto/status.h"
+#include "crypto/hash/hash_sha512.h"
+#include "crypto/hash/hmac.h"
+#include "crypto/stream/stream_fileutil.h"
+
+#define RESUME_FLAG_HMAC  1u
+#define RESUME_FILE_BYTES (STREAM_RESUME_HEADER_BYTES + HMAC_STATE_BYTES)
+
+static const unsigned char RESUME_MAGIC[4] = { 'S', 'E', 'C', 'P' };
+
+// -------------------------------------------------------------------
+// 상태 파일
+// -------------------------------------------------------------------
+
+typedef struct resume_state_t {
+    uint32_t flags;
+    uint64_t offset;            // 입력 오프셋 (출력은 16 + offset)
+    uint64_t counter;           // CTR 블록 번호 = offset / 16
+    unsigned char check[8];     // 키/IV 확인값
+    uint64_t in_size;
+    hmac_ctx hmac;
+} resume_state_t;
+
+// tmp에 기록 → 동기화 → 이름 바꾸기
+static int state_write(const resume_state_t* st, const char* state_path)
+{
+    unsigned char rec[RESUME_FILE_BYTES];
+    memset(rec, 0, sizeof(rec));
+    memcpy(rec, RESUME_MAGIC, 4);
+    store_be32(rec + 4, STREAM_RESUME_STATE_VERSION);
+    store_be32(rec + 8, st->flags);
+    store_be64(rec + 16, st->offset);
+    store_be64(rec + 24, st->counter);
+    memcpy(rec + 32, st->check, 8);
+    store_be64(rec + 40, st->in_size);
+    if ((st->flags & RESUME_FLAG_HMAC) &&
+        hmac_export_state(&st->hmac, rec + STREAM_RESUME_HEADER_BYTES) != CRYPTO_OK)
+        return -6;
+
+    char* tmp_path = stream_path_suffix(state_path, ".tmp");
+    if (!tmp_path) return -5;
+
+    FILE* f = fopen(tmp_path, "wb");
+    if (!f) {
+        free(tmp_path);
+        return -6;
+    }
+    int ok = (fwrite(rec, 1, sizeof(rec), f) == sizeof(rec));
+    ok = ok && (stream_file_sync(f) == 0);
+    ok = (fclose(f) == 0) && ok;
+    if (ok) ok = (stream_replace_file(tmp_path, state_path) == 0);
+    if (!ok) remove(tmp_path);
+
+    free(tmp_path);
+    memset(rec, 0, sizeof(rec));
+    return ok ? 0 : -6;
+}
+
+// 반환: 1 상태 있음(st 채움), 0 없음/깨짐(처음부터), -14 다른 HMAC 키
+static int state_load(resume_state_t* st, const char* state_path, uint32_t flags,
+                      const unsigned char* hmac_key, size_t hmac_key_len)
+{
+    unsigned char rec[RESUME_FILE_BYTES];
+    memset(st, 0, sizeof(*st));
+
+    FILE* f = fopen(state_path, "rb");
+    if (!f) return 0;
+    size_t n = fread(rec, 1, sizeof(rec), f);
+    fclose(f);
+
+    int ok = n == sizeof(rec) &&
+        memcmp(rec, RESUME_MAGIC, 4) == 0 &&
+        load_be32(rec + 4) == STREAM_RESUME_STATE_VERSION &&
+        load_be32(rec + 8) == flags;
+    if (ok) {
+        st->flags = flags;
+        st->offset = load_be64(rec + 16);
+        st->counter = load_be64(rec + 24);
+        memcpy(st->check, rec + 32, 8);
+        st->in_size = load_be64(rec + 40);
+        ok = (st->offset % CTR_BLOCK_BYTES) == 0 &&
+            st->counter == st->offset / CTR_BLOCK_BYTES &&
+            st->offset <= st->in_size;
+    }
+    // HMAC 상태는 같은 키로만 가져올 수 있고, 처리한 길이가 IV + 오프셋과 맞아야 한다
+    if (ok && (flags & RESUME_FLAG_HMAC)) {
+        int hrc = hmac_import_state(&st->hmac, hmac_key, hmac_key_len, rec + STREAM_RESUME_HEADER_BYTES);
+        if (hrc == CRYPTO_ERR_KEY) ok = -14;
+        else if (hrc != CRYPTO_OK) ok = 0;
+        else if (sha512_bytes_processed(&st->hmac.ctx) != SHA512_BLOCK_SIZE + CTR_BLOCK_BYTES + st->offset) ok = 0;
+    }
+    memset(rec, 0, sizeof(rec));
+    if (ok != 1) memset(st, 0, sizeof(*st));
+    return ok;
+}
+
+// 재개: 출력 앞 16바이트(IV)와 확인값을 대조하고 기록된 길이로 자른다.
+// 반환: 0 재개 준비 완료, 1 처음부터, -14 다른 키/입력
+static int resume_prepare(FILE* fout, ctr_mode_ctx_t* ctx, const unsigned char* key, int key_len,
+                          const resume_state_t* st, long long in_size, unsigned char iv[CTR_BLOCK_BYTES])
+{
+    if (in_size < 0 || (uint64_t)in_size != st->in_size) return -14;
+
+    long long out_size = stream_file_size(fout);
+    if (out_size < 0 || (uint64_t)out_size < CTR_BLOCK_BYTES + st->offset) return 1;
+    if (fread(iv, 1, CTR_BLOCK_BYTES, fout) != CTR_BLOCK_BYTES) return 1;
+
+    unsigned char check[8];
+    stream_key_check(key, (size_t)key_len, iv, check);
+    if (memcmp(check, st->check, 8) != 0) return -14;
+
+    if (stream_file_truncate(fout, CTR_BLOCK_BYTES + st->offset) != 0) return 1;
+    if (stream_file_seek(fout, CTR_BLOCK_BYTES + st->offset) != 0) return 1;
+    ctr_mode_seek(ctx, iv, st->counter);
+    return 0;
+}
+
+int stream_encrypt_ctr_hmac_file_resumable(const blockcipher_vtable_t* engine,
+                                           const char* in_path,
+                                           const char* out_path,
+                                           const unsigned char* key,
+                                           int key_len,
+                                           const unsigned char iv[CTR_BLOCK_BYTES],
+                                           const unsigned char* hmac_key,
+                                           size_t hmac_key_len,
+                                           const char* state_path,
+                                           uint64_t checkpoint_interval,
+                                           const stream_options_t* opt)
+{
+    if (!engine || !in_path || !out_path || !key || key_len <= 0 || !iv)
+        return -1;
+    if (opt && opt->compress) return -1;
+    if (checkpoint_interval == 0) checkpoint_interval = STREAM_CHECKPOINT_DEFAULT_INTERVAL;
+
+    char* spath = NULL;
+    if (!state_path) {
+        spath = stream_path_suffix(out_path, STREAM_RESUME_STATE_SUFFIX);
+        if (!spath) return -5;
+        state_path = spath;
+    }
+
+    FILE* fin = fopen(in_path, "rb");
+    if (!fin) {
+        free(spath);
+        return -2;
+    }
+    long long in_size = stream_file_size(fin);
+
+    int rc = 0;
+    ctr_mode_ctx_t* ctx = ctr_mode_init(engine, key, key_len, iv);
+    if (!ctx) rc = -4;
+
+    // 1) 상태 파일이 있으면 출력 파일을 확인하고 그 위치부터 이어서
+    resume_state_t st;
+    unsigned char use_iv[CTR_BLOCK_BYTES];
+    uint32_t flags = hmac_key ? RESUME_FLAG_HMAC : 0;
+    FILE* fout = NULL;
+    int resumed = 0;
+    if (rc == 0) {
+        int lr = state_load(&st, state_path, flags, hmac_key, hmac_key_len);
+        if (lr < 0) rc = lr;
+        else if (lr == 1 && (fout = fopen(out_path, "r+b")) != NULL) {
+            int pr = resume_prepare(fout, ctx, key, key_len, &st, in_size, use_iv);
+            if (pr < 0) rc = pr;
+            else if (pr == 0 && stream_file_seek(fin, st.offset) == 0) resumed = 1;
+            if (!resumed) {
+                fclose(fout);
+                fout = NULL;
+            }
+        }
+    }
+
+    // 2) 처음부터: 새 IV로 출력 파일을 만들고 IV를 기록
+    if (rc == 0 && !resumed) {
+        memset(&st, 0, sizeof(st));
+        st.flags = flags;
+        st.in_size = in_size > 0 ? (uint64_t)in_size : 0;
+        memcpy(use_iv, iv, CTR_BLOCK_BYTES);
+        stream_key_check(key, (size_t)key_len, use_iv, st.check);
+        if (hmac_key) {
+            hmac_init(&st.hmac, hmac_key, hmac_key_len);
+            hmac_update(&st.hmac, use_iv, CTR_BLOCK_BYTES);   // MAC 대상: IV || CT
+        }
+
+        fout = fopen(out_path, "wb");
+        if (!fout) rc = -3;
+        else if (fwrite(use_iv, 1, CTR_BLOCK_BYTES, fout) != CTR_BLOCK_BYTES) rc = -6;
+    }
+
+    size_t buf_size = stream_effective_buf_size(opt, in_size);
+    buf_size = (buf_size + CTR_BLOCK_BYTES - 1) / CTR_BLOCK_BYTES * CTR_BLOCK_BYTES;
+    unsigned char* buf = NULL;
+    if (rc == 0) {
+        buf = (unsigned char*)malloc(buf_size);
+        if (!buf) rc = -5;
+    }
+
+    // 3) 암호화하며 checkpoint_interval마다 출력 동기화 → 상태 기록
+    uint64_t since_ckpt = 0;
+    while (rc == 0) {
+        size_t n = fread(buf, 1, buf_size, fin);
+        if (n == 0) {
+            if (ferror(fin)) rc = -7;
+            break;
+        }
+        ctr_mode_update(ctx, buf, buf, (int)n);
+        if (hmac_key) hmac_update(&st.hmac, buf, n);
+        if (fwrite(buf, 1, n, fout) != n) {
+            rc = -6;
+            break;
+        }
+        st.offset += n;
+        since_ckpt += n;
+
+        // 짧은 읽기는 EOF에서만 생기므로 체크포인트 오프셋은 블록 배수
+        int cancel = 0;
+        if (opt && opt->progress) opt->progress(opt->user, st.offset, st.in_size);
+        if (opt && opt->cancel && opt->cancel(opt->user)) cancel = 1;
+
+        if ((since_ckpt >= checkpoint_interval || cancel) && st.offset % CTR_BLOCK_BYTES == 0) {
+            st.counter = st.offset / CTR_BLOCK_BYTES;
+            if (stream_file_sync(fout) != 0) rc = -6;
+            else rc = state_write(&st, state_path);
+            since_ckpt = 0;
+        }
+        if (rc == 0 && cancel) rc = -16;
+    }
+
+    // 4) 태그를 붙이고 상태 파일 삭제
+    if (rc == 0 && hmac_key) {
+        unsigned char tag[SHA512_DIGEST_LENGTH];
+        hmac_final(&st.hmac, tag);
+        if (fwrite(tag, 1, sizeof(tag), fout) != sizeof(tag)) rc = -6;
+        memset(tag, 0, sizeof(tag));
+    }
+    if (fout && fclose(fout) != 0 && rc == 0) rc = -6;
+    if (rc == 0) remove(state_path);
+
+    if (buf) {
+        memset(buf, 0, buf_size);
+        free(buf);
+    }
+    memset(&st, 0, sizeof(st));
+    if (ctx) ctr_mode_free(ctx);
+    fclose(fin);
+    free(spath);
+    return rc;
+}
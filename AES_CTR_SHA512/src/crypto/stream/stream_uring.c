@@ -0,0 +1,358 @@
+﻿// syscall(), MAP_POPULATE 선언용
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "crypto/stream/stream_uring.h"
+
+#ifdef STREAM_HAVE_IO_URING
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+
+// -------------------------------------------------------------------
+// 최소한의 io_uring 래퍼 (liburing 없이 시스템 콜 직접 사용)
+// -------------------------------------------------------------------
+typedef struct uring_t {
+    int fd;
+    unsigned int sq_entries;
+    unsigned int cq_entries;
+    void* sq_ptr;
+    size_t sq_len;
+    void* cq_ptr;
+    size_t cq_len;
+    struct io_uring_sqe* sqes;
+    size_t sqes_len;
+    unsigned int* sq_head;
+    unsigned int* sq_tail;
+    unsigned int* sq_mask;
+    unsigned int* sq_array;
+    unsigned int* cq_head;
+    unsigned int* cq_tail;
+    unsigned int* cq_mask;
+    struct io_uring_cqe* cqes;
+    unsigned int pending;   // 제출 대기 중인 SQE 수
+} uring_t;
+
+static int uring_setup(uring_t* u, unsigned int entries)
+{
+    struct io_uring_params p;
+    memset(u, 0, sizeof(*u));
+    memset(&p, 0, sizeof(p));
+
+    int fd = (int)syscall(__NR_io_uring_setup, entries, &p);
+    if (fd < 0) return -1;
+    u->fd = fd;
+    u->sq_entries = p.sq_entries;
+    u->cq_entries = p.cq_entries;
+
+    u->sq_len = p.sq_off.array + p.sq_entries * sizeof(unsigned int);
+    u->cq_len = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        if (u->cq_len > u->sq_len) u->sq_len = u->cq_len;
+        u->cq_len = u->sq_len;
+    }
+
+    u->sq_ptr = mmap(NULL, u->sq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (u->sq_ptr == MAP_FAILED) {
+        close(fd);
+        return -1;
+    }
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        u->cq_ptr = u->sq_ptr;
+    }
+    else {
+        u->cq_ptr = mmap(NULL, u->cq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (u->cq_ptr == MAP_FAILED) {
+            munmap(u->sq_ptr, u->sq_len);
+            close(fd);
+            return -1;
+        }
+    }
+
+    u->sqes_len = p.sq_entries * sizeof(struct io_uring_sqe);
+    u->sqes = (struct io_uring_sqe*)mmap(NULL, u->sqes_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (u->sqes == MAP_FAILED) {
+        if (u->cq_ptr != u->sq_ptr) munmap(u->cq_ptr, u->cq_len);
+        munmap(u->sq_ptr, u->sq_len);
+        close(fd);
+        return -1;
+    }
+
+    unsigned char* sq = (unsigned char*)u->sq_ptr;
+    unsigned char* cq = (unsigned char*)u->cq_ptr;
+    u->sq_head = (unsigned int*)(sq + p.sq_off.head);
+    u->sq_tail = (unsigned int*)(sq + p.sq_off.tail);
+    u->sq_mask = (unsigned int*)(sq + p.sq_off.ring_mask);
+    u->sq_array = (unsigned int*)(sq + p.sq_off.array);
+    u->cq_head = (unsigned int*)(cq + p.cq_off.head);
+    u->cq_tail = (unsigned int*)(cq + p.cq_off.tail);
+    u->cq_mask = (unsigned int*)(cq + p.cq_off.ring_mask);
+    u->cqes = (struct io_uring_cqe*)(cq + p.cq_off.cqes);
+    return 0;
+}
+
+static void uring_close(uring_t* u)
+{
+    munmap(u->sqes, u->sqes_len);
+    if (u->cq_ptr != u->sq_ptr) munmap(u->cq_ptr, u->cq_len);
+    munmap(u->sq_ptr, u->sq_len);
+    close(u->fd);
+}
+
+// SQE 하나를 채워 제출 대기열에 넣는다 (실제 제출은 uring_submit_wait)
+static void uring_prep_rw(uring_t* u, int op, int file_index, void* addr,
+                          unsigned int len, uint64_t offset, uint16_t buf_index, uint64_t user_data)
+{
+    unsigned int tail = *u->sq_tail;
+    unsigned int idx = tail & *u->sq_mask;
+    struct io_uring_sqe* sqe = &u->sqes[idx];
+
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = (uint8_t)op;
+    sqe->flags = IOSQE_FIXED_FILE;
+    sqe->fd = file_index;
+    sqe->addr = (uint64_t)(uintptr_t)addr;
+    sqe->len = len;
+    sqe->off = offset;
+    sqe->buf_index = buf_index;
+    sqe->user_data = user_data;
+
+    u->sq_array[idx] = idx;
+    __atomic_store_n(u->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    u->pending++;
+}
+
+// 대기 중인 SQE를 한 번의 시스템 콜로 제출하고, wait가 1이면 완료 1개 이상을 기다린다
+static int uring_submit_wait(uring_t* u, int wait)
+{
+    unsigned int flags = wait ? IORING_ENTER_GETEVENTS : 0;
+    for (;;) {
+        long rc = syscall(__NR_io_uring_enter, u->fd, u->pending, wait ? 1u : 0u, flags, NULL, 0);
+        if (rc >= 0) {
+            u->pending -= (unsigned int)rc;
+            return 0;
+        }
+        if (errno != EINTR) return -1;
+    }
+}
+
+static int uring_pop_cqe(uring_t* u, uint64_t* user_data, int* res)
+{
+    unsigned int head = *u->cq_head;
+    if (head == __atomic_load_n(u->cq_tail, __ATOMIC_ACQUIRE)) return 0;
+
+    struct io_uring_cqe* cqe = &u->cqes[head & *u->cq_mask];
+    *user_data = cqe->user_data;
+    *res = cqe->res;
+    __atomic_store_n(u->cq_head, head + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+// -------------------------------------------------------------------
+// 파일 처리
+//  - 청크 k는 버퍼 k % depth를 사용. 청크 k - depth의 쓰기가 끝나야 버퍼가 빈다.
+//  - 읽기는 순서와 무관하게 완료되지만 fn은 청크 순서대로 호출 (해시 순서 유지)
+//  - 짧은 읽기/쓰기는 남은 부분을 다시 제출
+// -------------------------------------------------------------------
+enum { SLOT_FREE = 0, SLOT_READING, SLOT_READY, SLOT_WRITING };
+
+typedef struct uring_slot_t {
+    int state;
+    uint64_t chunk;
+    size_t len;     // 청크 길이
+    size_t done;    // 읽기/쓰기 완료 바이트
+} uring_slot_t;
+
+#define URING_UD(slot, is_write) (((uint64_t)(slot) << 1) | (uint64_t)(is_write))
+
+static void slot_submit(uring_t* u, uring_slot_t* s, unsigned int slot_index,
+                        unsigned char* base, size_t buf_size, int is_write)
+{
+    unsigned char* addr = base + (size_t)slot_index * buf_size + s->done;
+    uint64_t off = s->chunk * (uint64_t)buf_size + s->done;
+    uring_prep_rw(u, is_write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED,
+        is_write ? 1 : 0, addr, (unsigned int)(s->len - s->done), off,
+        (uint16_t)slot_index, URING_UD(slot_index, is_write));
+}
+
+int stream_uring_process_file(const char* in_path,
+                              const char* out_path,
+                              size_t buf_size,
+                              unsigned int depth,
+                              stream_pipeline_fn fn,
+                              void* arg)
+{
+    if (!in_path || !fn) return -1;
+    if (buf_size == 0) buf_size = STREAM_PIPELINE_DEFAULT_BUF_SIZE;
+    if (buf_size > (1u << 30)) return 1;
+    if (depth == 0) depth = STREAM_URING_DEFAULT_DEPTH;
+    if (depth > STREAM_URING_MAX_DEPTH) depth = STREAM_URING_MAX_DEPTH;
+
+    int fds[2] = { -1, -1 };
+    fds[0] = open(in_path, O_RDONLY);
+    if (fds[0] < 0) return -2;
+
+    struct stat st;
+    if (fstat(fds[0], &st) != 0 || !S_ISREG(st.st_mode) || (uint64_t)st.st_size <= buf_size) {
+        close(fds[0]);
+        return 1;
+    }
+    uint64_t size = (uint64_t)st.st_size;
+    uint64_t chunks = (size + buf_size - 1) / buf_size;
+    if (chunks < depth) depth = (unsigned int)chunks;
+
+    // SQ가 가득 차지 않도록 슬롯마다 요청 1개 + 여유
+    uring_t u;
+    if (uring_setup(&u, depth * 2) != 0) {
+        close(fds[0]);
+        return 1;
+    }
+
+    int rc = 0;
+    unsigned char* base = (unsigned char*)stream_aligned_alloc(buf_size * depth, STREAM_PIPELINE_DEFAULT_ALIGNMENT);
+    uring_slot_t* slots = (uring_slot_t*)calloc(depth, sizeof(uring_slot_t));
+    struct iovec* iov = (struct iovec*)calloc(depth, sizeof(struct iovec));
+    if (!base || !slots || !iov) rc = -3;
+
+    if (rc == 0 && out_path) {
+        fds[1] = open(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fds[1] < 0) rc = -3;
+    }
+
+    // 등록 실패(권한, RLIMIT_MEMLOCK 등)는 사용 불가로 보고 일반 경로에 맡긴다
+    if (rc == 0) {
+        for (unsigned int i = 0; i < depth; i++) {
+            iov[i].iov_base = base + (size_t)i * buf_size;
+            iov[i].iov_len = buf_size;
+        }
+        if (syscall(__NR_io_uring_register, u.fd, IORING_REGISTER_BUFFERS, iov, depth) != 0 ||
+            syscall(__NR_io_uring_register, u.fd, IORING_REGISTER_FILES, fds, out_path ? 2u : 1u) != 0) {
+            rc = 1;
+        }
+    }
+
+    uint64_t next_read = 0;     // 다음에 읽기를 제출할 청크
+    uint64_t next_proc = 0;     // 다음에 fn으로 처리할 청크
+    uint64_t completed = 0;     // 쓰기까지 끝난 청크 수
+    unsigned int inflight = 0;
+
+    while (rc == 0 && completed < chunks) {
+        // 1) 빈 슬롯마다 다음 청크 읽기 제출
+        while (next_read < chunks && slots[next_read % depth].state == SLOT_FREE) {
+            unsigned int si = (unsigned int)(next_read % depth);
+            uring_slot_t* s = &slots[si];
+            s->state = SLOT_READING;
+            s->chunk = next_read;
+            s->len = (next_read == chunks - 1) ? (size_t)(size - next_read * buf_size) : buf_size;
+            s->done = 0;
+            slot_submit(&u, s, si, base, buf_size, 0);
+            inflight++;
+            next_read++;
+        }
+
+        // 2) 순서대로 준비된 청크 처리 → 쓰기 제출 (출력이 없으면 바로 반환)
+        int progressed = 0;
+        while (next_proc < next_read && slots[next_proc % depth].state == SLOT_READY) {
+            unsigned int si = (unsigned int)(next_proc % depth);
+            uring_slot_t* s = &slots[si];
+            if (fn(arg, 0, base + (size_t)si * buf_size, s->len, s->chunk * (uint64_t)buf_size) != 0) {
+                rc = -7;
+                break;
+            }
+            next_proc++;
+            progressed = 1;
+            if (out_path) {
+                s->state = SLOT_WRITING;
+                s->done = 0;
+                slot_submit(&u, s, si, base, buf_size, 1);
+                inflight++;
+            }
+            else {
+                s->state = SLOT_FREE;
+                completed++;
+            }
+        }
+        if (rc != 0 || completed == chunks) break;
+        if (progressed && !out_path) continue;   // 빈 슬롯에 새 읽기부터 제출
+
+        // 3) 제출 + 완료 1개 이상 대기 (한 번의 시스템 콜)
+        if (uring_submit_wait(&u, inflight > 0) != 0) {
+            rc = -4;
+            break;
+        }
+
+        uint64_t ud;
+        int res;
+        while (uring_pop_cqe(&u, &ud, &res)) {
+            unsigned int si = (unsigned int)(ud >> 1);
+            int is_write = (int)(ud & 1);
+            uring_slot_t* s = &slots[si];
+            inflight--;
+
+            if (res <= 0) {
+                // 0바이트 읽기는 파일이 도중에 줄어든 경우
+                if (rc == 0) rc = is_write ? -6 : -4;
+                continue;
+            }
+            s->done += (size_t)res;
+            if (s->done < s->len) {
+                slot_submit(&u, s, si, base, buf_size, is_write);
+                inflight++;
+                continue;
+            }
+            if (is_write) {
+                s->state = SLOT_FREE;
+                completed++;
+            }
+            else {
+                s->state = SLOT_READY;
+            }
+        }
+    }
+
+    // 오류로 빠져나온 경우에도 걸려 있는 요청이 버퍼를 쓰지 않도록 모두 회수한 뒤 해제
+    while (inflight > 0 && rc != 1) {
+        if (uring_submit_wait(&u, 1) != 0) break;
+        uint64_t ud;
+        int res;
+        while (uring_pop_cqe(&u, &ud, &res)) inflight--;
+    }
+
+    uring_close(&u);
+    if (fds[1] >= 0 && close(fds[1]) != 0 && rc == 0) rc = -6;
+    close(fds[0]);
+    if (rc == 1 && out_path) unlink(out_path);
+    stream_aligned_free(base);
+    free(slots);
+    free(iov);
+    return rc;
+}
+
+#else
+
+int stream_uring_process_file(const char* in_path,
+                              const char* out_path,
+                              size_t buf_size,
+                              unsigned int depth,
+                              stream_pipeline_fn fn,
+                              void* arg)
+{
+    (void)in_path;
+    (void)out_path;
+    (void)buf_size;
+    (void)depth;
+    (void)fn;
+    (void)arg;
+    return 1;
+}
+
+#endif
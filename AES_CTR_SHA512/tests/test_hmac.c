@@ -5,6 +5,7 @@
 
 #include "crypto/hash/hmac.h"
 #include "crypto/hash/hash_sha512.h"
+#include "crypto/status.h"
 
 // 헥스 유틸 (디버그 출력용)
 static void dump_hex(const uint8_t* x, size_t n) {
@@ -188,6 +189,115 @@ static int run_one_vector(const hmac_vec_t* v)
     return 1;
 }
 
+// 미리 계산한 키 하나로 여러 메시지를 MAC해도 매번 hmac_init 한 결과와 같아야 한다.
+static int run_precomputed_key_test(void)
+{
+    int ok = 1;
+    for (size_t i = 0; i < sizeof(VECTORS) / sizeof(VECTORS[0]); i++) {
+        const hmac_vec_t* v = &VECTORS[i];
+        hmac_key_t k;
+        hmac_key_init(&k, v->key, v->key_len);
+
+        for (int round = 0; round < 2; round++) {
+            uint8_t mac[SHA512_DIGEST_LENGTH];
+            hmac_ctx c;
+            hmac_start_from_key(&c, &k);
+            hmac_update(&c, v->msg, v->msg_len);
+            hmac_final(&c, mac);
+
+            if (!bytes_eq(mac, v->tag, v->tag_len)) {
+                printf("[FAIL] %s : precomputed key round %d mismatch\n", v->name, round);
+                ok = 0;
+            }
+        }
+        hmac_key_clear(&k);
+    }
+
+    if (ok) printf("[OK] HMAC precomputed key reuse\n");
+    return ok;
+}
+
+// 중간 상태 내보내기/가져오기 후 이어 계산한 MAC이 한 번에 계산한 MAC과 같아야 한다.
+static int run_state_roundtrip_test(void)
+{
+    const hmac_vec_t* v = &VECTORS[1];
+    uint8_t state[HMAC_STATE_BYTES];
+    uint8_t mac[SHA512_DIGEST_LENGTH];
+    size_t split = v->msg_len / 2;
+
+    hmac_ctx a;
+    hmac_init(&a, v->key, v->key_len);
+    hmac_update(&a, v->msg, split);
+    if (hmac_export_state(&a, state) != 0) {
+        printf("[FAIL] HMAC state export\n");
+        return 0;
+    }
+
+    // 다른 키로는 복원되면 안 된다.
+    hmac_ctx b;
+    if (hmac_import_state(&b, HMAC_KEY1, sizeof(HMAC_KEY1), state) == 0) {
+        printf("[FAIL] HMAC state import accepted wrong key\n");
+        return 0;
+    }
+
+    // 이전 버전(1) 레이아웃으로 표시된 상태는 거부
+    state[7] = 1;
+    if (hmac_import_state(&b, v->key, v->key_len, state) == 0) {
+        printf("[FAIL] HMAC state import accepted old version\n");
+        return 0;
+    }
+    state[7] = HMAC_STATE_VERSION;
+
+    if (hmac_import_state(&b, v->key, v->key_len, state) != 0) {
+        printf("[FAIL] HMAC state import\n");
+        return 0;
+    }
+    hmac_update(&b, v->msg + split, v->msg_len - split);
+    hmac_final(&b, mac);
+
+    if (!bytes_eq(mac, v->tag, v->tag_len)) {
+        printf("[FAIL] HMAC state roundtrip mismatch\n");
+        printf(" expected: "); dump_hex(v->tag, v->tag_len);
+        printf(" got     : "); dump_hex(mac, v->tag_len);
+        return 0;
+    }
+
+    printf("[OK] HMAC state export/import\n");
+    return 1;
+}
+
+// 다중 메시지 일괄 HMAC: 레코드마다 단일 hmac_sha512 결과와 같아야 한다.
+static int run_batch_test(void)
+{
+    /* 패딩 경계(111/112/128)와 여러 블록 길이를 섞어 레인 교체까지 확인 */
+    static const size_t lens[] = { 0, 1, 111, 112, 127, 128, 129, 239, 240, 300, 1000, 64 };
+    enum { N = sizeof(lens) / sizeof(lens[0]) };
+    uint8_t data[1000];
+    const uint8_t* msgs[N];
+    uint8_t tags[N][SHA512_DIGEST_LENGTH];
+    int ok = 1;
+
+    for (size_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(i * 31 + 7);
+    for (size_t i = 0; i < N; i++) msgs[i] = data + (i % 5);
+
+    if (hmac_sha512_batch(HMAC_KEY2, sizeof(HMAC_KEY2), msgs, lens, tags, N) != CRYPTO_OK) {
+        printf("[FAIL] HMAC batch returned error\n");
+        return 0;
+    }
+
+    for (size_t i = 0; i < N; i++) {
+        uint8_t ref[SHA512_DIGEST_LENGTH];
+        hmac_sha512(HMAC_KEY2, sizeof(HMAC_KEY2), msgs[i], lens[i], ref);
+        if (!bytes_eq(ref, tags[i], sizeof(ref))) {
+            printf("[FAIL] HMAC batch record %zu (len=%zu) mismatch\n", i, lens[i]);
+            ok = 0;
+        }
+    }
+
+    if (ok) printf("[OK] HMAC batch (%d records)\n", (int)N);
+    return ok;
+}
+
 // 테스트 실행 엔트리
 int test_hmac_main(void)
 {
@@ -195,6 +305,9 @@ int test_hmac_main(void)
     for (size_t i = 0; i < sizeof(VECTORS) / sizeof(VECTORS[0]); i++) {
         if (!run_one_vector(&VECTORS[i])) ok = 0;
     }
+    if (!run_precomputed_key_test()) ok = 0;
+    if (!run_state_roundtrip_test()) ok = 0;
+    if (!run_batch_test()) ok = 0;
 
     if (ok) {
         printf("\n=== ALL HMAC-SHA512 TESTS PASSED ===\n");
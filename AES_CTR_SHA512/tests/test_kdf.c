@@ -0,0 +1,283 @@
+﻿#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "crypto/key/pbkdf2.h"
+#include "crypto/key/hkdf.h"
+#include "crypto/key/key_context.h"
+
+// 헥스 유틸
+static int hexval(char c) {
+    if ('0' <= c && c <= '9') return c - '0';
+    if ('a' <= c && c <= 'f') return c - 'a' + 10;
+    if ('A' <= c && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+static int hex_to_bytes(const char* hex, unsigned char* out, size_t outlen) {
+    size_t n = strlen(hex);
+    if (n != outlen * 2) return 0;
+    for (size_t i = 0; i < outlen; i++) {
+        int hi = hexval(hex[2 * i]);
+        int lo = hexval(hex[2 * i + 1]);
+        if (hi < 0 || lo < 0) return 0;
+        out[i] = (unsigned char)((hi << 4) | lo);
+    }
+    return 1;
+}
+static void dump_hex(const unsigned char* x, size_t n) {
+    for (size_t i = 0; i < n; i++) printf("%02X", x[i]);
+    printf("\n");
+}
+static int bytes_eq(const unsigned char* a, const unsigned char* b, size_t n) {
+    return memcmp(a, b, n) == 0;
+}
+
+// PBKDF2-HMAC-SHA512 테스트 벡터
+typedef struct pbkdf2_vec_t {
+    const char* name;
+    const char* pass;
+    const char* salt;
+    uint32_t iterations;
+    size_t dk_len;
+    const char* dk_hex;
+} pbkdf2_vec_t;
+
+static const pbkdf2_vec_t PBKDF2_VECTORS[] = {
+    {
+        "PBKDF2-HMAC-SHA512 c=1",
+        "password", "salt", 1, 64,
+        "867f70cf1ade02cff3752599a3a53dc4af34c7a669815ae5d513554e1c8cf252"
+        "c02d470a285a0501bad999bfe943c08f050235d7d68b1da55e63f73b60a57fce"
+    },
+    {
+        "PBKDF2-HMAC-SHA512 c=2",
+        "password", "salt", 2, 64,
+        "e1d9c16aa681708a45f5c7c4e215ceb66e011a2e9f0040713f18aefdb866d53c"
+        "f76cab2868a39b9f7840edce4fef5a82be67335c77a6068e04112754f27ccf4e"
+    },
+    {
+        "PBKDF2-HMAC-SHA512 c=4096",
+        "password", "salt", 4096, 64,
+        "d197b1b33db0143e018b12f3d1d1479e6cdebdcc97c5c0f87f6902e072f457b5"
+        "143f30602641b3d55cd335988cb36b84376060ecd532e039b742a239434af2d5"
+    },
+    {
+        "PBKDF2-HMAC-SHA512 long pass/salt c=4096",
+        "passwordPASSWORDpassword", "saltSALTsaltSALTsaltSALTsaltSALTsalt", 4096, 64,
+        "8c0511f4c6e597c6ac6315d8f0362e225f3c501495ba23b868c005174dc4ee71"
+        "115b59f9e60cd9532fa33e0f75aefe30225c583a186cd82bd4daea9724a3d3b8"
+    },
+    {
+        "PBKDF2-HMAC-SHA512 multi-block dkLen=200",
+        "passwordPASSWORDpassword", "saltSALTsaltSALTsaltSALTsaltSALTsalt", 1000, 200,
+        "0e28f3efa802a2f0cd3b4ace5e3d9afadb7c2dccc5ef10eedb8a6564dfb0c9a6"
+        "3b6f46b1e150587b9fe7875cfaf999d00b454bb7d74295c60df1bbe5f8f36da1"
+        "88271db22110efda5cc9eeafb0ab29697849379903421d54eee3949344c72873"
+        "d6ce97426aca4e4db45259986bdee584b565a1abecfff13b31f0e4304df85d69"
+        "7effa5a7f594fb0e8b98a86b123ec8ad3b165ff28a00381e6570af2091537fc6"
+        "713eb64d918d75b58e1459eefd133aeefdc3b9f2dd8010a601fdae22ecd1a48c"
+        "553755d491aa5364"
+    }
+};
+
+static int run_pbkdf2_vector(const pbkdf2_vec_t* v, unsigned int threads)
+{
+    unsigned char expect[256];
+    unsigned char dk[256];
+
+    if (v->dk_len > sizeof(dk) || !hex_to_bytes(v->dk_hex, expect, v->dk_len)) {
+        printf("[FAIL] %s : expected hex parse failed\n", v->name);
+        return 0;
+    }
+
+    int rc = pbkdf2_hmac_sha512_ex((const uint8_t*)v->pass, strlen(v->pass),
+        (const uint8_t*)v->salt, strlen(v->salt),
+        v->iterations, dk, v->dk_len, threads);
+
+    if (rc != 0 || !bytes_eq(dk, expect, v->dk_len)) {
+        printf("[FAIL] %s (threads=%u) : rc=%d\n", v->name, threads, rc);
+        printf(" expected: "); dump_hex(expect, v->dk_len);
+        printf(" got     : "); dump_hex(dk, v->dk_len);
+        return 0;
+    }
+
+    printf("[OK] %s (threads=%u)\n", v->name, threads);
+    return 1;
+}
+
+// HKDF-SHA512 테스트 벡터 (RFC 5869 입력 형식, SHA-512 기준 기대값)
+typedef struct hkdf_vec_t {
+    const char* name;
+    const char* ikm_hex;
+    const char* salt_hex;
+    const char* info_hex;
+    const char* prk_hex;
+    const char* okm_hex;
+} hkdf_vec_t;
+
+static const hkdf_vec_t HKDF_VECTORS[] = {
+    {
+        "HKDF-SHA512 basic",
+        "0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b",
+        "000102030405060708090a0b0c",
+        "f0f1f2f3f4f5f6f7f8f9",
+        "665799823737ded04a88e47e54a5890bb2c3d247c7a4254a8e61350723590a26"
+        "c36238127d8661b88cf80ef802d57e2f7cebcf1e00e083848be19929c61b4237",
+        "832390086cda71fb47625bb5ceb168e4c8e26a1a16ed34d9fc7fe92c14815793"
+        "38da362cb8d9f925d7cb"
+    },
+    {
+        "HKDF-SHA512 long inputs",
+        "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+        "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+        "404142434445464748494a4b4c4d4e4f",
+        "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+        "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+        "a0a1a2a3a4a5a6a7a8a9aaabacadaeaf",
+        "b0b1b2b3b4b5b6b7b8b9babbbcbdbebfc0c1c2c3c4c5c6c7c8c9cacbcccdcecf"
+        "d0d1d2d3d4d5d6d7d8d9dadbdcdddedfe0e1e2e3e4e5e6e7e8e9eaebecedeeef"
+        "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff",
+        "35672542907d4e142c00e84499e74e1de08be86535f924e022804ad775dde27e"
+        "c86cd1e5b7d178c74489bdbeb30712beb82d4f97416c5a94ea81ebdf3e629e4a",
+        "ce6c97192805b346e6161e821ed165673b84f400a2b514b2fe23d84cd189ddf1"
+        "b695b48cbd1c8388441137b3ce28f16aa64ba33ba466b24df6cfcb021ecff235"
+        "f6a2056ce3af1de44d572097a8505d9e7a93"
+    },
+    {
+        "HKDF-SHA512 empty salt/info",
+        "0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b",
+        "",
+        "",
+        "fd200c4987ac491313bd4a2a13287121247239e11c9ef82802044b66ef357e5b"
+        "194498d0682611382348572a7b1611de54764094286320578a863f36562b0df6",
+        "f5fa02b18298a72a8c23898a8703472c6eb179dc204c03425c970e3b164bf90f"
+        "ff22d04836d0e2343bac"
+    }
+};
+
+static int run_hkdf_vector(const hkdf_vec_t* v)
+{
+    unsigned char ikm[128], salt[128], info[128];
+    unsigned char prk_exp[HKDF_SHA512_PRK_BYTES], okm_exp[128];
+    unsigned char prk[HKDF_SHA512_PRK_BYTES], okm[128];
+    size_t ikm_len = strlen(v->ikm_hex) / 2;
+    size_t salt_len = strlen(v->salt_hex) / 2;
+    size_t info_len = strlen(v->info_hex) / 2;
+    size_t okm_len = strlen(v->okm_hex) / 2;
+
+    if (!hex_to_bytes(v->ikm_hex, ikm, ikm_len) ||
+        !hex_to_bytes(v->salt_hex, salt, salt_len) ||
+        !hex_to_bytes(v->info_hex, info, info_len) ||
+        !hex_to_bytes(v->prk_hex, prk_exp, sizeof(prk_exp)) ||
+        !hex_to_bytes(v->okm_hex, okm_exp, okm_len)) {
+        printf("[FAIL] %s : hex parse failed\n", v->name);
+        return 0;
+    }
+
+    if (hkdf_sha512_extract(salt, salt_len, ikm, ikm_len, prk) != 0 ||
+        !bytes_eq(prk, prk_exp, sizeof(prk))) {
+        printf("[FAIL] %s : PRK mismatch\n", v->name);
+        printf(" expected: "); dump_hex(prk_exp, sizeof(prk_exp));
+        printf(" got     : "); dump_hex(prk, sizeof(prk));
+        return 0;
+    }
+
+    if (hkdf_sha512(salt, salt_len, ikm, ikm_len, info, info_len, okm, okm_len) != 0 ||
+        !bytes_eq(okm, okm_exp, okm_len)) {
+        printf("[FAIL] %s : OKM mismatch\n", v->name);
+        printf(" expected: "); dump_hex(okm_exp, okm_len);
+        printf(" got     : "); dump_hex(okm, okm_len);
+        return 0;
+    }
+
+    printf("[OK] %s\n", v->name);
+    return 1;
+}
+
+// 파일별 키 파생: 같은 file_id는 같은 키, 다른 file_id는 다른 키
+// file_id는 암호화마다 고유한 값 (여기서는 출력 헤더에 저장될 파일 번호 || 버전 번호).
+// 같은 파일을 다시 암호화하면 버전이 바뀌므로 키/IV도 바뀌어야 한다.
+static int run_file_key_test(void)
+{
+    key_context_t kc;
+    key_file_keys_t a, b, c;
+    const unsigned char seed[] = "file key derivation";
+    unsigned char id_v1[12] = { 0, 0, 0, 0, 0, 0, 0, 7, 0, 0, 0, 1 };   // 파일 7, 버전 1
+    unsigned char id_v2[12] = { 0, 0, 0, 0, 0, 0, 0, 7, 0, 0, 0, 2 };   // 파일 7, 다시 암호화
+
+    key_context_init_seed(&kc, seed, (unsigned int)(sizeof(seed) - 1));
+    int rc = key_context_derive_file(&kc, id_v1, sizeof(id_v1), 32, &a);
+    rc |= key_context_derive_file(&kc, id_v1, sizeof(id_v1), 32, &b);    // 복호화: 헤더의 id로 다시 파생
+    rc |= key_context_derive_file(&kc, id_v2, sizeof(id_v2), 32, &c);
+    key_context_clear(&kc);
+
+    if (rc != 0 ||
+        !bytes_eq(a.aes_key, b.aes_key, 32) || !bytes_eq(a.hmac_key, b.hmac_key, sizeof(a.hmac_key)) ||
+        !bytes_eq(a.iv, b.iv, sizeof(a.iv)) ||
+        bytes_eq(a.aes_key, c.aes_key, 32) || bytes_eq(a.iv, c.iv, sizeof(a.iv))) {
+        printf("[FAIL] key_context_derive_file\n");
+        return 0;
+    }
+
+    printf("[OK] key_context_derive_file\n");
+    return 1;
+}
+
+// enc_key 파생 버전: V1은 master_key 접두어(이전 빌드와 동일), 기본값은 V2(HKDF)
+static int run_derive_version_test(void)
+{
+    key_context_t kc;
+    unsigned char v2[32];
+    const unsigned char seed[] = "derive version";
+    int ok = 1;
+
+    key_context_init_seed(&kc, seed, (unsigned int)(sizeof(seed) - 1));
+
+    key_context_derive(&kc, 32);
+    memcpy(v2, kc.enc_key, sizeof(v2));
+    if (key_context_derive_ex(&kc, 32, KC_DERIVE_V2) != 0 || !bytes_eq(kc.enc_key, v2, 32)) ok = 0;
+
+    if (key_context_derive_ex(&kc, 16, KC_DERIVE_V1) != 0 ||
+        kc.enc_key_len != 16 || !bytes_eq(kc.enc_key, kc.master_key, 16)) ok = 0;
+    if (bytes_eq(v2, kc.master_key, 16)) ok = 0;
+    if (key_context_derive_ex(&kc, 32, 3) == 0) ok = 0;
+
+    key_context_clear(&kc);
+
+    printf("[%s] key_context_derive V1/V2\n", ok ? "OK" : "FAIL");
+    return ok;
+}
+
+// 테스트 실행 엔트리
+int test_kdf_main(void)
+{
+    int ok = 1;
+
+    for (size_t i = 0; i < sizeof(PBKDF2_VECTORS) / sizeof(PBKDF2_VECTORS[0]); i++) {
+        if (!run_pbkdf2_vector(&PBKDF2_VECTORS[i], 1)) ok = 0;
+    }
+    // 다중 블록 벡터는 스레드 분할 결과도 같아야 한다.
+    if (!run_pbkdf2_vector(&PBKDF2_VECTORS[4], 3)) ok = 0;
+
+    for (size_t i = 0; i < sizeof(HKDF_VECTORS) / sizeof(HKDF_VECTORS[0]); i++) {
+        if (!run_hkdf_vector(&HKDF_VECTORS[i])) ok = 0;
+    }
+    if (!run_file_key_test()) ok = 0;
+    if (!run_derive_version_test()) ok = 0;
+
+    unsigned char dk[64];
+    if (pbkdf2_hmac_sha512((const uint8_t*)"p", 1, (const uint8_t*)"s", 1, 0, dk, sizeof(dk)) == 0) {
+        printf("[FAIL] PBKDF2 NEG zero iterations accepted\n");
+        ok = 0;
+    }
+
+    if (ok) {
+        printf("\n=== ALL KDF TESTS PASSED ===\n");
+        return 0;
+    }
+    else {
+        printf("\n=== KDF TESTS FAILED ===\n");
+        return 1;
+    }
+}
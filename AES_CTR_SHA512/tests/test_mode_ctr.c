@@ -162,6 +162,77 @@ static int run_negative_tests(void)
     return 1;
 }
 
+// ctr_mode_seek: 블록 2부터 시작해도 연속 처리 결과의 뒷부분과 같아야 함
+static int run_seek_test(const ctr_vec_t* v)
+{
+    unsigned char key[32], iv[16], pt[64], ct_exp[64], out[32];
+
+    if (!hex_to_bytes(v->key_hex, key, v->key_len)) return 0;
+    if (!hex_to_bytes(v->iv_hex, iv, 16)) return 0;
+    if (!hex_to_bytes(v->pt_hex, pt, 64)) return 0;
+    if (!hex_to_bytes(v->ct_hex, ct_exp, 64)) return 0;
+
+    ctr_mode_ctx_t* ctx = ctr_mode_init(&AES_TTABLE_ENGINE, key, v->key_len, iv);
+    if (!ctx) { printf("[FAIL] %s seek: init NULL\n", v->name); return 0; }
+    ctr_mode_seek(ctx, iv, 2);
+    ctr_mode_update(ctx, pt + 32, out, 32);
+    ctr_mode_free(ctx);
+
+    if (!bytes_eq(out, ct_exp + 32, 32)) {
+        printf("[FAIL] %s seek: ciphertext mismatch\n", v->name);
+        return 0;
+    }
+
+    // 카운터 자리올림: 하위 64비트가 모두 FF인 IV에서 1블록 이동
+    unsigned char iv_ff[16], expect[16];
+    memset(iv_ff, 0xFF, sizeof(iv_ff));
+    iv_ff[0] = 0x01;
+    memset(expect, 0, sizeof(expect));
+    expect[0] = 0x02;
+    ctx = ctr_mode_init(&AES_TTABLE_ENGINE, key, v->key_len, iv);
+    if (!ctx) return 0;
+    ctr_mode_seek(ctx, iv_ff, 1);
+    int carry_ok = bytes_eq(ctx->counter, expect, 16);
+    ctr_mode_free(ctx);
+    if (!carry_ok) {
+        printf("[FAIL] %s seek: carry mismatch\n", v->name);
+        return 0;
+    }
+
+    printf("[OK] %s seek\n", v->name);
+    return 1;
+}
+
+// 블록 경계와 맞지 않는 길이로 나눠 호출해도 한 번에 처리한 결과와 같아야 함
+static int run_split_update_test(const ctr_vec_t* v)
+{
+    unsigned char key[32], iv[16], pt[64], ct_exp[64], out[64];
+    static const int parts[] = { 1, 15, 3, 17, 5, 23 };   // 합계 64
+
+    if (!hex_to_bytes(v->key_hex, key, v->key_len)) return 0;
+    if (!hex_to_bytes(v->iv_hex, iv, 16)) return 0;
+    if (!hex_to_bytes(v->pt_hex, pt, 64)) return 0;
+    if (!hex_to_bytes(v->ct_hex, ct_exp, 64)) return 0;
+
+    ctr_mode_ctx_t* ctx = ctr_mode_init(&AES_TTABLE_ENGINE, key, v->key_len, iv);
+    if (!ctx) { printf("[FAIL] %s split: init NULL\n", v->name); return 0; }
+    int off = 0;
+    for (size_t i = 0; i < sizeof(parts) / sizeof(parts[0]); i++) {
+        ctr_mode_update(ctx, pt + off, out + off, parts[i]);
+        off += parts[i];
+    }
+    ctr_mode_free(ctx);
+
+    if (off != 64 || !bytes_eq(out, ct_exp, 64)) {
+        printf("[FAIL] %s split: ciphertext mismatch\n", v->name);
+        dump_hex(out, 64);
+        return 0;
+    }
+
+    printf("[OK] %s split update\n", v->name);
+    return 1;
+}
+
 // 더 이상 main이 아님. 테스트용 함수.
 int test_mode_ctr_main(void)
 {
@@ -175,6 +246,8 @@ int test_mode_ctr_main(void)
         }
     }
 
+    if (!run_seek_test(&VECTORS[0])) ok = 0;
+    if (!run_split_update_test(&VECTORS[0])) ok = 0;
     if (!run_negative_tests()) ok = 0;
 
     if (ok) {
@@ -4,6 +4,8 @@
 #include <stdlib.h>
 
 #include "crypto/hash/hash_sha512.h"
+#include "crypto/hash/hmac.h"
+#include "crypto/stream/stream_api.h"
 
 // 헥스 유틸
 static int hexval(char c) {
@@ -142,6 +144,140 @@ static int run_million_a_test(void)
     return 1;
 }
 
+// 중간 상태를 내보낸 뒤 새 컨텍스트로 가져와 이어 계산해도 같은 다이제스트가 나와야 한다.
+static int run_state_roundtrip_test(void)
+{
+    const unsigned char* msg = MSG2;
+    size_t msg_len = sizeof(MSG2) - 1;
+    unsigned char expect[64];
+    unsigned char digest[64];
+    unsigned char state[SHA512_STATE_BYTES];
+
+    if (!hex_to_bytes(VECTORS[2].digest_hex, expect, 64)) return 0;
+
+    sha512_ctx_t a;
+    sha512_init(&a);
+    sha512_update(&a, msg, 37);
+    if (sha512_export_state(&a, state) != 0) {
+        printf("[FAIL] SHA-512 state export\n");
+        return 0;
+    }
+
+    sha512_ctx_t b;
+    if (sha512_import_state(&b, state) != 0 || sha512_bytes_processed(&b) != 37) {
+        printf("[FAIL] SHA-512 state import\n");
+        return 0;
+    }
+    sha512_update(&b, msg + 37, msg_len - 37);
+    sha512_final(&b, digest);
+
+    if (!bytes_eq(digest, expect, 64)) {
+        printf("[FAIL] SHA-512 state roundtrip mismatch\n");
+        printf(" expected: "); dump_hex(expect, 64);
+        printf(" got     : "); dump_hex(digest, 64);
+        return 0;
+    }
+
+    // 손상된 상태(버퍼 길이 불일치)는 거부되어야 한다.
+    state[4 + 4 + 8 + 64 + 3] ^= 0x01;
+    if (sha512_import_state(&b, state) == 0) {
+        printf("[FAIL] SHA-512 corrupted state accepted\n");
+        return 0;
+    }
+
+    printf("[OK] SHA-512 state export/import\n");
+    return 1;
+}
+
+// 재개형 파일 해시 (stream_api): 사이드카 체크포인트에서 이어 계산해도 한 번에 계산한 값과 같아야 한다.
+#define RESUME_IN   "test_sha512_resume.bin"
+#define RESUME_CKPT "test_sha512_resume.bin.hckp"
+
+static const unsigned char RESUME_KEY[32] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
+};
+
+static int resume_write(const unsigned char* data, size_t len, const char* mode)
+{
+    FILE* f = fopen(RESUME_IN, mode);
+    if (!f) return 0;
+    int ok = fwrite(data, 1, len, f) == len;
+    return fclose(f) == 0 && ok;
+}
+
+// kind 0 = SHA-512, 1 = HMAC
+static int resume_hash(int kind, unsigned char out[64])
+{
+    return kind ? stream_hmac_sha512_file_resumable(RESUME_IN, RESUME_KEY, sizeof(RESUME_KEY), RESUME_CKPT, 4096, out)
+        : stream_hash_sha512_file_resumable(RESUME_IN, RESUME_CKPT, 4096, out);
+}
+
+static void resume_reference(int kind, const unsigned char* data, size_t len, unsigned char out[64])
+{
+    if (kind) {
+        hmac_sha512(RESUME_KEY, sizeof(RESUME_KEY), data, len, out);
+        return;
+    }
+    sha512_ctx_t c;
+    sha512_init(&c);
+    sha512_update(&c, data, len);
+    sha512_final(&c, out);
+}
+
+static int run_resumable_file_test(void)
+{
+    static const char* names[] = { "SHA-512", "HMAC" };
+    const size_t len = 5 * 4096 + 123;
+    const size_t tail = 5000;
+    unsigned char* data = (unsigned char*)malloc(len + tail);
+    if (!data) return 0;
+    for (size_t i = 0; i < len + tail; i++) data[i] = (unsigned char)(i * 31 + 7);
+
+    int ok = 1;
+    for (int kind = 0; ok && kind < 2; kind++) {
+        unsigned char expect[64], got[64];
+        remove(RESUME_CKPT);
+
+        // 1) 처음부터: 한 번에 계산한 값과 같아야 한다.
+        resume_reference(kind, data, len, expect);
+        ok = resume_write(data, len, "wb") && resume_hash(kind, got) == 0 && bytes_eq(got, expect, 64);
+
+        // 2) 앞부분을 바꾸고 꼬리를 덧붙여도 결과가 (원래 내용 || 꼬리)이면
+        //    처음부터 다시 읽지 않고 체크포인트에서 이어 간 것
+        if (ok) {
+            data[0] ^= 0xff;
+            ok = resume_write(data, len, "wb") && resume_write(data + len, tail, "ab");
+            data[0] ^= 0xff;
+        }
+        resume_reference(kind, data, len + tail, expect);
+        ok = ok && resume_hash(kind, got) == 0 && bytes_eq(got, expect, 64);
+
+        // 3) 파일이 체크포인트보다 짧아지면 처음부터 다시 계산한다.
+        resume_reference(kind, data, len, expect);
+        ok = ok && resume_write(data, len, "wb") && resume_hash(kind, got) == 0 && bytes_eq(got, expect, 64);
+
+        // 4) 빈 입력: 오프셋 0 상태(HMAC이면 K ^ ipad 압축값)는 남기지 않고 이전 사이드카도 지운다.
+        resume_reference(kind, data, 0, expect);
+        ok = ok && resume_write(data, 0, "wb") && resume_hash(kind, got) == 0 && bytes_eq(got, expect, 64);
+        if (ok) {
+            FILE* f = fopen(RESUME_CKPT, "rb");
+            if (f) {
+                fclose(f);
+                ok = 0;
+            }
+        }
+
+        if (!ok) printf("[FAIL] %s resumable file hash\n", names[kind]);
+    }
+
+    remove(RESUME_IN);
+    remove(RESUME_CKPT);
+    free(data);
+    if (ok) printf("[OK] SHA-512 / HMAC resumable file hash\n");
+    return ok;
+}
+
 // 더 이상 main이 아님. 테스트용 함수.
 int test_sha512_main(void)
 {
@@ -151,6 +287,8 @@ int test_sha512_main(void)
         if (!run_one_vector(&VECTORS[i])) ok = 0;
     }
     if (!run_million_a_test()) ok = 0;
+    if (!run_state_roundtrip_test()) ok = 0;
+    if (!run_resumable_file_test()) ok = 0;
 
     if (ok) {
         printf("\n=== ALL SHA-512 TESTS PASSED ===\n");
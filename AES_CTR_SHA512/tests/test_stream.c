@@ -0,0 +1,1802 @@
+﻿#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#ifdef _WIN32
+#include <sys/utime.h>
+#else
+#include <utime.h>
+#endif
+
+#include "crypto/stream/stream_api.h"
+#include "crypto/stream/crypto_stream.h"
+#include "crypto/stream/stream_inplace.h"
+#include "crypto/stream/stream_resume.h"
+#include "crypto/stream/stream_chunked.h"
+#include "crypto/stream/stream_batch.h"
+#include "crypto/stream/stream_archive.h"
+#include "crypto/stream/stream_lz.h"
+#include "crypto/stream/stream_dedup.h"
+#include "crypto/stream/stream_index.h"
+#include "crypto/bytes.h"
+#include "crypto/status.h"
+#include "crypto/cipher/aes_engine_ttable.h"
+
+// 테스트용 임시 파일 (현재 작업 디렉터리에 만들고 끝나면 지운다)
+#define TS_IN   "test_stream_in.bin"
+#define TS_OUT  "test_stream_out.bin"
+#define TS_DEC  "test_stream_dec.bin"
+#define TS_JNL  "test_stream_in.bin" STREAM_INPLACE_JOURNAL_SUFFIX
+#define TS_ECKP "test_stream_out.bin" STREAM_RESUME_STATE_SUFFIX
+
+static const unsigned char TS_KEY[32] = {
+    0x60,0x3d,0xeb,0x10,0x15,0xca,0x71,0xbe,0x2b,0x73,0xae,0xf0,0x85,0x7d,0x77,0x81,
+    0x1f,0x35,0x2c,0x07,0x3b,0x61,0x08,0xd7,0x2d,0x98,0x10,0xa3,0x09,0x14,0xdf,0xf4
+};
+static const unsigned char TS_IV[16] = {
+    0xf0,0xf1,0xf2,0xf3,0xf4,0xf5,0xf6,0xf7,0xf8,0xf9,0xfa,0xfb,0xfc,0xfd,0xfe,0xff
+};
+
+static int write_file(const char* path, const unsigned char* data, size_t len) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return 0;
+    int ok = (len == 0 || fwrite(data, 1, len, f) == len);
+    return (fclose(f) == 0) && ok;
+}
+
+// 파일 전체를 읽는다 (호출 측이 free). 실패 시 NULL
+static unsigned char* read_file(const char* path, size_t* len) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    rewind(f);
+    unsigned char* buf = (unsigned char*)malloc((size_t)n + 1);
+    if (buf && fread(buf, 1, (size_t)n, f) != (size_t)n) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+    *len = (size_t)n;
+    return buf;
+}
+
+static unsigned char* make_pattern(size_t len) {
+    unsigned char* p = (unsigned char*)malloc(len + 1);
+    if (!p) return NULL;
+    uint32_t x = 0x12345678u;
+    for (size_t i = 0; i < len; i++) {
+        x = x * 1103515245u + 12345u;
+        p[i] = (unsigned char)(x >> 24);
+    }
+    return p;
+}
+
+// 파일 내용이 기대값과 같은지
+static int file_equals(const char* path, const unsigned char* exp, size_t len) {
+    size_t n = 0;
+    unsigned char* got = read_file(path, &n);
+    int ok = got && n == len && (len == 0 || memcmp(got, exp, len) == 0);
+    free(got);
+    return ok;
+}
+
+// 한 번의 ctr_mode_update로 만든 기준 암호문
+static unsigned char* reference_ctr(const unsigned char* pt, size_t len) {
+    unsigned char* ct = (unsigned char*)malloc(len + 1);
+    if (!ct) return NULL;
+    ctr_mode_ctx_t* ctx = ctr_mode_init(&AES_TTABLE_ENGINE, TS_KEY, 32, TS_IV);
+    if (!ctx) { free(ct); return NULL; }
+    ctr_mode_update(ctx, pt, ct, (int)len);
+    ctr_mode_free(ctx);
+    return ct;
+}
+
+// 옵션 하나로 암호화 → 기준 비교 → 복호화 → 원문 비교, 해시/HMAC는 기본 경로 결과와 비교
+static int run_options_case(const stream_options_t* popt, const char* mode_name, size_t len)
+{
+    const stream_options_t opt = *popt;
+    unsigned char* pt = make_pattern(len);
+    unsigned char* ct = pt ? reference_ctr(pt, len) : NULL;
+    int ok = pt && ct && write_file(TS_IN, pt, len);
+
+    if (ok && stream_encrypt_ctr_file_ex(&AES_TTABLE_ENGINE, TS_IN, TS_OUT, TS_KEY, 32, TS_IV, &opt) != 0) ok = 0;
+    if (ok && !file_equals(TS_OUT, ct, len)) ok = 0;
+    if (ok && stream_decrypt_ctr_file_ex(&AES_TTABLE_ENGINE, TS_OUT, TS_DEC, TS_KEY, 32, TS_IV, &opt) != 0) ok = 0;
+    if (ok && !file_equals(TS_DEC, pt, len)) ok = 0;
+
+    if (ok) {
+        unsigned char d_ref[64], d_got[64], m_ref[64], m_got[64];
+        ok = stream_hash_sha512_file(TS_IN, d_ref) == 0 &&
+            stream_hash_sha512_file_ex(TS_IN, d_got, &opt) == 0 &&
+            memcmp(d_ref, d_got, 64) == 0 &&
+            stream_hmac_sha512_file(TS_IN, TS_KEY, 32, m_ref) == 0 &&
+            stream_hmac_sha512_file_ex(TS_IN, TS_KEY, 32, m_got, &opt) == 0 &&
+            memcmp(m_ref, m_got, 64) == 0;
+    }
+
+    remove(TS_IN);
+    remove(TS_OUT);
+    remove(TS_DEC);
+    free(pt);
+    free(ct);
+
+    if (ok) printf("[OK] stream %s len=%zu\n", mode_name, len);
+    else printf("[FAIL] stream %s len=%zu\n", mode_name, len);
+    return ok;
+}
+
+static int run_mode_case(int io_mode, const char* mode_name, size_t len)
+{
+    stream_options_t opt;
+    stream_options_init(&opt);
+    opt.io_mode = io_mode;
+    opt.threads = 3;       // 파이프라인: 연산 스레드 여러 개가 순서를 지키는지 확인
+    opt.queue_depth = 3;   // io_uring: 청크(6개)보다 적은 슬롯을 돌려 쓰는지 확인
+    return run_options_case(&opt, mode_name, len);
+}
+
+static int run_io_mode_tests(void)
+{
+    // 빈 파일, 블록 미만, 정확히 버퍼 2개, 버퍼(1MB) 경계를 넘는 비정렬 길이
+    static const size_t lens[] = { 0, 37, 2u << 20, (5u << 20) + 37 };
+    int ok = 1;
+    for (size_t i = 0; i < sizeof(lens) / sizeof(lens[0]); i++) {
+        if (!run_mode_case(STREAM_IO_STDIO, "stdio", lens[i])) ok = 0;
+        if (!run_mode_case(STREAM_IO_MMAP, "mmap", lens[i])) ok = 0;
+        if (!run_mode_case(STREAM_IO_PIPELINE, "pipeline", lens[i])) ok = 0;
+        if (!run_mode_case(STREAM_IO_URING, "uring", lens[i])) ok = 0;
+        if (!run_mode_case(STREAM_IO_DIRECT, "direct", lens[i])) ok = 0;
+    }
+    return ok;
+}
+
+// 버퍼 옵션: 16의 배수가 아닌 크기(올림), 적은 버퍼 개수, 적응 모드
+static int run_buffer_option_tests(void)
+{
+    const size_t len = (3u << 20) + 37;
+    static const int modes[] = { STREAM_IO_STDIO, STREAM_IO_PIPELINE, STREAM_IO_URING, STREAM_IO_DIRECT };
+    static const char* names[] = { "stdio buf=5000", "pipeline buf=5000", "uring buf=5000", "direct buf=5000" };
+    int ok = 1;
+
+    for (int i = 0; i < 4; i++) {
+        stream_options_t opt;
+        stream_options_init(&opt);
+        opt.io_mode = modes[i];
+        opt.buf_size = 5000;
+        opt.buf_count = 2;
+        opt.threads = 2;
+        if (!run_options_case(&opt, names[i], len)) ok = 0;
+    }
+
+    stream_options_t opt;
+    stream_options_init(&opt);
+    opt.adaptive = 1;
+    if (!run_options_case(&opt, "stdio adaptive", len)) ok = 0;
+    if (!run_options_case(&opt, "stdio adaptive", 100)) ok = 0;
+
+    // 작은 파일은 파일 크기까지만 버퍼를 잡는다
+    if (stream_effective_buf_size(NULL, 100) != 112 ||
+        stream_effective_buf_size(NULL, -1) != STREAM_DEFAULT_BUF_SIZE ||
+        stream_effective_buf_size(&opt, -1) != STREAM_ADAPTIVE_MIN_BUF) {
+        printf("[FAIL] stream effective buffer size\n");
+        ok = 0;
+    }
+    return ok;
+}
+
+// 메모리 소스/싱크 (pump 콜백 테스트용)
+typedef struct mem_io_t {
+    unsigned char* data;
+    size_t len;
+    size_t pos;
+    size_t max_read;    // 한 번에 돌려줄 최대 길이 (짧은 읽기 흉내)
+} mem_io_t;
+
+static long long mem_read(void* ctx, unsigned char* buf, size_t cap)
+{
+    mem_io_t* m = (mem_io_t*)ctx;
+    size_t n = m->len - m->pos;
+    if (n > cap) n = cap;
+    if (n > m->max_read) n = m->max_read;
+    memcpy(buf, m->data + m->pos, n);
+    m->pos += n;
+    return (long long)n;
+}
+
+static int mem_write(void* ctx, const unsigned char* buf, size_t len)
+{
+    mem_io_t* m = (mem_io_t*)ctx;
+    if (m->pos + len > m->len) return -1;
+    memcpy(m->data + m->pos, buf, len);
+    m->pos += len;
+    return 0;
+}
+
+// crypto_stream: 조각 update / pump 결과가 한 번에 계산한 값과 같은지
+static int run_crypto_stream_tests(void)
+{
+    const size_t len = 100000;
+    static const size_t parts[] = { 1, 15, 17, 4096, 33, 65535 };
+    unsigned char* pt = make_pattern(len);
+    unsigned char* ct = pt ? reference_ctr(pt, len) : NULL;
+    unsigned char* out = (unsigned char*)malloc(len);
+    int ok = pt && ct && out;
+
+    // 1) CTR 조각 update
+    if (ok) {
+        crypto_stream_t* s = crypto_stream_ctr_new(&AES_TTABLE_ENGINE, TS_KEY, 32, TS_IV);
+        size_t off = 0, i = 0;
+        while (s && off < len) {
+            size_t n = parts[i++ % (sizeof(parts) / sizeof(parts[0]))];
+            if (n > len - off) n = len - off;
+            if (crypto_stream_update(s, pt + off, n, out + off) != CRYPTO_OK) break;
+            off += n;
+        }
+        ok = s && off == len && memcmp(out, ct, len) == 0 &&
+            crypto_stream_final(s, NULL) == CRYPTO_OK &&
+            crypto_stream_update(s, pt, 1, out) == CRYPTO_ERR_STATE;
+        crypto_stream_free(s);
+        if (!ok) printf("[FAIL] crypto_stream ctr split update\n");
+    }
+
+    // 2) SHA-512 / HMAC 조각 update
+    if (ok) {
+        unsigned char d_ref[64], d_got[64], m_ref[64], m_got[64];
+        sha512_ctx_t sc;
+        sha512_init(&sc);
+        sha512_update(&sc, pt, len);
+        sha512_final(&sc, d_ref);
+        hmac_sha512(TS_KEY, 32, pt, len, m_ref);
+
+        crypto_stream_t* hs = crypto_stream_sha512_new();
+        crypto_stream_t* ms = crypto_stream_hmac_new(TS_KEY, 32);
+        size_t off = 0, i = 0;
+        while (hs && ms && off < len) {
+            size_t n = parts[i++ % (sizeof(parts) / sizeof(parts[0]))];
+            if (n > len - off) n = len - off;
+            crypto_stream_update(hs, pt + off, n, NULL);
+            crypto_stream_update(ms, pt + off, n, NULL);
+            off += n;
+        }
+        ok = hs && ms &&
+            crypto_stream_final(hs, d_got) == CRYPTO_OK && memcmp(d_ref, d_got, 64) == 0 &&
+            crypto_stream_final(ms, m_got) == CRYPTO_OK && memcmp(m_ref, m_got, 64) == 0;
+        crypto_stream_free(hs);
+        crypto_stream_free(ms);
+        if (!ok) printf("[FAIL] crypto_stream sha512/hmac split update\n");
+    }
+
+    // 3) CTR+HMAC pump (메모리 콜백, 짧은 읽기): 암호화 태그 == 복호화 태그 == HMAC(IV || CT)
+    if (ok) {
+        unsigned char t_enc[64], t_dec[64], t_ref[64];
+        unsigned char* ivct = (unsigned char*)malloc(16 + len);
+        unsigned char* dec = (unsigned char*)malloc(len);
+        mem_io_t src = { pt, len, 0, 777 };
+        mem_io_t dst = { out, len, 0, len };
+        crypto_stream_t* es = crypto_stream_ctr_hmac_new(&AES_TTABLE_ENGINE, TS_KEY, 32, TS_IV, TS_KEY, 32, 1);
+        ok = ivct && dec && es &&
+            crypto_stream_pump(es, mem_read, &src, mem_write, &dst, 1000) == CRYPTO_OK &&
+            dst.pos == len && memcmp(out, ct, len) == 0 &&
+            crypto_stream_final(es, t_enc) == CRYPTO_OK;
+        crypto_stream_free(es);
+
+        if (ok) {
+            memcpy(ivct, TS_IV, 16);
+            memcpy(ivct + 16, ct, len);
+            hmac_sha512(TS_KEY, 32, ivct, 16 + len, t_ref);
+
+            mem_io_t csrc = { out, len, 0, len };
+            mem_io_t pdst = { dec, len, 0, len };
+            crypto_stream_t* ds = crypto_stream_ctr_hmac_new(&AES_TTABLE_ENGINE, TS_KEY, 32, TS_IV, TS_KEY, 32, 0);
+            ok = ds &&
+                crypto_stream_pump(ds, mem_read, &csrc, mem_write, &pdst, 0) == CRYPTO_OK &&
+                memcmp(dec, pt, len) == 0 &&
+                crypto_stream_final(ds, t_dec) == CRYPTO_OK &&
+                memcmp(t_enc, t_ref, 64) == 0 && memcmp(t_dec, t_ref, 64) == 0;
+            crypto_stream_free(ds);
+        }
+        free(ivct);
+        free(dec);
+        if (!ok) printf("[FAIL] crypto_stream ctr+hmac pump\n");
+    }
+
+    // 4) 싱크 실패는 CRYPTO_ERR_IO
+    if (ok) {
+        mem_io_t src = { pt, len, 0, len };
+        mem_io_t dst = { out, 10, 0, len };
+        crypto_stream_t* s = crypto_stream_ctr_new(&AES_TTABLE_ENGINE, TS_KEY, 32, TS_IV);
+        ok = s && crypto_stream_pump(s, mem_read, &src, mem_write, &dst, 0) == CRYPTO_ERR_IO;
+        crypto_stream_free(s);
+        if (!ok) printf("[FAIL] crypto_stream sink error\n");
+    }
+
+    free(pt);
+    free(ct);
+    free(out);
+    if (ok) printf("[OK] crypto_stream update/pump\n");
+    return ok;
+}
+
+// stream_encrypt_ctr_hmac_file_ex: IV || CT || HMAC(IV || CT) 한 번에 기록
+static int run_ctr_hmac_file_test(size_t len)
+{
+    unsigned char* pt = make_pattern(len);
+    unsigned char* ct = pt ? reference_ctr(pt, len) : NULL;
+    unsigned char* exp = (unsigned char*)malloc(16 + len + 64);
+    int ok = pt && ct && exp && write_file(TS_IN, pt, len);
+
+    if (ok) {
+        memcpy(exp, TS_IV, 16);
+        if (len) memcpy(exp + 16, ct, len);
+        hmac_sha512(TS_KEY, 32, exp, 16 + len, exp + 16 + len);
+
+        stream_options_t opt;
+        stream_options_init(&opt);
+        opt.buf_size = 5000;
+        ok = stream_encrypt_ctr_hmac_file_ex(&AES_TTABLE_ENGINE, TS_IN, TS_OUT, TS_KEY, 32, TS_IV, TS_KEY, 32, &opt) == 0 &&
+            file_equals(TS_OUT, exp, 16 + len + 64) &&
+            stream_encrypt_ctr_hmac_file_ex(&AES_TTABLE_ENGINE, TS_IN, TS_OUT, TS_KEY, 32, TS_IV, NULL, 0, NULL) == 0 &&
+            file_equals(TS_OUT, exp, 16 + len);
+    }
+
+    // 입력이 없으면 출력 파일을 남기지 않는다
+    remove(TS_IN);
+    remove(TS_OUT);
+    if (ok) {
+        FILE* f = NULL;
+        ok = stream_encrypt_ctr_hmac_file_ex(&AES_TTABLE_ENGINE, TS_IN, TS_OUT, TS_KEY, 32, TS_IV, TS_KEY, 32, NULL) == -2 &&
+            (f = fopen(TS_OUT, "rb")) == NULL;
+        if (f) fclose(f);
+    }
+
+    free(pt);
+    free(ct);
+    free(exp);
+    if (ok) printf("[OK] stream ctr+hmac file len=%zu\n", len);
+    else printf("[FAIL] stream ctr+hmac file len=%zu\n", len);
+    return ok;
+}
+
+// crypto_stream_open: IV || CT || HMAC을 임의 조각으로 넣어도 평문/검증 결과가 같아야 함
+static int run_open_stream_case(const unsigned char* blob, size_t blob_len,
+                                const unsigned char* pt, size_t pt_len,
+                                const unsigned char* hmac_key, size_t step, int expect)
+{
+    unsigned char* out = (unsigned char*)malloc(blob_len + 1);
+    crypto_stream_t* s = crypto_stream_ctr_hmac_open_new(&AES_TTABLE_ENGINE, TS_KEY, 32, hmac_key, hmac_key ? 32 : 0);
+    int ok = out && s;
+    size_t off = 0, produced = 0;
+
+    while (ok && off < blob_len) {
+        size_t n = blob_len - off < step ? blob_len - off : step;
+        size_t got = 0;
+        ok = crypto_stream_open_update(s, blob + off, n, out + produced, &got) == CRYPTO_OK && got <= n;
+        produced += got;
+        off += n;
+    }
+    if (ok) {
+        int rc = crypto_stream_open_final(s);
+        ok = rc == expect;
+        if (ok && rc == CRYPTO_OK) ok = produced == pt_len && (pt_len == 0 || memcmp(out, pt, pt_len) == 0);
+    }
+
+    crypto_stream_free(s);
+    free(out);
+    return ok;
+}
+
+static int run_open_stream_tests(void)
+{
+    static const size_t lens[] = { 0, 1, 63, 64, 65, 5000 };
+    static const size_t steps[] = { 1, 7, 64, 100, 100000 };
+    int ok = 1;
+
+    for (size_t li = 0; li < sizeof(lens) / sizeof(lens[0]) && ok; li++) {
+        size_t len = lens[li];
+        unsigned char* pt = make_pattern(len);
+        unsigned char* ct = pt ? reference_ctr(pt, len) : NULL;
+        unsigned char* blob = (unsigned char*)malloc(16 + len + 64);
+        ok = pt && ct && blob;
+        if (ok) {
+            memcpy(blob, TS_IV, 16);
+            if (len) memcpy(blob + 16, ct, len);
+            hmac_sha512(TS_KEY, 32, blob, 16 + len, blob + 16 + len);
+        }
+
+        for (size_t si = 0; si < sizeof(steps) / sizeof(steps[0]) && ok; si++) {
+            size_t step = steps[si];
+            // 정상 / 태그 없는 형식
+            if (!run_open_stream_case(blob, 16 + len + 64, pt, len, TS_KEY, step, CRYPTO_OK)) ok = 0;
+            if (!run_open_stream_case(blob, 16 + len, pt, len, NULL, step, CRYPTO_OK)) ok = 0;
+            // 암호문 / 태그 변조, 잘린 입력
+            blob[16 + len + 63] ^= 1;
+            if (!run_open_stream_case(blob, 16 + len + 64, pt, len, TS_KEY, step, CRYPTO_ERR_AUTH)) ok = 0;
+            blob[16 + len + 63] ^= 1;
+            if (len) {
+                blob[16] ^= 0x80;
+                if (!run_open_stream_case(blob, 16 + len + 64, pt, len, TS_KEY, step, CRYPTO_ERR_AUTH)) ok = 0;
+                blob[16] ^= 0x80;
+            }
+            if (!run_open_stream_case(blob, 16 + len + 63, pt, len, TS_KEY, step, len ? CRYPTO_ERR_AUTH : CRYPTO_ERR_INVALID)) ok = 0;
+            if (!run_open_stream_case(blob, 15, pt, 0, NULL, step, CRYPTO_ERR_INVALID)) ok = 0;
+            if (!ok) printf("[FAIL] crypto_stream open len=%zu step=%zu\n", len, step);
+        }
+
+        free(pt);
+        free(ct);
+        free(blob);
+    }
+
+    if (ok) printf("[OK] crypto_stream open (lookbehind)\n");
+    return ok;
+}
+
+// 암호화 파일 → 한 번 읽기 검증/복호화, 실패 시 출력 파일이 생기지 않아야 함
+static int run_ctr_hmac_decrypt_file_test(size_t len)
+{
+    unsigned char* pt = make_pattern(len);
+    int ok = pt && write_file(TS_IN, pt, len);
+    stream_options_t opt;
+    stream_options_init(&opt);
+    opt.buf_size = 4096;
+
+    if (ok) ok = stream_encrypt_ctr_hmac_file_ex(&AES_TTABLE_ENGINE, TS_IN, TS_OUT, TS_KEY, 32, TS_IV, TS_KEY, 32, NULL) == 0;
+    if (ok) ok = stream_decrypt_ctr_hmac_file_ex(&AES_TTABLE_ENGINE, TS_OUT, TS_DEC, TS_KEY, 32, TS_KEY, 32, &opt) == 0 &&
+        file_equals(TS_DEC, pt, len);
+    remove(TS_DEC);
+
+    // 태그 변조: -10, 출력/부분 파일 없음
+    if (ok) {
+        size_t n = 0;
+        unsigned char* blob = read_file(TS_OUT, &n);
+        ok = blob && n == 16 + len + 64;
+        if (ok) {
+            blob[n - 1] ^= 1;
+            ok = write_file(TS_OUT, blob, n) &&
+                stream_decrypt_ctr_hmac_file_ex(&AES_TTABLE_ENGINE, TS_OUT, TS_DEC, TS_KEY, 32, TS_KEY, 32, &opt) == -10;
+            FILE* f = fopen(TS_DEC, "rb");
+            FILE* fp = fopen(TS_DEC STREAM_PARTIAL_SUFFIX, "rb");
+            if (f || fp) ok = 0;
+            if (f) fclose(f);
+            if (fp) fclose(fp);
+        }
+        free(blob);
+    }
+
+    // 태그 없는 형식 (IV || CT)
+    if (ok) ok = stream_encrypt_ctr_hmac_file_ex(&AES_TTABLE_ENGINE, TS_IN, TS_OUT, TS_KEY, 32, TS_IV, NULL, 0, NULL) == 0 &&
+        stream_decrypt_ctr_hmac_file_ex(&AES_TTABLE_ENGINE, TS_OUT, TS_DEC, TS_KEY, 32, NULL, 0, NULL) == 0 &&
+        file_equals(TS_DEC, pt, len);
+
+    remove(TS_IN);
+    remove(TS_OUT);
+    remove(TS_DEC);
+    free(pt);
+    if (ok) printf("[OK] stream ctr+hmac decrypt file len=%zu\n", len);
+    else printf("[FAIL] stream ctr+hmac decrypt file len=%zu\n", len);
+    return ok;
+}
+
+// 제자리 변환 중 끊긴 상태를 만든다: [0, chunk_off)는 암호문, 끊긴 청크는 mask의 섹터만 암호문
+static int make_crashed_inplace(const unsigned char* pt, const unsigned char* ct, size_t len,
+                                size_t chunk_off, size_t chunk_len, unsigned int mask,
+                                const unsigned char* key)
+{
+    unsigned char* cur = (unsigned char*)malloc(len);
+    if (!cur) return 0;
+    memcpy(cur, pt, len);
+    memcpy(cur, ct, chunk_off);
+    uint32_t sectors = (uint32_t)((chunk_len + STREAM_INPLACE_SECTOR - 1) / STREAM_INPLACE_SECTOR);
+    for (uint32_t i = 0; i < sectors; i++) {
+        if (!(mask & (1u << i))) continue;
+        size_t so = chunk_off + (size_t)i * STREAM_INPLACE_SECTOR;
+        size_t sl = len - so < STREAM_INPLACE_SECTOR ? len - so : STREAM_INPLACE_SECTOR;
+        memcpy(cur + so, ct + so, sl);
+    }
+    int ok = write_file(TS_IN, cur, len);
+    free(cur);
+
+    // 저널: 헤더 + 섹터별 암호문 앞 8바이트
+    //  확인값 = HMAC(key, "stream resume check" || IV)의 앞 8바이트 (keystream과 무관)
+    unsigned char msg[19 + 16], digest[64];
+    memcpy(msg, "stream resume check", 19);
+    memcpy(msg + 19, TS_IV, 16);
+    hmac_sha512(key, 32, msg, sizeof(msg), digest);
+
+    unsigned char hdr[STREAM_INPLACE_HEADER_BYTES];
+    memset(hdr, 0, sizeof(hdr));
+    memcpy(hdr, "SIPJ", 4);
+    store_be32(hdr + 4, STREAM_INPLACE_JOURNAL_VERSION);
+    memcpy(hdr + 8, digest, 8);
+    store_be64(hdr + 16, len);
+    store_be64(hdr + 24, chunk_off);
+    store_be64(hdr + 32, chunk_len);
+    store_be32(hdr + 40, sectors);
+    store_be32(hdr + 44, 1);   // 암호화
+
+    FILE* f = fopen(TS_JNL, "wb");
+    if (!f) return 0;
+    ok = ok && fwrite(hdr, 1, sizeof(hdr), f) == sizeof(hdr);
+    for (uint32_t i = 0; i < sectors; i++) {
+        unsigned char pre[STREAM_INPLACE_PREFIX] = { 0 };
+        size_t so = chunk_off + (size_t)i * STREAM_INPLACE_SECTOR;
+        size_t pl = len - so < STREAM_INPLACE_PREFIX ? len - so : STREAM_INPLACE_PREFIX;
+        memcpy(pre, ct + so, pl);
+        ok = ok && fwrite(pre, 1, sizeof(pre), f) == sizeof(pre);
+    }
+    return (fclose(f) == 0) && ok;
+}
+
+static int journal_exists(void)
+{
+    FILE* f = fopen(TS_JNL, "rb");
+    if (f) fclose(f);
+    return f != NULL;
+}
+
+// 저널 어디에도 평문 섹터의 앞 8바이트가 없어야 한다
+static int journal_has_no_plaintext(const unsigned char* pt, size_t len)
+{
+    size_t n = 0;
+    unsigned char* jn = read_file(TS_JNL, &n);
+    int ok = jn && n > STREAM_INPLACE_HEADER_BYTES;
+    for (size_t so = 0; ok && so + STREAM_INPLACE_PREFIX <= len; so += STREAM_INPLACE_SECTOR) {
+        for (size_t k = STREAM_INPLACE_HEADER_BYTES; ok && k + STREAM_INPLACE_PREFIX <= n; k++) {
+            if (memcmp(jn + k, pt + so, STREAM_INPLACE_PREFIX) == 0) ok = 0;
+        }
+    }
+    free(jn);
+    return ok;
+}
+
+static int run_inplace_tests(void)
+{
+    const size_t len = 3 * 4096 + 700;   // 마지막 청크는 섹터 배수가 아님
+    unsigned char* pt = make_pattern(len);
+    unsigned char* ct = pt ? reference_ctr(pt, len) : NULL;
+    int ok = pt && ct;
+    stream_options_t opt;
+    stream_options_init(&opt);
+    opt.buf_size = 4096;   // 청크 4개, 청크당 섹터 8개
+
+    // 1) 제자리 암호화 = 기준 암호문, 다시 적용하면 원문, 저널은 남지 않음
+    if (ok) ok = write_file(TS_IN, pt, len) &&
+        stream_encrypt_ctr_file_inplace(&AES_TTABLE_ENGINE, TS_IN, TS_KEY, 32, TS_IV, NULL, &opt) == 0 &&
+        file_equals(TS_IN, ct, len) && !journal_exists() &&
+        stream_decrypt_ctr_file_inplace(&AES_TTABLE_ENGINE, TS_IN, TS_KEY, 32, TS_IV, NULL, NULL) == 0 &&
+        file_equals(TS_IN, pt, len);
+    if (!ok) printf("[FAIL] stream inplace round trip\n");
+
+    // 2) 청크 중간에 끊긴 상태에서 재개 (섹터 일부만 변환됨, 마지막 짧은 청크 포함)
+    static const size_t offs[] = { 0, 8192, 12288 };
+    static const unsigned int masks[] = { 0x00, 0x25, 0xFF, 0x02 };
+    for (size_t i = 0; ok && i < sizeof(offs) / sizeof(offs[0]); i++) {
+        size_t clen = len - offs[i] < 4096 ? len - offs[i] : 4096;
+        for (size_t m = 0; ok && m < sizeof(masks) / sizeof(masks[0]); m++) {
+            ok = make_crashed_inplace(pt, ct, len, offs[i], clen, masks[m], TS_KEY) &&
+                stream_encrypt_ctr_file_inplace(&AES_TTABLE_ENGINE, TS_IN, TS_KEY, 32, TS_IV, NULL, &opt) == 0 &&
+                file_equals(TS_IN, ct, len) && !journal_exists();
+            if (!ok) printf("[FAIL] stream inplace resume off=%zu mask=%02x\n", offs[i], masks[m]);
+        }
+    }
+
+    // 3) 섹터가 일부만 기록된 경우 -15, 다른 키의 저널은 -14 (둘 다 파일/저널 보존)
+    if (ok) {
+        ok = make_crashed_inplace(pt, ct, len, 4096, 4096, 0x01, TS_KEY);
+        size_t n = 0;
+        unsigned char* cur = ok ? read_file(TS_IN, &n) : NULL;
+        if (cur) {
+            cur[4096 + STREAM_INPLACE_SECTOR] ^= 0x5A;   // 섹터 1 앞부분이 원본도 암호문도 아님
+            ok = write_file(TS_IN, cur, n) &&
+                stream_encrypt_ctr_file_inplace(&AES_TTABLE_ENGINE, TS_IN, TS_KEY, 32, TS_IV, NULL, &opt) == -15 &&
+                file_equals(TS_IN, cur, n) && journal_exists();
+            free(cur);
+        }
+        else ok = 0;
+
+        unsigned char other[32];
+        memcpy(other, TS_KEY, 32);
+        other[0] ^= 1;
+        ok = ok && make_crashed_inplace(pt, ct, len, 4096, 4096, 0x01, other) &&
+            stream_encrypt_ctr_file_inplace(&AES_TTABLE_ENGINE, TS_IN, TS_KEY, 32, TS_IV, NULL, &opt) == -14 &&
+            journal_exists();
+        if (!ok) printf("[FAIL] stream inplace torn/mismatch\n");
+    }
+
+    remove(TS_IN);
+    remove(TS_JNL);
+    free(pt);
+    free(ct);
+    if (ok) printf("[OK] stream inplace (journal resume)\n");
+    return ok;
+}
+
+// 진행률 / 취소 콜백 기록
+typedef struct {
+    uint64_t last;
+    uint64_t total;
+    int calls;
+    int monotonic;
+    int cancel_after;   // 이 횟수만큼 진행률을 받은 뒤 취소 (0이면 취소 안 함)
+} progress_probe_t;
+
+static void probe_progress(void* user, uint64_t done, uint64_t total)
+{
+    progress_probe_t* p = (progress_probe_t*)user;
+    if (done < p->last) p->monotonic = 0;
+    p->last = done;
+    p->total = total;
+    p->calls++;
+}
+
+static int probe_cancel(void* user)
+{
+    progress_probe_t* p = (progress_probe_t*)user;
+    return p->cancel_after > 0 && p->calls >= p->cancel_after;
+}
+
+static void probe_init(progress_probe_t* p, stream_options_t* opt, int io_mode, int cancel_after)
+{
+    memset(p, 0, sizeof(*p));
+    p->monotonic = 1;
+    p->cancel_after = cancel_after;
+    stream_options_init(opt);
+    opt->io_mode = io_mode;
+    opt->buf_size = 4096;
+    opt->threads = 2;
+    opt->progress = probe_progress;
+    opt->cancel = probe_cancel;
+    opt->user = p;
+}
+
+static int run_progress_tests(void)
+{
+    static const int modes[] = { STREAM_IO_STDIO, STREAM_IO_MMAP, STREAM_IO_PIPELINE, STREAM_IO_URING, STREAM_IO_DIRECT };
+    static const char* names[] = { "stdio", "mmap", "pipeline", "uring", "direct" };
+    const size_t len = 5 * 4096 + 100;
+    unsigned char* pt = make_pattern(len);
+    unsigned char* ct = pt ? reference_ctr(pt, len) : NULL;
+    int ok = pt && ct && write_file(TS_IN, pt, len);
+
+    unsigned char d_ref[64], d_got[64];
+    if (ok) ok = stream_hash_sha512_file(TS_IN, d_ref) == 0;
+
+    for (size_t i = 0; ok && i < sizeof(modes) / sizeof(modes[0]); i++) {
+        progress_probe_t p;
+        stream_options_t opt;
+
+        // 1) 끝까지: 결과는 같고 진행률은 단조 증가해 total에서 끝남
+        probe_init(&p, &opt, modes[i], 0);
+        ok = stream_encrypt_ctr_file_ex(&AES_TTABLE_ENGINE, TS_IN, TS_OUT, TS_KEY, 32, TS_IV, &opt) == 0 &&
+            file_equals(TS_OUT, ct, len) &&
+            p.monotonic && p.calls >= 2 && p.last == len && p.total == len;
+        probe_init(&p, &opt, modes[i], 0);
+        ok = ok && stream_hash_sha512_file_ex(TS_IN, d_got, &opt) == 0 &&
+            memcmp(d_ref, d_got, 64) == 0 &&
+            p.monotonic && p.calls >= 2 && p.last == len && p.total == len;
+        if (!ok) printf("[FAIL] stream progress %s\n", names[i]);
+
+        // 2) 첫 버퍼 뒤 취소 → -16
+        probe_init(&p, &opt, modes[i], 1);
+        if (ok && stream_encrypt_ctr_file_ex(&AES_TTABLE_ENGINE, TS_IN, TS_OUT, TS_KEY, 32, TS_IV, &opt) != -16) ok = 0;
+        probe_init(&p, &opt, modes[i], 1);
+        if (ok && stream_hash_sha512_file_ex(TS_IN, d_got, &opt) != -16) ok = 0;
+        if (!ok) printf("[FAIL] stream cancel %s\n", names[i]);
+    }
+
+    // 3) IV||CT||HMAC 암호화/복호화: 진행률은 입력 기준, 취소 시 출력(.part 포함)을 남기지 않음
+    if (ok) {
+        progress_probe_t p;
+        stream_options_t opt;
+        probe_init(&p, &opt, STREAM_IO_STDIO, 0);
+        ok = stream_encrypt_ctr_hmac_file_ex(&AES_TTABLE_ENGINE, TS_IN, TS_OUT, TS_KEY, 32, TS_IV, TS_KEY, 32, &opt) == 0 &&
+            p.monotonic && p.last == len && p.total == len;
+        probe_init(&p, &opt, STREAM_IO_STDIO, 0);
+        ok = ok && stream_decrypt_ctr_hmac_file_ex(&AES_TTABLE_ENGINE, TS_OUT, TS_DEC, TS_KEY, 32, TS_KEY, 32, &opt) == 0 &&
+            file_equals(TS_DEC, pt, len) && p.monotonic && p.last == 16 + len + 64;
+
+        probe_init(&p, &opt, STREAM_IO_STDIO, 1);
+        remove(TS_DEC);
+        FILE* f = NULL;
+        ok = ok && stream_decrypt_ctr_hmac_file_ex(&AES_TTABLE_ENGINE, TS_OUT, TS_DEC, TS_KEY, 32, TS_KEY, 32, &opt) == -16 &&
+            (f = fopen(TS_DEC, "rb")) == NULL && (f = fopen(TS_DEC STREAM_PARTIAL_SUFFIX, "rb")) == NULL;
+        probe_init(&p, &opt, STREAM_IO_STDIO, 1);
+        ok = ok && stream_encrypt_ctr_hmac_file_ex(&AES_TTABLE_ENGINE, TS_IN, TS_OUT, TS_KEY, 32, TS_IV, TS_KEY, 32, &opt) == -16 &&
+            (f = fopen(TS_OUT, "rb")) == NULL;
+        if (f) fclose(f);
+        if (!ok) printf("[FAIL] stream progress/cancel ctr+hmac\n");
+    }
+
+    // 4) 제자리 변환: 취소하면 저널이 남고, 같은 인자로 다시 호출하면 이어서 끝냄
+    //    (남은 저널에는 평문이 없고, 방향이 다른 호출은 그 저널로 재개하지 않는다)
+    if (ok) {
+        progress_probe_t p;
+        stream_options_t opt;
+        probe_init(&p, &opt, STREAM_IO_STDIO, 2);
+        ok = stream_encrypt_ctr_file_inplace(&AES_TTABLE_ENGINE, TS_IN, TS_KEY, 32, TS_IV, NULL, &opt) == -16 &&
+            p.last == 2 * 4096 && journal_exists() && journal_has_no_plaintext(pt, len) &&
+            stream_decrypt_ctr_file_inplace(&AES_TTABLE_ENGINE, TS_IN, TS_KEY, 32, TS_IV, NULL, NULL) == -14;
+        p.cancel_after = 0;
+        ok = ok && stream_encrypt_ctr_file_inplace(&AES_TTABLE_ENGINE, TS_IN, TS_KEY, 32, TS_IV, NULL, &opt) == 0 &&
+            file_equals(TS_IN, ct, len) && !journal_exists() && p.monotonic && p.last == len;
+
+        probe_init(&p, &opt, STREAM_IO_STDIO, 2);
+        ok = ok && stream_decrypt_ctr_file_inplace(&AES_TTABLE_ENGINE, TS_IN, TS_KEY, 32, TS_IV, NULL, &opt) == -16 &&
+            journal_exists() && journal_has_no_plaintext(pt, len);
+        p.cancel_after = 0;
+        ok = ok && stream_decrypt_ctr_file_inplace(&AES_TTABLE_ENGINE, TS_IN, TS_KEY, 32, TS_IV, NULL, &opt) == 0 &&
+            file_equals(TS_IN, pt, len) && !journal_exists();
+        if (!ok) printf("[FAIL] stream cancel inplace resume\n");
+    }
+
+    // 5) 청크 컨테이너: 진행률 total은 입력(복호화는 컨테이너) 크기, 묶음 하나로 끝나면
+    //    마지막 청크를 기록한 뒤라 취소해도 성공, 여러 묶음이면 첫 묶음 뒤 취소 → -16
+    if (ok) {
+        const size_t sealed = STREAM_CHUNKED_HEADER_BYTES + len + (len / 8192 + 1) * STREAM_CHUNKED_TAG_BYTES;
+        progress_probe_t p;
+        stream_options_t opt;
+        probe_init(&p, &opt, STREAM_IO_STDIO, 0);
+        ok = write_file(TS_IN, pt, len) &&
+            stream_chunked_encrypt_file(&AES_TTABLE_ENGINE, TS_IN, TS_OUT, TS_KEY, 32, TS_IV, TS_KEY, 32, 8192, &opt) == 0 &&
+            p.monotonic && p.last == len && p.total == len;
+        probe_init(&p, &opt, STREAM_IO_STDIO, 0);
+        ok = ok && stream_chunked_decrypt_file(&AES_TTABLE_ENGINE, TS_OUT, TS_DEC, TS_KEY, 32, TS_KEY, 32, &opt) == 0 &&
+            file_equals(TS_DEC, pt, len) && p.monotonic && p.last == sealed && p.total == sealed;
+
+        probe_init(&p, &opt, STREAM_IO_STDIO, 1);
+        remove(TS_DEC);
+        ok = ok && stream_chunked_decrypt_file(&AES_TTABLE_ENGINE, TS_OUT, TS_DEC, TS_KEY, 32, TS_KEY, 32, &opt) == 0 &&
+            file_equals(TS_DEC, pt, len) && p.calls == 1;
+
+        probe_init(&p, &opt, STREAM_IO_STDIO, 1);
+        remove(TS_DEC);
+        FILE* f = NULL;
+        ok = ok && stream_chunked_encrypt_file(&AES_TTABLE_ENGINE, TS_IN, TS_OUT, TS_KEY, 32, TS_IV, TS_KEY, 32, 1024, NULL) == 0 &&
+            stream_chunked_decrypt_file(&AES_TTABLE_ENGINE, TS_OUT, TS_DEC, TS_KEY, 32, TS_KEY, 32, &opt) == -16 &&
+            (f = fopen(TS_DEC, "rb")) == NULL && (f = fopen(TS_DEC STREAM_PARTIAL_SUFFIX, "rb")) == NULL;
+        if (f) fclose(f);
+        if (!ok) printf("[FAIL] stream progress/cancel chunked\n");
+    }
+
+    // 6) 재개형 해시: 첫 버퍼 뒤 취소 → -16, 체크포인트가 남아 다음 호출이 이어서 계산
+    //    (체크포인트 앞부분을 바꿔도 원래 값이 나오면 저장된 상태에서 이어 간 것)
+    if (ok) {
+        const size_t hlen = 3 * STREAM_DEFAULT_BUF_SIZE + 123;
+        unsigned char* data = make_pattern(hlen);
+        unsigned char ref[64], got[64];
+        progress_probe_t p;
+        stream_options_t opt;
+        remove(TS_IN ".hckp");
+        probe_init(&p, &opt, STREAM_IO_STDIO, 1);
+        ok = data && write_file(TS_IN, data, hlen) && stream_hash_sha512_file(TS_IN, ref) == 0 &&
+            stream_hash_sha512_file_resumable_ex(TS_IN, TS_IN ".hckp", STREAM_DEFAULT_BUF_SIZE, got, &opt) == -16;
+        if (ok) {
+            data[0] ^= 0xff;
+            ok = write_file(TS_IN, data, hlen);
+        }
+        probe_init(&p, &opt, STREAM_IO_STDIO, 0);
+        ok = ok && stream_hash_sha512_file_resumable_ex(TS_IN, TS_IN ".hckp", STREAM_DEFAULT_BUF_SIZE, got, &opt) == 0 &&
+            memcmp(got, ref, 64) == 0 && p.monotonic && p.last == hlen;
+        remove(TS_IN ".hckp");
+        free(data);
+        if (!ok) printf("[FAIL] stream cancel resumable hash\n");
+    }
+
+    remove(TS_IN);
+    remove(TS_OUT);
+    remove(TS_DEC);
+    remove(TS_JNL);
+    free(pt);
+    free(ct);
+    if (ok) printf("[OK] stream progress/cancel callbacks\n");
+    return ok;
+}
+
+static int file_exists(const char* path)
+{
+    FILE* f = fopen(path, "rb");
+    if (f) fclose(f);
+    return f != NULL;
+}
+
+static int run_resumable_encrypt_tests(void)
+{
+    const size_t len = 10 * 4096 + 37;
+    unsigned char* pt = make_pattern(len);
+    size_t ref_len = 0;
+    unsigned char* ref = NULL;
+    int ok = pt && write_file(TS_IN, pt, len);
+
+    // 기준: 한 번에 암호화한 IV || CT || HMAC
+    if (ok) ok = stream_encrypt_ctr_hmac_file_ex(&AES_TTABLE_ENGINE, TS_IN, TS_DEC, TS_KEY, 32, TS_IV, TS_KEY, 32, NULL) == 0 &&
+        (ref = read_file(TS_DEC, &ref_len)) != NULL && ref_len == 16 + len + 64;
+
+    unsigned char other_iv[16];
+    memset(other_iv, 0xEE, sizeof(other_iv));
+    progress_probe_t p;
+    stream_options_t opt;
+
+    // 1) 끊김 없이: 기준과 같고 상태 파일은 남지 않음
+    probe_init(&p, &opt, STREAM_IO_STDIO, 0);
+    ok = ok && stream_encrypt_ctr_hmac_file_resumable(&AES_TTABLE_ENGINE, TS_IN, TS_OUT, TS_KEY, 32, TS_IV,
+        TS_KEY, 32, NULL, 8192, &opt) == 0 &&
+        file_equals(TS_OUT, ref, ref_len) && !file_exists(TS_ECKP) && p.last == len;
+    if (!ok) printf("[FAIL] stream resumable encrypt straight\n");
+
+    // 2) 3번째 버퍼 뒤 중단 + 체크포인트 뒤에 쓰다 만 꼬리 → 재개 (IV는 출력 파일의 것 사용)
+    probe_init(&p, &opt, STREAM_IO_STDIO, 3);
+    ok = ok && stream_encrypt_ctr_hmac_file_resumable(&AES_TTABLE_ENGINE, TS_IN, TS_OUT, TS_KEY, 32, TS_IV,
+        TS_KEY, 32, NULL, 8192, &opt) == -16 && file_exists(TS_ECKP);
+    if (ok) {
+        FILE* f = fopen(TS_OUT, "ab");
+        ok = f && fwrite(pt, 1, 5000, f) == 5000;
+        if (f) fclose(f);
+    }
+    probe_init(&p, &opt, STREAM_IO_STDIO, 0);
+    ok = ok && stream_encrypt_ctr_hmac_file_resumable(&AES_TTABLE_ENGINE, TS_IN, TS_OUT, TS_KEY, 32, other_iv,
+        TS_KEY, 32, NULL, 8192, &opt) == 0 &&
+        file_equals(TS_OUT, ref, ref_len) && !file_exists(TS_ECKP) && p.last == len;
+    if (!ok) printf("[FAIL] stream resumable encrypt resume\n");
+
+    // 3) 다른 HMAC 키 / 다른 AES 키로 재개 → -14, 상태 파일 유지
+    unsigned char wrong[32];
+    memcpy(wrong, TS_KEY, 32);
+    wrong[5] ^= 1;
+    probe_init(&p, &opt, STREAM_IO_STDIO, 2);
+    ok = ok && stream_encrypt_ctr_hmac_file_resumable(&AES_TTABLE_ENGINE, TS_IN, TS_OUT, TS_KEY, 32, TS_IV,
+        TS_KEY, 32, NULL, 8192, &opt) == -16 &&
+        stream_encrypt_ctr_hmac_file_resumable(&AES_TTABLE_ENGINE, TS_IN, TS_OUT, TS_KEY, 32, TS_IV,
+            wrong, 32, NULL, 8192, NULL) == -14 &&
+        stream_encrypt_ctr_hmac_file_resumable(&AES_TTABLE_ENGINE, TS_IN, TS_OUT, wrong, 32, TS_IV,
+            TS_KEY, 32, NULL, 8192, NULL) == -14 &&
+        file_exists(TS_ECKP);
+    if (!ok) printf("[FAIL] stream resumable encrypt key mismatch\n");
+
+    // 4) 출력이 체크포인트보다 짧으면 처음부터 다시
+    if (ok) ok = write_file(TS_OUT, ref, 100) &&
+        stream_encrypt_ctr_hmac_file_resumable(&AES_TTABLE_ENGINE, TS_IN, TS_OUT, TS_KEY, 32, TS_IV,
+            TS_KEY, 32, NULL, 8192, NULL) == 0 &&
+        file_equals(TS_OUT, ref, ref_len) && !file_exists(TS_ECKP);
+    if (!ok) printf("[FAIL] stream resumable encrypt short output\n");
+
+    remove(TS_IN);
+    remove(TS_OUT);
+    remove(TS_DEC);
+    remove(TS_ECKP);
+    free(pt);
+    free(ref);
+    if (ok) printf("[OK] stream resumable ctr+hmac encrypt\n");
+    return ok;
+}
+
+// 청크 컨테이너: 변조된 입력을 TS_OUT에 쓰고 복호화 결과 확인 (부분 파일은 남지 않아야 함)
+static int chunked_expect(const unsigned char* blob, size_t blob_len, int key_len, int expect)
+{
+    int ok = write_file(TS_OUT, blob, blob_len) &&
+        stream_chunked_decrypt_file(&AES_TTABLE_ENGINE, TS_OUT, TS_DEC, TS_KEY, key_len, TS_KEY, 32, NULL) == expect &&
+        !file_exists(TS_DEC STREAM_PARTIAL_SUFFIX);
+    if (expect != 0) ok = ok && !file_exists(TS_DEC);
+    remove(TS_DEC);
+    return ok;
+}
+
+static int run_chunked_case(size_t len, unsigned int threads)
+{
+    const size_t chunk = 4096;
+    unsigned char* pt = make_pattern(len);
+    int ok = pt && write_file(TS_IN, pt, len);
+    stream_options_t opt;
+    stream_options_init(&opt);
+    opt.threads = threads;
+
+    // 1) 왕복 + 크기: 헤더 + 평문 + 청크마다 태그 (배수이면 빈 마지막 청크)
+    size_t chunks = len / chunk + 1;
+    size_t blob_len = 0;
+    unsigned char* blob = NULL;
+    ok = ok && stream_chunked_encrypt_file(&AES_TTABLE_ENGINE, TS_IN, TS_OUT, TS_KEY, 32, TS_IV, TS_KEY, 32, chunk, &opt) == 0 &&
+        (blob = read_file(TS_OUT, &blob_len)) != NULL &&
+        blob_len == STREAM_CHUNKED_HEADER_BYTES + len + chunks * STREAM_CHUNKED_TAG_BYTES &&
+        stream_chunked_decrypt_file(&AES_TTABLE_ENGINE, TS_OUT, TS_DEC, TS_KEY, 32, TS_KEY, 32, &opt) == 0 &&
+        file_equals(TS_DEC, pt, len);
+
+    // 첫 청크의 CT는 같은 키/IV의 CTR과 같다
+    if (ok && len > 0) {
+        unsigned char* ct = reference_ctr(pt, len);
+        size_t first = len < chunk ? len : chunk;
+        ok = ct && memcmp(blob + STREAM_CHUNKED_HEADER_BYTES, ct, first) == 0;
+        free(ct);
+    }
+    remove(TS_DEC);
+
+    // 2) 변조: CT 바이트 / 태그 / 헤더(청크 크기) / 덧붙인 데이터 → -10,
+    //    마지막 청크 제거 → -13, 다른 키 길이 → -17
+    if (ok) {
+        unsigned char* bad = (unsigned char*)malloc(blob_len + 1);
+        ok = bad != NULL;
+        if (ok && len > 0) {
+            memcpy(bad, blob, blob_len);
+            bad[STREAM_CHUNKED_HEADER_BYTES + len / 2] ^= 1;
+            ok = chunked_expect(bad, blob_len, 32, -10);
+        }
+        if (ok) {
+            memcpy(bad, blob, blob_len);
+            bad[blob_len - 1] ^= 0x80;
+            ok = chunked_expect(bad, blob_len, 32, -10);
+        }
+        if (ok) {
+            memcpy(bad, blob, blob_len);
+            bad[12 + 2] ^= 0x20;   // 청크 크기 4096 → 12288 (형식상 유효)
+            ok = chunked_expect(bad, blob_len, 32, -10);
+        }
+        if (ok) {
+            memcpy(bad, blob, blob_len);
+            bad[blob_len] = 0;
+            ok = chunked_expect(bad, blob_len + 1, 32, -10);
+        }
+        if (ok && chunks > 1) {
+            size_t last = blob_len - (len % chunk) - STREAM_CHUNKED_TAG_BYTES;
+            ok = chunked_expect(blob, last, 32, -13);
+        }
+        ok = ok && chunked_expect(blob, STREAM_CHUNKED_HEADER_BYTES - 1, 32, -13) &&
+            chunked_expect(blob, blob_len, 16, -17);
+        free(bad);
+    }
+
+    // 3) 청크 순서 바꾸기 → -10, 스트리밍 복호화는 실패 지점 앞의 검증된 청크만 내보냄
+    if (ok && chunks > 2) {
+        const size_t rec = chunk + STREAM_CHUNKED_TAG_BYTES;
+        unsigned char* swapped = (unsigned char*)malloc(blob_len);
+        ok = swapped != NULL;
+        if (ok) {
+            memcpy(swapped, blob, blob_len);
+            memcpy(swapped + STREAM_CHUNKED_HEADER_BYTES + rec, blob + STREAM_CHUNKED_HEADER_BYTES + 2 * rec, rec);
+            memcpy(swapped + STREAM_CHUNKED_HEADER_BYTES + 2 * rec, blob + STREAM_CHUNKED_HEADER_BYTES + rec, rec);
+            ok = chunked_expect(swapped, blob_len, 32, -10);
+
+            mem_io_t sink = { (unsigned char*)malloc(len), len, 0, 0 };
+            FILE* f = fopen(TS_OUT, "rb");
+            ok = ok && sink.data && f &&
+                stream_chunked_decrypt_stream(&AES_TTABLE_ENGINE, f, mem_write, &sink, TS_KEY, 32, TS_KEY, 32, 0, &opt) == -10 &&
+                sink.pos == chunk && memcmp(sink.data, pt, chunk) == 0;
+            if (f) fclose(f);
+            free(sink.data);
+        }
+        free(swapped);
+    }
+
+    remove(TS_IN);
+    remove(TS_OUT);
+    remove(TS_DEC);
+    free(pt);
+    free(blob);
+    if (ok) printf("[OK] stream chunked container len=%zu threads=%u\n", len, threads);
+    else printf("[FAIL] stream chunked container len=%zu threads=%u\n", len, threads);
+    return ok;
+}
+
+static int run_crypto_file_tests(void)
+{
+    const size_t chunk = 4096, len = 20 * 4096 + 5;
+    unsigned char* pt = make_pattern(len);
+    unsigned char* got = (unsigned char*)malloc(len + 100);
+    int ok = pt && got && write_file(TS_IN, pt, len) &&
+        stream_chunked_encrypt_file(&AES_TTABLE_ENGINE, TS_IN, TS_OUT, TS_KEY, 32, TS_IV, TS_KEY, 32, chunk, NULL) == 0;
+
+    // 1) 흩어진 범위 읽기 (청크 경계 걸침, 끝 넘기, 0바이트) + 캐시 적중
+    crypto_file_t* cf = NULL;
+    ok = ok && crypto_file_open(&cf, &AES_TTABLE_ENGINE, TS_OUT, TS_KEY, 32, TS_KEY, 32, 4) == 0 &&
+        crypto_file_size(cf) == len;
+    static const size_t offs[] = { 0, 4095, 8000, 81920, 50000, 4100, 12345, 81924 };
+    static const size_t lens[] = { 10, 2, 9000, 5, 1, 4000, 100, 100 };
+    for (size_t i = 0; ok && i < sizeof(offs) / sizeof(offs[0]); i++) {
+        size_t exp = offs[i] + lens[i] > len ? len - offs[i] : lens[i];
+        ok = crypto_file_pread(cf, got, lens[i], offs[i]) == (long long)exp &&
+            memcmp(got, pt + offs[i], exp) == 0;
+    }
+    ok = ok && crypto_file_pread(cf, got, 10, len) == 0 && crypto_file_pread(cf, got, 0, 3) == 0;
+    uint64_t hits = 0, misses = 0;
+    crypto_file_cache_stats(cf, &hits, &misses);
+    ok = ok && crypto_file_pread(cf, got, 16, 4200) == 16 && memcmp(got, pt + 4200, 16) == 0;
+    uint64_t hits2 = 0, misses2 = 0;
+    crypto_file_cache_stats(cf, &hits2, &misses2);
+    ok = ok && hits2 == hits + 1 && misses2 == misses;
+    ok = ok && crypto_file_pread(cf, got, len + 100, 0) == (long long)len && memcmp(got, pt, len) == 0;
+    crypto_file_close(cf);
+    cf = NULL;
+    if (!ok) printf("[FAIL] crypto_file scattered reads\n");
+
+    // 2) 청크 5 변조: 그 청크에 닿는 읽기만 -10, 잘린 파일/다른 키 길이는 열기 실패
+    size_t blob_len = 0;
+    unsigned char* blob = ok ? read_file(TS_OUT, &blob_len) : NULL;
+    if (blob) {
+        const size_t rec = chunk + STREAM_CHUNKED_TAG_BYTES;
+        blob[STREAM_CHUNKED_HEADER_BYTES + 5 * rec + 7] ^= 1;
+        ok = write_file(TS_OUT, blob, blob_len) &&
+            crypto_file_open(&cf, &AES_TTABLE_ENGINE, TS_OUT, TS_KEY, 32, TS_KEY, 32, 0) == 0 &&
+            crypto_file_pread(cf, got, 100, 5 * chunk + 10) == -10 &&
+            crypto_file_pread(cf, got, 100, 4 * chunk) == 100 && memcmp(got, pt + 4 * chunk, 100) == 0 &&
+            crypto_file_pread(cf, got, 2 * chunk, 4 * chunk) == -10 &&
+            crypto_file_pread(cf, got, 100, 6 * chunk) == 100 && memcmp(got, pt + 6 * chunk, 100) == 0;
+        crypto_file_close(cf);
+        cf = NULL;
+
+        ok = ok && write_file(TS_OUT, blob, blob_len - 5 - STREAM_CHUNKED_TAG_BYTES) &&
+            crypto_file_open(&cf, &AES_TTABLE_ENGINE, TS_OUT, TS_KEY, 32, TS_KEY, 32, 0) == -13 && cf == NULL &&
+            crypto_file_open(&cf, &AES_TTABLE_ENGINE, TS_IN, TS_KEY, 32, TS_KEY, 32, 0) == -17 &&
+            crypto_file_open(&cf, &AES_TTABLE_ENGINE, "no_such_file.bin", TS_KEY, 32, TS_KEY, 32, 0) == -2;
+        if (!ok) printf("[FAIL] crypto_file tamper/truncate\n");
+        free(blob);
+    }
+    else ok = 0;
+
+    remove(TS_IN);
+    remove(TS_OUT);
+    free(pt);
+    free(got);
+    if (ok) printf("[OK] crypto_file seekable reader\n");
+    return ok;
+}
+
+// 일괄 처리: 크기/종류/키가 섞인 작업을 단일 파일 API 결과와 비교
+#define TS_BATCH_JOBS 9
+
+static int run_batch_tests(void)
+{
+    static const size_t sizes[TS_BATCH_JOBS] = { 0, 1, 15, 4096, 70000, 5, 200000, 150001, 4097 };
+    static const unsigned char KEY2[16] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+    char in[TS_BATCH_JOBS][32], enc[TS_BATCH_JOBS][32], dec[TS_BATCH_JOBS][32];
+    stream_batch_job_t jobs[TS_BATCH_JOBS];
+    unsigned char* pts[TS_BATCH_JOBS];
+    int ok = 1;
+
+    stream_options_t opt;
+    stream_options_init(&opt);
+    opt.threads = 3;
+    opt.buf_size = 4096;
+
+    memset(jobs, 0, sizeof(jobs));
+    for (unsigned int i = 0; i < TS_BATCH_JOBS; i++) {
+        snprintf(in[i], sizeof(in[i]), "test_batch_%u.in", i);
+        snprintf(enc[i], sizeof(enc[i]), "test_batch_%u.enc", i);
+        snprintf(dec[i], sizeof(dec[i]), "test_batch_%u.dec", i);
+        pts[i] = make_pattern(sizes[i] + i);
+        ok = ok && pts[i] && write_file(in[i], pts[i] + i, sizes[i]);
+
+        stream_batch_job_t* j = &jobs[i];
+        j->kind = (i % 3 == 2) ? STREAM_BATCH_SHA512 : (i % 3 == 1) ? STREAM_BATCH_CTR : STREAM_BATCH_CTR_HMAC;
+        j->encrypt = 1;
+        j->in_path = in[i];
+        j->out_path = enc[i];
+        j->engine = &AES_TTABLE_ENGINE;
+        j->key = (i < 4) ? TS_KEY : KEY2;
+        j->key_len = (i < 4) ? 32 : 16;
+        memcpy(j->iv, TS_IV, sizeof(j->iv));
+        j->iv[15] = (unsigned char)i;
+        j->hmac_key = TS_KEY;
+        j->hmac_key_len = (i < 6) ? 32 : 20;
+    }
+
+    // 1) 암호화/해시: 단일 파일 API와 같은 결과 (큰 CTR 작업 4, 7은 조각으로 나뉨)
+    stream_batch_stats_t st;
+    ok = ok && stream_encrypt_batch_ex(jobs, TS_BATCH_JOBS, &opt, &st) == 0 &&
+        st.threads == 3 && st.split_jobs == 2 && st.segments >= 4 &&
+        st.efficiency > 0.0 && st.efficiency <= 1.0;
+    for (unsigned int i = 0; ok && i < TS_BATCH_JOBS; i++) {
+        const stream_batch_job_t* j = &jobs[i];
+        if (j->kind == STREAM_BATCH_SHA512) {
+            unsigned char digest[64];
+            ok = stream_hash_sha512_file_ex(in[i], digest, NULL) == 0 && memcmp(digest, j->digest, 64) == 0;
+            continue;
+        }
+        size_t a_len = 0, b_len = 0;
+        ok = stream_encrypt_ctr_hmac_file_ex(j->engine, in[i], TS_OUT, j->key, j->key_len, j->iv,
+            j->kind == STREAM_BATCH_CTR_HMAC ? j->hmac_key : NULL, j->hmac_key_len, NULL) == 0;
+        unsigned char* a = ok ? read_file(TS_OUT, &a_len) : NULL;
+        unsigned char* b = ok ? read_file(enc[i], &b_len) : NULL;
+        ok = a && b && a_len == b_len && memcmp(a, b, a_len) == 0;
+        free(a);
+        free(b);
+    }
+    if (!ok) printf("[FAIL] stream batch encrypt\n");
+
+    // 2) 복호화 왕복 (스레드 1개, 진행률)
+    progress_probe_t probe;
+    probe_init(&probe, &opt, STREAM_IO_STDIO, 0);
+    opt.threads = 1;
+    for (unsigned int i = 0; i < TS_BATCH_JOBS; i++) {
+        jobs[i].encrypt = 0;
+        jobs[i].in_path = enc[i];
+        jobs[i].out_path = dec[i];
+        if (jobs[i].kind == STREAM_BATCH_SHA512) jobs[i].in_path = in[i];
+    }
+    ok = ok && stream_encrypt_batch(jobs, TS_BATCH_JOBS, &opt) == 0 &&
+        probe.monotonic && probe.last == TS_BATCH_JOBS && probe.total == TS_BATCH_JOBS;
+    for (unsigned int i = 0; ok && i < TS_BATCH_JOBS; i++) {
+        if (jobs[i].kind == STREAM_BATCH_SHA512) continue;
+        size_t n = 0;
+        unsigned char* got = read_file(dec[i], &n);
+        ok = got && n == sizes[i] && (n == 0 || memcmp(got, pts[i] + i, n) == 0);
+        free(got);
+    }
+    if (!ok) printf("[FAIL] stream batch decrypt\n");
+
+    // 3) 변조된 작업만 -10 (출력 없음), 나머지는 성공
+    size_t blob_len = 0;
+    unsigned char* blob = ok ? read_file(enc[6], &blob_len) : NULL;
+    if (blob) {
+        blob[20] ^= 1;
+        remove(dec[6]);
+        opt.threads = 4;
+        ok = write_file(enc[6], blob, blob_len) &&
+            stream_encrypt_batch_ex(jobs, TS_BATCH_JOBS, &opt, &st) == 1 && st.split_jobs == 2 &&
+            jobs[6].rc == -10 && !file_exists(dec[6]) && jobs[0].rc == 0 && jobs[3].rc == 0;
+        free(blob);
+    }
+    else ok = 0;
+    if (!ok) printf("[FAIL] stream batch tamper\n");
+
+    // 4) 첫 작업 뒤 취소: 나머지는 -16
+    probe_init(&probe, &opt, STREAM_IO_STDIO, 1);
+    opt.threads = 1;
+    ok = ok && stream_encrypt_batch(jobs, TS_BATCH_JOBS, &opt) == TS_BATCH_JOBS - 1 &&
+        jobs[TS_BATCH_JOBS - 1].rc == -16;
+    if (!ok) printf("[FAIL] stream batch cancel\n");
+
+    for (unsigned int i = 0; i < TS_BATCH_JOBS; i++) {
+        remove(in[i]);
+        remove(enc[i]);
+        remove(dec[i]);
+        free(pts[i]);
+    }
+    remove(TS_OUT);
+    if (ok) printf("[OK] stream batch (work-stealing pool)\n");
+    return ok;
+}
+
+// 작은 파일 빠른 경로: 경계 크기에서 스트리밍 경로와 같은 결과, 취소 시 출력 없음
+static int run_small_file_tests(void)
+{
+    int ok = run_ctr_hmac_file_test(1000) &&
+        run_ctr_hmac_file_test(STREAM_SMALL_FILE_MAX) &&
+        run_ctr_hmac_file_test(STREAM_SMALL_FILE_MAX + 1) &&
+        run_ctr_hmac_decrypt_file_test(1000) &&
+        run_ctr_hmac_decrypt_file_test(STREAM_SMALL_FILE_MAX);
+
+    // CTR만 (출력 = CT), 모든 I/O 모드
+    const size_t len = 3000;
+    unsigned char* pt = make_pattern(len);
+    unsigned char* ct = pt ? reference_ctr(pt, len) : NULL;
+    ok = ok && ct && write_file(TS_IN, pt, len);
+    static const int modes[] = { STREAM_IO_STDIO, STREAM_IO_MMAP, STREAM_IO_PIPELINE, STREAM_IO_URING, STREAM_IO_DIRECT };
+    for (size_t i = 0; ok && i < sizeof(modes) / sizeof(modes[0]); i++) {
+        stream_options_t opt;
+        stream_options_init(&opt);
+        opt.io_mode = modes[i];
+        ok = stream_encrypt_ctr_file_ex(&AES_TTABLE_ENGINE, TS_IN, TS_OUT, TS_KEY, 32, TS_IV, &opt) == 0 &&
+            file_equals(TS_OUT, ct, len);
+    }
+
+    // 진행률 한 번, 취소하면 -16 + 출력 없음
+    progress_probe_t p;
+    stream_options_t opt;
+    probe_init(&p, &opt, STREAM_IO_STDIO, 0);
+    opt.buf_size = 0;
+    ok = ok && stream_encrypt_ctr_hmac_file_ex(&AES_TTABLE_ENGINE, TS_IN, TS_OUT, TS_KEY, 32, TS_IV, TS_KEY, 32, &opt) == 0 &&
+        p.calls == 1 && p.last == len && p.total == len;
+    remove(TS_OUT);
+    probe_init(&p, &opt, STREAM_IO_STDIO, 1);
+    opt.buf_size = 0;
+    ok = ok && stream_encrypt_ctr_hmac_file_ex(&AES_TTABLE_ENGINE, TS_IN, TS_OUT, TS_KEY, 32, TS_IV, TS_KEY, 32, &opt) == -16 &&
+        !file_exists(TS_OUT);
+
+    remove(TS_IN);
+    remove(TS_OUT);
+    free(pt);
+    free(ct);
+    if (ok) printf("[OK] stream small-file fast path\n");
+    else printf("[FAIL] stream small-file fast path\n");
+    return ok;
+}
+
+// 묶음 아카이브: 작은 파일 여러 개 + 빈 파일 + 여러 청크에 걸친 파일
+#define TS_ARC_FILES 40
+
+static int run_archive_tests(void)
+{
+    char paths[TS_ARC_FILES][32], names[TS_ARC_FILES][32];
+    const char* path_list[TS_ARC_FILES];
+    const char* name_list[TS_ARC_FILES];
+    unsigned char* data[TS_ARC_FILES];
+    size_t sizes[TS_ARC_FILES];
+    int ok = 1;
+
+    for (unsigned int i = 0; i < TS_ARC_FILES; i++) {
+        snprintf(paths[i], sizeof(paths[i]), "test_arc_%u.bin", i);
+        snprintf(names[i], sizeof(names[i]), "dir%u/file_%u.txt", i % 3, i);
+        path_list[i] = paths[i];
+        name_list[i] = names[i];
+        sizes[i] = (i == 5) ? 0 : (i == 17) ? 3 * 4096 + 11 : 37 * i + 1;
+        data[i] = make_pattern(sizes[i] + i);
+        ok = ok && data[i] && write_file(paths[i], data[i] + i, sizes[i]);
+    }
+    name_list[9] = NULL;    // 이름이 없으면 경로를 그대로 사용
+
+    // 진행률 total은 평문 스트림 전체 길이 (마지막 알림이 total과 같아야 함)
+    stream_options_t opt;
+    progress_probe_t probe;
+    probe_init(&probe, &opt, STREAM_IO_STDIO, 0);
+    ok = ok && stream_archive_create(&AES_TTABLE_ENGINE, TS_OUT, path_list, name_list, TS_ARC_FILES,
+        TS_KEY, 32, TS_IV, TS_KEY, 32, 4096, &opt) == 0 &&
+        probe.total > 0 && probe.last == probe.total && probe.monotonic;
+
+    // 1) 색인 / 부분 읽기 / 꺼내기
+    stream_archive_t* ar = NULL;
+    ok = ok && stream_archive_open(&ar, &AES_TTABLE_ENGINE, TS_OUT, TS_KEY, 32, TS_KEY, 32) == 0 &&
+        stream_archive_count(ar) == TS_ARC_FILES;
+    unsigned char got[3 * 4096 + 64];
+    for (unsigned int i = 0; ok && i < TS_ARC_FILES; i++) {
+        const char* name = NULL;
+        uint64_t size = 0;
+        ok = stream_archive_entry(ar, i, &name, &size) == 0 && size == sizes[i] &&
+            strcmp(name, i == 9 ? paths[i] : names[i]) == 0 &&
+            stream_archive_find(ar, name) == (long long)i &&
+            stream_archive_read(ar, i, got, sizeof(got), 0) == (long long)sizes[i] &&
+            (sizes[i] == 0 || memcmp(got, data[i] + i, sizes[i]) == 0);
+    }
+    ok = ok && stream_archive_read(ar, 17, got, 100, 4090) == 100 && memcmp(got, data[17] + 17 + 4090, 100) == 0 &&
+        stream_archive_read(ar, 3, got, 10, sizes[3]) == 0 &&
+        stream_archive_read(ar, TS_ARC_FILES, got, 10, 0) == -1 &&
+        stream_archive_find(ar, "no/such") == -1 &&
+        stream_archive_extract(ar, 17, TS_DEC) == 0 && file_equals(TS_DEC, data[17] + 17, sizes[17]) &&
+        stream_archive_extract(ar, 5, TS_DEC) == 0 && file_equals(TS_DEC, NULL, 0);
+
+    // 꺼내기 진행률 / 취소: 취소되면 -16, .part는 지우고 기존 출력은 그대로
+    probe_init(&probe, &opt, STREAM_IO_STDIO, 0);
+    ok = ok && stream_archive_extract_ex(ar, 17, TS_DEC, &opt) == 0 && file_equals(TS_DEC, data[17] + 17, sizes[17]) &&
+        probe.total == sizes[17] && probe.last == sizes[17];
+    probe_init(&probe, &opt, STREAM_IO_STDIO, 1);
+    probe.calls = 1;
+    ok = ok && stream_archive_extract_ex(ar, 3, TS_DEC, &opt) == -16 &&
+        !file_exists(TS_DEC STREAM_PARTIAL_SUFFIX) && file_equals(TS_DEC, data[17] + 17, sizes[17]);
+    stream_archive_close(ar);
+    ar = NULL;
+    if (!ok) printf("[FAIL] stream archive read/extract\n");
+
+    // 2) 변조된 청크에 걸친 항목만 -10, 아카이브가 아닌 컨테이너는 -17, 없는 입력은 -2
+    size_t blob_len = 0;
+    unsigned char* blob = ok ? read_file(TS_OUT, &blob_len) : NULL;
+    if (blob) {
+        blob[STREAM_CHUNKED_HEADER_BYTES + 10] ^= 1;     // 청크 0
+        ok = write_file(TS_OUT, blob, blob_len) &&
+            stream_archive_open(&ar, &AES_TTABLE_ENGINE, TS_OUT, TS_KEY, 32, TS_KEY, 32) == 0 &&
+            stream_archive_read(ar, 1, got, 10, 0) == -10 &&
+            stream_archive_extract(ar, 1, TS_DEC) == -10 && !file_exists(TS_DEC STREAM_PARTIAL_SUFFIX) &&
+            stream_archive_read(ar, 39, got, sizeof(got), 0) == (long long)sizes[39];
+        stream_archive_close(ar);
+        ar = NULL;
+        free(blob);
+    }
+    else ok = 0;
+    ok = ok && stream_chunked_encrypt_file(&AES_TTABLE_ENGINE, paths[17], TS_OUT, TS_KEY, 32, TS_IV, TS_KEY, 32, 4096, NULL) == 0 &&
+        stream_archive_open(&ar, &AES_TTABLE_ENGINE, TS_OUT, TS_KEY, 32, TS_KEY, 32) == -17 && ar == NULL;
+    path_list[3] = "no_such_file.bin";
+    ok = ok && stream_archive_create(&AES_TTABLE_ENGINE, TS_OUT, path_list, NULL, TS_ARC_FILES,
+        TS_KEY, 32, TS_IV, TS_KEY, 32, 4096, NULL) == -2 && !file_exists(TS_OUT);
+    if (!ok) printf("[FAIL] stream archive tamper/format\n");
+
+    for (unsigned int i = 0; i < TS_ARC_FILES; i++) {
+        remove(paths[i]);
+        free(data[i]);
+    }
+    remove(TS_OUT);
+    remove(TS_DEC);
+    if (ok) printf("[OK] stream archive (%d files)\n", TS_ARC_FILES);
+    return ok;
+}
+
+// 키 교체: 결과가 새 키로 처음부터 암호화한 파일과 같아야 함
+static int run_rekey_tests(void)
+{
+    static const unsigned char KEY2[16] = { 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 1, 2, 3, 4, 5, 6 };
+    static const unsigned char HKEY2[20] = { 'n', 'e', 'w', '-', 'h', 'm', 'a', 'c' };
+    unsigned char iv2[16];
+    memcpy(iv2, TS_IV, 16);
+    iv2[0] ^= 0x5a;
+
+    const size_t len = 10000 + 7;
+    unsigned char* pt = make_pattern(len);
+    size_t exp_len = 0, got_len = 0;
+    unsigned char* exp = NULL;
+    unsigned char* got = NULL;
+    stream_options_t opt;
+    stream_options_init(&opt);
+    opt.buf_size = 4096;
+    opt.threads = 2;
+
+    // 1) IV || CT || HMAC, 제자리 (in == out)
+    int ok = pt && write_file(TS_IN, pt, len) &&
+        stream_encrypt_ctr_hmac_file_ex(&AES_TTABLE_ENGINE, TS_IN, TS_DEC, KEY2, 16, iv2, HKEY2, sizeof(HKEY2), NULL) == 0 &&
+        (exp = read_file(TS_DEC, &exp_len)) != NULL &&
+        stream_encrypt_ctr_hmac_file_ex(&AES_TTABLE_ENGINE, TS_IN, TS_OUT, TS_KEY, 32, TS_IV, TS_KEY, 32, NULL) == 0 &&
+        stream_rekey_ctr_hmac_file(&AES_TTABLE_ENGINE, TS_OUT, TS_OUT, TS_KEY, 32, TS_KEY, 32,
+            KEY2, 16, iv2, HKEY2, sizeof(HKEY2), &opt) == 0 &&
+        file_equals(TS_OUT, exp, exp_len) && !file_exists(TS_OUT STREAM_PARTIAL_SUFFIX);
+
+    // 변조 / 틀린 이전 키: -10, 입력은 그대로
+    got = ok ? read_file(TS_OUT, &got_len) : NULL;
+    if (got) {
+        got[got_len / 2] ^= 1;
+        ok = write_file(TS_OUT, got, got_len) &&
+            stream_rekey_ctr_hmac_file(&AES_TTABLE_ENGINE, TS_OUT, TS_OUT, KEY2, 16, HKEY2, sizeof(HKEY2),
+                TS_KEY, 32, TS_IV, TS_KEY, 32, &opt) == -10 &&
+            file_equals(TS_OUT, got, got_len) && !file_exists(TS_OUT STREAM_PARTIAL_SUFFIX) &&
+            stream_rekey_ctr_hmac_file(&AES_TTABLE_ENGINE, TS_DEC, TS_OUT, KEY2, 16, TS_KEY, 32,
+                TS_KEY, 32, TS_IV, TS_KEY, 32, NULL) == -10;
+        free(got);
+        got = NULL;
+    }
+    else ok = 0;
+
+    // 태그 없는 형식 → 태그 있는 형식
+    free(exp);
+    exp = NULL;
+    ok = ok && stream_encrypt_ctr_hmac_file_ex(&AES_TTABLE_ENGINE, TS_IN, TS_OUT, TS_KEY, 32, TS_IV, NULL, 0, NULL) == 0 &&
+        stream_rekey_ctr_hmac_file(&AES_TTABLE_ENGINE, TS_OUT, TS_DEC, TS_KEY, 32, NULL, 0,
+            KEY2, 16, iv2, HKEY2, sizeof(HKEY2), NULL) == 0 &&
+        stream_decrypt_ctr_hmac_file_ex(&AES_TTABLE_ENGINE, TS_DEC, TS_OUT, KEY2, 16, HKEY2, sizeof(HKEY2), NULL) == 0 &&
+        file_equals(TS_OUT, pt, len);
+    if (!ok) printf("[FAIL] stream rekey iv||ct||hmac\n");
+
+    // 2) 청크 컨테이너 (키 길이도 바뀜)
+    ok = ok && stream_chunked_encrypt_file(&AES_TTABLE_ENGINE, TS_IN, TS_DEC, KEY2, 16, iv2, HKEY2, sizeof(HKEY2), 1024, NULL) == 0 &&
+        (exp = read_file(TS_DEC, &exp_len)) != NULL &&
+        stream_chunked_encrypt_file(&AES_TTABLE_ENGINE, TS_IN, TS_OUT, TS_KEY, 32, TS_IV, TS_KEY, 32, 1024, NULL) == 0 &&
+        stream_chunked_rekey_file(&AES_TTABLE_ENGINE, TS_OUT, TS_OUT, TS_KEY, 32, TS_KEY, 32,
+            KEY2, 16, iv2, HKEY2, sizeof(HKEY2), &opt) == 0 &&
+        file_equals(TS_OUT, exp, exp_len) &&
+        stream_chunked_rekey_file(&AES_TTABLE_ENGINE, TS_OUT, TS_DEC, TS_KEY, 32, TS_KEY, 32,
+            KEY2, 16, iv2, HKEY2, sizeof(HKEY2), &opt) == -17;
+    got = ok ? read_file(TS_OUT, &got_len) : NULL;
+    if (got) {
+        got[STREAM_CHUNKED_HEADER_BYTES + 3 * (1024 + STREAM_CHUNKED_TAG_BYTES) + 5] ^= 1;
+        ok = write_file(TS_OUT, got, got_len) &&
+            stream_chunked_rekey_file(&AES_TTABLE_ENGINE, TS_OUT, TS_DEC, KEY2, 16, HKEY2, sizeof(HKEY2),
+                TS_KEY, 32, TS_IV, TS_KEY, 32, &opt) == -10 &&
+            !file_exists(TS_DEC STREAM_PARTIAL_SUFFIX) &&
+            write_file(TS_OUT, got, got_len - 5) &&
+            stream_chunked_rekey_file(&AES_TTABLE_ENGINE, TS_OUT, TS_DEC, KEY2, 16, HKEY2, sizeof(HKEY2),
+                TS_KEY, 32, TS_IV, TS_KEY, 32, &opt) != 0;
+        free(got);
+    }
+    else ok = 0;
+    if (!ok) printf("[FAIL] stream rekey chunked\n");
+
+    remove(TS_IN);
+    remove(TS_OUT);
+    remove(TS_DEC);
+    free(pt);
+    free(exp);
+    if (ok) printf("[OK] stream single-pass rekey\n");
+    return ok;
+}
+
+// 청크 압축: CSV 같은 텍스트 청크는 줄고, 난수 청크는 엔트로피 검사에서 걸러 그대로 저장
+#define TS_LZ_CHUNK 4096u
+
+static unsigned char* make_csv(size_t len)
+{
+    unsigned char* p = (unsigned char*)malloc(len + 1);
+    if (!p) return NULL;
+    size_t n = 0;
+    for (unsigned int row = 0; n < len; row++) {
+        char line[96];
+        int m = snprintf(line, sizeof(line), "%u,sensor-%02u,2024-01-%02u,%u.%u,OK\n",
+            row, row % 16, 1 + row % 28, 20 + row % 7, row % 10);
+        for (int i = 0; i < m && n < len; i++) p[n++] = (unsigned char)line[i];
+    }
+    return p;
+}
+
+static int run_compress_tests(void)
+{
+    // 1) LZ 단독: 왕복 / 난수 거르기 / 빈 입력 / 잘린 압축본
+    const size_t text_len = 10 * TS_LZ_CHUNK;
+    const size_t rand_len = 3 * TS_LZ_CHUNK;
+    unsigned char* text = make_csv(text_len);
+    unsigned char* rnd = make_pattern(rand_len);
+    unsigned char* z = (unsigned char*)malloc(text_len);
+    unsigned char* back = (unsigned char*)malloc(text_len);
+    int ok = text && rnd && z && back;
+
+    size_t zn = ok ? stream_lz_compress(text, text_len, z, text_len - 1) : 0;
+    ok = ok && zn > 0 && zn < text_len / 2 &&
+        stream_lz_decompress(z, zn, back, text_len) == (long long)text_len &&
+        memcmp(back, text, text_len) == 0 &&
+        stream_lz_decompress(z, zn, back, text_len - 1) == -1 &&
+        stream_lz_decompress(z, zn / 2, back, text_len) != (long long)text_len &&
+        stream_lz_probe(text, text_len) == 1 &&
+        stream_lz_probe(rnd, rand_len) == 0 &&
+        stream_lz_compress(text, 0, z, 1) == 1 &&
+        stream_lz_decompress(z, 1, back, 0) == 0;
+    if (!ok) printf("[FAIL] stream lz codec\n");
+
+    // 2) 컨테이너: 텍스트 10청크 + 난수 3청크 + 텍스트 일부
+    const size_t len = text_len + rand_len + 123;
+    unsigned char* pt = (unsigned char*)malloc(len);
+    unsigned char* got = NULL;
+    size_t got_len = 0, raw_len = 0;
+    stream_options_t opt;
+    stream_options_init(&opt);
+    opt.threads = 3;
+    opt.compress = 1;
+    if (pt && ok) {
+        memcpy(pt, text, text_len);
+        memcpy(pt + text_len, rnd, rand_len);
+        memcpy(pt + text_len + rand_len, text, 123);
+    }
+    ok = ok && pt && write_file(TS_IN, pt, len) &&
+        stream_chunked_encrypt_file(&AES_TTABLE_ENGINE, TS_IN, TS_DEC, TS_KEY, 32, TS_IV, TS_KEY, 32, TS_LZ_CHUNK, NULL) == 0 &&
+        (got = read_file(TS_DEC, &raw_len)) != NULL;
+    free(got);
+    got = NULL;
+    ok = ok && stream_chunked_encrypt_file(&AES_TTABLE_ENGINE, TS_IN, TS_OUT, TS_KEY, 32, TS_IV, TS_KEY, 32, TS_LZ_CHUNK, &opt) == 0 &&
+        (got = read_file(TS_OUT, &got_len)) != NULL &&
+        got[8] == STREAM_CHUNKED_FLAG_LZ &&
+        got_len < raw_len - text_len / 2 &&
+        stream_chunked_decrypt_file(&AES_TTABLE_ENGINE, TS_OUT, TS_DEC, TS_KEY, 32, TS_KEY, 32, &opt) == 0 &&
+        file_equals(TS_DEC, pt, len);
+
+    // 난수 청크는 그대로 저장: 저장 길이 == 평문 길이
+    if (ok) {
+        size_t pos = STREAM_CHUNKED_HEADER_BYTES;
+        for (size_t i = 0; i < 10 && pos + 8 <= got_len; i++)
+            pos += STREAM_CHUNKED_RECORD_HEAD + load_be32(got + pos + 4) + STREAM_CHUNKED_TAG_BYTES;
+        ok = pos + 8 <= got_len &&
+            load_be32(got + pos) == TS_LZ_CHUNK && load_be32(got + pos + 4) == TS_LZ_CHUNK;
+    }
+
+    // 임의 접근 읽기 (청크 위치는 열 때 수집)
+    crypto_file_t* cf = NULL;
+    ok = ok && crypto_file_open(&cf, &AES_TTABLE_ENGINE, TS_OUT, TS_KEY, 32, TS_KEY, 32, 2) == 0 &&
+        crypto_file_size(cf) == len;
+    for (size_t off = 0; ok && off < len; off += 1777) {
+        unsigned char buf[3000];
+        size_t want = (len - off < sizeof(buf)) ? len - off : sizeof(buf);
+        ok = crypto_file_pread(cf, buf, sizeof(buf), off) == (long long)want &&
+            memcmp(buf, pt + off, want) == 0;
+    }
+    crypto_file_close(cf);
+    if (!ok) printf("[FAIL] stream compressed container\n");
+
+    // 3) 키 교체 (압축본 그대로) 후 새 키로 복호화
+    static const unsigned char KEY2[16] = { 3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5, 8, 9, 7, 9, 3 };
+    ok = ok && stream_chunked_rekey_file(&AES_TTABLE_ENGINE, TS_OUT, TS_DEC, TS_KEY, 32, TS_KEY, 32,
+            KEY2, 16, TS_IV, KEY2, 16, &opt) == 0 &&
+        stream_chunked_decrypt_file(&AES_TTABLE_ENGINE, TS_DEC, TS_DEC, KEY2, 16, KEY2, 16, NULL) == 0 &&
+        file_equals(TS_DEC, pt, len);
+
+    // 4) 길이 필드 변조 / 플래그 제거: 실패하고 출력 없음
+    if (ok && got) {
+        got[STREAM_CHUNKED_HEADER_BYTES + 7] ^= 1;
+        ok = write_file(TS_OUT, got, got_len) &&
+            stream_chunked_decrypt_file(&AES_TTABLE_ENGINE, TS_OUT, TS_DEC "2", TS_KEY, 32, TS_KEY, 32, NULL) != 0 &&
+            !file_exists(TS_DEC "2");
+        got[STREAM_CHUNKED_HEADER_BYTES + 7] ^= 1;
+        got[8] = 0;
+        ok = ok && write_file(TS_OUT, got, got_len) &&
+            stream_chunked_decrypt_file(&AES_TTABLE_ENGINE, TS_OUT, TS_DEC "2", TS_KEY, 32, TS_KEY, 32, NULL) != 0 &&
+            !file_exists(TS_DEC "2");
+    }
+
+    // 5) 청크 크기의 배수 (빈 마지막 청크)
+    ok = ok && write_file(TS_IN, text, text_len) &&
+        stream_chunked_encrypt_file(&AES_TTABLE_ENGINE, TS_IN, TS_OUT, TS_KEY, 32, TS_IV, TS_KEY, 32, TS_LZ_CHUNK, &opt) == 0 &&
+        stream_chunked_decrypt_file(&AES_TTABLE_ENGINE, TS_OUT, TS_DEC, TS_KEY, 32, TS_KEY, 32, NULL) == 0 &&
+        file_equals(TS_DEC, text, text_len);
+
+    // 6) 압축을 지원하지 않는 API는 compress가 켜져 있으면 -1
+    unsigned char digest[64];
+    ok = ok && stream_encrypt_ctr_file_ex(&AES_TTABLE_ENGINE, TS_IN, TS_DEC, TS_KEY, 32, TS_IV, &opt) == -1 &&
+        stream_encrypt_ctr_hmac_file_ex(&AES_TTABLE_ENGINE, TS_IN, TS_DEC, TS_KEY, 32, TS_IV, TS_KEY, 32, &opt) == -1 &&
+        stream_hash_sha512_file_ex(TS_IN, digest, &opt) == -1;
+    if (!ok) printf("[FAIL] stream compressed rekey/tamper\n");
+
+    remove(TS_IN);
+    remove(TS_OUT);
+    remove(TS_DEC);
+    free(got);
+    free(pt);
+    free(text);
+    free(rnd);
+    free(z);
+    free(back);
+    if (ok) printf("[OK] stream chunk compression\n");
+    return ok;
+}
+
+// 중복 제거 일괄 암호화: 같은 내용은 한 번만 암호화하고 나머지는 참조
+#define TS_DEDUP_JOBS 7
+
+// 지문 단계가 끝나는 순간 (첫 done == total) 입력을 바꾼다
+typedef struct dedup_change_t {
+    const char* path;
+    const unsigned char* data;
+    size_t len;
+    int fired;
+} dedup_change_t;
+
+static void dedup_change_progress(void* user, uint64_t done, uint64_t total)
+{
+    dedup_change_t* c = (dedup_change_t*)user;
+    if (done == total && !c->fired) {
+        c->fired = 1;
+        write_file(c->path, c->data, c->len);
+    }
+}
+
+static int run_dedup_tests(void)
+{
+    char in[TS_DEDUP_JOBS][48], out[TS_DEDUP_JOBS][48];
+    // 내용: A B A 빈 A B (없는 파일)
+    static const int content[TS_DEDUP_JOBS] = { 0, 1, 0, 2, 0, 1, -1 };
+    const size_t len_a = 70000, len_b = 1234;
+    unsigned char* a = make_pattern(len_a);
+    unsigned char* b = make_pattern(len_b);
+    int ok = a && b;
+    if (b) b[0] ^= 0xff;   // A의 앞부분과 다르게
+
+    for (int i = 0; i < TS_DEDUP_JOBS; i++) {
+        snprintf(in[i], sizeof(in[i]), "test_stream_dd_in%d.bin", i);
+        snprintf(out[i], sizeof(out[i]), "test_stream_dd_out%d.bin", i);
+        remove(out[i]);
+        if (content[i] == 0) ok = ok && write_file(in[i], a, len_a);
+        else if (content[i] == 1) ok = ok && write_file(in[i], b, len_b);
+        else if (content[i] == 2) ok = ok && write_file(in[i], a, 0);
+        else remove(in[i]);
+    }
+
+    key_context_t kc;
+    static const unsigned char seed[8] = { 'd', 'e', 'd', 'u', 'p', '-', 't', 's' };
+    key_context_init_seed(&kc, seed, sizeof(seed));
+    stream_options_t opt;
+    stream_options_init(&opt);
+    opt.threads = 3;
+    opt.buf_size = 4096;
+
+    stream_dedup_job_t jobs[TS_DEDUP_JOBS];
+    stream_dedup_stats_t st;
+    memset(jobs, 0, sizeof(jobs));
+    for (int i = 0; i < TS_DEDUP_JOBS; i++) {
+        jobs[i].in_path = in[i];
+        jobs[i].out_path = out[i];
+    }
+    ok = ok && stream_encrypt_batch_dedup(&AES_TTABLE_ENGINE, &kc, 32, jobs, TS_DEDUP_JOBS, &opt, &st) == 1 &&
+        st.unique == 3 && st.duplicates == 3 &&
+        jobs[6].rc == -2 &&
+        jobs[0].dup_of == 0 && jobs[1].dup_of == 1 && jobs[2].dup_of == 0 && jobs[3].dup_of == 3 &&
+        jobs[4].dup_of == 0 && jobs[5].dup_of == 1 &&
+        file_exists(out[0]) && file_exists(out[1]) && file_exists(out[3]) &&
+        !file_exists(out[2]) && !file_exists(out[4]) && !file_exists(out[5]) && !file_exists(out[6]) &&
+        memcmp(jobs[2].digest, jobs[0].digest, SHA512_DIGEST_LENGTH) == 0;
+
+    // 지문으로 키를 되살려 복호화
+    key_file_keys_t keys;
+    ok = ok && stream_dedup_keys(&kc, jobs[0].digest, 32, &keys) == 0 &&
+        stream_decrypt_ctr_hmac_file_ex(&AES_TTABLE_ENGINE, out[0], TS_DEC, keys.aes_key, 32,
+            keys.hmac_key, KC_FILE_HMAC_KEY_BYTES, NULL) == 0 &&
+        file_equals(TS_DEC, a, len_a) &&
+        stream_dedup_keys(&kc, jobs[3].digest, 32, &keys) == 0 &&
+        stream_decrypt_ctr_hmac_file_ex(&AES_TTABLE_ENGINE, out[3], TS_DEC, keys.aes_key, 32,
+            keys.hmac_key, KC_FILE_HMAC_KEY_BYTES, NULL) == 0 &&
+        file_equals(TS_DEC, a, 0);
+
+    // 결정적: 같은 내용을 다른 묶음에서 다시 암호화해도 같은 암호문
+    size_t ct_len = 0;
+    unsigned char* ct = ok ? read_file(out[1], &ct_len) : NULL;
+    stream_dedup_job_t again;
+    memset(&again, 0, sizeof(again));
+    again.in_path = in[5];
+    again.out_path = TS_OUT;
+    ok = ok && ct && stream_encrypt_batch_dedup(&AES_TTABLE_ENGINE, &kc, 32, &again, 1, NULL, NULL) == 0 &&
+        again.dup_of == 0 && file_equals(TS_OUT, ct, ct_len);
+    free(ct);
+
+    // 지문 단계와 암호화 단계 사이에 입력이 바뀜: 다른 내용이 지문의 키/IV로 암호화되므로 실패
+    stream_dedup_job_t changed[2];
+    dedup_change_t chg = { in[1], a, len_a, 0 };
+    memset(changed, 0, sizeof(changed));
+    changed[0].in_path = in[1];
+    changed[0].out_path = out[1];
+    changed[1].in_path = in[5];
+    changed[1].out_path = out[5];
+    stream_options_init(&opt);
+    opt.threads = 1;
+    opt.progress = dedup_change_progress;
+    opt.user = &chg;
+    remove(out[1]);
+    remove(out[5]);
+    ok = ok && stream_encrypt_batch_dedup(&AES_TTABLE_ENGINE, &kc, 32, changed, 2, &opt, NULL) == 2 &&
+        chg.fired && changed[0].rc == -14 && changed[1].dup_of == 0 && changed[1].rc == -14 &&
+        !file_exists(out[1]) && !file_exists(out[5]) &&
+        memcmp(changed[0].digest, jobs[1].digest, SHA512_DIGEST_LENGTH) == 0;
+
+    for (int i = 0; i < TS_DEDUP_JOBS; i++) {
+        remove(in[i]);
+        remove(out[i]);
+    }
+    remove(TS_OUT);
+    remove(TS_DEC);
+    memset(&keys, 0, sizeof(keys));
+    key_context_clear(&kc);
+    free(a);
+    free(b);
+    if (ok) printf("[OK] stream dedup batch\n");
+    else printf("[FAIL] stream dedup batch\n");
+    return ok;
+}
+
+// 무결성 색인: 바뀌지 않은 파일은 메타데이터만 보고 답한다
+#define TS_IDX       "test_stream_idx.sidx"
+#define TS_IDX_FILES 4
+
+// 수정 시각을 seconds초 전으로 (색인의 racy 구간 밖으로)
+static int backdate(const char* path, long seconds)
+{
+#ifdef _WIN32
+    struct _utimbuf t;
+    t.actime = t.modtime = time(NULL) - seconds;
+    return _utime(path, &t) == 0;
+#else
+    struct utimbuf t;
+    t.actime = t.modtime = time(NULL) - seconds;
+    return utime(path, &t) == 0;
+#endif
+}
+
+static int run_index_tests(void)
+{
+    static const unsigned char IKEY[16] = { 'i', 'd', 'x', '-', 'k', 'e', 'y' };
+    char path[TS_IDX_FILES][40];
+    unsigned char exp[TS_IDX_FILES][64];
+    const size_t len = 20000;
+    unsigned char* data = make_pattern(len);
+    int ok = data != NULL;
+    remove(TS_IDX);
+    for (int i = 0; ok && i < TS_IDX_FILES; i++) {
+        snprintf(path[i], sizeof(path[i]), "test_stream_idx%d.bin", i);
+        data[0] = (unsigned char)i;
+        ok = write_file(path[i], data, len - (size_t)i) && backdate(path[i], 100) &&
+            stream_hash_sha512_file(path[i], exp[i]) == 0;
+    }
+
+    // 1) 단일 파일: 처음은 계산, 다음은 색인. HMAC은 키마다 따로
+    stream_index_t* idx = NULL;
+    unsigned char d[64], mac[64], mac2[64];
+    size_t entries = 0;
+    uint64_t hits = 0, misses = 0;
+    ok = ok && stream_index_open(&idx, TS_IDX, NULL, 0) == -1 && idx == NULL &&     // 키 없는 색인은 위조 가능
+        stream_index_open(&idx, TS_IDX, IKEY, sizeof(IKEY)) == 0 &&
+        stream_index_sha512_file(idx, path[0], d, NULL) == 0 && memcmp(d, exp[0], 64) == 0 &&
+        stream_index_sha512_file(idx, path[0], d, NULL) == 0 && memcmp(d, exp[0], 64) == 0 &&
+        stream_hmac_sha512_file(path[0], TS_KEY, 32, mac) == 0 &&
+        stream_index_hmac_sha512_file(idx, path[0], TS_KEY, 32, d, NULL) == 0 && memcmp(d, mac, 64) == 0 &&
+        stream_index_hmac_sha512_file(idx, path[0], TS_KEY, 32, d, NULL) == 0 && memcmp(d, mac, 64) == 0 &&
+        stream_hmac_sha512_file(path[0], TS_KEY, 16, mac2) == 0 &&
+        stream_index_hmac_sha512_file(idx, path[0], TS_KEY, 16, d, NULL) == 0 && memcmp(d, mac2, 64) == 0;
+    stream_index_stats(idx, &entries, &hits, &misses);
+    ok = ok && entries == 3 && hits == 2 && misses == 3;
+
+    // 2) 일괄: 색인에 있는 파일만 건너뛰고 나머지는 병렬 계산
+    stream_batch_job_t jobs[TS_IDX_FILES];
+    stream_options_t opt;
+    stream_options_init(&opt);
+    opt.threads = 2;
+    memset(jobs, 0, sizeof(jobs));
+    for (int i = 0; i < TS_IDX_FILES; i++) {
+        jobs[i].kind = STREAM_BATCH_SHA512;
+        jobs[i].in_path = path[i];
+    }
+    ok = ok && stream_index_batch(idx, jobs, TS_IDX_FILES, &opt) == 0;
+    stream_index_stats(idx, &entries, &hits, &misses);
+    ok = ok && entries == 6 && hits == 3 && misses == 6;
+    for (int i = 0; ok && i < TS_IDX_FILES; i++) ok = memcmp(jobs[i].digest, exp[i], 64) == 0;
+    ok = ok && stream_index_save(idx) == 0;
+    stream_index_close(idx);
+    idx = NULL;
+
+    // 3) 다시 열면 모두 색인으로 답하고, 바뀐 파일만 다시 계산
+    memset(jobs[1].digest, 0, 64);
+    data[0] = 0x77;
+    ok = ok && write_file(path[2], data, len - 2) && backdate(path[2], 50) &&
+        stream_hash_sha512_file(path[2], exp[2]) == 0 &&
+        stream_index_open(&idx, TS_IDX, IKEY, sizeof(IKEY)) == 0 &&
+        stream_index_batch(idx, jobs, TS_IDX_FILES, &opt) == 0;
+    stream_index_stats(idx, &entries, &hits, &misses);
+    ok = ok && entries == 6 && hits == 3 && misses == 1;
+    for (int i = 0; ok && i < TS_IDX_FILES; i++) ok = memcmp(jobs[i].digest, exp[i], 64) == 0;
+
+    // 방금 쓴 파일은 racy 구간이라 색인을 믿지 않는다
+    ok = ok && write_file(TS_IN, data, 100) &&
+        stream_index_sha512_file(idx, TS_IN, d, NULL) == 0 &&
+        stream_index_sha512_file(idx, TS_IN, d, NULL) == 0;
+    stream_index_stats(idx, &entries, &hits, &misses);
+    ok = ok && hits == 3 && misses == 3;
+
+    // 없어진 파일 정리 (TS_IN, path[3])
+    remove(TS_IN);
+    remove(path[3]);
+    ok = ok && stream_index_prune(idx) == 2 && stream_index_save(idx) == 0;
+    stream_index_close(idx);
+    idx = NULL;
+    if (!ok) printf("[FAIL] stream integrity index\n");
+
+    // 4) 색인 파일 변조 / 다른 키: 빈 색인으로 시작
+    //    키 id는 index_key에 묶여 있어 HMAC(key, 라벨)만으로 찾을 수 없다
+    static const char KEY_ID_LABEL[] = "stream index key id";
+    size_t ilen = 0;
+    unsigned char* raw = ok ? read_file(TS_IDX, &ilen) : NULL;
+    if (raw) {
+        hmac_sha512(TS_KEY, 32, (const unsigned char*)KEY_ID_LABEL, sizeof(KEY_ID_LABEL) - 1, mac);
+        for (size_t k = 0; k + 16 <= ilen; k++) {
+            if (memcmp(raw + k, mac, 16) == 0) ok = 0;
+        }
+        ok = stream_index_open(&idx, TS_IDX, TS_KEY, 32) == 0;
+        stream_index_stats(idx, &entries, NULL, NULL);
+        ok = ok && entries == 0;
+        stream_index_close(idx);
+        idx = NULL;
+        raw[ilen / 2] ^= 1;
+        ok = ok && write_file(TS_IDX, raw, ilen) && stream_index_open(&idx, TS_IDX, IKEY, sizeof(IKEY)) == 0;
+        stream_index_stats(idx, &entries, NULL, NULL);
+        ok = ok && entries == 0;
+        stream_index_close(idx);
+        free(raw);
+    }
+    else ok = 0;
+    if (!ok) printf("[FAIL] stream integrity index file\n");
+
+    for (int i = 0; i < TS_IDX_FILES; i++) remove(path[i]);
+    remove(TS_IDX);
+    free(data);
+    if (ok) printf("[OK] stream integrity index\n");
+    return ok;
+}
+
+int test_stream_main(void)
+{
+    int ok = 1;
+    if (!run_io_mode_tests()) ok = 0;
+    if (!run_buffer_option_tests()) ok = 0;
+    if (!run_crypto_stream_tests()) ok = 0;
+    if (!run_ctr_hmac_file_test(0)) ok = 0;
+    if (!run_ctr_hmac_file_test(12345)) ok = 0;
+    if (!run_open_stream_tests()) ok = 0;
+    if (!run_ctr_hmac_decrypt_file_test(0)) ok = 0;
+    if (!run_ctr_hmac_decrypt_file_test(100000)) ok = 0;
+    if (!run_inplace_tests()) ok = 0;
+    if (!run_progress_tests()) ok = 0;
+    if (!run_resumable_encrypt_tests()) ok = 0;
+    if (!run_chunked_case(0, 1)) ok = 0;
+    if (!run_chunked_case(1000, 2)) ok = 0;
+    if (!run_chunked_case(3 * 4096, 3)) ok = 0;
+    if (!run_chunked_case(20 * 4096 + 5, 3)) ok = 0;
+    if (!run_crypto_file_tests()) ok = 0;
+    if (!run_batch_tests()) ok = 0;
+    if (!run_small_file_tests()) ok = 0;
+    if (!run_archive_tests()) ok = 0;
+    if (!run_rekey_tests()) ok = 0;
+    if (!run_compress_tests()) ok = 0;
+    if (!run_dedup_tests()) ok = 0;
+    if (!run_index_tests()) ok = 0;
+
+    if (ok) {
+        printf("\n=== ALL STREAM TESTS PASSED ===\n");
+        return 0;
+    }
+    else {
+        printf("\n=== STREAM TESTS FAILED ===\n");
+        return 1;
+    }
+}